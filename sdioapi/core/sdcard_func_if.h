@@ -58,12 +58,26 @@ struct sdcard_cmd53 {
 				    b7:Command CRC Error */
 };
 
+struct scatterlist;
+
+struct sdcard_cmd53_sg {
+	unsigned int direction; /* 0: Rd(card->host), 1: Wr(host->card) */
+	unsigned int op; /* 0: fixed address, 1: incrementing address */
+	unsigned int regaddr; /* lower 17bit */
+	struct scatterlist *sg; /* data buffer list */
+	unsigned int nents; /* number of sg entries */
+	unsigned int resp_flags; /* CMD response flags (see sdcard_cmd53) */
+};
+
 /* definitions for sdcard func drivers */
 struct sdcard_device *sdcard_register_driver(struct sdcard_driver *pdrv);
 int sdcard_unregister_driver(struct sdcard_driver *pdrv);
 int sdcard_register_irq_handler(void *irq_handler, void *ptr);
 int sdcard_cmd52(struct sdcard_device *pdev, struct sdcard_cmd52 *cmd);
 int sdcard_cmd53(struct sdcard_device *pdev, struct sdcard_cmd53 *cmd);
+int sdcard_cmd53_sg(struct sdcard_device *pdev, struct sdcard_cmd53_sg *cmd);
+int sdcard_begin_batch(struct sdcard_device *pdev);
+void sdcard_end_batch(struct sdcard_device *pdev);
 
 /* for debug */
 int sdcard_cmd52_funcnum(struct sdcard_device *pdev, struct sdcard_cmd52 *cmd,
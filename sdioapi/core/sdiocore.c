@@ -112,11 +112,51 @@ sdcard_cmd53(struct sdcard_device *pdev, struct sdcard_cmd53 *cmd)
 	return TRUE;
 }
 
+int
+sdcard_cmd53_sg(struct sdcard_device *pdev, struct sdcard_cmd53_sg *cmd)
+{
+	int ret;
+
+	DPRINT(SD_DBG_SG, "%s: %s, addr=%08x, nents=%d\n",
+	       __func__, cmd->direction ? "write" : "read ",
+	       cmd->regaddr, cmd->nents);
+
+	ret = sdioapi_cmd53_sg(cmd->direction, cmd->regaddr, cmd->sg,
+			       cmd->nents, cmd->op);
+	if (ret)
+		return FALSE;
+
+	cmd->resp_flags = 0;
+	return TRUE;
+}
+
+int
+sdcard_begin_batch(struct sdcard_device *pdev)
+{
+	DPRINT(SD_DBG_FUNC, "%s: enter\n", __func__);
+
+	if (sdioapi_begin_batch())
+		return FALSE;
+
+	return TRUE;
+}
+
+void
+sdcard_end_batch(struct sdcard_device *pdev)
+{
+	DPRINT(SD_DBG_FUNC, "%s: enter\n", __func__);
+
+	sdioapi_end_batch();
+}
+
 EXPORT_SYMBOL(sdcard_register_driver);
 EXPORT_SYMBOL(sdcard_unregister_driver);
 EXPORT_SYMBOL(sdcard_register_irq_handler);
 EXPORT_SYMBOL(sdcard_cmd52);
 EXPORT_SYMBOL(sdcard_cmd53);
+EXPORT_SYMBOL(sdcard_cmd53_sg);
+EXPORT_SYMBOL(sdcard_begin_batch);
+EXPORT_SYMBOL(sdcard_end_batch);
 
 int 
 sdcard_cmd52_funcnum(struct sdcard_device *pdev, struct sdcard_cmd52 *cmd,
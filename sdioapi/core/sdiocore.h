@@ -21,6 +21,9 @@
 #define printf(x...) sdioapi_ddi_printf(x)
 #define sdioapi_cmd52(x...) sdioapi_ddi_cmd52(x)
 #define sdioapi_cmd53(x...) sdioapi_ddi_cmd53(x)
+#define sdioapi_cmd53_sg(x...) sdioapi_ddi_cmd53_sg(x)
+#define sdioapi_begin_batch() sdioapi_ddi_begin_batch()
+#define sdioapi_end_batch() sdioapi_ddi_end_batch()
 
 #define FALSE		0
 #define TRUE		1
@@ -21,8 +21,12 @@
  */
 
 #include <linux/module.h>
+#include <linux/sched.h>
+#include <linux/scatterlist.h>
+#include <linux/mmc/core.h>
 #include <linux/mmc/host.h>
 #include <linux/mmc/card.h>
+#include <linux/mmc/sdio.h>
 #include <linux/mmc/sdio_ids.h>
 #include <linux/mmc/sdio_func.h>
 #include "sdio_if.h"
@@ -30,6 +34,10 @@
 static struct sdioapi_callback *sdiocallp;
 static struct sdio_func *sdiofunc;
 
+/* batch owner keeps the host claimed over several commands. */
+static struct task_struct *batch_owner;
+static int batch_depth;
+
 #define DRIVER_VERSION "1.0.1"
 
 
@@ -182,6 +190,50 @@ int sdioapi_ddi_printf(const char *fmt, ...)
 	return printk("%s", buf);
 }
 
+/*
+ * the command claims the host by itself unless it is in the batch
+ * of the current task. batch_owner is changed only by the owner, so
+ * it can be compared without lock.
+ */
+static inline void sdioapi_claim(void)
+{
+	if (batch_owner != current)
+		sdio_claim_host(sdiofunc);
+}
+
+static inline void sdioapi_release(void)
+{
+	if (batch_owner != current)
+		sdio_release_host(sdiofunc);
+}
+
+int sdioapi_ddi_begin_batch(void)
+{
+	if (sdiofunc == NULL)
+		return -EBUSY;
+
+	if (batch_owner == current) {
+		batch_depth++;
+		return 0;
+	}
+
+	sdio_claim_host(sdiofunc);
+	batch_owner = current;
+	batch_depth = 1;
+	return 0;
+}
+
+void sdioapi_ddi_end_batch(void)
+{
+	if (batch_owner != current)
+		return;
+
+	if (--batch_depth == 0) {
+		batch_owner = NULL;
+		sdio_release_host(sdiofunc);
+	}
+}
+
 int sdioapi_ddi_cmd52(unsigned int direction, unsigned int regaddr,
 		      unsigned char *data)
 {
@@ -190,13 +242,13 @@ int sdioapi_ddi_cmd52(unsigned int direction, unsigned int regaddr,
 	if (sdiofunc == NULL)
 		return -EBUSY;
 
-	sdio_claim_host(sdiofunc);
+	sdioapi_claim();
 	if (direction) {
 		sdio_writeb(sdiofunc, *data, regaddr, &err);
 	} else {
 		*data = sdio_readb(sdiofunc, regaddr, &err);
 	}
-	sdio_release_host(sdiofunc);
+	sdioapi_release();
 	return err;
 }
 
@@ -208,7 +260,7 @@ int sdioapi_ddi_cmd53(unsigned int direction, unsigned regaddr,
 	if (sdiofunc == NULL)
 		return -EBUSY;
 
-	sdio_claim_host(sdiofunc);
+	sdioapi_claim();
 	if (op) {
 		if (direction) {
 			err = sdio_memcpy_toio(sdiofunc, regaddr,
@@ -226,7 +278,119 @@ int sdioapi_ddi_cmd53(unsigned int direction, unsigned regaddr,
 					  regaddr, size);
 		}
 	}
-	sdio_release_host(sdiofunc);
+	sdioapi_release();
+	return err;
+}
+
+/*
+ * issue one multi-block CMD53 over the sg list.
+ * same as mmc_io_rw_extended() in mmc core, which is not exported.
+ */
+static int sdioapi_rw_extended_sg(struct sdio_func *func, unsigned int write,
+				  unsigned int addr, unsigned int incr,
+				  struct scatterlist *sg, int nents,
+				  unsigned int blocks)
+{
+	struct mmc_request mrq;
+	struct mmc_command cmd;
+	struct mmc_data data;
+
+	memset(&mrq, 0, sizeof(mrq));
+	memset(&cmd, 0, sizeof(cmd));
+	memset(&data, 0, sizeof(data));
+
+	mrq.cmd = &cmd;
+	mrq.data = &data;
+
+	cmd.opcode = SD_IO_RW_EXTENDED;
+	cmd.arg = write ? 0x80000000 : 0x00000000;
+	cmd.arg |= func->num << 28;
+	cmd.arg |= incr ? 0x04000000 : 0x00000000;
+	cmd.arg |= addr << 9;
+	cmd.arg |= 0x08000000 | blocks;	/* block mode */
+	cmd.flags = MMC_RSP_SPI_R5 | MMC_RSP_R5 | MMC_CMD_ADTC;
+
+	data.blksz = func->cur_blksize;
+	data.blocks = blocks;
+	data.flags = write ? MMC_DATA_WRITE : MMC_DATA_READ;
+	data.sg = sg;
+	data.sg_len = nents;
+
+	mmc_set_data_timeout(&data, func->card);
+
+	mmc_wait_for_req(func->card->host, &mrq);
+
+	if (cmd.error)
+		return cmd.error;
+	if (data.error)
+		return data.error;
+
+	if (cmd.resp[0] & R5_ERROR)
+		return -EIO;
+	if (cmd.resp[0] & R5_FUNCTION_NUMBER)
+		return -EINVAL;
+	if (cmd.resp[0] & R5_OUT_OF_RANGE)
+		return -ERANGE;
+
+	return 0;
+}
+
+int sdioapi_ddi_cmd53_sg(unsigned int direction, unsigned regaddr,
+			 struct scatterlist *sg, int nents, unsigned int op)
+{
+	struct mmc_host *host;
+	struct scatterlist *s;
+	unsigned int total = 0;
+	unsigned int blksz;
+	int err = 0;
+	int i;
+
+	if (sdiofunc == NULL)
+		return -EBUSY;
+
+	for_each_sg(sg, s, nents, i)
+		total += s->length;
+
+	sdioapi_claim();
+
+	host  = sdiofunc->card->host;
+	blksz = sdiofunc->cur_blksize;
+
+	/* the whole chain by one request if the host accepts it. */
+	if (!mmc_host_is_spi(host) && blksz != 0 &&
+	    (total % blksz) == 0 &&
+	    (total / blksz) <= min(host->max_blk_count, 511u) &&
+	    total <= host->max_req_size &&
+	    nents <= host->max_segs) {
+		err = sdioapi_rw_extended_sg(sdiofunc, direction, regaddr, op,
+					     sg, nents, total / blksz);
+		goto out;
+	}
+
+	/* otherwise each segment, but still under one host claim. */
+	for_each_sg(sg, s, nents, i) {
+		if (op) {
+			if (direction)
+				err = sdio_memcpy_toio(sdiofunc, regaddr,
+						       sg_virt(s), s->length);
+			else
+				err = sdio_memcpy_fromio(sdiofunc, sg_virt(s),
+							 regaddr, s->length);
+			regaddr += s->length;
+		} else {
+			if (direction)
+				err = sdio_writesb(sdiofunc, regaddr,
+						   sg_virt(s), s->length);
+			else
+				err = sdio_readsb(sdiofunc, sg_virt(s),
+						  regaddr, s->length);
+		}
+		if (err)
+			break;
+	}
+
+out:
+	sdioapi_release();
 	return err;
 }
 
@@ -235,3 +399,6 @@ EXPORT_SYMBOL(sdioapi_ddi_unset);
 EXPORT_SYMBOL(sdioapi_ddi_printf);
 EXPORT_SYMBOL(sdioapi_ddi_cmd52);
 EXPORT_SYMBOL(sdioapi_ddi_cmd53);
+EXPORT_SYMBOL(sdioapi_ddi_cmd53_sg);
+EXPORT_SYMBOL(sdioapi_ddi_begin_batch);
+EXPORT_SYMBOL(sdioapi_ddi_end_batch);
@@ -20,6 +20,8 @@ struct dummy {
 	;
 };
 
+struct scatterlist;
+
 struct sdioapi_callback {
 	void (*probe)(struct dummy *p);
 	void (*remove)(struct dummy *p);
@@ -34,4 +36,8 @@ int sdioapi_ddi_cmd52(unsigned int direction, unsigned int regaddr,
 		      unsigned char *data);
 int sdioapi_ddi_cmd53(unsigned int direction, unsigned regaddr,
 		      unsigned char *data, int size, unsigned int op);
+int sdioapi_ddi_begin_batch(void);
+void sdioapi_ddi_end_batch(void);
+int sdioapi_ddi_cmd53_sg(unsigned int direction, unsigned regaddr,
+			 struct scatterlist *sg, int nents, unsigned int op);
 
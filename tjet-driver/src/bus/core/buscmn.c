@@ -36,6 +36,7 @@
 #include "buscmn.h"
 #include "buscmn_dev.h"
 #include "bus_sdio.h"
+#include "bus_sim.h"
 
 
 /*-------------------------------------------------------------------
@@ -62,6 +63,21 @@ static S_BUS_OPS g_sdioBusOps = {
     .pIoctl         = BUS_sdioIoctl,
     .pRead          = BUS_sdioRead,
     .pWrite         = BUS_sdioWrite,
+    .pReadSg        = BUS_sdioReadSg,
+    .pWriteSg       = BUS_sdioWriteSg,
+    .pBeginBatch    = BUS_sdioBeginBatch,
+    .pEndBatch      = BUS_sdioEndBatch,
+};
+
+static S_BUS_OPS g_simBusOps = {
+    .pSetIrqHandler = BUS_simSetIrqHandler,
+    .pIoctl         = BUS_simIoctl,
+    .pRead          = BUS_simRead,
+    .pWrite         = BUS_simWrite,
+    .pReadSg        = BUS_simReadSg,
+    .pWriteSg       = BUS_simWriteSg,
+    .pBeginBatch    = BUS_simBeginBatch,
+    .pEndBatch      = BUS_simEndBatch,
 };
 
 /*-------------------------------------------------------------------
@@ -77,7 +93,7 @@ static S_BUS_OPS g_sdioBusOps = {
  *-----------------------------------------------------------------*/
 /**
  * allocate bus common device.
- * @param  busType  : bus type (SDIO or PCI)
+ * @param  busType  : bus type (SDIO, PCI or SIM)
  * @param  privSize : size of private data field.
  * @return pointer to the allocated bus common device.
  * @note   
@@ -94,6 +110,9 @@ BUSCMN_allocDev(T_BUSCMN_TYPE busType,
     case BUSCMN_TYPE_SDIO : 
         pBusOps = &g_sdioBusOps;
         break;
+    case BUSCMN_TYPE_SIM :
+        pBusOps = &g_simBusOps;
+        break;
     case BUSCMN_TYPE_PCI :
     case BUSCMN_TYPE_USB :
         // PCI and USB bus is not supported yet.
@@ -237,6 +256,9 @@ BUSCMN_registerDriver(S_BUSCMN_DRIVER *pDriver)
     case BUSCMN_TYPE_SDIO : 
         retval = BUS_sdioRegisterDriver(pDriver);
         break;
+    case BUSCMN_TYPE_SIM :
+        retval = BUS_simRegisterDriver(pDriver);
+        break;
     case BUSCMN_TYPE_PCI :
     case BUSCMN_TYPE_USB :
         // PCI and USB bus is not supported yet.
@@ -271,6 +293,9 @@ BUSCMN_unregisterDriver(S_BUSCMN_DRIVER *pDriver)
     case BUSCMN_TYPE_SDIO : 
         retval = BUS_sdioUnregisterDriver(pDriver);
         break;
+    case BUSCMN_TYPE_SIM :
+        retval = BUS_simUnregisterDriver(pDriver);
+        break;
     case BUSCMN_TYPE_PCI :
     case BUSCMN_TYPE_USB :
         // PCI and USB bus is not supported yet.
@@ -403,6 +428,107 @@ BUSCMN_write(void *pPtr,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : BUSCMN_readSg
+ *-----------------------------------------------------------------*/
+/**
+ * read data from device into the scatter-gather list.
+ * @param  pPtr        : pointer to the bus common device
+ * @param  addr        : data address of device.
+ * @param  pSg         : pointer to the scatterlist.
+ * @param  nents       : number of scatterlist entries.
+ * @param  pStatus     : return pointer of status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   the whole list is transferred under one bus claim.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUSCMN_readSg(void               *pPtr, 
+              u32                 addr,
+              struct scatterlist *pSg,
+              u32                 nents,
+              void               *pStatus)
+{
+
+    S_BUSCMN_DEV *pCmnDev = (S_BUSCMN_DEV *)pPtr;
+    return pCmnDev->pBusOps->pReadSg(pCmnDev, addr, pSg, nents, pStatus);
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUSCMN_writeSg
+ *-----------------------------------------------------------------*/
+/**
+ * write data in the scatter-gather list to device.
+ * @param  pPtr        : pointer to the bus common device
+ * @param  addr        : data address of device.
+ * @param  pSg         : pointer to the scatterlist.
+ * @param  nents       : number of scatterlist entries.
+ * @param  pStatus     : return pointer of status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   the whole list is transferred under one bus claim.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUSCMN_writeSg(void               *pPtr, 
+               u32                 addr,
+               struct scatterlist *pSg,
+               u32                 nents,
+               void               *pStatus)
+{
+
+    S_BUSCMN_DEV *pCmnDev = (S_BUSCMN_DEV *)pPtr;
+    return pCmnDev->pBusOps->pWriteSg(pCmnDev, addr, pSg, nents, pStatus);
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUSCMN_beginBatch
+ *-----------------------------------------------------------------*/
+/**
+ * begin the batch of bus accesses.
+ * @param  pPtr        : pointer to the bus common device
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   the bus is claimed once until BUSCMN_endBatch() is called,
+ *         the read/write in between skip their own bus claim.
+ *         the batch can be nested in the same context.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUSCMN_beginBatch(void *pPtr)
+{
+
+    S_BUSCMN_DEV *pCmnDev = (S_BUSCMN_DEV *)pPtr;
+    return pCmnDev->pBusOps->pBeginBatch(pCmnDev);
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUSCMN_endBatch
+ *-----------------------------------------------------------------*/
+/**
+ * end the batch of bus accesses.
+ * @param  pPtr        : pointer to the bus common device
+ * @return nothing.
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+void
+BUSCMN_endBatch(void *pPtr)
+{
+
+    S_BUSCMN_DEV *pCmnDev = (S_BUSCMN_DEV *)pPtr;
+    pCmnDev->pBusOps->pEndBatch(pCmnDev);
+
+}
+
+
 /**
  * Module Initailize/Cleanup functions.
  * called when module installed or rmoved.
@@ -458,3 +584,7 @@ EXPORT_SYMBOL(BUSCMN_setIrqHandler);
 EXPORT_SYMBOL(BUSCMN_ioctl);
 EXPORT_SYMBOL(BUSCMN_read);
 EXPORT_SYMBOL(BUSCMN_write);
+EXPORT_SYMBOL(BUSCMN_readSg);
+EXPORT_SYMBOL(BUSCMN_writeSg);
+EXPORT_SYMBOL(BUSCMN_beginBatch);
+EXPORT_SYMBOL(BUSCMN_endBatch);
@@ -62,5 +62,9 @@ extern T_CMN_ERR BUS_sdioSetIrqHandler(S_BUSCMN_DEV *, T_IRQ_HANDLER, void *);
 extern T_CMN_ERR BUS_sdioIoctl(S_BUSCMN_DEV *, T_BUSCMN_IOTYPE, void *);
 extern T_CMN_ERR BUS_sdioRead(S_BUSCMN_DEV *, u32, u32, void *, void *);
 extern T_CMN_ERR BUS_sdioWrite(S_BUSCMN_DEV *, u32, u32, void *, void *);
+extern T_CMN_ERR BUS_sdioReadSg(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUS_sdioWriteSg(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUS_sdioBeginBatch(S_BUSCMN_DEV *);
+extern void      BUS_sdioEndBatch(S_BUSCMN_DEV *);
 
 #endif /* __BUS_SDIO_H__ */
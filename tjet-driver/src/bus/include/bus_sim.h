@@ -0,0 +1,63 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *
+ *
+ *
+ */
+/*=================================================================*/
+
+#if !defined(__BUS_SIM_H__)
+#define __BUS_SIM_H__
+
+/*-------------------------------------------------------------------
+ *-----------------------------------------------------------------*/
+#include "cmn_type.h"
+#include "cmn_err.h"
+
+#include "buscmn.h"
+#include "buscmn_dev.h"
+
+/*-------------------------------------------------------------------
+ *-----------------------------------------------------------------*/
+#define BUSSIM_DEV_MAX_NUM 4 // shall not set over BUSCMN_DEV_MAX_NUM.
+
+
+/*-------------------------------------------------------------------
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ *-----------------------------------------------------------------*/
+extern T_CMN_ERR BUS_simRegisterDriver(S_BUSCMN_DRIVER *);
+extern T_CMN_ERR BUS_simUnregisterDriver(S_BUSCMN_DRIVER *);
+
+extern T_CMN_ERR BUS_simSetIrqHandler(S_BUSCMN_DEV *, T_IRQ_HANDLER, void *);
+extern T_CMN_ERR BUS_simIoctl(S_BUSCMN_DEV *, T_BUSCMN_IOTYPE, void *);
+extern T_CMN_ERR BUS_simRead(S_BUSCMN_DEV *, u32, u32, void *, void *);
+extern T_CMN_ERR BUS_simWrite(S_BUSCMN_DEV *, u32, u32, void *, void *);
+extern T_CMN_ERR BUS_simReadSg(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUS_simWriteSg(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUS_simBeginBatch(S_BUSCMN_DEV *);
+extern void      BUS_simEndBatch(S_BUSCMN_DEV *);
+
+#endif /* __BUS_SIM_H__ */
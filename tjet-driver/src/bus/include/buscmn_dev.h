@@ -40,7 +40,7 @@
 /*-------------------------------------------------------------------
  * Macro definition
  *-----------------------------------------------------------------*/
-#define BUSCMN_DEV_MAX_NUM 1
+#define BUSCMN_DEV_MAX_NUM 4
 
 /*-------------------------------------------------------------------
  * Structure definition
@@ -52,6 +52,10 @@ typedef struct S_BUS_OPS {
     T_CMN_ERR (*pIoctl)(S_BUSCMN_DEV *, T_BUSCMN_IOTYPE, void *);
     T_CMN_ERR (*pRead)(S_BUSCMN_DEV *, u32, u32, void *, void *);
     T_CMN_ERR (*pWrite)(S_BUSCMN_DEV *, u32, u32, void *, void *);
+    T_CMN_ERR (*pReadSg)(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+    T_CMN_ERR (*pWriteSg)(S_BUSCMN_DEV *, u32, struct scatterlist *, u32, void *);
+    T_CMN_ERR (*pBeginBatch)(S_BUSCMN_DEV *);
+    void      (*pEndBatch)(S_BUSCMN_DEV *);
 }S_BUS_OPS;
 
 
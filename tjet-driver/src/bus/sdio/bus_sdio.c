@@ -34,6 +34,9 @@
 #include <asm/atomic.h>
 #include <asm/bitops.h>
 #include <linux/version.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/scatterlist.h>
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,26)
 #include <linux/semaphore.h>
 #else
@@ -45,6 +48,10 @@
 #include "bus_sdio.h"
 #include "sdcard_func_if.h"
 
+// tracepoints of tosbuscmn are instantiated here.
+#define CREATE_TRACE_POINTS
+#include "bus_sdio_trace.h"
+
 /*-------------------------------------------------------------------
  * Macro definition
  *-----------------------------------------------------------------*/
@@ -55,6 +62,9 @@
 #define SDIO_OPCODE_FIXED_ADDR 0
 #define SDIO_OPCODE_INC_ADDR   1
 
+// max scatterlist entries built on stack for vmalloc buffer.
+#define SDIO_SG_MAX_NUM        16
+
 
 /*-------------------------------------------------------------------
  * Structure definition
@@ -74,6 +84,7 @@ typedef struct tagS_SDIO_PRIV {
 static void      BUS_sdioProbe(struct sdcard_device *);  // temporary 
 static void      BUS_sdioRemove(struct sdcard_device *); // temporary
 static int       BUS_sdioSetBlockSize(struct sdcard_device *, u8, u16 *);
+static T_CMN_ERR BUS_sdioXferSg(S_BUSCMN_DEV *, u8, u32, struct scatterlist *, u32, void *);
 
 
 /*-------------------------------------------------------------------
@@ -189,10 +200,14 @@ BUS_sdioExecCmd53(struct sdcard_device *pSdDev, u8 dir, u8 blockMode,
              dir, blockMode, opCode, addr, count, cmd53.dbuf[0], cmd53.dbuf[1], cmd53.dbuf[2], cmd53.dbuf[3], cmd53.dbuf[4]);
     }
 
+    trace_bus_sdio_cmd53(dir, blockMode, addr, count);
+
     /* down_interruptible(&pSdDev->sem); */
     retval = sdcard_cmd53(pSdDev, &cmd53);
     /* up(&pSdDev->sem); */
 
+    trace_bus_sdio_cmd53_done(dir, addr, retval, (u8)cmd53.resp_flags);
+
     if (retval == 0) {
         DBG_INFO2("cmd53 returns %d\n", retval);
     }
@@ -210,6 +225,108 @@ BUS_sdioExecCmd53(struct sdcard_device *pSdDev, u8 dir, u8 blockMode,
 }
 
 
+static inline int
+BUS_sdioExecCmd53Sg(struct sdcard_device *pSdDev, u8 dir, u8 opCode,
+                    u32 addr, struct scatterlist *pSg, u32 nents, u8 *pStatus)
+{
+
+    int                    retval;
+    struct sdcard_cmd53_sg cmd53 = {0};
+
+    cmd53.direction  = (unsigned int)dir;
+    cmd53.op         = opCode;
+    cmd53.regaddr    = (unsigned int)addr;
+    cmd53.sg         = pSg;
+    cmd53.nents      = nents;
+
+    DBG_INFO2("cmd53sg p:d=%d, oc=%d, ad=%08x, n=%u\n",
+              dir, opCode, addr, nents);
+
+    trace_bus_sdio_cmd53_sg(dir, addr, pSg, nents);
+
+    retval = sdcard_cmd53_sg(pSdDev, &cmd53);
+
+    trace_bus_sdio_cmd53_done(dir, addr, retval, (u8)cmd53.resp_flags);
+
+    if (retval == 0) {
+        DBG_INFO2("cmd53sg returns %d\n", retval);
+    }
+
+    // return back data.
+    *pStatus = (u8)cmd53.resp_flags;
+
+
+    return retval;
+}
+
+
+/**
+ * build the scatterlist of the vmalloc(vmap) buffer.
+ * returns 0 if the buffer needs more entries than max.
+ */
+static inline u32
+BUS_sdioVmallocToSg(void *pData, u32 length, struct scatterlist *pSg, u32 max)
+{
+
+    u8                 *pCur = (u8 *)pData;
+    u32                 rest = length;
+    u32                 len;
+    u32                 nents = 0;
+
+    sg_init_table(pSg, max);
+
+    while(rest > 0) {
+        if(nents >= max) {
+            return 0;
+        }
+        len = MIN(rest, (u32)(PAGE_SIZE - offset_in_page(pCur)));
+        sg_set_page(&pSg[nents], vmalloc_to_page(pCur), len, offset_in_page(pCur));
+        nents++;
+        pCur += len;
+        rest -= len;
+    }
+
+    sg_mark_end(&pSg[nents - 1]);
+
+    return nents;
+}
+
+
+/**
+ * resolve the data buffer to the linear(lowmem) address.
+ * the buffer of zero-copy data request is mapped by vmap(), and
+ * SDIO host controller can not handle it as is. so that, the transfer
+ * is divided into the physically contiguous chunks.
+ */
+static inline u32
+BUS_sdioLinearChunk(void *pData, u32 length, void **ppLinear)
+{
+
+    u8                 *pCur;
+    u32                 chunk;
+
+    if(!is_vmalloc_addr(pData)) {
+        // linear buffer, the whole data can be transferred at once.
+        *ppLinear = pData;
+        return length;
+    }
+
+    pCur      = (u8 *)page_address(vmalloc_to_page(pData)) + offset_in_page(pData);
+    *ppLinear = pCur;
+    chunk     = PAGE_SIZE - offset_in_page(pData);
+
+    // merge the following pages while these are physically contiguous.
+    while(chunk < length) {
+        if(page_address(vmalloc_to_page((u8 *)pData + chunk)) != (pCur + chunk)) {
+            break;
+        }
+        chunk += PAGE_SIZE;
+    }
+
+    return MIN(chunk, length);
+}
+
+
 /*-------------------------------------------------------------------
  * Function declarations
  *-----------------------------------------------------------------*/
@@ -640,11 +757,23 @@ BUS_sdioRead(S_BUSCMN_DEV *pCmnDev,
 
     u32                   len;
     u32                   rest;
+    u32                   chunk;
     u32                   addrPos;
     u32                   bufPos;
     u16                   count;
     u8                    blockMode;
     u8                    opCode;
+    void                 *pLinear;
+    u32                   nents;
+    struct scatterlist    sg[SDIO_SG_MAX_NUM];
+
+    // non-contiguous buffer goes to the card without splitting.
+    if(is_vmalloc_addr(pData)) {
+        nents = BUS_sdioVmallocToSg(pData, length, sg, SDIO_SG_MAX_NUM);
+        if(nents != 0) {
+            return BUS_sdioXferSg(pCmnDev, SDIO_DIR_IN, addr, sg, nents, pStatus);
+        }
+    }
 
     pSdDev  = (struct sdcard_device *)pCmnDev->pDev;
     pPriv   = DEV_TO_PRIV(pCmnDev);
@@ -655,7 +784,8 @@ BUS_sdioRead(S_BUSCMN_DEV *pCmnDev,
     bufPos  = 0;
 
     while(rest > 0) {
-        len = rest / pPriv->blockSize;
+        chunk = BUS_sdioLinearChunk((u8 *)pData + bufPos, rest, &pLinear);
+        len   = chunk / pPriv->blockSize;
         if(len != 0) {
             // at least 1block.
             blockMode = SDIO_BLKMODE_ON;
@@ -663,7 +793,7 @@ BUS_sdioRead(S_BUSCMN_DEV *pCmnDev,
             len       = count * pPriv->blockSize;
         } else {
             blockMode = SDIO_BLKMODE_OFF;
-            count     = (u16)MIN(512, (rest % pPriv->blockSize));
+            count     = (u16)MIN(512, (chunk % pPriv->blockSize));
             len       = count;
             count     = count % 512; // 0 means 512 byte.
         }
@@ -673,7 +803,7 @@ BUS_sdioRead(S_BUSCMN_DEV *pCmnDev,
                                    opCode,
                                    addr + addrPos,
                                    count,
-                                   (void *)((u8 *)pData + bufPos),
+                                   pLinear,
                                    (u8 *)pStatus);
         if(retval == FALSE) {
             DBG_ERR("exec cmd53 failed.\n");
@@ -725,11 +855,23 @@ BUS_sdioWrite(S_BUSCMN_DEV *pCmnDev,
 
     u32                   len;
     u32                   rest;
+    u32                   chunk;
     u32                   addrPos;
     u32                   bufPos;
     u16                   count;
     u8                    blockMode;
     u8                    opCode;
+    void                 *pLinear;
+    u32                   nents;
+    struct scatterlist    sg[SDIO_SG_MAX_NUM];
+
+    // non-contiguous buffer goes to the card without splitting.
+    if(is_vmalloc_addr(pData)) {
+        nents = BUS_sdioVmallocToSg(pData, length, sg, SDIO_SG_MAX_NUM);
+        if(nents != 0) {
+            return BUS_sdioXferSg(pCmnDev, SDIO_DIR_OUT, addr, sg, nents, pStatus);
+        }
+    }
 
     pSdDev  = (struct sdcard_device *)pCmnDev->pDev;
     pPriv   = DEV_TO_PRIV(pCmnDev);
@@ -740,7 +882,8 @@ BUS_sdioWrite(S_BUSCMN_DEV *pCmnDev,
     bufPos  = 0;
 
     while(rest > 0) {
-        len = rest / pPriv->blockSize;
+        chunk = BUS_sdioLinearChunk((u8 *)pData + bufPos, rest, &pLinear);
+        len   = chunk / pPriv->blockSize;
         if(len != 0) {
             // at least 1block.
             blockMode = SDIO_BLKMODE_ON;
@@ -748,7 +891,7 @@ BUS_sdioWrite(S_BUSCMN_DEV *pCmnDev,
             len       = count * pPriv->blockSize;
         } else {
             blockMode = SDIO_BLKMODE_OFF;
-            count     = (u16)MIN(512, (rest % pPriv->blockSize));
+            count     = (u16)MIN(512, (chunk % pPriv->blockSize));
             len       = count;
             count     = count % 512; // 0 means 512 byte.
         }
@@ -758,7 +901,7 @@ BUS_sdioWrite(S_BUSCMN_DEV *pCmnDev,
                                    opCode,
                                    addr + addrPos,
                                    count,
-                                   (void *)((u8 *)pData + bufPos),
+                                   pLinear,
                                    (u8 *)pStatus);
         if(retval == FALSE) {
             DBG_ERR("exec cmd53 failed.\n");
@@ -778,3 +921,163 @@ BUS_sdioWrite(S_BUSCMN_DEV *pCmnDev,
     return SUCCESS;
 
 }
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_sdioXferSg
+ *-----------------------------------------------------------------*/
+/**
+ * transfer the scatter-gather list with SDIO device
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  dir        : SDIO_DIR_IN or SDIO_DIR_OUT.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  pSg        : pointer to the scatterlist.
+ * @param  nents      : number of scatterlist entries.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   the host is claimed once for the whole list, and the list is
+ *         issued as one multi-block CMD53 if the host supports it.
+ */
+/*-----------------------------------------------------------------*/
+static T_CMN_ERR
+BUS_sdioXferSg(S_BUSCMN_DEV       *pCmnDev,
+               u8                  dir,
+               u32                 addr,
+               struct scatterlist *pSg,
+               u32                 nents,
+               void               *pStatus)
+{
+
+    int                   retval;
+
+    S_SDIO_PRIV          *pPriv;
+    struct sdcard_device *pSdDev;
+    u8                    opCode;
+
+    pSdDev  = (struct sdcard_device *)pCmnDev->pDev;
+    pPriv   = DEV_TO_PRIV(pCmnDev);
+
+    opCode  = (pPriv->dmaAddrMode == 0) ? SDIO_OPCODE_FIXED_ADDR : SDIO_OPCODE_INC_ADDR;
+
+    retval = BUS_sdioExecCmd53Sg(pSdDev,
+                                 dir,
+                                 opCode,
+                                 addr,
+                                 pSg,
+                                 nents,
+                                 (u8 *)pStatus);
+    if(retval == FALSE) {
+        DBG_ERR("exec cmd53 sg failed.\n");
+        return ERR_SYSTEM;
+    }
+
+    return SUCCESS;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_sdioReadSg
+ *-----------------------------------------------------------------*/
+/**
+ * read data from SDIO device into the scatter-gather list
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  pSg        : pointer to the scatterlist.
+ * @param  nents      : number of scatterlist entries.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUS_sdioReadSg(S_BUSCMN_DEV       *pCmnDev,
+               u32                 addr,
+               struct scatterlist *pSg,
+               u32                 nents,
+               void               *pStatus)
+{
+    return BUS_sdioXferSg(pCmnDev, SDIO_DIR_IN, addr, pSg, nents, pStatus);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_sdioWriteSg
+ *-----------------------------------------------------------------*/
+/**
+ * write data in the scatter-gather list to SDIO device
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  pSg        : pointer to the scatterlist.
+ * @param  nents      : number of scatterlist entries.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUS_sdioWriteSg(S_BUSCMN_DEV       *pCmnDev,
+                u32                 addr,
+                struct scatterlist *pSg,
+                u32                 nents,
+                void               *pStatus)
+{
+    return BUS_sdioXferSg(pCmnDev, SDIO_DIR_OUT, addr, pSg, nents, pStatus);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_sdioBeginBatch
+ *-----------------------------------------------------------------*/
+/**
+ * claim the SDIO host for the following commands.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_SYSTEM  (system error)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR 
+BUS_sdioBeginBatch(S_BUSCMN_DEV *pCmnDev)
+{
+
+    struct sdcard_device *pSdDev;
+
+    pSdDev = (struct sdcard_device *)pCmnDev->pDev;
+
+    if(sdcard_begin_batch(pSdDev) == FALSE) {
+        DBG_ERR("begin batch failed.\n");
+        return ERR_SYSTEM;
+    }
+
+    return SUCCESS;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_sdioEndBatch
+ *-----------------------------------------------------------------*/
+/**
+ * release the SDIO host claimed by BUS_sdioBeginBatch.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @return nothing.
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+void
+BUS_sdioEndBatch(S_BUSCMN_DEV *pCmnDev)
+{
+
+    struct sdcard_device *pSdDev;
+
+    pSdDev = (struct sdcard_device *)pCmnDev->pDev;
+
+    sdcard_end_batch(pSdDev);
+
+    return;
+
+}
@@ -0,0 +1,119 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     bus_sdio_trace.h
+ *
+ *  @brief    SDIO bus tracepoints.
+ *
+ *
+ *  @note     events are under "tosbuscmn" in tracefs.
+ */
+/*=================================================================*/
+
+#if !defined(__BUS_SDIO_TRACE_H__) || defined(TRACE_HEADER_MULTI_READ)
+#define __BUS_SDIO_TRACE_H__
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM tosbuscmn
+
+#include <linux/tracepoint.h>
+#include <linux/scatterlist.h>
+
+/**
+ * @brief CMD53 is issued, count is blocks if blockMode else bytes(0 is 512).
+ */
+TRACE_EVENT(bus_sdio_cmd53,
+    TP_PROTO(u8 dir, u8 blockMode, u32 addr, u16 count),
+    TP_ARGS(dir, blockMode, addr, count),
+    TP_STRUCT__entry(
+        __field(u8,  dir)
+        __field(u8,  blockMode)
+        __field(u32, addr)
+        __field(u16, count)
+    ),
+    TP_fast_assign(
+        __entry->dir       = dir;
+        __entry->blockMode = blockMode;
+        __entry->addr      = addr;
+        __entry->count     = count;
+    ),
+    TP_printk("dir=%s bm=%u addr=0x%08x count=%u",
+              __entry->dir ? "out" : "in", __entry->blockMode,
+              __entry->addr, __entry->count)
+);
+
+/**
+ * @brief CMD53 is issued with the scatterlist.
+ */
+TRACE_EVENT(bus_sdio_cmd53_sg,
+    TP_PROTO(u8 dir, u32 addr, struct scatterlist *pSg, u32 nents),
+    TP_ARGS(dir, addr, pSg, nents),
+    TP_STRUCT__entry(
+        __field(u8,  dir)
+        __field(u32, addr)
+        __field(u32, nents)
+        __field(u32, length)
+    ),
+    TP_fast_assign(
+        struct scatterlist *pCur;
+        u32                 i;
+
+        __entry->dir    = dir;
+        __entry->addr   = addr;
+        __entry->nents  = nents;
+        __entry->length = 0;
+        for_each_sg(pSg, pCur, nents, i) {
+            __entry->length += pCur->length;
+        }
+    ),
+    TP_printk("dir=%s addr=0x%08x nents=%u len=%u",
+              __entry->dir ? "out" : "in", __entry->addr,
+              __entry->nents, __entry->length)
+);
+
+/**
+ * @brief CMD53 is done, ret is TRUE on success.
+ */
+TRACE_EVENT(bus_sdio_cmd53_done,
+    TP_PROTO(u8 dir, u32 addr, int retval, u8 resp),
+    TP_ARGS(dir, addr, retval, resp),
+    TP_STRUCT__entry(
+        __field(u8,  dir)
+        __field(u32, addr)
+        __field(int, retval)
+        __field(u8,  resp)
+    ),
+    TP_fast_assign(
+        __entry->dir    = dir;
+        __entry->addr   = addr;
+        __entry->retval = retval;
+        __entry->resp   = resp;
+    ),
+    TP_printk("dir=%s addr=0x%08x ret=%d resp=0x%02x",
+              __entry->dir ? "out" : "in", __entry->addr,
+              __entry->retval, __entry->resp)
+);
+
+#endif /* __BUS_SDIO_TRACE_H__ */
+
+// this part must be outside the header guard.
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE bus_sdio_trace
+#include <trace/define_trace.h>
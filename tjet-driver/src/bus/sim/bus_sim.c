@@ -0,0 +1,1450 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     bus_sim.c
+ *
+ *  @brief    simulated IZAN bus interface function
+ *
+ *
+ *  @note     the register file of IZAN is modeled in software so that
+ *            the CNL driver runs without the SDIO card. the chips are
+ *            linked back-to-back by pair, (0,1) and (2,3), and the frames
+ *            sent by one chip are received by the other one.
+ *            T_Connect/T_Accept/T_Resend/T_Keepalive timers, rate control
+ *            and PHY/RF registers are not modeled.
+ */
+/*=================================================================*/
+/*-------------------------------------------------------------------
+ * Header section
+ *-----------------------------------------------------------------*/
+#include "cmn_type.h"
+#include "cmn_err.h"
+#include "cmn_dbg.h"
+
+#include <asm/bitops.h>
+#include <linux/version.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
+#include <linux/delay.h>
+#include <linux/jiffies.h>
+#include <linux/vmalloc.h>
+#include <linux/scatterlist.h>
+
+#include "buscmn.h"
+#include "buscmn_dev.h"
+#include "bus_sim.h"
+#include "cnl_type.h"
+#include "izan_cnf.h"
+#include "izan_sdio_reg.h"
+
+/*-------------------------------------------------------------------
+ * Macro definition
+ *-----------------------------------------------------------------*/
+#define BUSSIM_REG_SPACE           0x20000 // register address space of IZAN.
+#define BUSSIM_MNGFRM_SIZE         32      // TXMNGBODY1-8, RXMNGBODY1-8.
+
+#define BUSSIM_DATAINFO_VALID      0x80000000
+#define BUSSIM_DATAINFO_LENGTH(x)  ((x) & 0xFFFF)
+#define BUSSIM_PADDING_4B(x)       (((x) + 3) & ~0x03)
+
+// LiCC of management frame(2nd byte of the frame body).
+#define BUSSIM_LICC_C_REQ          0x01
+#define BUSSIM_LICC_C_ACC          0x02
+#define BUSSIM_LICC_C_RLS          0x03
+#define BUSSIM_LICC_C_SLEEP        0x08
+#define BUSSIM_LICC_C_WAKE         0x09
+#define BUSSIM_LICC_C_PROBE        0x0A
+
+#define BUSSIM_CMD_TO_CLMSTATE(x)  ((u8)((x) & 0x0F))
+#define BUSSIM_IS_CONNECTED(x)     (((x) == CLMSTATE_INIT_CONNECTED) || \
+                                    ((x) == CLMSTATE_RESP_CONNECTED))
+
+// CR OSC measurement result, rises by step per trimming level.
+#define BUSSIM_CRMSR_BASE          0x3400
+#define BUSSIM_CRMSR_STEP          0x0040
+
+// vendor code of the UID given to the simulated chips.
+#define BUSSIM_UID_VENDOR          0x0FEE
+
+
+/*-------------------------------------------------------------------
+ * Structure definition
+ *-----------------------------------------------------------------*/
+typedef struct tagS_SIM_BANK {
+    u32 info;                    // DATAINFO of the CSDU.
+    u32 pos;                     // TXFIFO/RXFIFO position in the CSDU.
+    u8  data[CNL_CSDU_SIZE];
+}S_SIM_BANK;
+
+typedef struct tagS_SIM_CHIP S_SIM_CHIP;
+
+struct tagS_SIM_CHIP {
+    u8                   index;
+    S_SIM_CHIP          *pPeer;       // chip linked back-to-back.
+    S_BUSCMN_DEV        *pCmnDev;
+    T_IRQ_HANDLER        pIrqHandler;
+    void                *pIrqArg;
+
+    u8                   reg[BUSSIM_REG_SPACE]; // register image(little endian).
+    u32                  command;
+    u32                  intst;
+    u32                  intmask;
+    u8                   cardIntEn;
+    u8                   txEnable;
+
+    S_SIM_BANK           txBank[IZAN_TX_CSDU_NUM];
+    u8                   txHead;      // oldest TX bank.
+    u8                   txCnt;       // TX banks given TXDATAINFO.
+    u8                   txFilled;    // TX banks filled through TXFIFO.
+
+    S_SIM_BANK           rxBank[IZAN_RX_CSDU_NUM];
+    u8                   rxHead;      // oldest RX bank.
+    u8                   rxCnt;       // RX banks holding CSDU.
+    u8                   rxRead;      // RX banks read through RXFIFO since READDONE.
+    u32                  rxDonePos;   // RXFIFO position of head bank at READDONE.
+
+    u8                   mfTx[BUSSIM_MNGFRM_SIZE];
+    u8                   mfTxPending; // management frame waits the peer.
+    u8                   mfRxBusy;    // RXMNGBODY is not read done yet.
+    u8                   caccRcvd;    // C-Acc received, ACK is not sent yet.
+
+    struct work_struct   irqWork;
+    struct delayed_work  xferWork;
+};
+
+
+/*-------------------------------------------------------------------
+ * Prototypes
+ *-----------------------------------------------------------------*/
+static void BUS_simIrqWork(struct work_struct *);
+static void BUS_simXferWork(struct work_struct *);
+static void BUS_simDeliverMngFrame(S_SIM_CHIP *);
+
+
+/*-------------------------------------------------------------------
+ * Globals
+ *-----------------------------------------------------------------*/
+static S_BUSCMN_DRIVER *g_pCmnDrv = NULL;
+static unsigned long    g_used    = 0;
+static S_SIM_CHIP      *g_pSimChip[BUSSIM_DEV_MAX_NUM] = {};
+static DEFINE_MUTEX(g_simLock);
+
+/**
+ * number of simulated chips, and latency in usec added to every bus
+ * command(register access or FIFO transfer) and to every data frame
+ * sent between the linked chips.
+ */
+static uint g_simDevNum      = 2;
+static uint g_simCmdLatency  = 0;
+static uint g_simLinkLatency = 0;
+module_param_named(SimDevNum,      g_simDevNum,      uint, S_IRUGO);
+module_param_named(SimCmdLatency,  g_simCmdLatency,  uint, S_IRUGO | S_IWUSR);
+module_param_named(SimLinkLatency, g_simLinkLatency, uint, S_IRUGO | S_IWUSR);
+
+
+/*-------------------------------------------------------------------
+ * Inline functions definition
+ *-----------------------------------------------------------------*/
+static inline u32
+BUS_simGetReg32(S_SIM_CHIP *pChip, u32 addr)
+{
+    return le32_to_cpu(*((u32 *)&pChip->reg[addr]));
+}
+
+
+static inline void
+BUS_simSetReg32(S_SIM_CHIP *pChip, u32 addr, u32 value)
+{
+    *((u32 *)&pChip->reg[addr]) = cpu_to_le32(value);
+}
+
+
+static inline void
+BUS_simDelay(void)
+{
+    uint latency = g_simCmdLatency;
+
+    if(latency == 0) {
+        return;
+    }
+    if(latency < 20) {
+        udelay(latency);
+    } else {
+        usleep_range(latency, latency + (latency >> 3));
+    }
+}
+
+
+/**
+ * request the IRQ handler if the interrupt is asserted.
+ * g_simLock must be held.
+ */
+static inline void
+BUS_simKick(S_SIM_CHIP *pChip)
+{
+    if((pChip->pIrqHandler != NULL) &&
+       (pChip->cardIntEn != 0) &&
+       ((pChip->intst & ~pChip->intmask) != 0)) {
+        schedule_work(&pChip->irqWork);
+    }
+}
+
+
+/**
+ * request sending the filled TX banks to the peer.
+ * g_simLock must be held.
+ */
+static inline void
+BUS_simScheduleXfer(S_SIM_CHIP *pChip)
+{
+    if(pChip->txFilled > 0) {
+        schedule_delayed_work(&pChip->xferWork, usecs_to_jiffies(g_simLinkLatency));
+    }
+}
+
+
+static inline u8
+BUS_simPmuState(u8 pmumchg)
+{
+    switch(pmumchg) {
+    case PMUMCHG_TO_DPSLP :
+        return PMUSTATE_DPSLP;
+    case PMUMCHG_TO_SLP :
+        return PMUSTATE_SLP;
+    case PMUMCHG_TO_AWK :
+    default :
+        return PMUSTATE_AWK;
+    }
+}
+
+
+/*-------------------------------------------------------------------
+ * Function declarations
+ *-----------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simSyncRegister
+ *-----------------------------------------------------------------*/
+/**
+ * reflect the chip state to the register image before read.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simSyncRegister(S_SIM_CHIP *pChip)
+{
+
+    u8  i;
+    u32 info;
+
+    BUS_simSetReg32(pChip, REG_TXBANKSTA, pChip->txCnt);
+    BUS_simSetReg32(pChip, REG_RXBANKSTA, pChip->rxCnt);
+
+    for(i=0; i<IZAN_RX_CSDU_NUM; i++) {
+        info = 0;
+        if(i < pChip->rxCnt) {
+            info = pChip->rxBank[(pChip->rxHead + i) % IZAN_RX_CSDU_NUM].info;
+        }
+        BUS_simSetReg32(pChip, REG_RXDATAINFO + (4 * i), info);
+    }
+
+    BUS_simSetReg32(pChip, REG_INT,     pChip->intst);
+    BUS_simSetReg32(pChip, REG_INTMASK, pChip->intmask);
+    BUS_simSetReg32(pChip, REG_COMMAND, pChip->command);
+    pChip->reg[REG_CLMSTATE] = BUSSIM_CMD_TO_CLMSTATE(pChip->command);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simDeliverMngFrame
+ *-----------------------------------------------------------------*/
+/**
+ * deliver the requested management frame to the peer.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ *         the frame is kept while the peer is closed or its MF buffer
+ *         is not read done, as IZAN repeats it until the peer receives.
+ *         C-Rls is not repeated.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simDeliverMngFrame(S_SIM_CHIP *pChip)
+{
+
+    S_SIM_CHIP *pPeer = pChip->pPeer;
+    u32         txBits;
+    u32         rxBits;
+
+    if(pChip->mfTxPending == FALSE) {
+        return;
+    }
+
+    if(pChip->mfTx[1] == BUSSIM_LICC_C_RLS) {
+        pChip->mfTxPending = FALSE;
+        pChip->intst      |= INT_CRLSTX;
+        if((pPeer != NULL) &&
+           (BUSSIM_CMD_TO_CLMSTATE(pPeer->command) != CLMSTATE_CLOSE)) {
+            memcpy(&pPeer->reg[REG_RXCRLSBODY1], pChip->mfTx, BUSSIM_MNGFRM_SIZE);
+            pPeer->intst |= INT_CRLSRCV;
+        }
+        return;
+    }
+
+    if((pPeer == NULL) ||
+       (BUSSIM_CMD_TO_CLMSTATE(pPeer->command) == CLMSTATE_CLOSE) ||
+       (pPeer->mfRxBusy == TRUE)) {
+        return;
+    }
+
+    txBits = 0;
+    switch(pChip->mfTx[1]) {
+    case BUSSIM_LICC_C_REQ :
+        if(pPeer->command & COMMAND_CREQ_RCVDIS) {
+            return;
+        }
+        rxBits = INT_CREQRCV;
+        break;
+    case BUSSIM_LICC_C_ACC :
+        rxBits          = INT_CACCRCV;
+        pPeer->caccRcvd = TRUE;
+        break;
+    case BUSSIM_LICC_C_SLEEP :
+        txBits = INT_CSLEEPTX;
+        rxBits = INT_CSLEEPRCV;
+        break;
+    case BUSSIM_LICC_C_WAKE :
+        txBits = INT_CWAKETX;
+        rxBits = INT_CWAKERCV;
+        break;
+    case BUSSIM_LICC_C_PROBE :
+        txBits = INT_CPROBETX;
+        rxBits = INT_CPROBERCV;
+        break;
+    default :
+        DBG_ERR("sim%u : unknown LiCC 0x%x is dropped.\n", pChip->index, pChip->mfTx[1]);
+        pChip->mfTxPending = FALSE;
+        return;
+    }
+
+    memcpy(&pPeer->reg[REG_RXMNGBODY1], pChip->mfTx, BUSSIM_MNGFRM_SIZE);
+    pPeer->mfRxBusy    = TRUE;
+    pPeer->intst      |= rxBits;
+    pChip->intst      |= txBits;
+    pChip->mfTxPending = FALSE;
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simCommand
+ *-----------------------------------------------------------------*/
+/**
+ * handle COMMAND register written.
+ * @param  pChip : pointer to the simulated chip.
+ * @param  value : written value.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simCommand(S_SIM_CHIP *pChip, u32 value)
+{
+
+    S_SIM_CHIP *pPeer = pChip->pPeer;
+    u8          prev;
+    u8          next;
+
+    prev = BUSSIM_CMD_TO_CLMSTATE(pChip->command);
+    next = BUSSIM_CMD_TO_CLMSTATE(value);
+    pChip->command = value;
+
+    if((prev == CLMSTATE_CLOSE) && (next != CLMSTATE_CLOSE)) {
+        pChip->intst |= INT_SLEEPTOAWAKE | INT_AWAKEPRIOD;
+    } else if((prev != CLMSTATE_CLOSE) && (next == CLMSTATE_CLOSE)) {
+        pChip->intst   |= INT_AWAKETOSLEEP;
+        pChip->caccRcvd = FALSE;
+    }
+
+    // ACK for C-Acc is sent by enabling ACK in RESPONSE_WAITING.
+    if((next == CLMSTATE_RESPONSE_WAITING) &&
+       (value & COMMAND_ACK_ENABLE) &&
+       (pChip->caccRcvd == TRUE)) {
+        pChip->caccRcvd = FALSE;
+        pChip->intst   |= INT_CACCACKTX;
+        if((pPeer != NULL) &&
+           (BUSSIM_CMD_TO_CLMSTATE(pPeer->command) == CLMSTATE_RESPONDER_RESPONSE)) {
+            pPeer->intst |= INT_CACCTX;
+        }
+    }
+
+    // the frames waiting this chip may go now.
+    if(pPeer != NULL) {
+        BUS_simDeliverMngFrame(pPeer);
+        BUS_simScheduleXfer(pPeer);
+    }
+    BUS_simScheduleXfer(pChip);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simBankClear
+ *-----------------------------------------------------------------*/
+/**
+ * handle BANKCLR register written.
+ * @param  pChip : pointer to the simulated chip.
+ * @param  value : written value.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simBankClear(S_SIM_CHIP *pChip, u32 value)
+{
+
+    if(value & BANKCLR_TXBANK) {
+        pChip->txHead   = 0;
+        pChip->txCnt    = 0;
+        pChip->txFilled = 0;
+    }
+
+    if(value & BANKCLR_RXBANK) {
+        pChip->rxHead    = 0;
+        pChip->rxCnt     = 0;
+        pChip->rxRead    = 0;
+        pChip->rxDonePos = 0;
+        if(pChip->pPeer != NULL) {
+            BUS_simScheduleXfer(pChip->pPeer);
+        }
+    }
+
+    if(value & BANKCLR_TXDATASTOP) {
+        pChip->txEnable = FALSE;
+        pChip->intst   |= INT_TXDATASTOPCONF;
+    } else {
+        pChip->txEnable = (value & BANKCLR_TXDISABLE) ? FALSE : TRUE;
+    }
+
+    if((pChip->txEnable == TRUE) && (pChip->txCnt == 0)) {
+        pChip->intst |= INT_TXBANKEMPT;
+    }
+
+    BUS_simScheduleXfer(pChip);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simReadDone
+ *-----------------------------------------------------------------*/
+/**
+ * handle READDONE register written, free RX banks read through.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simReadDone(S_SIM_CHIP *pChip)
+{
+
+    pChip->rxHead  = (pChip->rxHead + pChip->rxRead) % IZAN_RX_CSDU_NUM;
+    pChip->rxCnt  -= pChip->rxRead;
+    pChip->rxRead  = 0;
+
+    // head bank may be read partially, REWIND returns here.
+    pChip->rxDonePos = 0;
+    if(pChip->rxCnt > 0) {
+        pChip->rxDonePos = pChip->rxBank[pChip->rxHead].pos;
+        pChip->intst    |= INT_RXBANKNOTEMPT;
+    }
+
+    if(pChip->pPeer != NULL) {
+        BUS_simScheduleXfer(pChip->pPeer);
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simRewind
+ *-----------------------------------------------------------------*/
+/**
+ * handle REWIND register written, RXFIFO returns to READDONE.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simRewind(S_SIM_CHIP *pChip)
+{
+
+    u8 i;
+
+    for(i=0; (i<=pChip->rxRead) && (i<pChip->rxCnt); i++) {
+        pChip->rxBank[(pChip->rxHead + i) % IZAN_RX_CSDU_NUM].pos = 0;
+    }
+    if(pChip->rxCnt > 0) {
+        pChip->rxBank[pChip->rxHead].pos = pChip->rxDonePos;
+    }
+    pChip->rxRead = 0;
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simWriteRegister
+ *-----------------------------------------------------------------*/
+/**
+ * handle the register written to the register image.
+ * @param  pChip  : pointer to the simulated chip.
+ * @param  addr   : register address.
+ * @param  length : written length.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ *         the register not listed here only keeps the written value.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simWriteRegister(S_SIM_CHIP *pChip, u32 addr, u32 length)
+{
+
+    S_SIM_BANK *pBank;
+    u32         value;
+    u32         result;
+    u32         i;
+
+    value = (length >= 4) ? BUS_simGetReg32(pChip, addr) : pChip->reg[addr];
+
+    switch(addr) {
+    case REG_PMUMCHG :
+        pChip->reg[REG_PMUSTATE] = BUS_simPmuState((u8)value);
+        break;
+
+    case REG_DMTEXIT :
+        if(value & DMTEXIT_ON) {
+            pChip->reg[REG_PMUSTATE] = PMUSTATE_AWK;
+        }
+        break;
+
+    case REG_CRMSRCTL :
+        if(value & 0x01) {
+            result = BUSSIM_CRMSR_BASE + (pChip->reg[REG_ZA_0x01915] & 0x0F) * BUSSIM_CRMSR_STEP;
+            pChip->reg[REG_CRMSRRSLT0] = (u8)(result & 0xFF);
+            pChip->reg[REG_CRMSRRSLT1] = (u8)(result >> 8);
+            pChip->reg[REG_CRMSRSTAT]  = 0x01;
+        } else {
+            pChip->reg[REG_CRMSRSTAT]  = 0x00;
+        }
+        break;
+
+    case REG_CARD_INT_MASK_REG1 :
+        pChip->cardIntEn = (u8)(value & 0x01);
+        break;
+
+    case REG_INT :
+        pChip->intst &= ~value;
+        break;
+
+    case REG_INTMASK :
+        pChip->intmask = value;
+        break;
+
+    case REG_TXFIFO_CUR_ADR_REG0 :
+    case REG_TXFIFO_CUR_ADR_REG1 :
+        // TXFIFO address to the head of next bank.
+        if(pChip->txFilled < pChip->txCnt) {
+            pBank = &pChip->txBank[(pChip->txHead + pChip->txFilled) % IZAN_TX_CSDU_NUM];
+            if(pBank->pos != 0) {
+                pChip->txFilled++;
+                BUS_simScheduleXfer(pChip);
+            }
+        }
+        break;
+
+    case REG_RXFIFO_CUR_ADR_REG0 :
+    case REG_RXFIFO_CUR_ADR_REG1 :
+        // RXFIFO address to the head of next bank.
+        if(pChip->rxRead < pChip->rxCnt) {
+            pBank = &pChip->rxBank[(pChip->rxHead + pChip->rxRead) % IZAN_RX_CSDU_NUM];
+            if(pBank->pos != 0) {
+                pChip->rxRead++;
+            }
+        }
+        break;
+
+    case REG_TXDATAINFO :
+        for(i=0; i<(length / 4); i++) {
+            if(pChip->txCnt >= IZAN_TX_CSDU_NUM) {
+                DBG_ERR("sim%u : TXDATAINFO exceeds TX banks.\n", pChip->index);
+                break;
+            }
+            pBank = &pChip->txBank[(pChip->txHead + pChip->txCnt) % IZAN_TX_CSDU_NUM];
+            pBank->info = BUS_simGetReg32(pChip, REG_TXDATAINFO + (4 * i));
+            pBank->pos  = 0;
+            pChip->txCnt++;
+        }
+        break;
+
+    case REG_MFTXREQ :
+        if(value & MFTXREQ_START) {
+            memcpy(pChip->mfTx, &pChip->reg[REG_TXMNGBODY1], BUSSIM_MNGFRM_SIZE);
+            pChip->mfTxPending = TRUE;
+            BUS_simDeliverMngFrame(pChip);
+        }
+        break;
+
+    case REG_TXMFSTOP :
+        if(value & TXMFSTOP_ON) {
+            pChip->mfTxPending = FALSE;
+            pChip->intst      |= INT_TXMFSTOPCONF;
+        }
+        break;
+
+    case REG_MFDATAREADDONE :
+        if(value & MFDATAREADDONE_ON) {
+            pChip->mfRxBusy = FALSE;
+            if(pChip->pPeer != NULL) {
+                BUS_simDeliverMngFrame(pChip->pPeer);
+            }
+        }
+        break;
+
+    case REG_READDONE :
+        if(value & READDONE_ON) {
+            BUS_simReadDone(pChip);
+        }
+        break;
+
+    case REG_REWIND :
+        if(value & REWIND_ON) {
+            BUS_simRewind(pChip);
+        }
+        break;
+
+    case REG_BANKCLR :
+        BUS_simBankClear(pChip, value);
+        break;
+
+    case REG_COMMAND :
+        BUS_simCommand(pChip, value);
+        break;
+
+    default :
+        break;
+    }
+
+    BUS_simKick(pChip);
+    if(pChip->pPeer != NULL) {
+        BUS_simKick(pChip->pPeer);
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simWriteFifo
+ *-----------------------------------------------------------------*/
+/**
+ * write data to TXFIFO, TX banks are filled in order.
+ * @param  pChip  : pointer to the simulated chip.
+ * @param  pData  : pointer to the data buffer.
+ * @param  length : data length.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ *         a bank is filled when the padded length of TXDATAINFO is written.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simWriteFifo(S_SIM_CHIP *pChip, u8 *pData, u32 length)
+{
+
+    S_SIM_BANK *pBank;
+    u32         end;
+    u32         len;
+
+    while(length > 0) {
+        if(pChip->txFilled >= pChip->txCnt) {
+            DBG_ERR("sim%u : TXFIFO written without TXDATAINFO[%u].\n", pChip->index, length);
+            break;
+        }
+        pBank = &pChip->txBank[(pChip->txHead + pChip->txFilled) % IZAN_TX_CSDU_NUM];
+        end   = MIN(BUSSIM_PADDING_4B(BUSSIM_DATAINFO_LENGTH(pBank->info)), CNL_CSDU_SIZE);
+        len   = MIN(length, end - pBank->pos);
+
+        memcpy(&pBank->data[pBank->pos], pData, len);
+        pBank->pos += len;
+        pData      += len;
+        length     -= len;
+
+        if(pBank->pos >= end) {
+            pChip->txFilled++;
+        }
+    }
+
+    BUS_simScheduleXfer(pChip);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simReadFifo
+ *-----------------------------------------------------------------*/
+/**
+ * read data from RXFIFO, RX banks are read in order.
+ * @param  pChip  : pointer to the simulated chip.
+ * @param  pData  : pointer to the data buffer.
+ * @param  length : data length.
+ * @return nothing.
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simReadFifo(S_SIM_CHIP *pChip, u8 *pData, u32 length)
+{
+
+    S_SIM_BANK *pBank;
+    u32         end;
+    u32         len;
+
+    while(length > 0) {
+        if(pChip->rxRead >= pChip->rxCnt) {
+            DBG_ERR("sim%u : RXFIFO read over RX banks[%u].\n", pChip->index, length);
+            memset(pData, 0, length);
+            break;
+        }
+        pBank = &pChip->rxBank[(pChip->rxHead + pChip->rxRead) % IZAN_RX_CSDU_NUM];
+        end   = MIN(BUSSIM_PADDING_4B(BUSSIM_DATAINFO_LENGTH(pBank->info)), CNL_CSDU_SIZE);
+        len   = MIN(length, end - pBank->pos);
+
+        memcpy(pData, &pBank->data[pBank->pos], len);
+        pBank->pos += len;
+        pData      += len;
+        length     -= len;
+
+        if(pBank->pos >= end) {
+            pChip->rxRead++;
+        }
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simXfer
+ *-----------------------------------------------------------------*/
+/**
+ * transfer data through TXRXFIFO, or the register otherwise.
+ * @param  pChip  : pointer to the simulated chip.
+ * @param  write  : TRUE if write.
+ * @param  addr   : address of the access point of device.
+ * @param  pData  : pointer to the data buffer.
+ * @param  length : data length.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note   g_simLock must be held.
+ */
+/*-----------------------------------------------------------------*/
+static T_CMN_ERR
+BUS_simXfer(S_SIM_CHIP *pChip, u8 write, u32 addr, void *pData, u32 length)
+{
+
+    if(addr == REG_TXRXFIFO) {
+        if(write) {
+            BUS_simWriteFifo(pChip, (u8 *)pData, length);
+        } else {
+            BUS_simReadFifo(pChip, (u8 *)pData, length);
+        }
+        return SUCCESS;
+    }
+
+    if((length == 0) || (addr + length > BUSSIM_REG_SPACE)) {
+        DBG_ERR("sim%u : register 0x%x[%u] is out of range.\n", pChip->index, addr, length);
+        return ERR_BADPARM;
+    }
+
+    if(write) {
+        memcpy(&pChip->reg[addr], pData, length);
+        BUS_simWriteRegister(pChip, addr, length);
+    } else {
+        BUS_simSyncRegister(pChip);
+        memcpy(pData, &pChip->reg[addr], length);
+    }
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simXferWork
+ *-----------------------------------------------------------------*/
+/**
+ * send the filled TX banks to the RX banks of the peer.
+ * @param  pWork : pointer to the xferWork of the chip.
+ * @return nothing.
+ * @note   data frame is sent only while both chips are CONNECTED.
+ *         the rest waits until the peer reads done its RX banks.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simXferWork(struct work_struct *pWork)
+{
+
+    S_SIM_CHIP *pChip = container_of(pWork, S_SIM_CHIP, xferWork.work);
+    S_SIM_CHIP *pPeer;
+    S_SIM_BANK *pTx;
+    S_SIM_BANK *pRx;
+    u8          sent = 0;
+
+    mutex_lock(&g_simLock);
+
+    pPeer = pChip->pPeer;
+    if((pPeer == NULL) ||
+       (pChip->txEnable == FALSE) ||
+       !BUSSIM_IS_CONNECTED(BUSSIM_CMD_TO_CLMSTATE(pChip->command)) ||
+       !BUSSIM_IS_CONNECTED(BUSSIM_CMD_TO_CLMSTATE(pPeer->command))) {
+        goto EXIT;
+    }
+
+    while((pChip->txFilled > 0) && (pPeer->rxCnt < IZAN_RX_CSDU_NUM)) {
+        pTx = &pChip->txBank[pChip->txHead];
+        pRx = &pPeer->rxBank[(pPeer->rxHead + pPeer->rxCnt) % IZAN_RX_CSDU_NUM];
+
+        pRx->info = pTx->info | BUSSIM_DATAINFO_VALID;
+        pRx->pos  = 0;
+        memcpy(pRx->data, pTx->data, MIN(BUSSIM_DATAINFO_LENGTH(pTx->info), CNL_CSDU_SIZE));
+        pPeer->rxCnt++;
+
+        pChip->txHead = (pChip->txHead + 1) % IZAN_TX_CSDU_NUM;
+        pChip->txCnt--;
+        pChip->txFilled--;
+        sent++;
+    }
+
+    if(sent > 0) {
+        pChip->intst |= INT_TXDFRAME;
+        if(pChip->txCnt == 0) {
+            pChip->intst |= INT_TXBANKEMPT;
+        }
+        pPeer->intst |= INT_RXBANKNOTEMPT;
+
+        BUS_simKick(pChip);
+        BUS_simKick(pPeer);
+    }
+
+EXIT:
+    mutex_unlock(&g_simLock);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simIrqWork
+ *-----------------------------------------------------------------*/
+/**
+ * call IRQ handler while the interrupt is asserted.
+ * @param  pWork : pointer to the irqWork of the chip.
+ * @return nothing.
+ * @note   IRQ handler disables the card interrupt, it is requested
+ *         again when the card interrupt is enabled.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simIrqWork(struct work_struct *pWork)
+{
+
+    S_SIM_CHIP    *pChip = container_of(pWork, S_SIM_CHIP, irqWork);
+    T_IRQ_HANDLER  pIrqHandler = NULL;
+    void          *pArg = NULL;
+
+    mutex_lock(&g_simLock);
+    if((pChip->cardIntEn != 0) &&
+       ((pChip->intst & ~pChip->intmask) != 0)) {
+        pIrqHandler = pChip->pIrqHandler;
+        pArg        = pChip->pIrqArg;
+    }
+    mutex_unlock(&g_simLock);
+
+    if(pIrqHandler != NULL) {
+        pIrqHandler(pArg);
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simAllocChip
+ *-----------------------------------------------------------------*/
+/**
+ * allocate simulated chip in power-on state.
+ * @param  index : index of the chip.
+ * @return pointer to the allocated chip.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static S_SIM_CHIP *
+BUS_simAllocChip(u8 index)
+{
+
+    S_SIM_CHIP *pChip;
+
+    pChip = (S_SIM_CHIP *)vmalloc(sizeof(S_SIM_CHIP));
+    if(pChip == NULL) {
+        return NULL;
+    }
+    memset(pChip, 0, sizeof(S_SIM_CHIP));
+
+    pChip->index   = index;
+    pChip->intmask = 0xFFFFFFFF;
+    pChip->reg[REG_PMUSTATE] = PMUSTATE_DPSLP;
+
+    // eFuse UID, unique in the chips.
+    BUS_simSetReg32(pChip, REG_SYS_UID_D, BUSSIM_UID_VENDOR);
+    BUS_simSetReg32(pChip, REG_SYS_UID_C, 0);
+    BUS_simSetReg32(pChip, REG_SYS_UID_B, index + 1);
+
+    INIT_WORK(&pChip->irqWork, BUS_simIrqWork);
+    INIT_DELAYED_WORK(&pChip->xferWork, BUS_simXferWork);
+
+    return pChip;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simFreeChips
+ *-----------------------------------------------------------------*/
+/**
+ * release all simulated chips.
+ * @param  nothing.
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simFreeChips(void)
+{
+
+    u8 i;
+
+    // unlink first, work of a chip refers to the peer.
+    mutex_lock(&g_simLock);
+    for(i=0; i<BUSSIM_DEV_MAX_NUM; i++) {
+        if(g_pSimChip[i] != NULL) {
+            g_pSimChip[i]->pPeer       = NULL;
+            g_pSimChip[i]->pIrqHandler = NULL;
+        }
+    }
+    mutex_unlock(&g_simLock);
+
+    for(i=0; i<BUSSIM_DEV_MAX_NUM; i++) {
+        if(g_pSimChip[i] != NULL) {
+            cancel_work_sync(&g_pSimChip[i]->irqWork);
+            cancel_delayed_work_sync(&g_pSimChip[i]->xferWork);
+            vfree(g_pSimChip[i]);
+            g_pSimChip[i] = NULL;
+        }
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simProbe
+ *-----------------------------------------------------------------*/
+/**
+ * probe the simulated chip as inserted card.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simProbe(S_SIM_CHIP *pChip)
+{
+
+    int           retval;
+    S_BUSCMN_DEV *pCmnDev;
+
+    DBG_INFO("sim%u : bus probe called.\n", pChip->index);
+    DBG_ASSERT(g_pCmnDrv != NULL);
+
+    pCmnDev = BUSCMN_allocDev(BUSCMN_TYPE_SIM, 0);
+    if(pCmnDev == NULL) {
+        DBG_ERR("allocate bus common device failed.\n");
+        return;
+    }
+
+    pCmnDev->pDev = (void *)pChip;
+
+    retval = BUSCMN_registerDev(pCmnDev);
+    if(retval != SUCCESS) {
+        DBG_ERR("register bus common device failed[%d].\n", retval);
+        BUSCMN_releaseDev(pCmnDev);
+        return;
+    }
+
+    // call upper layer probe function.
+    retval = g_pCmnDrv->pProbe((void *)pCmnDev, &g_pCmnDrv->ids);
+    if(retval != 0) {
+        DBG_ERR("call upper layer probe function failed.\n");
+        BUSCMN_unregisterDev(pCmnDev);
+        BUSCMN_releaseDev(pCmnDev);
+        return;
+    }
+
+    pChip->pCmnDev = pCmnDev;
+
+    DBG_INFO("sim%u : probe device completed successfully.\n", pChip->index);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simRemove
+ *-----------------------------------------------------------------*/
+/**
+ * remove the simulated chip as removed card.
+ * @param  pChip : pointer to the simulated chip.
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void
+BUS_simRemove(S_SIM_CHIP *pChip)
+{
+
+    int           retval;
+    S_BUSCMN_DEV *pCmnDev = pChip->pCmnDev;
+
+    if(pCmnDev == NULL) {
+        return;
+    }
+
+    // call upper layer remove function.
+    retval = g_pCmnDrv->pRemove((void *)pCmnDev);
+    if(retval != 0) {
+        DBG_ERR("call upper layer remove function failed.\n");
+    }
+
+    mutex_lock(&g_simLock);
+    pChip->pIrqHandler = NULL;
+    mutex_unlock(&g_simLock);
+    cancel_work_sync(&pChip->irqWork);
+
+    BUSCMN_unregisterDev(pCmnDev);
+    BUSCMN_releaseDev(pCmnDev);
+    pChip->pCmnDev = NULL;
+
+    DBG_INFO("sim%u : disconnect device completed successfully.\n", pChip->index);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simRegisterDriver
+ *-----------------------------------------------------------------*/
+/**
+ * register driver to the simulated chips.
+ * @param  pDriver : the pointer to the common bus driver.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_INVSTAT (driver is already registerd)
+ * @return ERR_NOMEM   (allocate chip failed)
+ * @note   SimDevNum chips are created and probed at once.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simRegisterDriver(S_BUSCMN_DRIVER *pDriver)
+{
+
+    u8 num;
+    u8 i;
+
+    if(test_and_set_bit(0, &g_used) != 0) {
+        DBG_ERR("simulated bus driver is already registered.\n");
+        return ERR_INVSTAT;
+    }
+
+    g_pCmnDrv = pDriver;
+
+    num = (u8)(MIN(g_simDevNum, BUSSIM_DEV_MAX_NUM));
+    for(i=0; i<num; i++) {
+        g_pSimChip[i] = BUS_simAllocChip(i);
+        if(g_pSimChip[i] == NULL) {
+            DBG_ERR("allocate simulated chip[%u] failed.\n", i);
+            BUS_simFreeChips();
+            g_pCmnDrv = NULL;
+            clear_bit(0, &g_used);
+            return ERR_NOMEM;
+        }
+    }
+
+    // link back-to-back by pair.
+    for(i=0; (i+1)<num; i+=2) {
+        g_pSimChip[i]->pPeer   = g_pSimChip[i+1];
+        g_pSimChip[i+1]->pPeer = g_pSimChip[i];
+    }
+
+    for(i=0; i<num; i++) {
+        BUS_simProbe(g_pSimChip[i]);
+    }
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simUnregisterDriver
+ *-----------------------------------------------------------------*/
+/**
+ * unregister driver from the simulated chips.
+ * @param  pDriver : the pointer to the common bus driver.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_INVSTAT (driver is not already registerd)
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simUnregisterDriver(S_BUSCMN_DRIVER *pDriver)
+{
+
+    u8 i;
+
+    if(test_bit(0, &g_used) == 0) {
+        DBG_ERR("simulated bus driver is not registerd.\n");
+        return ERR_INVSTAT;
+    }
+
+    for(i=0; i<BUSSIM_DEV_MAX_NUM; i++) {
+        if(g_pSimChip[i] != NULL) {
+            BUS_simRemove(g_pSimChip[i]);
+        }
+    }
+
+    BUS_simFreeChips();
+
+    g_pCmnDrv = NULL;
+
+    clear_bit(0, &g_used);
+
+    return SUCCESS;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simSetIrqHandler
+ *-----------------------------------------------------------------*/
+/**
+ * set IRQ handler
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  pIrqHandle : pointer to the IRQ handler function.
+ * @param  pArg       : pointer to the IRQ handler argument..
+ * @return SUCCESS     (normally completion)
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simSetIrqHandler(S_BUSCMN_DEV  *pCmnDev,
+                     T_IRQ_HANDLER  pIrqHandler,
+                     void          *pArg)
+{
+
+    S_SIM_CHIP *pChip = (S_SIM_CHIP *)pCmnDev->pDev;
+
+    mutex_lock(&g_simLock);
+    pChip->pIrqHandler = pIrqHandler;
+    pChip->pIrqArg     = pArg;
+    BUS_simKick(pChip);
+    mutex_unlock(&g_simLock);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simIoctl
+ *-----------------------------------------------------------------*/
+/**
+ * I/O access to simulated chip(currently register read/write is enabled)
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  ioType     : I/O type.
+ * @param  pArg       : pointer to the S_BUSCMN_REG_CTRL.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simIoctl(S_BUSCMN_DEV    *pCmnDev,
+             T_BUSCMN_IOTYPE  ioType,
+             void            *pArg)
+{
+
+    T_CMN_ERR          retval;
+    S_SIM_CHIP        *pChip    = (S_SIM_CHIP *)pCmnDev->pDev;
+    S_BUSCMN_REG_CTRL *pRegCtrl = (S_BUSCMN_REG_CTRL *)pArg;
+    u8                 write;
+
+    switch(ioType) {
+    case BUSCMN_IOTYPE_READ_REG :
+        write = FALSE;
+        break;
+    case BUSCMN_IOTYPE_WRITE_REG :
+        write = TRUE;
+        break;
+    default :
+        DBG_ERR("simulated bus is not support ioType[%d].\n", ioType);
+        return ERR_BADPARM;
+    }
+
+    BUS_simDelay();
+
+    mutex_lock(&g_simLock);
+    retval = BUS_simXfer(pChip, write, pRegCtrl->addr, pRegCtrl->pData, pRegCtrl->length);
+    mutex_unlock(&g_simLock);
+
+    *((u8 *)pRegCtrl->pStatus) = 0;
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simRead
+ *-----------------------------------------------------------------*/
+/**
+ * read chunk of data from simulated chip
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  length     : data length.
+ * @param  pData      : pointer to the data buffer.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simRead(S_BUSCMN_DEV *pCmnDev,
+            u32           addr,
+            u32           length,
+            void         *pData,
+            void         *pStatus)
+{
+
+    T_CMN_ERR   retval;
+    S_SIM_CHIP *pChip = (S_SIM_CHIP *)pCmnDev->pDev;
+
+    BUS_simDelay();
+
+    mutex_lock(&g_simLock);
+    retval = BUS_simXfer(pChip, FALSE, addr, pData, length);
+    mutex_unlock(&g_simLock);
+
+    *((u8 *)pStatus) = 0;
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simWrite
+ *-----------------------------------------------------------------*/
+/**
+ * write chunk of data to simulated chip
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  length     : data length.
+ * @param  pData      : pointer to the data buffer.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simWrite(S_BUSCMN_DEV *pCmnDev,
+             u32           addr,
+             u32           length,
+             void         *pData,
+             void         *pStatus)
+{
+
+    T_CMN_ERR   retval;
+    S_SIM_CHIP *pChip = (S_SIM_CHIP *)pCmnDev->pDev;
+
+    BUS_simDelay();
+
+    mutex_lock(&g_simLock);
+    retval = BUS_simXfer(pChip, TRUE, addr, pData, length);
+    mutex_unlock(&g_simLock);
+
+    *((u8 *)pStatus) = 0;
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simReadSg
+ *-----------------------------------------------------------------*/
+/**
+ * read data from simulated chip into the scatter-gather list.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  pSg        : pointer to the scatterlist.
+ * @param  nents      : number of scatterlist entries.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note   the whole list is one bus command.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simReadSg(S_BUSCMN_DEV       *pCmnDev,
+              u32                 addr,
+              struct scatterlist *pSg,
+              u32                 nents,
+              void               *pStatus)
+{
+
+    T_CMN_ERR           retval = SUCCESS;
+    S_SIM_CHIP         *pChip  = (S_SIM_CHIP *)pCmnDev->pDev;
+    struct scatterlist *pEnt;
+    u32                 i;
+
+    BUS_simDelay();
+
+    mutex_lock(&g_simLock);
+    for_each_sg(pSg, pEnt, nents, i) {
+        retval = BUS_simXfer(pChip, FALSE, addr, sg_virt(pEnt), pEnt->length);
+        if(retval != SUCCESS) {
+            break;
+        }
+    }
+    mutex_unlock(&g_simLock);
+
+    *((u8 *)pStatus) = 0;
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simWriteSg
+ *-----------------------------------------------------------------*/
+/**
+ * write data in the scatter-gather list to simulated chip.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @param  addr       : address of the access point of device(REGADDR).
+ * @param  pSg        : pointer to the scatterlist.
+ * @param  nents      : number of scatterlist entries.
+ * @param  pStatus    : return pointer to the status
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (bad parameter error)
+ * @note   the whole list is one bus command.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simWriteSg(S_BUSCMN_DEV       *pCmnDev,
+               u32                 addr,
+               struct scatterlist *pSg,
+               u32                 nents,
+               void               *pStatus)
+{
+
+    T_CMN_ERR           retval = SUCCESS;
+    S_SIM_CHIP         *pChip  = (S_SIM_CHIP *)pCmnDev->pDev;
+    struct scatterlist *pEnt;
+    u32                 i;
+
+    BUS_simDelay();
+
+    mutex_lock(&g_simLock);
+    for_each_sg(pSg, pEnt, nents, i) {
+        retval = BUS_simXfer(pChip, TRUE, addr, sg_virt(pEnt), pEnt->length);
+        if(retval != SUCCESS) {
+            break;
+        }
+    }
+    mutex_unlock(&g_simLock);
+
+    *((u8 *)pStatus) = 0;
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simBeginBatch
+ *-----------------------------------------------------------------*/
+/**
+ * begin the batch of bus accesses.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @return SUCCESS     (normally completion)
+ * @note   no bus to claim, every access is serialized by g_simLock.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+BUS_simBeginBatch(S_BUSCMN_DEV *pCmnDev)
+{
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BUS_simEndBatch
+ *-----------------------------------------------------------------*/
+/**
+ * end the batch of bus accesses.
+ * @param  pCmnDev    : pointer to the bus common device.
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+void
+BUS_simEndBatch(S_BUSCMN_DEV *pCmnDev)
+{
+    return;
+}
@@ -44,6 +44,14 @@
  *-----------------------------------------------------------------*/
 #define CMN_REQ_EXT_SIZE 32
 
+/**
+ * @brief the request is queued by CNL request (state is set by CNL).
+ *        pComplete of the async request is called only if it is queued,
+ *        so the requester can tell it, even after the status is updated
+ *        by the completion.
+ */
+#define CNL_REQ_IS_ACCEPTED(pReq)  ((pReq)->state != 0)
+
 /**
  * @brief CNL cancel request discardRequestID values 
  */
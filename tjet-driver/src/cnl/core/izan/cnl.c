@@ -65,13 +65,10 @@ static T_CMN_ERR  CNL_unregisterCnlOps(S_CNL_DEV *);
 /*-------------------------------------------------------------------
  * Globals
  *-----------------------------------------------------------------*/
-static u8  g_cnlTaskId       = CNL_TASK_ID;
 static u8  g_cnlDevMtxId     = CNL_DEV_MTX_ID;
 static u8  g_cnlDevMemPoolId = CNL_DEV_MPL_ID;
 S_CNL_DEV *g_pCnlDevArray[CNL_DEV_MAX_NUM];         // management unnecessary 
-
-static u8     g_sigDevLockId = CNL_DEV_SIG_LOC_ID;
-static S_LIST g_sigDevList;
+static S_CNL_DEV *g_pCnlDevRsvArray[CNL_DEV_MAX_NUM]; // devnum reserved by alloc.
 
 static S_CNL_OPS g_cnlOps = {
     .pOpen           = CNL_open,
@@ -81,11 +78,20 @@ static S_CNL_OPS g_cnlOps = {
     .pGetState       = CNL_getState,
 };
 
-static S_CNL_DEV *g_pCurrentCnlDev = NULL;
-
 /*-------------------------------------------------------------------
  * Inline function definition
  *-----------------------------------------------------------------*/
+static inline u8
+CNL_queueSize(uint size)
+{
+    if(size == 0) {
+        return 1;
+    }
+    if(size > CNL_QUEUE_SIZE_MAX) {
+        return CNL_QUEUE_SIZE_MAX;
+    }
+    return (u8)size;
+}
 
 
 /*-------------------------------------------------------------------
@@ -144,18 +150,11 @@ CNL_getCmnResources()
 
     T_CMN_ERR retval;
     
-    // create CNL task object.
-    retval = CMN_createTask(g_cnlTaskId, 0, NULL, CNL_task, 0, 0, NULL);
-    if(retval != SUCCESS) {
-        DBG_ERR("create CNL task object failed\n");
-        goto EXIT;
-    }
-
     // create device management semaphore object.
     retval = CMN_INIT_MUTEX(g_cnlDevMtxId);
     if(retval != SUCCESS) {
         DBG_ERR("create CNL semaphore object failed\n");
-        goto EXIT_1;
+        goto EXIT;
     }
 
     // create device mem pool
@@ -165,24 +164,13 @@ CNL_getCmnResources()
                                     CNL_DEV_MPL_SIZE);
     if(retval != SUCCESS) {
         DBG_ERR("create CNL Fixed memory pool object failed\n");
-        goto EXIT_2;
-    }
-
-    // create signal device mutex.
-    retval = CMN_createCpuLock(g_sigDevLockId);
-    if(retval != SUCCESS) {
-        DBG_ERR("create signal device mutex object failed.\n");
-        goto EXIT_3;
+        goto EXIT_1;
     }
 
     return SUCCESS;
 
-EXIT_3:
-    CMN_deleteFixedMemPool(g_cnlDevMemPoolId);
-EXIT_2:
-    CMN_deleteSem(g_cnlDevMtxId);
 EXIT_1:
-    CMN_deleteTask(g_cnlTaskId);
+    CMN_deleteSem(g_cnlDevMtxId);
 EXIT:
     return retval;
 }
@@ -203,10 +191,8 @@ CNL_putCmnResources()
 {
 
     // ignore errors.
-    CMN_deleteCpuLock(g_sigDevLockId);
     CMN_deleteFixedMemPool(g_cnlDevMemPoolId);
     CMN_deleteSem(g_cnlDevMtxId);
-    CMN_deleteTask(g_cnlTaskId);
 
     return SUCCESS;
 }
@@ -232,7 +218,7 @@ CNL_initDeviceParam(S_CNL_DEV *pCnlDev)
 
     // device state.
     pCnlDev->devState = CNL_DEV_READY;
-    CMN_LIST_INIT(&pCnlDev->devList);
+    CMN_ATOMIC_SET(&pCnlDev->sigState, 0);
 
     pCnlDev->cnlState    = MAKE_CNLSTATE(CNL_STATE_CLOSE, CNL_SUBSTATE_NULL);
     pCnlDev->liccVersion = CNL_LICC_VERSION_1;
@@ -246,6 +232,9 @@ CNL_initDeviceParam(S_CNL_DEV *pCnlDev)
     pCnlDev->rx0ReqCnt  = 0;
     pCnlDev->rx1ReqCnt  = 0;
     pCnlDev->ctrlReqCnt = 0;
+    pCnlDev->txQueueSize  = CNL_TX_QUEUE_SIZE;
+    pCnlDev->rx0QueueSize = CNL_RX_QUEUE0_SIZE;
+    pCnlDev->rx1QueueSize = CNL_RX_QUEUE1_SIZE;
 
     CMN_LIST_INIT(&pCnlDev->cancelQueue);
 
@@ -265,6 +254,9 @@ CNL_initDeviceParam(S_CNL_DEV *pCnlDev)
     pCnlDev->txSendingCsdu = 0; //
     pCnlDev->rxReady       = FALSE;
     pCnlDev->rxReadyPid    = CNL_EMPTY_PID;
+    pCnlDev->rssi          = CNL_RSSI_VALUE_MIN;
+    pCnlDev->rxDeficit     = 0;
+    pCnlDev->txDeficit     = 0;
 
     pCnlDev->pwrState = CNL_PWR_STATE_AWAKE;
     pCnlDev->pPclCbks = NULL;
@@ -294,7 +286,8 @@ CNL_initDeviceParam(S_CNL_DEV *pCnlDev)
  * @return SUCCESS (normally completion)
  * @return ERR_INVID   (the ID is invalid)
  * @return ERR_NOOBJ   (the object don't exist)
- * @note   
+ * @note   lock free, called from IRQ path and request submission.
+ *         worker task is waken up only when it is idle.
  */
 /*-----------------------------------------------------------------*/
 T_CMN_ERR
@@ -302,20 +295,25 @@ CNL_signalDev(S_CNL_DEV *pCnlDev)
 {
 
     T_CMN_ERR retval;
+    int       state;
+    int       prev;
 
-    //
-    // add event to signaled device queue.
-    // if already queued, do nothing.
-    // 
-    CMN_lockCpu(g_sigDevLockId);
-    if(!CMN_IS_IN_LIST(&g_sigDevList, pCnlDev, S_CNL_DEV, devList)) {
-        CMN_LIST_ADD_TAIL(&g_sigDevList, pCnlDev, S_CNL_DEV, devList);
-    }else{
-        DBG_INFO("this device is already signaled.\n");
-    }
-    CMN_unlockCpu(g_sigDevLockId);
-
-    retval = CMN_wakeupTask(g_cnlTaskId);
+    state = CMN_ATOMIC_READ(&pCnlDev->sigState);
+    do {
+        if(state & CNL_SIG_SIGNALED) {
+            DBG_INFO("this device is already signaled.\n");
+            return SUCCESS;
+        }
+        prev  = state;
+        state = CMN_ATOMIC_CMPXCHG(&pCnlDev->sigState, prev, prev | CNL_SIG_SIGNALED);
+    } while(state != prev);
+
+    if(prev & CNL_SIG_BUSY) {
+        // worker checks the signal before it sleeps.
+        return SUCCESS;
+    }
+
+    retval = CMN_wakeupTask(pCnlDev->taskId);
     if(retval != SUCCESS) {
         DBG_ERR("wakeupTask failed.\n");
         return retval;
@@ -326,59 +324,69 @@ CNL_signalDev(S_CNL_DEV *pCnlDev)
 
 
 /*-------------------------------------------------------------------
- * Function : CNL_getSignaledDev
+ * Function : CNL_consumeSignal
  *-----------------------------------------------------------------*/
 /**
- * get signaled CNL device.
- * @param  pCnlDev : return pointer to the CNL device.
- * @return SUCCESS     (normally completion)
- * @return ERR_RLWAIT  (force release during wait)
- * @return ERR_SYSTEM  (internal error)
+ * take the signal of CNL device and mark worker busy.
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return TRUE  (signal taken, worker is busy)
+ * @return FALSE (not signaled, worker is idle)
  * @note   
  */
 /*-----------------------------------------------------------------*/
-T_CMN_ERR
-CNL_getSignaledDev(S_CNL_DEV **pCnlDev)
+static u8
+CNL_consumeSignal(S_CNL_DEV *pCnlDev)
 {
 
-    int           retval;
-    S_CNL_DEV    *pTmpCnlDev;
+    int state;
+    int prev;
+    int next;
 
-    // clear current CnlDev
-    CMN_lockCpu(g_sigDevLockId);
-    g_pCurrentCnlDev = NULL;
-    CMN_unlockCpu(g_sigDevLockId);
+    state = CMN_ATOMIC_READ(&pCnlDev->sigState);
+    do {
+        prev  = state;
+        next  = (prev & CNL_SIG_SIGNALED) ? CNL_SIG_BUSY : 0;
+        state = CMN_ATOMIC_CMPXCHG(&pCnlDev->sigState, prev, next);
+    } while(state != prev);
 
-    //
-    // get CNL device operation required.
-    //
-RETRY:
-    retval = CMN_sleepTask(0);
-    if(retval != 0) {
-        DBG_ERR("terminateTask is called[%d]\n", retval);
-        return retval; // exit task.
-    }
+    return (next == CNL_SIG_BUSY) ? TRUE : FALSE;
 
-    DBG_INFO("normally wakeup\n");
+}
 
-    CMN_lockCpu(g_sigDevLockId);
-    pTmpCnlDev = CMN_LIST_REMOVE_HEAD(&g_sigDevList,
-                                      S_CNL_DEV,
-                                      devList);
 
-    if (pTmpCnlDev != NULL) {
-        // Set current CnlDev
-        g_pCurrentCnlDev = pTmpCnlDev;
-    }
+/*-------------------------------------------------------------------
+ * Function : CNL_waitSignal
+ *-----------------------------------------------------------------*/
+/**
+ * wait until CNL device is signaled. called by the worker task.
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return SUCCESS     (normally completion)
+ * @return ERR_RLWAIT  (force release during wait)
+ * @return ERR_SYSTEM  (internal error)
+ * @note   signaled while busy is handled without sleeping.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_waitSignal(S_CNL_DEV *pCnlDev)
+{
 
-    CMN_unlockCpu(g_sigDevLockId);
+    int retval;
 
-    if(pTmpCnlDev == NULL) {
-        DBG_INFO("signaled same time.\n");
-        goto RETRY;
+    // signaled while handling, continue without sleep.
+    if(CNL_consumeSignal(pCnlDev)) {
+        return SUCCESS;
     }
 
-    *pCnlDev = pTmpCnlDev;
+    do {
+        retval = CMN_sleepTask(0);
+        if(retval != 0) {
+            DBG_ERR("terminateTask is called[%d]\n", retval);
+            return retval; // exit task.
+        }
+
+        DBG_INFO("normally wakeup\n");
+
+    } while(!CNL_consumeSignal(pCnlDev));
 
     return SUCCESS;
 
@@ -401,6 +409,8 @@ CNL_allocDevice()
 
     T_CMN_ERR  retval;
     S_CNL_DEV *pCnlDev = NULL;
+    u8         devnum;
+    int        cpu;
 
     //
     // allocate CNL device structure.
@@ -413,60 +423,110 @@ CNL_allocDevice()
 
     CMN_MEMSET(pCnlDev, 0x00, sizeof(S_CNL_DEV));
 
+    //
+    // reserve device number.
+    // device dependent resource IDs are decided by it.
+    //
+    CMN_LOCK_MUTEX(g_cnlDevMtxId);
+    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
+        if(g_pCnlDevRsvArray[devnum] == NULL) {
+            g_pCnlDevRsvArray[devnum] = pCnlDev;
+            break;
+        }
+    }
+    CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+    if(devnum >= CNL_DEV_MAX_NUM) {
+        DBG_ERR("can't handle more device.\n");
+        goto EXIT_1;
+    }
+    pCnlDev->devnum = devnum;
+
     //
     // get device dependent resources.
     //
-    pCnlDev->mngLockId = CNL_DEV_MNG_LOC_ID;
+    pCnlDev->mngLockId = CNL_DEV_MNG_LOC_ID + devnum;
     retval = CMN_createCpuLock(pCnlDev->mngLockId);
     if(retval != SUCCESS) {
         DBG_ERR("create device management lock object failed[%d].\n", retval);
-        goto EXIT_1;
+        goto EXIT_2;
     }
 
-    pCnlDev->reqMtxId = CNL_REQ_MTX_ID;
+    pCnlDev->reqMtxId = CNL_REQ_MTX_ID + devnum;
     retval = CMN_INIT_MUTEX(pCnlDev->reqMtxId);
     if(retval != SUCCESS) {
         DBG_ERR("create block request mutex object failed[%d].\n", retval);
-        goto EXIT_2;
+        goto EXIT_3;
     }
 
-    pCnlDev->reqWaitId = CNL_REQ_WAIT_ID;
+    pCnlDev->reqWaitId = CNL_REQ_WAIT_ID + devnum;
     retval = CMN_INIT_WAIT(pCnlDev->reqWaitId);
     if(retval != SUCCESS) {
         DBG_ERR("create block request wait object failed[%d].\n", retval);
-        goto EXIT_3;
+        goto EXIT_4;
     }
 
-    pCnlDev->cancelWaitId = CNL_CANCEL_WAIT_ID;
+    pCnlDev->cancelWaitId = CNL_CANCEL_WAIT_ID + devnum;
     retval = CMN_INIT_WAIT(pCnlDev->cancelWaitId);
     if(retval != SUCCESS) {
         DBG_ERR("create block request wait object failed[%d].\n", retval);
-        goto EXIT_4;
+        goto EXIT_5;
     }
 
     // create device mem pool
-    pCnlDev->dummyReqMplId = CNL_DUMMY_REQ_MPL_ID;
+    pCnlDev->dummyReqMplId = CNL_DUMMY_REQ_MPL_ID + devnum;
     retval = CMN_createFixedMemPool(pCnlDev->dummyReqMplId,
                                     0,
                                     CNL_DUMMY_REQ_MPL_CNT,
                                     CNL_DUMMY_REQ_MPL_SIZE);
     if(retval != SUCCESS) {
         DBG_ERR("create DummyReq Fixed memory pool object failed\n");
-        goto EXIT_5;
+        goto EXIT_6;
     }
 
+    pCnlDev->cmdToutTimId    = CNL_CMD_TOUT_TIM_ID + devnum;
+    pCnlDev->cancelToutTimId = CNL_CANCEL_TOUT_TIM_ID + devnum;
+
     CNL_initDeviceParam(pCnlDev);
 
+    // create worker task of this device.
+    pCnlDev->taskId = CNL_TASK_ID + devnum;
+    retval = CMN_createTask(pCnlDev->taskId, 0, (void *)pCnlDev, CNL_task, 0, 0, NULL);
+    if(retval != SUCCESS) {
+        DBG_ERR("create CNL task object failed[%d].\n", retval);
+        goto EXIT_7;
+    }
+
+    retval = CMN_startTask(pCnlDev->taskId, NULL);
+    if(retval != SUCCESS) {
+        DBG_ERR("start CNL task failed[%d].\n", retval);
+        goto EXIT_8;
+    }
+
+    if(g_cnlWorkerCpu >= 0) {
+        cpu = g_cnlWorkerCpu + devnum;
+        retval = CMN_setTaskAffinity(pCnlDev->taskId, cpu);
+        if(retval != SUCCESS) {
+            // run on any CPU.
+            DBG_ERR("bind CNL task to CPU%d failed[%d].\n", cpu, retval);
+        }
+    }
+
     return pCnlDev;
 
-EXIT_5:
+EXIT_8:
+    CMN_deleteTask(pCnlDev->taskId);
+EXIT_7:
+    CMN_deleteFixedMemPool(pCnlDev->dummyReqMplId);
+EXIT_6:
     CMN_deleteSem(pCnlDev->cancelWaitId);
-EXIT_4:
+EXIT_5:
     CMN_deleteSem(pCnlDev->reqWaitId);
+EXIT_4:
+    CMN_deleteSem(pCnlDev->reqMtxId);
 EXIT_3:
-    CMN_deleteCpuLock(pCnlDev->reqMtxId);
-EXIT_2:
     CMN_deleteCpuLock(pCnlDev->mngLockId);
+EXIT_2:
+    g_pCnlDevRsvArray[devnum] = NULL;
 EXIT_1:
     CMN_releaseFixedMemPool(g_cnlDevMemPoolId, pCnlDev);
 EXIT:
@@ -496,6 +556,10 @@ CNL_releaseDevice(S_CNL_DEV *pCnlDev)
     //
     DBG_ASSERT(pCnlDev != NULL);
 
+    // stop the worker task first, it refers the resources below.
+    CMN_terminateTask(pCnlDev->taskId);
+    CMN_deleteTask(pCnlDev->taskId);
+
     CMN_deleteFixedMemPool(pCnlDev->dummyReqMplId);
     CMN_deleteSem(pCnlDev->cancelWaitId);
     CMN_deleteSem(pCnlDev->reqWaitId);
@@ -504,6 +568,9 @@ CNL_releaseDevice(S_CNL_DEV *pCnlDev)
 
     pCnlDev->pDeviceOps->pReleaseDeviceData(pCnlDev);
 
+    // single store, caller may hold g_cnlDevMtxId.
+    g_pCnlDevRsvArray[pCnlDev->devnum] = NULL;
+
     CMN_releaseFixedMemPool(g_cnlDevMemPoolId, pCnlDev);
 
     return;
@@ -527,23 +594,17 @@ CNL_registerDevice(S_CNL_DEV *pCnlDev)
 {
 
     T_CMN_ERR retval;
-    u8        devnum;
 
     CMN_LOCK_MUTEX(g_cnlDevMtxId);
 
-    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
-        if(g_pCnlDevArray[devnum] == NULL) {
-            // empty found.
-            g_pCnlDevArray[devnum] = pCnlDev;
-            pCnlDev->devnum = devnum;
-            goto FOUND;
-        }
+    // device number is reserved by CNL_allocDevice.
+    if(g_pCnlDevArray[pCnlDev->devnum] != NULL) {
+        CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+        DBG_ERR("can't handle more device.\n");
+        return ERR_NOOBJ;
     }
-    CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
-    DBG_ERR("can't handle more device.\n");
-    return ERR_NOOBJ;
+    g_pCnlDevArray[pCnlDev->devnum] = pCnlDev;
 
-FOUND:
     retval = CNL_registerCnlOps(pCnlDev);
     if(retval != SUCCESS) {
         DBG_ERR("register CNL operation to upper layer failed[%d].\n",
@@ -573,6 +634,8 @@ CNL_unregisterDevice(S_CNL_DEV *pCnlDev)
 
     T_CMN_ERR          retval;
     S_CNL_DEVICE_EVENT event;
+    u8                 released = FALSE;
+    u8                 devnum   = pCnlDev->devnum;
 
     int RetryCount = 0;
 
@@ -587,6 +650,7 @@ CNL_unregisterDevice(S_CNL_DEV *pCnlDev)
         if(retval == SUCCESS) {
             g_pCnlDevArray[pCnlDev->devnum] = NULL;
             CNL_releaseDevice(pCnlDev);
+            released = TRUE;
         } else {
             DBG_ERR("unregister CNL operation from upper layer failed[%d].\n",
                     retval);
@@ -605,23 +669,32 @@ CNL_unregisterDevice(S_CNL_DEV *pCnlDev)
 
     CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
 
+    if(released) {
+        // worker task is already stopped.
+        return SUCCESS;
+    }
+
     // wait for CNL task idle state.
     do {
-        S_CNL_DEV   *pTempCnlDev = NULL;
+        int state;
 
-        CMN_lockCpu(g_sigDevLockId);
-        pTempCnlDev = (S_CNL_DEV*)CMN_LIST_LOOKUP(&g_sigDevList);
-        if (g_pCurrentCnlDev == NULL && pTempCnlDev == NULL) {
-            DBG_INFO("No events. Cnl task is idle state.\n");
-            CMN_unlockCpu(g_sigDevLockId);
+        // device may be released by CNL_close meanwhile.
+        CMN_LOCK_MUTEX(g_cnlDevMtxId);
+        if(g_pCnlDevArray[devnum] != pCnlDev) {
+            CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+            DBG_INFO("device is released.\n");
             break;
         }
-        else {
-            // do nothing.
-            DBG_INFO("Cnl task is running. pCurrentCnlDev=%p, pTempCnlDev=%p\n", 
-                g_pCurrentCnlDev, pTempCnlDev);
+        state = CMN_ATOMIC_READ(&pCnlDev->sigState);
+        CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+
+        if(state == 0) {
+            DBG_INFO("No events. Cnl task is idle state.\n");
+            break;
         }
-        CMN_unlockCpu(g_sigDevLockId);
+
+        // do nothing.
+        DBG_INFO("Cnl task is running. state=0x%x\n", state);
 
         // retry MaxRetryCount times.
         if(++RetryCount > WAIT_CNLTASKSTOP_MAX_NUM) {
@@ -665,6 +738,116 @@ CNL_devToCnlDev(void *pDev)
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : CNL_getIrqStat
+ *-----------------------------------------------------------------*/
+/**
+ * copy the IRQ latency statistics of CNL device.
+ * @param  devnum : device number.
+ * @param  pStat  : the pointer to the statistics stored.
+ * @return SUCCESS   (normally completion)
+ * @return ERR_NOOBJ (the device don't exist)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_getIrqStat(u8 devnum, S_CNL_IRQ_STAT *pStat)
+{
+
+    T_CMN_ERR retval = ERR_NOOBJ;
+
+    if(devnum >= CNL_DEV_MAX_NUM) {
+        return ERR_NOOBJ;
+    }
+
+    CMN_LOCK_MUTEX(g_cnlDevMtxId);
+    if(g_pCnlDevArray[devnum] != NULL) {
+        CMN_MEMCPY(pStat, &(g_pCnlDevArray[devnum]->irqStat), sizeof(S_CNL_IRQ_STAT));
+        retval = SUCCESS;
+    }
+    CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_getSchdStat
+ *-----------------------------------------------------------------*/
+/**
+ * copy the scheduler statistics of CNL device.
+ * @param  devnum : device number.
+ * @param  pStat  : the pointer to the statistics stored.
+ * @return SUCCESS   (normally completion)
+ * @return ERR_NOOBJ (the device don't exist)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_getSchdStat(u8 devnum, S_CNL_SCHD_STAT *pStat)
+{
+
+    T_CMN_ERR retval = ERR_NOOBJ;
+
+    if(devnum >= CNL_DEV_MAX_NUM) {
+        return ERR_NOOBJ;
+    }
+
+    CMN_LOCK_MUTEX(g_cnlDevMtxId);
+    if(g_pCnlDevArray[devnum] != NULL) {
+        CMN_MEMCPY(pStat, &(g_pCnlDevArray[devnum]->schdStat), sizeof(S_CNL_SCHD_STAT));
+        retval = SUCCESS;
+    }
+    CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+
+    return retval;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_getDevStat
+ *-----------------------------------------------------------------*/
+/**
+ * copy the device statistics of CNL device.
+ * @param  devnum : device number.
+ * @param  pStat  : the pointer to the statistics stored.
+ * @return SUCCESS   (normally completion)
+ * @return ERR_NOOBJ (the device don't exist)
+ * @note   counters are copied without the device lock. time in the
+ *         current PMU state is added up to now.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_getDevStat(u8 devnum, S_CNL_DEV_STAT *pStat)
+{
+
+    T_CMN_ERR retval = ERR_NOOBJ;
+    u32       now;
+
+    if(devnum >= CNL_DEV_MAX_NUM) {
+        return ERR_NOOBJ;
+    }
+
+    CMN_LOCK_MUTEX(g_cnlDevMtxId);
+    if(g_pCnlDevArray[devnum] != NULL) {
+        CMN_MEMCPY(pStat, &(g_pCnlDevArray[devnum]->devStat), sizeof(S_CNL_DEV_STAT));
+        retval = SUCCESS;
+    }
+    CMN_UNLOCK_MUTEX(g_cnlDevMtxId);
+
+    if((retval == SUCCESS) &&
+       (pStat->pmuState != 0) && (pStat->pmuState < CNL_PMU_STATE_NUM)) {
+        CMN_getTime(&now);
+        pStat->pmuTime[pStat->pmuState] += now - pStat->pmuStamp;
+    }
+
+    return retval;
+
+}
+
+
 /*-------------------------------------------------------------------
  * Function : CNL_open
  *-----------------------------------------------------------------*/
@@ -718,6 +901,10 @@ CNL_open(void **pDev, S_PCL_CBKS *pPclCbks)
         // store PCL callback function pointers.
         pCnlDev->devState = CNL_DEV_ACTIVE;
         pCnlDev->pPclCbks = pPclCbks;
+        // queues are empty while closed, take current depth parameters.
+        pCnlDev->txQueueSize  = CNL_queueSize(g_cnlTxQueueSize);
+        pCnlDev->rx0QueueSize = CNL_queueSize(g_cnlRx0QueueSize);
+        pCnlDev->rx1QueueSize = CNL_queueSize(g_cnlRx1QueueSize);
         retval = SUCCESS;
     }
 
@@ -804,9 +991,9 @@ CNL_init(void)
     u8        devnum;
     
     for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
-        g_pCnlDevArray[devnum] = NULL;
+        g_pCnlDevArray[devnum]    = NULL;
+        g_pCnlDevRsvArray[devnum] = NULL;
     }
-    CMN_LIST_INIT(&g_sigDevList);
 
     // get common resources.
     retval = CNL_getCmnResources();
@@ -814,24 +1001,17 @@ CNL_init(void)
         goto EXIT;
     }
 
-    // 1. start CNL task.
-    retval = CMN_startTask(g_cnlTaskId, NULL);
-    if(retval != SUCCESS) {
-        goto EXIT_1;
-    }
-
-    // 2. register driver(s)
+    // register driver(s)
+    // CNL tasks are started per device by CNL_allocDevice.
     retval = CNL_registerDriver();
     if(retval != SUCCESS) {
-        goto EXIT_2;
+        goto EXIT_1;
     }
 
     DBG_INFO("CNL core driver module is inserted to the kernel.\n");
 
     return SUCCESS;
 
-EXIT_2:
-    CMN_terminateTask(g_cnlTaskId);
 EXIT_1:
     CNL_putCmnResources();
 EXIT:
@@ -857,7 +1037,6 @@ CNL_exit(void)
 
     // be careful to unregister
     CNL_unregisterDriver();
-    CMN_terminateTask(g_cnlTaskId);
     CNL_putCmnResources();
 
     DBG_INFO("CNL core driver module is removed from the kernel.\n");
@@ -40,6 +40,7 @@
 #include "cnl_type.h"
 #include "cnl_err.h"
 #include "cnl_if.h"
+#include "cnl_trace.h"
 
 /*-------------------------------------------------------------------
  * Macro definition
@@ -62,18 +63,51 @@
 /**
  * Configurations. these are moved to config file or Makefile etc..
  */
-#define CNL_DEV_MAX_NUM         1 // shall not set over 31.
+#define CNL_DEV_MAX_NUM         4 // shall not set over CNL_DEV_RSC_NUM(cmn_rsc.h).
 #define CNL_CTRL_QUEUE_SIZE     1 // control request queue depth.
-#define CNL_TX_QUEUE_SIZE       5 // TX request queue depth.
-#define CNL_RX_QUEUE0_SIZE      2 // RX request queue depth.
-#define CNL_RX_QUEUE1_SIZE      5 // RX request queue depth.
+#define CNL_TX_QUEUE_SIZE       5 // TX request queue depth. (default)
+#define CNL_RX_QUEUE0_SIZE      2 // RX request queue depth. (default)
+#define CNL_RX_QUEUE1_SIZE      5 // RX request queue depth. (default)
+#define CNL_QUEUE_SIZE_MAX     64 // max of request queue depth parameters.
 #define CNL_MAX_DEVICE_PRIV   128 // max size of device private data.
-#define CNL_ACTION_LIST_NUM    1
+#define CNL_ACTION_LIST_NUM    2 // actions per scheduling pass(RX and TX data).
+#define CNL_IRQ_LAT_HIST_NUM  16 // buckets of IRQ latency histogram(log2 usec).
+#define CNL_RX_POLL_ENTER      2 // busy RX passes to enter polling. (default, 0:disable)
+#define CNL_RX_POLL_BUDGET     8 // idle polls before going back to interrupt. (default)
+#define CNL_RX_POLL_INTERVAL  50 // usec between idle polls. (default)
+#define CNL_ARB_POLICY         0 // TX/RX arbitration, CNL_ARB_xxx. (default)
+#define CNL_ARB_RX_QUANTUM 32768 // RX bytes per round of deficit arbitration. (default)
+#define CNL_ARB_TX_QUANTUM 32768 // TX bytes per round of deficit arbitration. (default)
+#define CNL_PRIO_PROFILE_1     1 // profile 1 send request is high priority. (default)
+#define CNL_TX_FRAME_MAX       8 // TX frames coalesced in one submission.
 
 // config end.
 
 #define CNL_LICC_VERSION_1     1
 
+// TX/RX arbitration policy.
+#define CNL_ARB_RX_FIRST    0    // RX then TX, no limit.
+#define CNL_ARB_DEFICIT     1    // deficit round robin by bytes.
+
+// data request priority.
+#define CNL_PRIO_NORMAL     0
+#define CNL_PRIO_HIGH       1
+
+// scheduler statistics queue index.
+#define CNL_SCHD_Q_TX       0
+#define CNL_SCHD_Q_RX0      1
+#define CNL_SCHD_Q_RX1      2
+#define CNL_SCHD_Q_CTRL     3
+#define CNL_SCHD_Q_NUM      4
+
+// device statistics.
+#define CNL_INT_BIT_NUM     32   // bits of the device interrupt status.
+#define CNL_PMU_STATE_NUM   8    // device PMU states, indexed by the state value.
+
+// worker task signal state bits.
+#define CNL_SIG_SIGNALED    0x01 // new work is signaled.
+#define CNL_SIG_BUSY        0x02 // worker is handling the device.
+
 /**
  * Internal type definitions
  */
@@ -121,6 +155,8 @@ typedef enum tagE_CNL_ACTION {
 }E_CNL_ACTION;
 typedef u8 T_CNL_ACTION;
 #define IS_HANDLER_ACTION(x) (x & 0x80)
+#define IS_DATA_COMP_ACTION(p) (((p)->type == CNL_ACTION_HANDLE_COMPLETE) && \
+                                ((p)->compReq == CNL_COMP_DATA_REQ))
 
 
 /**
@@ -272,6 +308,8 @@ typedef struct tagS_CNL_DATA_REQ_EXT {
     u32 sendingLen; // current sending length.
     u32 compLen;    // sent/received data length.
     u32 startTime;  // use test mode only
+    u32 queuedTime; // time queued(usec).
+    u8  priority;   // CNL_PRIO_xxx, send request only.
 }S_DATA_REQ_EXT;
 
 /*
@@ -318,6 +356,7 @@ typedef struct tagS_CNL_ACTION {
 
     // for SENDDATA/RECEIVEDATA
     u32            readyLength;
+    u32            budget;    // bytes allowed in this pass, 0 is no limit.
 }S_CNL_ACTION;
 
 
@@ -356,6 +395,83 @@ typedef struct tagS_CNL_DEVICE_EVENT {
 }S_CNL_DEVICE_EVENT;
 
 
+/**
+ * @brief IRQ latency statistics.
+ *        bucket n counts [2^n, 2^(n+1)) usec, the last one is open ended.
+ */
+typedef struct tagS_CNL_IRQ_STAT {
+    u32            topCnt;                          // top half count.
+    u32            bottomCnt;                       // bottom half count.
+    u32            coalesced;                       // IRQs merged into a pending bottom half.
+    u32            rxPolled;                        // RX banks found by polling.
+    u32            topHist[CNL_IRQ_LAT_HIST_NUM];   // top half duration.
+    u32            wakeHist[CNL_IRQ_LAT_HIST_NUM];  // top half to bottom half start.
+    u32            bottomHist[CNL_IRQ_LAT_HIST_NUM];// bottom half duration.
+}S_CNL_IRQ_STAT;
+
+
+/**
+ * @brief scheduler statistics.
+ *        wait is queued to completion, bucketed as S_CNL_IRQ_STAT.
+ */
+typedef struct tagS_CNL_SCHD_STAT {
+    u32            passCnt;                         // getAction passes.
+    u32            initCloseCnt;                    // Init/Close Action.
+    u32            eventCnt;                        // Action by device event.
+    u32            ctrlCnt;                         // Action by control request.
+    u32            rxCnt;                           // Action by RX.
+    u32            txCnt;                           // Action by TX.
+    u32            sleepCnt;                        // Action to sleep.
+    u32            batchCnt;                        // RX and TX in one pass.
+    u32            rxCapped;                        // RX stopped by deficit.
+    u32            txCapped;                        // TX stopped by deficit.
+    u32            prioCnt;                         // high priority send queued ahead.
+    u32            waitCnt[CNL_SCHD_Q_NUM];
+    u32            waitMax[CNL_SCHD_Q_NUM];         // usec.
+    u32            waitHist[CNL_SCHD_Q_NUM][CNL_IRQ_LAT_HIST_NUM];
+}S_CNL_SCHD_STAT;
+
+
+/**
+ * @brief device statistics, cumulative from the device allocation.
+ *        counters are written by one context(CNL task or IRQ task) or under
+ *        the lock already taken there, CRC retries by any context are atomic.
+ *        readers copy them without lock.
+ */
+typedef struct tagS_CNL_DEV_STAT {
+    u64            txBytes;                         // data bytes sent.
+    u64            rxBytes;                         // data bytes received.
+    u32            txCsdu;                          // CSDUs sent.
+    u32            rxCsdu;                          // CSDUs received.
+    u32            reqCompleted;                    // requests completed successfully.
+    u32            reqCancelled;                    // requests cancelled.
+    u32            reqFailed;                       // requests completed with error.
+    u32            reqQovr;                         // requests refused by queue overflow.
+    u32            cancelLookup;                    // cancel target lookups.
+    u32            cancelMiss;                      // cancel target not found.
+    u64            cancelProbe;                     // requests compared by cancel lookups.
+    u32            cancelProbeMax;                  // max requests compared by a lookup.
+    T_CMN_ATOMIC   crcRetryRead;                    // register read retried by CRC error.
+    T_CMN_ATOMIC   crcRetryWrite;                   // register write retried by CRC error.
+    u32            rewindRetry;                     // RX data read retried by REWIND.
+    u32            tResendTout;                     // T_Resend timeouts.
+    u32            intCnt[CNL_INT_BIT_NUM];         // interrupts by status bit.
+    u8             pmuState;                        // current PMU state.
+    u32            pmuStamp;                        // msec, current PMU state entered.
+    u32            pmuTime[CNL_PMU_STATE_NUM];      // msec, time in each PMU state left.
+}S_CNL_DEV_STAT;
+
+
+/**
+ * @brief TX frame, a part of send request written to TX bank(s).
+ */
+typedef struct tagS_CNL_TX_FRAME {
+    u8             profileId;
+    u8             fragment;
+    u32            length;
+    void          *pData;
+}S_CNL_TX_FRAME;
+
 
 /**
  * @brief CNL Device operations.
@@ -371,6 +487,7 @@ typedef struct tagS_CNL_DEVICE_OPS {
     T_CNL_ERR (*pSleep)(S_CNL_DEV *);
     T_CNL_ERR (*pSendMngFrame)(S_CNL_DEV *, u16, void *, void *);
     T_CNL_ERR (*pSendData)(S_CNL_DEV *, u8, u8, u32, void *);
+    T_CNL_ERR (*pSendDataMulti)(S_CNL_DEV *, S_CNL_TX_FRAME *, u8, u8 *); // optional.
     T_CNL_ERR (*pSendDataIntUnmask)(S_CNL_DEV *);
     T_CNL_ERR (*pReadReadyTxBuffer)(S_CNL_DEV *, u32 *);
     T_CNL_ERR (*pReceiveData)(S_CNL_DEV *, u8, u8 *, u32 *, void *);
@@ -405,7 +522,8 @@ struct tagS_CNL_DEV {
     //
     u8                  devnum;        // device number.
     T_DEV_STATE         devState;      // device state.
-    S_LIST              devList;       // use for signaling.
+    u8                  taskId;        // worker task of this device.
+    T_CMN_ATOMIC        sigState;      // CNL_SIG_xxx of the worker.
 
 
     //
@@ -420,17 +538,24 @@ struct tagS_CNL_DEV {
     // reqeust information.
     u8                  reqMtxId;      // sync request mutex.
     u8                  reqWaitId;     // wait for block request.
+    u8                  cmdToutTimId;  // sync request timeout timer.
+    S_CNL_CMN_REQ      *pToutReq;      // sync request watched by the timer.
     S_LIST              ctrlQueue;     // CTRL request queue head.
     u8                  ctrlReqCnt;    // current CTRL request count.
     S_LIST              txQueue;       // TX request queue head.
     u8                  txReqCnt;      // current TX request count.
+    u8                  txQueueSize;   // TX request queue depth.
     S_LIST              rx0Queue;      // RX request queue head for pid 0.
     u8                  rx0ReqCnt;     // current RX request for pid 0 count.
+    u8                  rx0QueueSize;  // RX request queue depth for pid 0.
     S_LIST              rx1Queue;      // RX request queue head for pid 1
     u8                  rx1ReqCnt;     // current RX request for pid 1 count.
+    u8                  rx1QueueSize;  // RX request queue depth for pid 1.
 
     u8                  dummyReqMplId; // dummy request memory pool Id for cancel.
     u8                  cancelWaitId;  // cancel request wait Id
+    u8                  cancelToutTimId; // cancel request timeout timer.
+    S_CNL_CMN_REQ      *pCancelDummy;  // cancel request watched by the timer.
     S_LIST              cancelQueue;   // cancel request queue.
     T_CMN_ERR           cancelStatus;  // cancel status
     
@@ -450,6 +575,9 @@ struct tagS_CNL_DEV {
     u8                  txSendingCsdu; // current using TX CSDU count.
     u8                  rxReady;       // indicate RX is ready.
     u8                  rxReadyPid;    // remaind RX.
+    u8                  rssi;          // latest RSSI while connected.
+    s32                 rxDeficit;     // RX bytes allowed by arbitration.
+    s32                 txDeficit;     // TX bytes allowed by arbitration.
 
 
 
@@ -468,6 +596,9 @@ struct tagS_CNL_DEV {
     void               *pDev;          // pointer to the device.
     S_CNL_DEVICE_OPS   *pDeviceOps;    // device interface functions for CNL core.
     S_CNL_DEVICE_PARAM  deviceParam;   // device dependent CNL parameters.
+    S_CNL_IRQ_STAT      irqStat;       // IRQ latency statistics.
+    S_CNL_SCHD_STAT     schdStat;      // scheduler statistics.
+    S_CNL_DEV_STAT      devStat;       // device statistics.
     u8                  devicePriv[0]; // device private data field.
                                        // maximum size is defined as CNL_MAX_DEVICE_PRIV
 };
@@ -476,12 +607,78 @@ struct tagS_CNL_DEV {
 /*-------------------------------------------------------------------
  * Inline functions definition
  *-----------------------------------------------------------------*/
+static inline void
+CNL_addIrqLatency(u32 *pHist, u32 usec) {
+    u8 bucket = 0;
+    while((usec > 1) && (bucket < (CNL_IRQ_LAT_HIST_NUM - 1))) {
+        usec >>= 1;
+        bucket++;
+    }
+    pHist[bucket]++;
+    return;
+}
+
+static inline void
+CNL_addWaitTime(S_CNL_DEV *pCnlDev, S_CNL_CMN_REQ *pReq) {
+    S_DATA_REQ_EXT *pExt = (S_DATA_REQ_EXT *)(&pReq->extData);
+    u32 now;
+    u32 wait;
+    u8  q;
+
+    if(pReq->type == CNL_REQ_TYPE_SEND_REQ) {
+        q = CNL_SCHD_Q_TX;
+    } else if(pReq->type == CNL_REQ_TYPE_RECEIVE_REQ) {
+        q = (pReq->dataReq.profileId == CNL_PROFILE_ID_0) ? CNL_SCHD_Q_RX0 : CNL_SCHD_Q_RX1;
+    } else {
+        q = CNL_SCHD_Q_CTRL;
+    }
+
+    CMN_getTimeUs(&now);
+    wait = now - pExt->queuedTime;
+    pCnlDev->schdStat.waitCnt[q]++;
+    if(wait > pCnlDev->schdStat.waitMax[q]) {
+        pCnlDev->schdStat.waitMax[q] = wait;
+    }
+    CNL_addIrqLatency(pCnlDev->schdStat.waitHist[q], wait);
+    return;
+}
+
+static inline void
+CNL_addCompStat(S_CNL_DEV *pCnlDev, S_CNL_CMN_REQ *pReq) {
+    if(pReq->status == CNL_SUCCESS) {
+        pCnlDev->devStat.reqCompleted++;
+    } else if(pReq->status == CNL_ERR_CANCELLED) {
+        pCnlDev->devStat.reqCancelled++;
+    } else {
+        pCnlDev->devStat.reqFailed++;
+    }
+    return;
+}
+
+static inline void
+CNL_setPmuStat(S_CNL_DEV *pCnlDev, u8 state) {
+    S_CNL_DEV_STAT *pStat = &pCnlDev->devStat;
+    u32             now;
+
+    CMN_getTime(&now);
+    // state 0 is before the first change.
+    if((pStat->pmuState != 0) && (pStat->pmuState < CNL_PMU_STATE_NUM)) {
+        pStat->pmuTime[pStat->pmuState] += now - pStat->pmuStamp;
+    }
+    pStat->pmuStamp = now;
+    pStat->pmuState = state;
+    return;
+}
+
 static inline void
 CNL_completeRequest(S_CNL_DEV *pCnlDev, S_CNL_CMN_REQ *pReq) {
     if(pReq->state == CNL_REQ_CANCELLING) {
         // this is dummy request, do not call completion but free it.
         CMN_releaseFixedMemPool(pCnlDev->dummyReqMplId, pReq);
     } else {
+        CNL_addWaitTime(pCnlDev, pReq);
+        CNL_addCompStat(pCnlDev, pReq);
+        trace_cnl_complete(pCnlDev->devnum, pReq->id, pReq->type, pReq->status);
         pReq->pComplete(pReq, pReq->pArg1, pReq->pArg2);
     }
     return;
@@ -519,7 +716,24 @@ extern T_CMN_ERR  CNL_registerDevice(S_CNL_DEV *);
 extern T_CMN_ERR  CNL_unregisterDevice(S_CNL_DEV *);
 extern S_CNL_DEV *CNL_devToCnlDev(void *);
 extern T_CMN_ERR  CNL_signalDev(S_CNL_DEV *);
-extern T_CMN_ERR  CNL_getSignaledDev(S_CNL_DEV **);
+extern T_CMN_ERR  CNL_waitSignal(S_CNL_DEV *);
+extern T_CMN_ERR  CNL_getIrqStat(u8, S_CNL_IRQ_STAT *);
+extern T_CMN_ERR  CNL_getSchdStat(u8, S_CNL_SCHD_STAT *);
+extern T_CMN_ERR  CNL_getDevStat(u8, S_CNL_DEV_STAT *);
+
+// cnl_km.c
+extern uint       g_cnlTxQueueSize;
+extern uint       g_cnlRx0QueueSize;
+extern uint       g_cnlRx1QueueSize;
+extern uint       g_cnlRxPollEnter;
+extern uint       g_cnlRxPollBudget;
+extern uint       g_cnlRxPollInterval;
+extern int        g_cnlWorkerCpu;
+extern uint       g_cnlArbPolicy;
+extern uint       g_cnlArbRxQuantum;
+extern uint       g_cnlArbTxQuantum;
+extern uint       g_cnlPrioProfile1;
+extern uint       g_cnlBusSim;
 
 // cnl_task.c
 extern void       CNL_task(void *);
@@ -47,10 +47,6 @@
 /*-------------------------------------------------------------------
  * Structure definition
  *-----------------------------------------------------------------*/
-typedef struct tagS_CNL_TOUT_ARG {
-    S_CNL_DEV      *pCnlDev;
-    S_CNL_CMN_REQ  *pReq;
-}S_CNL_TOUT_ARG;
 
 
 /*-------------------------------------------------------------------
@@ -66,7 +62,6 @@ static void      CNL_cmdToutCallback(unsigned long);
 /*-------------------------------------------------------------------
  * Globals
  *-----------------------------------------------------------------*/
-static S_CNL_TOUT_ARG g_cnlToutArg = {NULL, NULL};
 
 /*-------------------------------------------------------------------
  * Inline function definition
@@ -320,6 +315,9 @@ CNL_request(void          *pDev,
     S_CNL_DEV *pCnlDev = (S_CNL_DEV *)pDev;
     u8         block = FALSE;
 
+    // not queued yet, see CNL_REQ_IS_ACCEPTED.
+    pReq->state = 0;
+
     //
     // 1.device state check.
     //
@@ -360,22 +358,24 @@ CNL_request(void          *pDev,
         pReq->pArg2     = NULL;
         /************************************/
         block           = TRUE;
+    } else {
+        // async request may be completed before CNL_addRequest returns.
+        pReq->status    = CNL_SUCCESS;
     }
     
     // setting alarm timer for cnl request.
     if ((block) &&  
         (pReq->type != CNL_REQ_TYPE_SEND_REQ) &&  
         (pReq->type != CNL_REQ_TYPE_RECEIVE_REQ)) {
-        g_cnlToutArg.pCnlDev = pCnlDev;
-        g_cnlToutArg.pReq = pReq;
-        retval = CMN_createAlarmTim(CNL_CMD_TOUT_TIM_ID, 0, NULL, CNL_cmdToutCallback);
+        pCnlDev->pToutReq = pReq;
+        retval = CMN_createAlarmTim(pCnlDev->cmdToutTimId, 0, (void *)pCnlDev, CNL_cmdToutCallback);
         if (retval != SUCCESS) {
             DBG_ERR("CMN_createAlarmTim failed. retval:%d\n", retval);
         } else {
-            retval = CMN_startAlarmTim(CNL_CMD_TOUT_TIM_ID, CNL_CMD_TOUT_VAL_MS);
+            retval = CMN_startAlarmTim(pCnlDev->cmdToutTimId, CNL_CMD_TOUT_VAL_MS);
             if (retval != SUCCESS) {
                 DBG_ERR("CMN_startAlarmTim failed. retval:%d\n", retval);
-                retval = CMN_deleteAlarmTim(CNL_CMD_TOUT_TIM_ID);
+                retval = CMN_deleteAlarmTim(pCnlDev->cmdToutTimId);
                 if (retval != SUCCESS) {
                     DBG_ERR("CMN_deleteAlarmTim failed. retval:%d\n", retval);
                 }
@@ -388,21 +388,28 @@ CNL_request(void          *pDev,
     // 3.add request to the request depended queue and set device signaled.
     //
     retval = CNL_addRequest(pCnlDev, pReq);
+    if((pReq->type == CNL_REQ_TYPE_SEND_REQ) || (pReq->type == CNL_REQ_TYPE_RECEIVE_REQ)) {
+        trace_cnl_request(pCnlDev->devnum, pReq->id, pReq->type,
+                          pReq->dataReq.profileId, pReq->dataReq.length,
+                          (retval == SUCCESS) ? CNL_SUCCESS : CNL_ERR_QOVR);
+    } else {
+        trace_cnl_request(pCnlDev->devnum, pReq->id, pReq->type, 0, 0,
+                          (retval == SUCCESS) ? CNL_SUCCESS : CNL_ERR_QOVR);
+    }
     if(retval != SUCCESS) {
         if(block){
             if((pReq->type != CNL_REQ_TYPE_SEND_REQ) &&
                (pReq->type != CNL_REQ_TYPE_RECEIVE_REQ)) {
                 // stop alarm timer for cnl request.
-                retval = CMN_stopAlarmTim(CNL_CMD_TOUT_TIM_ID);
+                retval = CMN_stopAlarmTim(pCnlDev->cmdToutTimId);
                 if (retval != SUCCESS) {
                     DBG_ERR("CMN_stopAlarmTim failed. retval:%d\n", retval);
                 }
-                retval = CMN_deleteAlarmTim(CNL_CMD_TOUT_TIM_ID);
+                retval = CMN_deleteAlarmTim(pCnlDev->cmdToutTimId);
                 if (retval != SUCCESS) {
                     DBG_ERR("CMN_deleteAlarmTim failed. retval:%d\n", retval);
                 }
-                g_cnlToutArg.pCnlDev = NULL;
-                g_cnlToutArg.pReq = NULL;
+                pCnlDev->pToutReq = NULL;
             }
             CMN_UNLOCK_MUTEX(pCnlDev->reqMtxId);
         }
@@ -415,21 +422,18 @@ CNL_request(void          *pDev,
         if((pReq->type != CNL_REQ_TYPE_SEND_REQ) &&
            (pReq->type != CNL_REQ_TYPE_RECEIVE_REQ)) {
             // stop alarm timer for cnl request.
-            retval = CMN_stopAlarmTim(CNL_CMD_TOUT_TIM_ID);
+            retval = CMN_stopAlarmTim(pCnlDev->cmdToutTimId);
             if (retval != SUCCESS) {
                 DBG_ERR("CMN_stopAlarmTim failed. retval:%d\n", retval);
             }
-            retval = CMN_deleteAlarmTim(CNL_CMD_TOUT_TIM_ID);
+            retval = CMN_deleteAlarmTim(pCnlDev->cmdToutTimId);
             if (retval != SUCCESS) {
                 DBG_ERR("CMN_deleteAlarmTim failed. retval:%d\n", retval);
             }
-            g_cnlToutArg.pCnlDev = NULL;
-            g_cnlToutArg.pReq = NULL;
+            pCnlDev->pToutReq = NULL;
         }
         retval = SUCCESS;
         CMN_UNLOCK_MUTEX(pCnlDev->reqMtxId);
-    } else {
-        pReq->status = CNL_SUCCESS;
     }
 
     return retval;
@@ -592,29 +596,34 @@ CNL_releaseDiscardBuffer(S_CNL_CMN_REQ *pReq,
  *-----------------------------------------------------------------*/
 /**
  * CNL command timeout callback function
- * @param   arg     :not used.
+ * @param   arg     :the pointer to the S_CNL_DEV.
  * @return  nothing.
- * @note    use g_cnlToutArg 
+ * @note    use pCnlDev->pToutReq 
  */
 /*-----------------------------------------------------------------*/
 static void CNL_cmdToutCallback(unsigned long arg)
 {
+    S_CNL_DEV     *pCnlDev = (S_CNL_DEV *)arg;
+    S_CNL_CMN_REQ *pReq;
+
     DBG_INFO("CNL_cmdToutCallback Called.\n");
 
-    if ((g_cnlToutArg.pReq == NULL) || (g_cnlToutArg.pCnlDev == NULL)) {
+    if (pCnlDev == NULL) {
         return;
     } 
 
-    CMN_lockCpu(g_cnlToutArg.pCnlDev->mngLockId);
-    if (CMN_IS_IN_LIST(&(g_cnlToutArg.pCnlDev->ctrlQueue), g_cnlToutArg.pReq, S_CNL_CMN_REQ, list)) {
-        CNL_removeRequestFromCtrlQueue(g_cnlToutArg.pCnlDev, g_cnlToutArg.pReq);
-        CMN_unlockCpu(g_cnlToutArg.pCnlDev->mngLockId);
+    CMN_lockCpu(pCnlDev->mngLockId);
+    pReq = pCnlDev->pToutReq;
+    if ((pReq != NULL) &&
+        CMN_IS_IN_LIST(&(pCnlDev->ctrlQueue), pReq, S_CNL_CMN_REQ, list)) {
+        CNL_removeRequestFromCtrlQueue(pCnlDev, pReq);
+        CMN_unlockCpu(pCnlDev->mngLockId);
 
-        g_cnlToutArg.pReq->status = CNL_ERR_TIMEOUT;
+        pReq->status = CNL_ERR_TIMEOUT;
         // release WAIT
-        g_cnlToutArg.pReq->pComplete(g_cnlToutArg.pReq, g_cnlToutArg.pReq->pArg1, g_cnlToutArg.pReq->pArg2);
+        pReq->pComplete(pReq, pReq->pArg1, pReq->pArg2);
     } else { 
-        CMN_unlockCpu(g_cnlToutArg.pCnlDev->mngLockId);
+        CMN_unlockCpu(pCnlDev->mngLockId);
     }
 
     return;
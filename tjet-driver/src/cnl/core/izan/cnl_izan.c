@@ -74,11 +74,14 @@ static T_CNL_ERR IZAN_wake(S_CNL_DEV *);
 static T_CNL_ERR IZAN_sleep(S_CNL_DEV *);
 static T_CNL_ERR IZAN_sendMngFrame(S_CNL_DEV *, u16, void *, void *);
 static T_CNL_ERR IZAN_sendData(S_CNL_DEV *, u8, u8, u32, void *);
+static T_CNL_ERR IZAN_sendDataMulti(S_CNL_DEV *, S_CNL_TX_FRAME *, u8, u8 *);
 static T_CNL_ERR IZAN_sendDataIntUnmask(S_CNL_DEV *);
 static T_CNL_ERR IZAN_readReadyTxBuffer(S_CNL_DEV *, u32 *);
+static T_CNL_ERR IZAN_readTxBankSta(S_CNL_DEV *, u32 *);
 static T_CNL_ERR IZAN_receiveData(S_CNL_DEV *, u8, u8 *, u32 *, void *);
 static T_CNL_ERR IZAN_receiveDataIntUnmask(S_CNL_DEV *);
 static T_CNL_ERR IZAN_readReadyRxBuffer(S_CNL_DEV *, u32 *, u8);
+static T_CNL_ERR IZAN_pollRxBank(S_CNL_DEV *, u32 *);
 
 // HW access function for scheduler and state machine 
 static T_CNL_ERR IZAN_readReadyPid(S_CNL_DEV *, u8 *);
@@ -137,6 +140,8 @@ static T_CNL_ERR IZAN_execCalibration(S_CNL_DEV *);
 
 // functions to be registered to SD host.
 static void      IZAN_irqHandler(void *);
+static void      IZAN_irqBottomHalf(S_CNL_DEV *);
+static void      IZAN_irqTask(void *);
 static int       IZAN_probe(void *, S_BUSCMN_IDS *);
 static int       IZAN_remove(void *);
 
@@ -182,6 +187,7 @@ static S_CNL_DEVICE_OPS g_cnlDeviceOps = {
     .pSleep             = IZAN_sleep,
     .pSendMngFrame      = IZAN_sendMngFrame,
     .pSendData          = IZAN_sendData,
+    .pSendDataMulti     = IZAN_sendDataMulti,
     .pSendDataIntUnmask = IZAN_sendDataIntUnmask,
     .pReadReadyTxBuffer = IZAN_readReadyTxBuffer,
     .pReceiveData       = IZAN_receiveData,
@@ -281,11 +287,10 @@ static u32 g_monaddr[] =
     0xFFFFFFFF                              // end.
 };
 
-static int g_TxRxBankStaRead_N = CNL_FREQUPDN_MAX;
-static int g_freqUpdN          = CNL_DEFAULT_FREQUPDN_VALUE;
-u8         g_rssi              = CNL_RSSI_VALUE_MIN;
+static int g_freqUpdN = CNL_DEFAULT_FREQUPDN_VALUE;
 
-static S_CNL_DEV *stored_dev = NULL;
+static S_CNL_DEV *g_pIzanDevArray[CNL_DEV_MAX_NUM]; // for suspend notify.
+static u8         g_izanDevCnt = 0;
 
 /*-------------------------------------------------------------------
  * Inline function definition
@@ -305,6 +310,9 @@ IZAN_initDeviceData(S_IZAN_DEVICE_DATA *pDeviceData)
     pDeviceData->rxFragment    = CNL_FRAGMENTED_DATA;
     pDeviceData->rxNeedReset   = FALSE;
     pDeviceData->rxBankHeadPos = 0;
+    pDeviceData->rssiReadCnt   = CNL_FREQUPDN_MAX;
+    pDeviceData->txCredit      = 0;
+    CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
     pDeviceData->txNeedResend  = FALSE;
     pDeviceData->discardCreq   = FALSE;
 
@@ -364,6 +372,27 @@ IZAN_cnlDevToDeviceData(S_CNL_DEV *pCnlDev)
 }
 
 
+static inline void
+IZAN_addIntStat(S_CNL_DEV *pCnlDev, u32 bits)
+{
+    u8 i;
+
+    for(i=0; (i<CNL_INT_BIT_NUM) && (bits != 0); i++, bits >>= 1) {
+        if(bits & 0x1) {
+            pCnlDev->devStat.intCnt[i]++;
+        }
+    }
+}
+
+
+static inline void
+IZAN_setPmuState(S_CNL_DEV *pCnlDev, T_IZAN_PMU_STATE state)
+{
+    IZAN_cnlDevToDeviceData(pCnlDev)->pmuState = state;
+    CNL_setPmuStat(pCnlDev, state);
+}
+
+
 static inline void
 IZAN_setupMngFrame(S_IZAN_MNGFRM *pMngFrm, 
                    u8             liccVersion,
@@ -496,6 +525,7 @@ IZAN_readRegister(void *pDev,
 
     T_CMN_ERR         retval;
     S_BUSCMN_REG_CTRL ctrl;
+    S_CNL_DEV        *pCnlDev;
     u8                status = 0;
     u8                cnt;
 
@@ -520,6 +550,10 @@ IZAN_readRegister(void *pDev,
         }
         else if(status == BUSSDIO_STATUS_CRC_ERR) {
             DBG_WARN("read register CRC error occured, retry cmd.\n");
+            pCnlDev = CNL_devToCnlDev(pDev);
+            if(pCnlDev != NULL) {
+                CMN_ATOMIC_INC(&pCnlDev->devStat.crcRetryRead);
+            }
             cnt++;
             continue;
         } else {
@@ -555,6 +589,7 @@ IZAN_writeRegister(void *pDev,
 
     T_CMN_ERR         retval;
     S_BUSCMN_REG_CTRL ctrl;
+    S_CNL_DEV        *pCnlDev;
     u8                status = 0;
     u8                cnt;
 
@@ -578,6 +613,10 @@ IZAN_writeRegister(void *pDev,
         }
         else if(status == BUSSDIO_STATUS_CRC_ERR) {
             DBG_WARN("write register CRC error occured, retry\n");
+            pCnlDev = CNL_devToCnlDev(pDev);
+            if(pCnlDev != NULL) {
+                CMN_ATOMIC_INC(&pCnlDev->devStat.crcRetryWrite);
+            }
             cnt++;
             continue;
         } else {
@@ -782,7 +821,7 @@ IZAN_writeDMA(void *pDev,
  * @param  pCnlDev : the pointer to the S_CNL_DEV
  * @return CNL_SUCCESS      (normally completion)
  * @return CNL_ERR_BADPARM  (bad paramter)
- * @note   use g_rssi g_TxRxBankStRead_N 
+ * @note   use pCnlDev->rssi pDeviceData->rssiReadCnt 
  */
 /*-----------------------------------------------------------------*/
 static T_CNL_ERR 
@@ -791,26 +830,28 @@ IZAN_readRxvgagain(S_CNL_DEV *pCnlDev)
     u32       rxvgagain;
     u8        mainState;
     T_CNL_ERR retval;
+    S_IZAN_DEVICE_DATA *pDeviceData;
 
     if (pCnlDev == NULL) {
         DBG_ERR("Bad Parameter pCnlDev:%p.\n", pCnlDev);
         return CNL_ERR_BADPARM; 
     }
 
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
 
     mainState = CNLSTATE_TO_MAINSTATE(pCnlDev->cnlState);
     if (( mainState == CNL_STATE_INITIATOR_CONNECTED) ||
         ( mainState == CNL_STATE_RESPONDER_CONNECTED)) {
-        g_TxRxBankStaRead_N++;
-        if ( g_TxRxBankStaRead_N >= g_freqUpdN) { 
-            DBG_INFO("g_TxRxBankStaRead_N:%d, g_rssi:%u\n", g_TxRxBankStaRead_N, g_rssi);
-            g_TxRxBankStaRead_N = 0; 
+        pDeviceData->rssiReadCnt++;
+        if ( pDeviceData->rssiReadCnt >= g_freqUpdN) { 
+            DBG_INFO("rssiReadCnt:%d, rssi:%u\n", pDeviceData->rssiReadCnt, pCnlDev->rssi);
+            pDeviceData->rssiReadCnt = 0; 
             retval = IZAN_readRegister(pCnlDev->pDev, REG_RXVGAGAIN, 4, &rxvgagain); 
             if(retval != CNL_SUCCESS) {
                 DBG_ERR("read RXVGAGAIN failed[%d].\n", retval);
                 return retval;
             }
-            g_rssi = IZAN_RXVGAGAIN_TO_RSSI(CMN_LE2H32(rxvgagain));
+            pCnlDev->rssi = IZAN_RXVGAGAIN_TO_RSSI(CMN_LE2H32(rxvgagain));
         }
     }
 
@@ -878,7 +919,7 @@ IZAN_resetRxvgagain(S_CNL_DEV *pCnlDev)
     }
 
     /* Reset counter */
-    g_TxRxBankStaRead_N = CNL_FREQUPDN_MAX;
+    IZAN_cnlDevToDeviceData(pCnlDev)->rssiReadCnt = CNL_FREQUPDN_MAX;
 
     return CNL_SUCCESS;
 
@@ -931,10 +972,12 @@ IZAN_closeReset(S_CNL_DEV *pCnlDev)
         return retval;
     }
 
-    pDeviceData->pmuState     = PMU_DEEP_SLEEP;
+    IZAN_setPmuState(pCnlDev, PMU_DEEP_SLEEP);
     pDeviceData->rxRemain     = 0;
     pDeviceData->rxFragment   = CNL_FRAGMENTED_DATA;
     pDeviceData->rxNeedReset  = FALSE;
+    pDeviceData->txCredit     = 0;
+    CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
     pDeviceData->txNeedResend = FALSE;
     pDeviceData->discardCreq  = FALSE;
     
@@ -1021,6 +1064,8 @@ IZAN_releaseReset(S_CNL_DEV *pCnlDev)
     pDeviceData->rxRemain     = 0;
     pDeviceData->rxFragment   = CNL_FRAGMENTED_DATA;
     pDeviceData->rxNeedReset  = FALSE;
+    pDeviceData->txCredit     = 0;
+    CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
     pDeviceData->txNeedResend = FALSE;
     pDeviceData->discardCreq  = FALSE;
     return CNL_SUCCESS;
@@ -2155,7 +2200,7 @@ IZAN_sleepToAwake(S_CNL_DEV *pCnlDev)
         goto EXIT;
     }
 
-    pDeviceData->pmuState = PMU_AWAKE;
+    IZAN_setPmuState(pCnlDev, PMU_AWAKE);
 
 EXIT:
     CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
@@ -2218,7 +2263,7 @@ IZAN_awakeToSleep(S_CNL_DEV *pCnlDev)
         goto EXIT;
     }
 
-    pDeviceData->pmuState = PMU_SLEEP;
+    IZAN_setPmuState(pCnlDev, PMU_SLEEP);
 
 EXIT:
     CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
@@ -2287,7 +2332,7 @@ IZAN_sleepToDeepsleep(S_CNL_DEV *pCnlDev)
         goto EXIT;
     }
 
-    pDeviceData->pmuState = PMU_DEEP_SLEEP;
+    IZAN_setPmuState(pCnlDev, PMU_DEEP_SLEEP);
 
 EXIT:
     CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
@@ -2895,6 +2940,8 @@ IZAN_postProcCS(S_CNL_DEV   *pCnlDev,
             return retval;
         }
 
+        CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
+
         CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
         event.type |= CNL_EVENT_TX_READY;
         CNL_addEvent(pCnlDev, &event); 
@@ -3187,10 +3234,11 @@ COMPLETE :
  * Function : IZAN_irqHandler
  *-----------------------------------------------------------------*/
 /**
- * default IRQ handler.
+ * default IRQ handler(top half).
  * @param  pArg  : the pointer to the S_CNL_DEV
  * @return nothing.
- * @note
+ * @note   only silences the CNL block, the interrupt status is
+ *         handled by IZAN_irqBottomHalf() in the IRQ task.
  */
 /*-----------------------------------------------------------------*/
 static void
@@ -3199,6 +3247,71 @@ IZAN_irqHandler(void *pArg)
 
     T_CNL_ERR           retval;
     S_CNL_DEV          *pCnlDev;
+    S_IZAN_DEVICE_DATA *pDeviceData;
+    u32                 start;
+    u32                 end;
+    u8                  wakeup;
+
+    pCnlDev     = (S_CNL_DEV *)pArg;
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
+
+    CMN_getTimeUs(&start);
+
+    //
+    // top half sequence.
+    //
+    // 1. disable CNL interrupt, it is enabled again by the bottom half.
+    // 2. request the bottom half if not yet pending.
+    //
+
+    // 1.
+    retval = IZAN_disableCnlInt(pCnlDev);
+    if(retval != CNL_SUCCESS) {
+        DBG_ERR("IRQ Handler : disable CNL interrupt failed[%d].\n", retval);
+        // fall through, the bottom half reads the status anyway.
+    }
+
+    // 2.
+    CMN_lockCpu(pDeviceData->irqLockId);
+    if(pDeviceData->irqPending == FALSE) {
+        pDeviceData->irqPending = TRUE;
+        pDeviceData->irqStamp   = start;
+        wakeup = TRUE;
+    } else {
+        pCnlDev->irqStat.coalesced++;
+        wakeup = FALSE;
+    }
+    pCnlDev->irqStat.topCnt++;
+    CMN_getTimeUs(&end);
+    CNL_addIrqLatency(pCnlDev->irqStat.topHist, end - start);
+    CMN_unlockCpu(pDeviceData->irqLockId);
+
+    trace_izan_irq(pCnlDev->devnum, wakeup);
+
+    if(wakeup) {
+        CMN_wakeupTask(pDeviceData->irqTaskId);
+    }
+
+    return;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : IZAN_irqBottomHalf
+ *-----------------------------------------------------------------*/
+/**
+ * handle the interrupt status requested by IZAN_irqHandler.
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void
+IZAN_irqBottomHalf(S_CNL_DEV *pCnlDev)
+{
+
+    T_CNL_ERR           retval;
     void               *pDev;
     S_IZAN_DEVICE_DATA *pDeviceData;
     S_CNL_DEVICE_EVENT  event;
@@ -3207,11 +3320,21 @@ IZAN_irqHandler(void *pArg)
     u32                 intmask;
     u32                 intst = 0;
     u32                 bits;
+    u32                 start;
+    u32                 stamp;
+    u32                 end;
 
-    pCnlDev     = (S_CNL_DEV *)pArg;
     pDev        = pCnlDev->pDev;
     pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
 
+    CMN_getTimeUs(&start);
+
+    // interrupts raised from now on request the next bottom half.
+    CMN_lockCpu(pDeviceData->irqLockId);
+    pDeviceData->irqPending = FALSE;
+    stamp                   = pDeviceData->irqStamp;
+    CMN_unlockCpu(pDeviceData->irqLockId);
+
     CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
 
     //
@@ -3221,24 +3344,22 @@ IZAN_irqHandler(void *pArg)
     // 2. clear interrupt
     // 3. mask interrupt
     // 4. convert interrupt status to event.
-    // 5. notify event.
+    // 5. enable CNL interrupt disabled by the top half.
+    // 6. notify event.
     //
 
     CMN_LOCK_MUTEX(pDeviceData->intLockId);
 
+    // register accesses below are issued under one bus claim.
+    BUSCMN_beginBatch(pDev);
+
     if(pDeviceData->pmuState == PMU_POWERSAVE) {
         //
         // interrupt raised while powersave state.
-        // disable CNL interrupt and notify event.
+        // keep CNL interrupt disabled and notify event.
         //
         DBG_INFO("Interrupt raised while POWERSAVE sate.\n");
 
-        retval = IZAN_disableCnlInt(pCnlDev);
-        if(retval != CNL_SUCCESS) {
-            DBG_ERR("IRQ Handler : disable CNL interrupt failed[%d].\n", retval);
-            goto EXIT;
-        }
-
         event.type = CNL_EVENT_WAKE_REQUIRED;
         goto EXIT;
     }
@@ -3246,22 +3367,21 @@ IZAN_irqHandler(void *pArg)
     // 1.
     retval = IZAN_readRegister(pDev, REG_INT, 4, &intst);
     if(retval != CNL_SUCCESS) {
-        CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
         DBG_ERR("IRQ Handler : read REG_INT failed[%d].\n", retval);
-        return;
+        goto ENABLE;
     }
     intst = CMN_LE2H32(intst);
 
     // bits interrupt bitmap.
     bits = pDeviceData->currIntEnable & intst;
+    trace_izan_irq_status(pCnlDev->devnum, intst, bits);
 
     // 2. write interrupt status(clear interrupt)
     intst = CMN_H2LE32(bits);
     retval = IZAN_writeRegister(pDev, REG_INT, 4, &intst);
     if(retval != CNL_SUCCESS) {
-        CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
         DBG_ERR("IRQ Handler : write REG_INT[0x%08x] failed[%d].\n", intst, retval);
-        return;
+        goto ENABLE;
     }
 
     {
@@ -3272,9 +3392,8 @@ IZAN_irqHandler(void *pArg)
         {
             retval = IZAN_readRegister(pDev, REG_RXBANKSTA, 4, &rxbanksta);
             if(retval != CNL_SUCCESS) {
-                CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
                 DBG_ERR("IRQ Handler : read RXBANKSTA failed[%d].\n", retval);
-                return;
+                goto ENABLE;
             }
 
             rxbankcnt = CMN_LE2H32(rxbanksta) & 0x0000000F;
@@ -3284,6 +3403,7 @@ IZAN_irqHandler(void *pArg)
                           rxbankcnt);
                 bits &= ~INT_RXBANKNOTEMPT;
             }
+            // RSSI of the received frames, read in the same bus claim.
             if (IZAN_readRxvgagain(pCnlDev) != CNL_SUCCESS) {
                 DBG_ERR("IRQ Handler : read RXVGAGAIN failed.\n");
             }
@@ -3296,9 +3416,8 @@ IZAN_irqHandler(void *pArg)
     intmask = CMN_H2LE32(newmask);
     retval  = IZAN_writeRegister(pDev, REG_INTMASK, 4, &intmask);
     if(retval != CNL_SUCCESS) {
-        CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
         DBG_ERR("IRQ Handler : write REG_INT[0x%08x] failed[%d].\n", intmask, retval);
-        return;
+        goto ENABLE;
     }
 
     DBG_INFO("IRQ Handler : INTMASK modified [Enable(0x%08x)] -> [Enable(0x%08x)].\n",
@@ -3308,6 +3427,12 @@ IZAN_irqHandler(void *pArg)
 
     // 4.convert interrupt status to Event type.
     IZAN_intToEvent(&event, bits);
+    IZAN_addIntStat(pCnlDev, bits);
+
+    if(bits & (INT_TXDFRAME | INT_TXBANKEMPT)) {
+        // TX bank(s) freed, TX credit is resynchronized at next ready check.
+        CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
+    }
 
     DBG_INFO("IRQ Handler : converted INT[0x%08x] to Event[0x%x]\n", 
              bits, event.type);
@@ -3319,14 +3444,65 @@ IZAN_irqHandler(void *pArg)
         // state is changed to CONNECTED.
         //
         pDeviceData->txNeedResend = TRUE;
+        pCnlDev->devStat.tResendTout++;
 
     }
 
+ENABLE:
+    // 5.
+    if(IZAN_enableCnlInt(pCnlDev) != CNL_SUCCESS) {
+        DBG_ERR("IRQ Handler : enable CNL interrupt failed.\n");
+    }
+
 EXIT:
+    BUSCMN_endBatch(pDev);
     CMN_UNLOCK_MUTEX(pDeviceData->intLockId);
 
-    // 5.  
-    CNL_addEvent(pCnlDev, &event);
+    // 6.  
+    if(event.type != 0) {
+        CNL_addEvent(pCnlDev, &event);
+    }
+
+    CMN_getTimeUs(&end);
+    pCnlDev->irqStat.bottomCnt++;
+    CNL_addIrqLatency(pCnlDev->irqStat.wakeHist, start - stamp);
+    CNL_addIrqLatency(pCnlDev->irqStat.bottomHist, end - start);
+
+    return;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : IZAN_irqTask
+ *-----------------------------------------------------------------*/
+/**
+ * IRQ bottom half thread.
+ * @param  pArg  : the pointer to the S_CNL_DEV
+ * @return nothing.
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static void
+IZAN_irqTask(void *pArg)
+{
+
+    T_CMN_ERR  retval;
+    S_CNL_DEV *pCnlDev = (S_CNL_DEV *)pArg;
+
+    DBG_INFO("IZAN IRQ task started\n");
+
+    do {
+        retval = CMN_sleepTask(0);
+        if(retval != SUCCESS) {
+            // terminate task is called.
+            break;
+        }
+
+        IZAN_irqBottomHalf(pCnlDev);
+    } while(1);
+
+    DBG_INFO("IZAN IRQ task exited\n");
 
     return;
 
@@ -3344,8 +3520,11 @@ EXIT:
 /*-----------------------------------------------------------------*/
 static void IZAN_suspend(int type)
 {
-    if( stored_dev ) {
-        if( stored_dev->devState == CNL_DEV_ACTIVE ) {
+    u8 devnum;
+
+    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
+        S_CNL_DEV *pCnlDev = g_pIzanDevArray[devnum];
+        if( pCnlDev && (pCnlDev->devState == CNL_DEV_ACTIVE) ) {
             S_CNL_DEVICE_EVENT event={0};
             event.type |= CNL_EVENT_ERROR_OCCURRED;
             if( type ) {
@@ -3353,7 +3532,7 @@ static void IZAN_suspend(int type)
             }else{
                 event.error = CNL_ERR_HW_RESUME;
             }
-            CNL_addEvent(stored_dev, &event);
+            CNL_addEvent(pCnlDev, &event);
         }
     }
 }
@@ -3399,8 +3578,9 @@ IZAN_probe(void         *pDev,
     //
     pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
     IZAN_initDeviceData(pDeviceData);
+    CNL_setPmuStat(pCnlDev, pDeviceData->pmuState);
 
-    pDeviceData->intLockId = CNL_INT_MTX_ID;
+    pDeviceData->intLockId = CNL_INT_MTX_ID + pCnlDev->devnum;
     retval = CMN_INIT_MUTEX(pDeviceData->intLockId);
     if(retval != SUCCESS) {
         DBG_ERR("create interrupt mutex object failed[%d].\n", retval);
@@ -3411,36 +3591,64 @@ IZAN_probe(void         *pDev,
     // 2. card initialize sequence.
     status = IZAN_initializeDevice(pCnlDev);
     if(status != CNL_SUCCESS) {
-        CMN_deleteSem(pDeviceData->intLockId);
-        CNL_releaseDevice(pCnlDev);
-        return -1;
+        goto EXIT;
     }
 
-    // 3. set irq handler.
+    // 3. start IRQ bottom half task.
+    pDeviceData->irqLockId = CNL_IRQ_LOC_ID + pCnlDev->devnum;
+    retval = CMN_createCpuLock(pDeviceData->irqLockId);
+    if(retval != SUCCESS) {
+        DBG_ERR("create IRQ lock object failed[%d].\n", retval);
+        goto EXIT;
+    }
+
+    pDeviceData->irqTaskId = CNL_IRQ_TASK_ID + pCnlDev->devnum;
+    retval = CMN_createTask(pDeviceData->irqTaskId, 0, (void *)pCnlDev, IZAN_irqTask, 0, 0, NULL);
+    if(retval != SUCCESS) {
+        DBG_ERR("create IRQ task failed[%d].\n", retval);
+        goto EXIT_1;
+    }
+
+    retval = CMN_startTask(pDeviceData->irqTaskId, NULL);
+    if(retval != SUCCESS) {
+        DBG_ERR("start IRQ task failed[%d].\n", retval);
+        goto EXIT_2;
+    }
+
+    // 4. set irq handler.
     retval = BUSCMN_setIrqHandler(pDev,
                                   IZAN_irqHandler, 
                                   (void *)pCnlDev);
     if(retval != SUCCESS) {
-        CMN_deleteSem(pDeviceData->intLockId);
-        CNL_releaseDevice(pCnlDev);
-        return -1;
+        goto EXIT_3;
     }
 
     retval = CNL_registerDevice(pCnlDev);
     if(retval != SUCCESS) {
         DBG_ERR("register device failed.\n");
-        CMN_deleteSem(pDeviceData->intLockId);
-        CNL_releaseDevice(pCnlDev);
-        return -1;
+        BUSCMN_setIrqHandler(pDev, NULL, NULL);
+        goto EXIT_3;
     }
 
-    // create Lock Mng.
-    CMN_createPowerLock();
-
-    stored_dev = pCnlDev;
-    CMN_setSuspendEvent(IZAN_suspend);
+    // create Lock Mng. shared by all devices.
+    if(g_izanDevCnt++ == 0) {
+        CMN_createPowerLock();
+        CMN_setSuspendEvent(IZAN_suspend);
+    }
+    g_pIzanDevArray[pCnlDev->devnum] = pCnlDev;
 
     return 0;
+
+EXIT_3:
+    CMN_terminateTask(pDeviceData->irqTaskId);
+EXIT_2:
+    CMN_deleteTask(pDeviceData->irqTaskId);
+EXIT_1:
+    CMN_deleteCpuLock(pDeviceData->irqLockId);
+EXIT:
+    CMN_deleteSem(pDeviceData->intLockId);
+    CNL_releaseDevice(pCnlDev);
+    return -1;
 }
 
 
@@ -3462,6 +3670,7 @@ IZAN_remove(void *pDev)
     S_CNL_DEV          *pCnlDev;
     S_IZAN_DEVICE_DATA *pDeviceData;
     u8                  lockId;
+    u8                  devnum;
     
     DBG_INFO("CNL device is removed.\n");
     pCnlDev     = CNL_devToCnlDev(pDev);
@@ -3471,17 +3680,28 @@ IZAN_remove(void *pDev)
         return -1;
     }
     pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
+    devnum      = pCnlDev->devnum;
+
+    g_pIzanDevArray[devnum] = NULL;
+
+    // release the top half first, it wakes up the IRQ task.
+    BUSCMN_setIrqHandler(pDev, NULL, NULL);
+
+    // stop the bottom half before the device is released.
+    CMN_terminateTask(pDeviceData->irqTaskId);
+    CMN_deleteTask(pDeviceData->irqTaskId);
+    CMN_deleteCpuLock(pDeviceData->irqLockId);
 
     lockId = pDeviceData->intLockId;
     CNL_unregisterDevice(pCnlDev);
     CMN_deleteSem(lockId);
 
-    CMN_clearSuspendEvent();
-    stored_dev = NULL;
-
-    // unlock WakeLock & delete Lock Mng.
-    CMN_unlockPower();
-    CMN_deletePowerLock();
+    // unlock WakeLock & delete Lock Mng by the last device.
+    if(--g_izanDevCnt == 0) {
+        CMN_clearSuspendEvent();
+        CMN_unlockPower();
+        CMN_deletePowerLock();
+    }
     return 0;
 }
 
@@ -3525,6 +3745,8 @@ CNL_registerDriver()
 {
     T_CMN_ERR retval;
 
+    g_cnlDriver.busType = (g_cnlBusSim != 0) ? BUSCMN_TYPE_SIM : BUSCMN_TYPE_SDIO;
+
     retval = BUSCMN_registerDriver(&g_cnlDriver);
     if(retval != SUCCESS) {
         DBG_ERR("register CNL device driver failed.\n");
@@ -3973,7 +4195,7 @@ IZAN_wake(S_CNL_DEV *pCnlDev)
         DBG_ERR("IZAN wake : set DMTEXIT(0x%x) failed[%d].\n", dmtexit, retval);
         goto COMPLETE;
     }
-    pDeviceData->pmuState = PMU_AWAKE;
+    IZAN_setPmuState(pCnlDev, PMU_AWAKE);
     intst  = CMN_H2LE32(INT_SLEEPTOAWAKE|INT_AWAKETOSLEEP);
     retval = IZAN_writeRegister(pDev, REG_INT, 4, &intst);
     if(retval != CNL_SUCCESS) {
@@ -4060,7 +4282,7 @@ IZAN_sleep(S_CNL_DEV *pCnlDev)
     }
 
     // change to powersave immediately,
-    pDeviceData->pmuState = PMU_POWERSAVE;
+    IZAN_setPmuState(pCnlDev, PMU_POWERSAVE);
 
     // notify dummy completion to shceduler.
     CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
@@ -4338,55 +4560,128 @@ IZAN_sendData(S_CNL_DEV *pCnlDev,
               void      *pData)
 {
 
-    T_CNL_ERR  retval;
-    void      *pDev;
-    u8         cnt;
-    u32        txInfo[IZAN_TX_CSDU_NUM];
+    S_CNL_TX_FRAME frame;
+    u8             sentNum;
 
-    pDev  = pCnlDev->pDev;
+    frame.profileId = profileId;
+    frame.fragment  = fragment;
+    frame.length    = length;
+    frame.pData     = pData;
 
-    DBG_ASSERT(pData  != NULL);
-    DBG_ASSERT((length > 0) && (length <= IZAN_TX_CSDU_NUM * CNL_CSDU_SIZE));
+    return IZAN_sendDataMulti(pCnlDev, &frame, 1, &sentNum);
+}
 
-    cnt = (u8)LENGTH_TO_CSDU(length);
+
+/*-------------------------------------------------------------------
+ * Function : IZAN_sendDataMulti
+ *-----------------------------------------------------------------*/
+/**
+ * send data frames coalesced in one submission.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pFrame     : the pointer to the S_CNL_TX_FRAME array.
+ * @param  num        : number of frames.
+ * @param  pSentNum   : number of frames written to TXFIFO.(OUT)
+ * @return CNL_SUCCESS      (normally completion)
+ * @return CNL_ERR_HOST_IO  (HostI/O failed)
+ * @note   TXDATAINFO of all frames is written at once, TXDATAINFO and
+ *         TXFIFO are not contiguous so the data is written per frame.
+ *         on failure, the frames written before it may be sent by IZAN,
+ *         so they are counted in pSentNum and must not be sent again.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+IZAN_sendDataMulti(S_CNL_DEV      *pCnlDev,
+                   S_CNL_TX_FRAME *pFrame,
+                   u8              num,
+                   u8             *pSentNum)
+{
+
+    T_CNL_ERR           retval;
+    void               *pDev;
+    S_IZAN_DEVICE_DATA *pDeviceData;
+    u8                  cnt;
+    u8                  i;
+    u32                 total;
+    u32                 txInfo[IZAN_TX_CSDU_NUM];
+
+    pDev        = pCnlDev->pDev;
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
+    *pSentNum   = 0;
+
+    DBG_ASSERT(num > 0);
 
     // 
     // send data frame sequence.
     //
-    // 0. setup TX info data.
+    // 0. setup TX info data of all frames.
     // 1. write TXDATAINFO.
     // 2. write data to TXFIFO.(writeDMA)
     // 3. if write data is not 4096 * n, put TxFIFO address to head.
+    // 2-3 are repeated for each frame.
     //
 
     // 0.
-    IZAN_setupTxInfo(txInfo, length, profileId, fragment);
+    cnt   = 0;
+    total = 0;
+    for(i=0; i<num; i++) {
+        DBG_ASSERT(pFrame[i].pData != NULL);
+        if((pFrame[i].length == 0) ||
+           (cnt + LENGTH_TO_CSDU(pFrame[i].length) > IZAN_TX_CSDU_NUM)) {
+            DBG_ERR("SendData : frames exceed TX banks[%u].\n", i);
+            return CNL_ERR_BADPARM;
+        }
+
+        IZAN_setupTxInfo(&txInfo[cnt], pFrame[i].length, pFrame[i].profileId, pFrame[i].fragment);
+        cnt   += (u8)LENGTH_TO_CSDU(pFrame[i].length);
+        total += pFrame[i].length;
+    }
+
+    trace_izan_send_data(pCnlDev->devnum, num, total, cnt);
+
+    // take TX credit for the banks to be filled.
+    pDeviceData->txCredit = (pDeviceData->txCredit > cnt) ? (pDeviceData->txCredit - cnt) : 0;
+
+    // 1-3 are issued under one bus claim.
+    BUSCMN_beginBatch(pDev);
 
     // 1.
     retval = IZAN_writeRegister(pDev, REG_TXDATAINFO, 4 * cnt, (void *)txInfo);
     if(retval != CNL_SUCCESS) {
         DBG_ERR("SendData : set TXINFO[1-%d] failed[%d].\n", cnt, retval);
-        return retval;
-    }
-
-    // 2.
-    retval = IZAN_writeDMA(pDev, REG_TXRXFIFO, PADDING_4B(length), pData);
-    if(retval != CNL_SUCCESS) {
-        DBG_ERR("SendData : write DATA to TXFIFO failed[%d].\n", retval);
-        return retval;
+        goto EXIT;
     }
 
-    // 3. 
-    if(!IS_MULTI_OF_4K(PADDING_4B(length))) {
-        // last data frame is not 4K byte, reset TxFIFO internal address.
-        retval = IZAN_resetTxFifo(pCnlDev);
+    for(i=0; i<num; i++) {
+        // 2.
+        retval = IZAN_writeDMA(pDev, REG_TXRXFIFO, PADDING_4B(pFrame[i].length), pFrame[i].pData);
         if(retval != CNL_SUCCESS) {
-            DBG_ERR("SendData : resetTxFifo failed[%d].\n", retval);
-            return retval;
+            DBG_ERR("SendData : write DATA to TXFIFO failed[%d].\n", retval);
+            goto EXIT;
+        }
+        (*pSentNum)++;
+
+        // 3. 
+        if(!IS_MULTI_OF_4K(PADDING_4B(pFrame[i].length))) {
+            // last data frame is not 4K byte, reset TxFIFO internal address.
+            retval = IZAN_resetTxFifo(pCnlDev);
+            if(retval != CNL_SUCCESS) {
+                DBG_ERR("SendData : resetTxFifo failed[%d].\n", retval);
+                goto EXIT;
+            }
         }
     }
 
-    return CNL_SUCCESS;
+EXIT:
+    BUSCMN_endBatch(pDev);
+
+    if(retval != CNL_SUCCESS) {
+        // bank state is unknown, read TXBANKSTA at next ready check.
+        CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
+    }
+
+    trace_izan_send_data_done(pCnlDev->devnum, cnt, retval);
+
+    return retval;
 }
 
 
@@ -4486,6 +4781,8 @@ IZAN_receiveData(S_CNL_DEV *pCnlDev,
         frag    = pDeviceData->rxFragment;
     }
 
+    trace_izan_receive_data(pCnlDev->devnum, profileId, *pLength, pDeviceData->rxRemain);
+
 
     // 1. read data from RXFIFO.
     retry = 0;
@@ -4504,8 +4801,10 @@ IZAN_receiveData(S_CNL_DEV *pCnlDev,
         retval = IZAN_writeRegister(pDev, REG_REWIND, 4, &rewind);
         if(retval != CNL_SUCCESS) {
             DBG_ERR("ReceiveData : write REWIND failed[%d].\n", retval);
+            trace_izan_receive_data_done(pCnlDev->devnum, 0, frag, retry, retval);
             return retval;
         }
+        pCnlDev->devStat.rewindRetry++;
         retry++;
     }
 
@@ -4515,6 +4814,7 @@ IZAN_receiveData(S_CNL_DEV *pCnlDev,
     retval = IZAN_writeRegister(pDev, REG_READDONE, 4, &readdone);
     if(retval != CNL_SUCCESS) {
         DBG_ERR("ReceiveData : write READDONE failed[%d].\n", retval);
+        trace_izan_receive_data_done(pCnlDev->devnum, 0, frag, retry, retval);
         return retval;
     }
 
@@ -4522,6 +4822,12 @@ IZAN_receiveData(S_CNL_DEV *pCnlDev,
     *pLength   = length;
     *pFragment = frag;
 
+    // count banks read out, the last bank of the chunk may be partial.
+    pCnlDev->devStat.rxCsdu += (pDeviceData->rxBankHeadPos + length) / CNL_CSDU_SIZE;
+    if((remain == 0) && (((pDeviceData->rxBankHeadPos + length) % CNL_CSDU_SIZE) != 0)) {
+        pCnlDev->devStat.rxCsdu++;
+    }
+
     // update information.
     pDeviceData->rxRemain      = remain;
     if(remain == 0) {
@@ -4544,6 +4850,8 @@ IZAN_receiveData(S_CNL_DEV *pCnlDev,
         pDeviceData->rxNeedReset = FALSE;
     }
 
+    trace_izan_receive_data_done(pCnlDev->devnum, length, frag, retry, CNL_SUCCESS);
+
     return CNL_SUCCESS;
 }
 
@@ -4565,9 +4873,11 @@ IZAN_receiveDataIntUnmask(S_CNL_DEV *pCnlDev)
 
     T_CNL_ERR           retval;
     void               *pDev;
+    S_IZAN_DEVICE_DATA *pDeviceData;
     u32                 unmask;
 
-    pDev = pCnlDev->pDev;
+    pDev        = pCnlDev->pDev;
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
 
     {
         u32                rxbanksta;
@@ -4585,6 +4895,19 @@ IZAN_receiveDataIntUnmask(S_CNL_DEV *pCnlDev)
 
         rxbankcnt = CMN_LE2H32(rxbanksta) & 0x0000000F;
 
+        if(rxbankcnt > 0) {
+            // banks keep arriving, count busy pass.
+            if(pDeviceData->rxBusyCnt < 0xFF) {
+                pDeviceData->rxBusyCnt++;
+            }
+        } else {
+            // poll for a while before enabling interrupt.
+            retval = IZAN_pollRxBank(pCnlDev, &rxbankcnt);
+            if(retval != CNL_SUCCESS) {
+                return retval;
+            }
+        }
+
         if(rxbankcnt > 0) {
             DBG_INFO("=======> RXBANKCNT = %d \n", rxbankcnt);
             CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
@@ -4610,6 +4933,89 @@ IZAN_receiveDataIntUnmask(S_CNL_DEV *pCnlDev)
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : IZAN_pollRxBank
+ *-----------------------------------------------------------------*/
+/**
+ * poll RXBANKSTA while receive is busy instead of waiting interrupt.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pRxbankcnt : the pointer to the RXBANKCNT stored.
+ *                      0 means to go back to interrupt.
+ * @return CNL_SUCCESS      (normally completion)
+ * @return CNL_ERR_HOST_IO  (HostI/O failed)
+ * @note   polling is done only while CONNECTED and after g_cnlRxPollEnter
+ *         busy passes, and is stopped when other event is pending, the
+ *         worker is signaled (new request, cancel, completion), or TX
+ *         request waits for the ready TX bank.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+IZAN_pollRxBank(S_CNL_DEV *pCnlDev,
+                u32       *pRxbankcnt)
+{
+
+    T_CNL_ERR           retval;
+    S_IZAN_DEVICE_DATA *pDeviceData;
+    u32                 rxbanksta;
+    u8                  mainState;
+    uint                poll;
+    u16                 interval;
+    u8                  pending;
+
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
+    mainState   = CNLSTATE_TO_MAINSTATE(pCnlDev->cnlState);
+    interval    = (g_cnlRxPollInterval > 0xFFFF) ? 0xFFFF : (u16)g_cnlRxPollInterval;
+
+    *pRxbankcnt = 0;
+
+    if((g_cnlRxPollEnter == 0) ||
+       (pDeviceData->rxBusyCnt < g_cnlRxPollEnter) ||
+       ((mainState != CNL_STATE_INITIATOR_CONNECTED) &&
+        (mainState != CNL_STATE_RESPONDER_CONNECTED))) {
+        pDeviceData->rxBusyCnt = 0;
+        return CNL_SUCCESS;
+    }
+
+    for(poll=0; poll<g_cnlRxPollBudget; poll++) {
+        if((pCnlDev->event.type != 0) ||
+           (CMN_ATOMIC_READ(&pCnlDev->sigState) & CNL_SIG_SIGNALED)) {
+            // do not delay other events and requests.
+            break;
+        }
+
+        if(pCnlDev->txReady) {
+            CMN_lockCpu(pCnlDev->mngLockId);
+            pending = (CNL_searchNextSendRequest(pCnlDev) != NULL);
+            CMN_unlockCpu(pCnlDev->mngLockId);
+            if(pending) {
+                // TX arbitration runs in the next pass.
+                break;
+            }
+        }
+
+        CMN_delayTaskUs(interval);
+
+        retval = IZAN_readRegister(pCnlDev->pDev, REG_RXBANKSTA, 4, &rxbanksta);
+        if(retval != CNL_SUCCESS) {
+            DBG_ERR("PollRxBank : read RXBANKSTA failed[%d].\n", retval);
+            return retval;
+        }
+
+        *pRxbankcnt = CMN_LE2H32(rxbanksta) & 0x0000000F;
+        if(*pRxbankcnt > 0) {
+            pCnlDev->irqStat.rxPolled++;
+            return CNL_SUCCESS;
+        }
+    }
+
+    // idle budget is exhausted, go back to interrupt.
+    DBG_INFO("PollRxBank : RX idle, enable interrupt.\n");
+    pDeviceData->rxBusyCnt = 0;
+
+    return CNL_SUCCESS;
+}
+
+
 /*-------------------------------------------------------------------
  * Function : IZAN_readReadyPid
  *-----------------------------------------------------------------*/
@@ -4697,6 +5103,7 @@ IZAN_readReadyBuffer(S_CNL_DEV *pCnlDev,
     // check ready CSDU count sequence.
     //
     // if TX
+    // 0. if no TX bank is freed since last read, return TX credit.
     // 1. read TXBANKSTA
     //    -- return empty Bank count * CSDU_SIZE
     // 2. if Sending Frame is remained, UNMASK TXDFRAME interrupt again
@@ -4707,22 +5114,18 @@ IZAN_readReadyBuffer(S_CNL_DEV *pCnlDev,
     //
 
     if(which == CNL_TX_CSDU) {
-        // TX 1.
-        retval = IZAN_readRegister(pDev, REG_TXBANKSTA, 4, &banksta);
-        if(retval != CNL_SUCCESS) {
-            DBG_ERR("ReadReadyBuffer(TX) : read TXBANKSTA failed[%d].\n", retval);
-            return retval;
+        // TX 0.
+        //  only this driver fills TX banks, so the credit never exceeds
+        //  free banks of IZAN.
+        if((!CMN_ATOMIC_READ(&pDeviceData->txResync)) && (pDeviceData->txCredit != 0)) {
+            *pLength = (u32)(pDeviceData->txCredit * CNL_CSDU_SIZE);
+            return CNL_SUCCESS;
         }
 
-        *pLength = (u32)(IZAN_TXBANKSTA_TO_READY_CSDU(banksta) * CNL_CSDU_SIZE);
-
-        // TX 2.
-        if(IZAN_TXBANKSTA_TO_READY_CSDU(banksta) != IZAN_TX_CSDU_NUM) {
-            retval = IZAN_addIntUnmask(pCnlDev, INT_TXDFRAME);
-            if(retval != CNL_SUCCESS) {
-                DBG_ERR("ReadReadyBuffer(TX) : re-unmask TXDFRAME failed[%d].\n", retval);
-                return retval;
-            }
+        // TX 1, 2.
+        retval = IZAN_readTxBankSta(pCnlDev, pLength);
+        if(retval != CNL_SUCCESS) {
+            return retval;
         }
     }
     else {
@@ -4802,45 +5205,86 @@ IZAN_readReadyBuffer(S_CNL_DEV *pCnlDev,
 
 
 /*-------------------------------------------------------------------
- * Function : IZAN_readReadyTxBuffer
+ * Function : IZAN_readTxBankSta
  *-----------------------------------------------------------------*/
 /**
- * read ready TX buffer length.
- * TX : number of empty BANK count * CSDU_SIZE.
+ * read TXBANKSTA and set TX credit to the empty banks.
  * @param  pCnlDev    : the pointer to the S_CNL_DEV
  * @param  pLength    : ready buffer length.
  * @return CNL_SUCCESS      (normally completion)
  * @return CNL_ERR_HOST_IO  (HostI/O failed)
- * @note 
+ * @note   TXDFRAME is unmasked again while any bank is still filled.
+ *         txResync is cleared before reading, TX interrupt after this
+ *         sets it again.
  */
 /*-----------------------------------------------------------------*/
 static T_CNL_ERR
-IZAN_readReadyTxBuffer(S_CNL_DEV *pCnlDev,
-                       u32       *pLength)
+IZAN_readTxBankSta(S_CNL_DEV *pCnlDev,
+                   u32       *pLength)
 {
 
     T_CNL_ERR           retval;
-    void               *pDev;
+    S_IZAN_DEVICE_DATA *pDeviceData;
     u32                 banksta = 0;
 
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
 
-    pDev = pCnlDev->pDev;
-
-    //
-    // check ready CSDU count sequence.
-    //
-    retval = IZAN_readRegister(pDev, REG_TXBANKSTA, 4, &banksta);
+    CMN_ATOMIC_SET(&pDeviceData->txResync, FALSE);
+    retval = IZAN_readRegister(pCnlDev->pDev, REG_TXBANKSTA, 4, &banksta);
     if(retval != CNL_SUCCESS) {
-        DBG_ERR("ReadyTxBuffer : read TXBANKSTA failed[%d].\n", retval);
+        DBG_ERR("ReadReadyBuffer(TX) : read TXBANKSTA failed[%d].\n", retval);
+        CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
         return retval;
     }
 
-    *pLength = (u32)(IZAN_TXBANKSTA_TO_READY_CSDU(banksta) * CNL_CSDU_SIZE);
+    pDeviceData->txCredit = IZAN_TXBANKSTA_TO_READY_CSDU(banksta);
+    *pLength = (u32)(pDeviceData->txCredit * CNL_CSDU_SIZE);
+
+    if(pDeviceData->txCredit != IZAN_TX_CSDU_NUM) {
+        retval = IZAN_addIntUnmask(pCnlDev, INT_TXDFRAME);
+        if(retval != CNL_SUCCESS) {
+            DBG_ERR("ReadReadyBuffer(TX) : re-unmask TXDFRAME failed[%d].\n", retval);
+            return retval;
+        }
+    }
 
     return CNL_SUCCESS;
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : IZAN_readReadyTxBuffer
+ *-----------------------------------------------------------------*/
+/**
+ * read ready TX buffer length.
+ * TX : number of empty BANK count * CSDU_SIZE.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pLength    : ready buffer length.
+ * @return CNL_SUCCESS      (normally completion)
+ * @return CNL_ERR_HOST_IO  (HostI/O failed)
+ * @note   answered from TX credit while it remains, TXBANKSTA is read
+ *         when the credit is used up or a TX bank is freed, so that
+ *         the banks sent meanwhile are refilled in the same pass.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+IZAN_readReadyTxBuffer(S_CNL_DEV *pCnlDev,
+                       u32       *pLength)
+{
+
+    S_IZAN_DEVICE_DATA *pDeviceData;
+
+    pDeviceData = IZAN_cnlDevToDeviceData(pCnlDev);
+
+    if((!CMN_ATOMIC_READ(&pDeviceData->txResync)) && (pDeviceData->txCredit != 0)) {
+        *pLength = (u32)(pDeviceData->txCredit * CNL_CSDU_SIZE);
+        return CNL_SUCCESS;
+    }
+
+    return IZAN_readTxBankSta(pCnlDev, pLength);
+}
+
+
 /*-------------------------------------------------------------------
  * Function : IZAN_readReadyRxBuffer
  *-----------------------------------------------------------------*/
@@ -5341,6 +5785,9 @@ IZAN_changeState(S_CNL_DEV   *pCnlDev,
 
     CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
     IZAN_intToEvent(&event, clearInt);
+    if(clearInt & (INT_TXDFRAME | INT_TXBANKEMPT)) {
+        CMN_ATOMIC_SET(&pDeviceData->txResync, TRUE);
+    }
 
     // 1.
     intmask = CMN_H2LE32(IZAN_INTEN_TO_MASK(IZAN_INTEN_NONE));
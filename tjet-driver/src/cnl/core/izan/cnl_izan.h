@@ -172,6 +172,12 @@ typedef struct tagS_IZAN_DEVICE_DATA {
     u32                 currIntMask;
     u32                 currIntEnable;
 
+    // deferred interrupt handling
+    u8                  irqTaskId;     // bottom half task.
+    u8                  irqLockId;     // protects irqPending/irqStamp.
+    u8                  irqPending;    // bottom half is requested.
+    u32                 irqStamp;      // top half entry time(usec).
+
     // pmu state
     T_IZAN_PMU_STATE    pmuState;
     u8                  dummy[3];
@@ -187,8 +193,12 @@ typedef struct tagS_IZAN_DEVICE_DATA {
     u8                  rxFragment;
     u8                  rxNeedReset;
     u32                 rxBankHeadPos;
+    u8                  rxBusyCnt;     // busy receive passes in a row.
+    int                 rssiReadCnt;   // RXBANKSTA reads since RSSI update.
 
     //
+    u8                  txCredit;      // free TX banks known by the driver. (CNL task only)
+    T_CMN_ATOMIC        txResync;      // TX bank freed, TXBANKSTA must be read. (set by IRQ task)
     u8                  txNeedResend;
     u8                  discardCreq;
     S_CNL_DEVICE_EVENT  eventFilter;
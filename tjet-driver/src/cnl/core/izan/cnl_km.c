@@ -28,7 +28,14 @@
  * Header section
  *-----------------------------------------------------------------*/
 #include <linux/module.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include "cnl.h"
+#include "cnl_izan.h"
+
+// tracepoints of toscnl are instantiated here.
+#define CREATE_TRACE_POINTS
+#include "cnl_trace.h"
 
 
 /*-------------------------------------------------------------------
@@ -40,6 +47,14 @@
 #define DRIVER_VERSION "1.0.1";
 #define DRIVER_DESC "CNL Core Driver";
 
+/**
+ * @brief debugfs entry names.
+ */
+#define CNL_DEBUGFS_DIR    "toscnl"
+#define CNL_DEBUGFS_IRQLAT "irqlat"
+#define CNL_DEBUGFS_SCHED  "sched"
+#define CNL_DEBUGFS_STATS  "stats"
+
 
 /*-------------------------------------------------------------------
  * Structure definition
@@ -49,11 +64,255 @@
 /*-------------------------------------------------------------------
  * Prototypes
  *-----------------------------------------------------------------*/
+static int CNL_openIrqStat(struct inode *, struct file *);
+static int CNL_openSchdStat(struct inode *, struct file *);
+static int CNL_openDevStat(struct inode *, struct file *);
 
 
 /*-------------------------------------------------------------------
  * Globals
  *-----------------------------------------------------------------*/
+/**
+ * request queue depths, applied when the device is opened.
+ * deeper queues need the larger IO container/TXRX pools in upper driver.
+ */
+uint g_cnlTxQueueSize  = CNL_TX_QUEUE_SIZE;
+uint g_cnlRx0QueueSize = CNL_RX_QUEUE0_SIZE;
+uint g_cnlRx1QueueSize = CNL_RX_QUEUE1_SIZE;
+module_param_named(TxQueueSize,  g_cnlTxQueueSize,  uint, S_IRUGO | S_IWUSR);
+module_param_named(Rx0QueueSize, g_cnlRx0QueueSize, uint, S_IRUGO | S_IWUSR);
+module_param_named(Rx1QueueSize, g_cnlRx1QueueSize, uint, S_IRUGO | S_IWUSR);
+
+/**
+ * adaptive RX polling. after RxPollEnter busy receive passes in a row,
+ * RXBANKSTA is polled RxPollBudget times every RxPollInterval usec
+ * before RXBANKNOTEMPT interrupt is enabled again.
+ */
+uint g_cnlRxPollEnter    = CNL_RX_POLL_ENTER;
+uint g_cnlRxPollBudget   = CNL_RX_POLL_BUDGET;
+uint g_cnlRxPollInterval = CNL_RX_POLL_INTERVAL;
+module_param_named(RxPollEnter,    g_cnlRxPollEnter,    uint, S_IRUGO | S_IWUSR);
+module_param_named(RxPollBudget,   g_cnlRxPollBudget,   uint, S_IRUGO | S_IWUSR);
+module_param_named(RxPollInterval, g_cnlRxPollInterval, uint, S_IRUGO | S_IWUSR);
+
+/**
+ * CPU binding of CNL worker threads, applied when the device is allocated.
+ * device n runs on CPU (WorkerCpu + n). negative value means no binding.
+ */
+int g_cnlWorkerCpu = -1;
+module_param_named(WorkerCpu, g_cnlWorkerCpu, int, S_IRUGO | S_IWUSR);
+
+/**
+ * TX/RX arbitration. ArbPolicy 0 handles RX then TX without limit,
+ * 1 shares the bus by ArbRxQuantum/ArbTxQuantum bytes while both are busy.
+ * PrioProfile1 sends profile 1 requests ahead of queued profile 0 ones.
+ */
+uint g_cnlArbPolicy    = CNL_ARB_POLICY;
+uint g_cnlArbRxQuantum = CNL_ARB_RX_QUANTUM;
+uint g_cnlArbTxQuantum = CNL_ARB_TX_QUANTUM;
+uint g_cnlPrioProfile1 = CNL_PRIO_PROFILE_1;
+module_param_named(ArbPolicy,    g_cnlArbPolicy,    uint, S_IRUGO | S_IWUSR);
+module_param_named(ArbRxQuantum, g_cnlArbRxQuantum, uint, S_IRUGO | S_IWUSR);
+module_param_named(ArbTxQuantum, g_cnlArbTxQuantum, uint, S_IRUGO | S_IWUSR);
+module_param_named(PrioProfile1, g_cnlPrioProfile1, uint, S_IRUGO | S_IWUSR);
+
+/**
+ * BusSim 1 binds the driver to the simulated IZAN chips of the common bus
+ * driver instead of the SDIO card, see SimDevNum of the bus module.
+ */
+uint g_cnlBusSim = 0;
+module_param_named(BusSim, g_cnlBusSim, uint, S_IRUGO);
+
+static struct dentry *g_cnlDebugfsDir;
+
+static const struct file_operations g_cnlIrqStatFops = {
+    .owner   = THIS_MODULE,
+    .open    = CNL_openIrqStat,
+    .read    = seq_read,
+    .llseek  = seq_lseek,
+    .release = single_release,
+};
+
+static const struct file_operations g_cnlSchdStatFops = {
+    .owner   = THIS_MODULE,
+    .open    = CNL_openSchdStat,
+    .read    = seq_read,
+    .llseek  = seq_lseek,
+    .release = single_release,
+};
+
+static const struct file_operations g_cnlDevStatFops = {
+    .owner   = THIS_MODULE,
+    .open    = CNL_openDevStat,
+    .read    = seq_read,
+    .llseek  = seq_lseek,
+    .release = single_release,
+};
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_showIrqStat
+ *-----------------------------------------------------------------*/
+/**
+ * show the IRQ latency histogram of all CNL devices (debugfs).
+ * @param   m : the seq_file.
+ * @param   v : not used.
+ * @return  0 (normally completion)
+ * @note    
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNL_showIrqStat(struct seq_file *m, void *v)
+{
+
+    S_CNL_IRQ_STAT stat;
+    u8             devnum;
+    int            i;
+
+    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
+        if(CNL_getIrqStat(devnum, &stat) != SUCCESS) {
+            continue;
+        }
+
+        seq_printf(m, "dev%u: top %u bottom %u coalesced %u rxpolled %u\n",
+                   devnum, stat.topCnt, stat.bottomCnt, stat.coalesced, stat.rxPolled);
+        seq_printf(m, "%10s %10s %10s %10s\n", "usec", "top", "wake", "bottom");
+        for(i=0; i<CNL_IRQ_LAT_HIST_NUM; i++) {
+            seq_printf(m, "%9u%s %10u %10u %10u\n",
+                       (i == 0) ? 0 : (1U << i),
+                       (i == (CNL_IRQ_LAT_HIST_NUM - 1)) ? "+" : " ",
+                       stat.topHist[i], stat.wakeHist[i], stat.bottomHist[i]);
+        }
+    }
+
+    return 0;
+
+}
+
+
+static int
+CNL_openIrqStat(struct inode *inode, struct file *file)
+{
+    return single_open(file, CNL_showIrqStat, NULL);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_showSchdStat
+ *-----------------------------------------------------------------*/
+/**
+ * show the scheduler statistics of all CNL devices (debugfs).
+ * @param   m : the seq_file.
+ * @param   v : not used.
+ * @return  0 (normally completion)
+ * @note    
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNL_showSchdStat(struct seq_file *m, void *v)
+{
+
+    S_CNL_SCHD_STAT stat;
+    u8              devnum;
+    int             i;
+
+    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
+        if(CNL_getSchdStat(devnum, &stat) != SUCCESS) {
+            continue;
+        }
+
+        seq_printf(m, "dev%u: pass %u initclose %u event %u ctrl %u rx %u tx %u sleep %u\n",
+                   devnum, stat.passCnt, stat.initCloseCnt, stat.eventCnt,
+                   stat.ctrlCnt, stat.rxCnt, stat.txCnt, stat.sleepCnt);
+        seq_printf(m, "  batch %u rxcapped %u txcapped %u prio %u\n",
+                   stat.batchCnt, stat.rxCapped, stat.txCapped, stat.prioCnt);
+        seq_printf(m, "  wait count %u/%u/%u/%u max %u/%u/%u/%u usec\n",
+                   stat.waitCnt[CNL_SCHD_Q_TX],  stat.waitCnt[CNL_SCHD_Q_RX0],
+                   stat.waitCnt[CNL_SCHD_Q_RX1], stat.waitCnt[CNL_SCHD_Q_CTRL],
+                   stat.waitMax[CNL_SCHD_Q_TX],  stat.waitMax[CNL_SCHD_Q_RX0],
+                   stat.waitMax[CNL_SCHD_Q_RX1], stat.waitMax[CNL_SCHD_Q_CTRL]);
+        seq_printf(m, "%10s %10s %10s %10s %10s\n", "usec", "tx", "rx0", "rx1", "ctrl");
+        for(i=0; i<CNL_IRQ_LAT_HIST_NUM; i++) {
+            seq_printf(m, "%9u%s %10u %10u %10u %10u\n",
+                       (i == 0) ? 0 : (1U << i),
+                       (i == (CNL_IRQ_LAT_HIST_NUM - 1)) ? "+" : " ",
+                       stat.waitHist[CNL_SCHD_Q_TX][i],
+                       stat.waitHist[CNL_SCHD_Q_RX0][i],
+                       stat.waitHist[CNL_SCHD_Q_RX1][i],
+                       stat.waitHist[CNL_SCHD_Q_CTRL][i]);
+        }
+    }
+
+    return 0;
+
+}
+
+
+static int
+CNL_openSchdStat(struct inode *inode, struct file *file)
+{
+    return single_open(file, CNL_showSchdStat, NULL);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_showDevStat
+ *-----------------------------------------------------------------*/
+/**
+ * show the device statistics of all CNL devices (debugfs).
+ * @param   m : the seq_file.
+ * @param   v : not used.
+ * @return  0 (normally completion)
+ * @note    interrupts are shown only for the bits counted.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNL_showDevStat(struct seq_file *m, void *v)
+{
+
+    S_CNL_DEV_STAT stat;
+    u8             devnum;
+    int            i;
+
+    for(devnum=0; devnum<CNL_DEV_MAX_NUM; devnum++) {
+        if(CNL_getDevStat(devnum, &stat) != SUCCESS) {
+            continue;
+        }
+
+        seq_printf(m, "dev%u: tx %llu bytes %u csdu rx %llu bytes %u csdu\n",
+                   devnum, stat.txBytes, stat.txCsdu, stat.rxBytes, stat.rxCsdu);
+        seq_printf(m, "  request completed %u cancelled %u failed %u qovr %u\n",
+                   stat.reqCompleted, stat.reqCancelled, stat.reqFailed, stat.reqQovr);
+        seq_printf(m, "  cancel lookup %u miss %u probe avg %llu max %u\n",
+                   stat.cancelLookup, stat.cancelMiss,
+                   (stat.cancelLookup) ? div_u64(stat.cancelProbe, stat.cancelLookup) : 0,
+                   stat.cancelProbeMax);
+        seq_printf(m, "  retry crc read %u crc write %u rewind %u tresend %u\n",
+                   CMN_ATOMIC_READ(&stat.crcRetryRead), CMN_ATOMIC_READ(&stat.crcRetryWrite),
+                   stat.rewindRetry, stat.tResendTout);
+        seq_printf(m, "  pmu msec deepsleep %u sleep %u awake %u powersave %u\n",
+                   stat.pmuTime[PMU_DEEP_SLEEP], stat.pmuTime[PMU_SLEEP],
+                   stat.pmuTime[PMU_AWAKE], stat.pmuTime[PMU_POWERSAVE]);
+        for(i=0; i<CNL_INT_BIT_NUM; i++) {
+            if(stat.intCnt[i] != 0) {
+                seq_printf(m, "  int 0x%08x %u\n", (1U << i), stat.intCnt[i]);
+            }
+        }
+    }
+
+    return 0;
+
+}
+
+
+static int
+CNL_openDevStat(struct inode *inode, struct file *file)
+{
+    return single_open(file, CNL_showDevStat, NULL);
+}
+
+
+
 /**
  * Module Initailize/Cleanup functions.
  * called when module installed or rmoved.
@@ -72,7 +331,28 @@
 static int __init
 CNL_initModule(void) 
 {
-    return CNL_init();
+
+    int retval;
+
+    retval = CNL_init();
+    if(retval != 0) {
+        return retval;
+    }
+
+    // statistics are optional, failure is not fatal.
+    g_cnlDebugfsDir = debugfs_create_dir(CNL_DEBUGFS_DIR, NULL);
+    if(IS_ERR_OR_NULL(g_cnlDebugfsDir)) {
+        g_cnlDebugfsDir = NULL;
+        return 0;
+    }
+    debugfs_create_file(CNL_DEBUGFS_IRQLAT, S_IRUGO, g_cnlDebugfsDir,
+                        NULL, &g_cnlIrqStatFops);
+    debugfs_create_file(CNL_DEBUGFS_SCHED, S_IRUGO, g_cnlDebugfsDir,
+                        NULL, &g_cnlSchdStatFops);
+    debugfs_create_file(CNL_DEBUGFS_STATS, S_IRUGO, g_cnlDebugfsDir,
+                        NULL, &g_cnlDevStatFops);
+
+    return 0;
 }
 
 
@@ -89,6 +369,7 @@ CNL_initModule(void)
 static void __exit
 CNL_exitModule(void) 
 {
+    debugfs_remove_recursive(g_cnlDebugfsDir);
     CNL_exit();
     return;
 }
@@ -0,0 +1,68 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cnl_posix.c
+ *
+ *  @brief    user space counterpart of cnl_km.c for POSIX build.
+ *
+ *
+ *  @note     parameters are plain globals, the program may set them
+ *            before CNL_init() instead of module parameters.
+ */
+/*=================================================================*/
+/*-------------------------------------------------------------------
+ * Header section
+ *-----------------------------------------------------------------*/
+#include "cnl.h"
+
+
+/*-------------------------------------------------------------------
+ * Globals
+ *-----------------------------------------------------------------*/
+/**
+ * request queue depths, applied when the device is opened.
+ */
+uint g_cnlTxQueueSize  = CNL_TX_QUEUE_SIZE;
+uint g_cnlRx0QueueSize = CNL_RX_QUEUE0_SIZE;
+uint g_cnlRx1QueueSize = CNL_RX_QUEUE1_SIZE;
+
+/**
+ * adaptive RX polling, not used by the loopback device.
+ */
+uint g_cnlRxPollEnter    = CNL_RX_POLL_ENTER;
+uint g_cnlRxPollBudget   = CNL_RX_POLL_BUDGET;
+uint g_cnlRxPollInterval = CNL_RX_POLL_INTERVAL;
+
+/**
+ * CPU binding of CNL worker threads, applied when the device is allocated.
+ * device n runs on CPU (WorkerCpu + n). negative value means no binding.
+ */
+int g_cnlWorkerCpu = -1;
+
+/**
+ * TX/RX arbitration, same as the module parameters.
+ */
+uint g_cnlArbPolicy    = CNL_ARB_POLICY;
+uint g_cnlArbRxQuantum = CNL_ARB_RX_QUANTUM;
+uint g_cnlArbTxQuantum = CNL_ARB_TX_QUANTUM;
+uint g_cnlPrioProfile1 = CNL_PRIO_PROFILE_1;
+
+/**
+ * the loopback device is always used.
+ */
+uint g_cnlBusSim = 0;
@@ -44,14 +44,13 @@
  *-----------------------------------------------------------------*/
 #define CNL_CANCEL_TOUT_VAL_MS    5000   /* 5000ms */
 
+// a data action stops at the budget after one chunk of ready buffer.
+#define CNL_ARB_OVERRUN_MAX       (CNL_TX_FRAME_MAX * CNL_CSDU_SIZE)
+
 
 /*-------------------------------------------------------------------
  * Structure definition
  *-----------------------------------------------------------------*/
-typedef struct tagS_CNL_CANCEL_TOUT_ARG {
-    S_CNL_DEV      *pCnlDev;
-    S_CNL_CMN_REQ  *pDummy;
-}S_CNL_CANCEL_TOUT_ARG;
 
 
 /*-------------------------------------------------------------------
@@ -91,14 +90,12 @@ static void CNL_getStatsToAction(S_CNL_DEV *, S_CNL_CMN_REQ *, S_CNL_ACTION  *);
 static void CNL_regPassthroughToAction(S_CNL_DEV *, S_CNL_CMN_REQ *, S_CNL_ACTION  *);
 static void CNL_powersaveReqToAction(S_CNL_DEV *, S_CNL_CMN_REQ *, S_CNL_ACTION *);
 
+static void CNL_setArbBudget(S_CNL_DEV *, S_CNL_ACTION *);
 static void CNL_cancelToutCallback(unsigned long);
 
 /*-------------------------------------------------------------------
  * Globals
  *-----------------------------------------------------------------*/
-extern u8 g_rssi;
-
-static S_CNL_CANCEL_TOUT_ARG g_cnlCancelToutArg = {NULL, NULL};
 
 /*-------------------------------------------------------------------
  * Inline function definition
@@ -117,6 +114,7 @@ CNL_initAction(S_CNL_ACTION *pAction)
     pAction->readyLength = 0;
     pAction->status      = 0;
     pAction->extra       = 0;
+    pAction->budget      = 0;
     CMN_LIST_INIT(&pAction->compQueue);
     return;
 }
@@ -625,6 +623,46 @@ CNL_checkTxRequest(S_CNL_DEV    *pCnlDev,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : CNL_setArbBudget
+ *-----------------------------------------------------------------*/
+/**
+ * set the byte budget of RX/TX data actions scheduled in one pass.
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @param  pAction : the pointer to the S_CNL_ACTION list
+ * @return nothing.
+ * @note   each side earns its quantum per pass and pays the bytes
+ *         moved, the deficit is dropped while the other side is idle.
+ *         a side that runs dry is reset to 0 by the task, and the
+ *         deficit never exceeds one quantum and one overrun.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNL_setArbBudget(S_CNL_DEV    *pCnlDev,
+                 S_CNL_ACTION *pAction)
+{
+
+    if((g_cnlArbPolicy       != CNL_ARB_DEFICIT)         ||
+       (pAction[0].type      != CNL_ACTION_RECEIVE_DATA) ||
+       (pAction[1].type      != CNL_ACTION_SEND_DATA)) {
+        pCnlDev->rxDeficit = 0;
+        pCnlDev->txDeficit = 0;
+        return;
+    }
+
+    pCnlDev->rxDeficit = MIN(pCnlDev->rxDeficit + (s32)g_cnlArbRxQuantum,
+                             (s32)g_cnlArbRxQuantum + CNL_ARB_OVERRUN_MAX);
+    pCnlDev->txDeficit = MIN(pCnlDev->txDeficit + (s32)g_cnlArbTxQuantum,
+                             (s32)g_cnlArbTxQuantum + CNL_ARB_OVERRUN_MAX);
+
+    // at least one CSDU to keep both sides moving.
+    pAction[0].budget = MAX(pCnlDev->rxDeficit, CNL_CSDU_SIZE);
+    pAction[1].budget = MAX(pCnlDev->txDeficit, CNL_CSDU_SIZE);
+
+    return;
+}
+
+
 /*-------------------------------------------------------------------
  * Function : CNL_checkSleep
  *-----------------------------------------------------------------*/
@@ -2082,7 +2120,7 @@ CNL_getStatsToAction(S_CNL_DEV     *pCnlDev,
     mainState = CNLSTATE_TO_MAINSTATE(pCnlDev->cnlState);
     if((mainState == CNL_STATE_INITIATOR_CONNECTED) ||
        (mainState == CNL_STATE_RESPONDER_CONNECTED)) {
-        pReq->stats.RSSI = g_rssi;
+        pReq->stats.RSSI = pCnlDev->rssi;
     } else {
         pReq->stats.RSSI = CNL_RSSI_VALUE_MIN;
     }
@@ -2253,7 +2291,21 @@ CNL_addRequest(S_CNL_DEV     *pCnlDev,
 
 {
 
-    T_CMN_ERR retval = SUCCESS;
+    T_CMN_ERR       retval = SUCCESS;
+    S_DATA_REQ_EXT *pExt   = (S_DATA_REQ_EXT *)(&pReq->extData);
+
+    //
+    // stamp the request for wait time statistics,
+    // profile 1 send request is put ahead of profile 0 ones.
+    //
+    CMN_getTimeUs(&pExt->queuedTime);
+    if((pReq->type == CNL_REQ_TYPE_SEND_REQ) &&
+       (pReq->dataReq.profileId == CNL_PROFILE_ID_1) &&
+       (g_cnlPrioProfile1)) {
+        pExt->priority = CNL_PRIO_HIGH;
+    } else {
+        pExt->priority = CNL_PRIO_NORMAL;
+    }
 
     CMN_lockCpu(pCnlDev->mngLockId);
   
@@ -2298,6 +2350,10 @@ CNL_addRequest(S_CNL_DEV     *pCnlDev,
         break;
     }
 
+    if(retval == CNL_ERR_QOVR) {
+        pCnlDev->devStat.reqQovr++;
+    }
+
     CMN_unlockCpu(pCnlDev->mngLockId);
     
     if(retval != SUCCESS) {
@@ -2348,19 +2404,19 @@ CNL_cancelRequest(S_CNL_DEV    *pCnlDev,
     }
     
     // setting alarm timer for cancel request.
-    if (g_cnlCancelToutArg.pCnlDev != NULL) {
+    if (pCnlDev->pCancelDummy != NULL) {
+        CMN_releaseFixedMemPool(pCnlDev->dummyReqMplId, pDummy);
         return ERR_RSVFUNC;
     }
-    g_cnlCancelToutArg.pCnlDev = pCnlDev;
-    g_cnlCancelToutArg.pDummy = pDummy;
-    retval = CMN_createAlarmTim(CNL_CANCEL_TOUT_TIM_ID, 0, NULL, CNL_cancelToutCallback);
+    pCnlDev->pCancelDummy = pDummy;
+    retval = CMN_createAlarmTim(pCnlDev->cancelToutTimId, 0, (void *)pCnlDev, CNL_cancelToutCallback);
     if (retval != SUCCESS) {
         DBG_ERR("CMN_createAlarmTim failed[%d].\n", retval);
     } else {
-        retval = CMN_startAlarmTim(CNL_CANCEL_TOUT_TIM_ID, CNL_CANCEL_TOUT_VAL_MS);
+        retval = CMN_startAlarmTim(pCnlDev->cancelToutTimId, CNL_CANCEL_TOUT_VAL_MS);
         if (retval != SUCCESS) {
             DBG_ERR("CMN_startAlarmTim failed[%d].\n", retval);
-            retval = CMN_deleteAlarmTim(CNL_CANCEL_TOUT_TIM_ID);
+            retval = CMN_deleteAlarmTim(pCnlDev->cancelToutTimId);
             if (retval != SUCCESS) {
                 DBG_ERR("CMN_deleteAlarmTim failed[%d].\n", retval);
             }
@@ -2380,16 +2436,15 @@ CNL_cancelRequest(S_CNL_DEV    *pCnlDev,
     CMN_WAIT(pCnlDev->cancelWaitId);
 
     // stop alarm timer for cancel request.
-    retval = CMN_stopAlarmTim(CNL_CANCEL_TOUT_TIM_ID);
+    retval = CMN_stopAlarmTim(pCnlDev->cancelToutTimId);
     if (retval != SUCCESS) {
         DBG_ERR("CMN_stopAlarmTim failed[%d].\n", retval);
     }
-    retval = CMN_deleteAlarmTim(CNL_CANCEL_TOUT_TIM_ID);
+    retval = CMN_deleteAlarmTim(pCnlDev->cancelToutTimId);
     if (retval != SUCCESS) {
         DBG_ERR("CMN_deleteAlarmTim failed[%d].\n", retval);
     }
-    g_cnlCancelToutArg.pCnlDev = NULL;
-    g_cnlCancelToutArg.pDummy = NULL;
+    pCnlDev->pCancelDummy = NULL;
 
 
     return pCnlDev->cancelStatus;
@@ -2612,7 +2667,8 @@ CNL_clearEvent(S_CNL_DEV          *pCnlDev,
  * @param  *pCnlDev : the pointer to the S_CNL_DEV
  * @param  *pAction : the pointer to the S_CNL_ACTION list
  * @return SUCCESS (normally completion)
- * @note   
+ * @note   while CONNECTED, Action.ReceiveData and Action.SendData
+ *         are scheduled in one list.
  */
 /*-----------------------------------------------------------------*/
 T_CMN_ERR
@@ -2621,12 +2677,16 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
 {
 
     u8  mainState;
+    S_CNL_ACTION    *pTxAction = pAction;
+    S_CNL_SCHD_STAT *pStat     = &pCnlDev->schdStat;
 
     int i;
     for(i=0; i<CNL_ACTION_LIST_NUM; i++) {
         CNL_initAction(&(pAction[i]));
     }
 
+    pStat->passCnt++;
+
 
     //
     // if cancel is called handle it first, and fall through to scheduling.
@@ -2638,6 +2698,7 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
     //
     CNL_checkInitClose(pCnlDev, pAction);
     if(pAction->type != CNL_ACTION_NOP) {
+        pStat->initCloseCnt++;
         goto EXIT;
     }
 
@@ -2646,6 +2707,7 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
     //
     CNL_checkEvent(pCnlDev, pAction);
     if(pAction->type != CNL_ACTION_NOP) {
+        pStat->eventCnt++;
         goto EXIT;
     }
 
@@ -2656,6 +2718,7 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
     if(pCnlDev->procAction == CNL_ACTION_NOP) {
         CNL_checkCtrlRequest(pCnlDev, pAction);
         if(pAction->type != CNL_ACTION_NOP) {
+            pStat->ctrlCnt++;
             goto EXIT;
         }
     }
@@ -2669,7 +2732,12 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
     if((mainState == CNL_STATE_INITIATOR_CONNECTED) ||
        (mainState == CNL_STATE_RESPONDER_CONNECTED)) {
         CNL_checkRxRequest(pCnlDev, pAction);
-        if(pAction->type != CNL_ACTION_NOP) {
+        if(pAction->type == CNL_ACTION_RECEIVE_DATA) {
+            // TX can be scheduled with RX data.
+            pStat->rxCnt++;
+            pTxAction = &pAction[1];
+        } else if(pAction->type != CNL_ACTION_NOP) {
+            pStat->rxCnt++;
             goto EXIT;
         }
     }
@@ -2683,12 +2751,24 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
         (mainState == CNL_STATE_RESPONDER_CONNECTED)) && 
        (pCnlDev->procAction == CNL_ACTION_NOP)) {
 
-        CNL_checkTxRequest(pCnlDev, pAction);
-        if(pAction->type != CNL_ACTION_NOP) {
-            goto EXIT;
+        CNL_checkTxRequest(pCnlDev, pTxAction);
+        if(pTxAction->type != CNL_ACTION_NOP) {
+            pStat->txCnt++;
+            if(pTxAction != pAction) {
+                pStat->batchCnt++;
+            }
         }
     }
 
+    //
+    // share the bus between RX and TX data by deficit of bytes.
+    //
+    CNL_setArbBudget(pCnlDev, pAction);
+
+    if(pAction->type != CNL_ACTION_NOP) {
+        goto EXIT;
+    }
+
 
     //
     // check Sleep 
@@ -2696,14 +2776,19 @@ CNL_getAction(S_CNL_DEV    *pCnlDev,
     //
     if(pCnlDev->procAction == CNL_ACTION_NOP) {
         CNL_checkSleep(pCnlDev, pAction);
+        if(pAction->type != CNL_ACTION_NOP) {
+            pStat->sleepCnt++;
+        }
     }
 
 
 EXIT:
 
+    trace_cnl_get_action(pCnlDev->devnum,
+                         pAction[0].type, pAction[0].readyLength, pAction[0].budget,
+                         pAction[1].type, pAction[1].readyLength, pAction[1].budget);
 
-
-    DBG_INFO("scheduled action is [0x%x].\n",pAction->type);
+    DBG_INFO("scheduled action is [0x%x][0x%x].\n",pAction[0].type, pAction[1].type);
 
     return SUCCESS;
 }
@@ -2713,32 +2798,36 @@ EXIT:
  *-----------------------------------------------------------------*/
 /**
  * CNL cancel timeout callback function.
- * @param   arg     :not used.
+ * @param   arg     :the pointer to the S_CNL_DEV.
  * @return  nothing
- * @note    use g_cnlCancelToutArg 
+ * @note    use pCnlDev->pCancelDummy 
  */
 /*-----------------------------------------------------------------*/
 static void CNL_cancelToutCallback(unsigned long arg)
 {
 
+    S_CNL_DEV     *pCnlDev = (S_CNL_DEV *)arg;
+    S_CNL_CMN_REQ *pDummy;
+
     DBG_INFO("CNL_cancelToutCallback Called.\n");
 
-    if ((g_cnlCancelToutArg.pCnlDev == NULL) || 
-        (g_cnlCancelToutArg.pDummy == NULL)){
+    if (pCnlDev == NULL) {
         return;
     }
 
-    CMN_lockCpu(g_cnlCancelToutArg.pCnlDev->mngLockId);
-    if (CMN_IS_IN_LIST(&(g_cnlCancelToutArg.pCnlDev->cancelQueue), g_cnlCancelToutArg.pDummy, S_CNL_CMN_REQ, list)) {
-        CMN_LIST_REMOVE(&(g_cnlCancelToutArg.pCnlDev->cancelQueue), g_cnlCancelToutArg.pDummy, S_CNL_CMN_REQ, list);
-        g_cnlCancelToutArg.pCnlDev->cancelStatus = ERR_TIMEOUT;
-        CMN_releaseFixedMemPool(g_cnlCancelToutArg.pCnlDev->dummyReqMplId, g_cnlCancelToutArg.pDummy);
-        CMN_unlockCpu(g_cnlCancelToutArg.pCnlDev->mngLockId);
+    CMN_lockCpu(pCnlDev->mngLockId);
+    pDummy = pCnlDev->pCancelDummy;
+    if ((pDummy != NULL) &&
+        CMN_IS_IN_LIST(&(pCnlDev->cancelQueue), pDummy, S_CNL_CMN_REQ, list)) {
+        CMN_LIST_REMOVE(&(pCnlDev->cancelQueue), pDummy, S_CNL_CMN_REQ, list);
+        pCnlDev->cancelStatus = ERR_TIMEOUT;
+        CMN_releaseFixedMemPool(pCnlDev->dummyReqMplId, pDummy);
+        CMN_unlockCpu(pCnlDev->mngLockId);
 
         // release WAIT
-        CMN_REL_WAIT(g_cnlCancelToutArg.pCnlDev->cancelWaitId);
+        CMN_REL_WAIT(pCnlDev->cancelWaitId);
     } else {
-        CMN_unlockCpu(g_cnlCancelToutArg.pCnlDev->mngLockId);
+        CMN_unlockCpu(pCnlDev->mngLockId);
     }
 
     return;
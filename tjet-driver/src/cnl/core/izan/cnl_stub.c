@@ -0,0 +1,1322 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cnl_stub.c
+ *
+ *  @brief    CNL device interface for user space build.
+ *            two loopback devices are connected back to back, data and
+ *            management frame written by one are received by the other.
+ *
+ *
+ *  @note     only the event sequence of IZAN is emulated, timers of the
+ *            device(T_Connect, T_Accept, T_Keepalive ...) are not expired.
+ */
+/*=================================================================*/
+/*-------------------------------------------------------------------
+ * Header section
+ *-----------------------------------------------------------------*/
+#include "cmn_type.h"
+#include "cmn_err.h"
+#include "cmn_dbg.h"
+
+#include "oscmn.h"
+
+#include "cnl_type.h"
+#include "cnl_err.h"
+#include "cnl_if.h"
+#include "cnl.h"
+#include "izan_cnf.h"
+
+
+/*-------------------------------------------------------------------
+ * Macro definition
+ *-----------------------------------------------------------------*/
+/**
+ * @brief the number of loopback devices.
+ */
+#define STUB_DEV_NUM             2
+
+/**
+ * @brief the number of RX CSDU slots per device.
+ */
+#define STUB_RX_CSDU_NUM         IZAN_RX_CSDU_NUM
+
+
+/*-------------------------------------------------------------------
+ * Structure definition
+ *-----------------------------------------------------------------*/
+/**
+ * @brief received CSDU.
+ */
+typedef struct tagS_STUB_CSDU {
+    u8                  profileId;
+    u8                  fragment;
+    u32                 length;
+    u8                  data[CNL_CSDU_SIZE];
+} S_STUB_CSDU;
+
+
+/**
+ * @brief loopback device.
+ */
+typedef struct tagS_STUB_PORT {
+    S_CNL_DEV          *pCnlDev;
+    struct tagS_STUB_PORT *pPeer;
+
+    u8                  devUID[CNL_UID_SIZE];  // used when INIT gives no UID, like eFuse.
+    u8                  ownUID[CNL_UID_SIZE];
+    u8                  open;
+    u8                  waitConnect;
+    u8                  creqPending;     // C-Req is kept until waitConnect.
+
+    // received management frame body.
+    u16                 rxLicc;
+    u8                  rxUID[CNL_UID_SIZE];
+    u8                  rxLiccInfo[CNL_LICC_INFO_SIZE];
+
+    // RX CSDU ring.
+    S_STUB_CSDU        *pRxCsdu;
+    u8                  rxHead;
+    u8                  rxCnt;
+    u32                 rxPos;           // read position of head CSDU.
+} S_STUB_PORT;
+
+
+/*-------------------------------------------------------------------
+ * Prototypes
+ *-----------------------------------------------------------------*/
+// device interface function
+static T_CNL_ERR STUB_getDeviceParam(S_CNL_DEV *, S_CNL_DEVICE_PARAM *);
+static T_CNL_ERR STUB_init(S_CNL_DEV *);
+static T_CNL_ERR STUB_close(S_CNL_DEV *);
+static T_CNL_ERR STUB_wake(S_CNL_DEV *);
+static T_CNL_ERR STUB_sleep(S_CNL_DEV *);
+static T_CNL_ERR STUB_sendMngFrame(S_CNL_DEV *, u16, void *, void *);
+static T_CNL_ERR STUB_sendData(S_CNL_DEV *, u8, u8, u32, void *);
+static T_CNL_ERR STUB_sendDataMulti(S_CNL_DEV *, S_CNL_TX_FRAME *, u8, u8 *);
+static T_CNL_ERR STUB_sendDataIntUnmask(S_CNL_DEV *);
+static T_CNL_ERR STUB_readReadyTxBuffer(S_CNL_DEV *, u32 *);
+static T_CNL_ERR STUB_receiveData(S_CNL_DEV *, u8, u8 *, u32 *, void *);
+static T_CNL_ERR STUB_receiveDataIntUnmask(S_CNL_DEV *);
+static T_CNL_ERR STUB_readReadyRxBuffer(S_CNL_DEV *, u32 *, u8);
+static T_CNL_ERR STUB_readReadyPid(S_CNL_DEV *, u8 *);
+static T_CNL_ERR STUB_readReadyBuffer(S_CNL_DEV *, u8, u32 *);
+static T_CNL_ERR STUB_readMngBody(S_CNL_DEV *, u16 *, void *, void *);
+static T_CNL_ERR STUB_changeState(S_CNL_DEV *, T_CNL_STATE, T_CNL_STATE);
+static T_CNL_ERR STUB_waitConnect(S_CNL_DEV *);
+static T_CNL_ERR STUB_cancelWaitConnect(S_CNL_DEV *);
+static T_CNL_ERR STUB_getStats(S_CNL_DEV *, S_CNL_STATS *);
+static T_CNL_ERR STUB_regPassthrough(S_CNL_DEV *, S_CNL_REG_PASSTHROUGH *);
+static void      STUB_releaseDeviceData(S_CNL_DEV *);
+
+static int       STUB_probe(S_STUB_PORT *);
+static int       STUB_remove(S_STUB_PORT *);
+
+
+/*-------------------------------------------------------------------
+ * Globals
+ *-----------------------------------------------------------------*/
+// device interface function
+static S_CNL_DEVICE_OPS g_cnlDeviceOps = {
+    .pGetDeviceParam    = STUB_getDeviceParam,
+    .pInit              = STUB_init,
+    .pClose             = STUB_close,
+    .pWake              = STUB_wake,
+    .pSleep             = STUB_sleep,
+    .pSendMngFrame      = STUB_sendMngFrame,
+    .pSendData          = STUB_sendData,
+    .pSendDataMulti     = STUB_sendDataMulti,
+    .pSendDataIntUnmask = STUB_sendDataIntUnmask,
+    .pReadReadyTxBuffer = STUB_readReadyTxBuffer,
+    .pReceiveData       = STUB_receiveData,
+    .pReceiveDataIntUnmask = STUB_receiveDataIntUnmask,
+    .pReadReadyRxBuffer = STUB_readReadyRxBuffer,
+
+    // call from scheduler or statemachine functions.
+    .pReadReadyPid      = STUB_readReadyPid,
+    .pReadReadyBuffer   = STUB_readReadyBuffer,
+    .pReadMngBody       = STUB_readMngBody,
+    .pChangeState       = STUB_changeState,
+
+    // 
+    .pWaitConnect       = STUB_waitConnect,
+    .pCancelWaitConnect = STUB_cancelWaitConnect,
+    .pGetStats          = STUB_getStats,
+    .pRegPassthrough    = STUB_regPassthrough,
+
+    // 
+    .pReleaseDeviceData = STUB_releaseDeviceData,
+
+};
+
+static S_STUB_PORT g_stubPort[STUB_DEV_NUM];
+
+// one lock for both devices, as a frame is written to the peer.
+static u8          g_stubLockId = CNL_INT_MTX_ID;
+
+
+/*-------------------------------------------------------------------
+ * Inline functions
+ *-----------------------------------------------------------------*/
+static inline S_STUB_PORT *
+STUB_cnlDevToPort(S_CNL_DEV *pCnlDev)
+{
+    return (S_STUB_PORT *)pCnlDev->pDev;
+}
+
+
+static inline void
+STUB_addEvent(S_CNL_DEV *pCnlDev,
+              u32        type,
+              u32        compReq,
+              u16        recvdLicc)
+{
+    S_CNL_DEVICE_EVENT event;
+
+    CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
+    event.type      = type;
+    event.compReq   = compReq;
+    event.recvdLicc = recvdLicc;
+    CNL_addEvent(pCnlDev, &event);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readyRxLength
+ *-----------------------------------------------------------------*/
+/**
+ * calculate continuous RX data length.
+ * @param  pPort      : the pointer to the S_STUB_PORT
+ * @param  pFragment  : fragment of terminal CSDU(OUT)
+ * @return length of same PID CSDUs up to the not fragmented one.
+ * @note   assumed to call with holding stub lock.
+ */
+/*-----------------------------------------------------------------*/
+static u32
+STUB_readyRxLength(S_STUB_PORT *pPort,
+                   u8          *pFragment)
+{
+
+    S_STUB_CSDU *pCsdu;
+    u32          remain = 0;
+    u8           pid;
+    u8           i;
+
+    *pFragment = CNL_NOT_FRAGMENTED_DATA;
+    if(pPort->rxCnt == 0) {
+        return 0;
+    }
+
+    pid = pPort->pRxCsdu[pPort->rxHead].profileId;
+    for(i=0; i<pPort->rxCnt; i++) {
+        pCsdu = &pPort->pRxCsdu[(pPort->rxHead + i) % STUB_RX_CSDU_NUM];
+        if(pCsdu->profileId != pid) {
+            // different PID data. do not add length.
+            break;
+        }
+        *pFragment = pCsdu->fragment;
+        remain    += pCsdu->length;
+        if(pCsdu->fragment == CNL_NOT_FRAGMENTED_DATA) {
+            // terminal data of a data chunk.
+            break;
+        }
+    }
+
+    return remain - pPort->rxPos;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_flushRx
+ *-----------------------------------------------------------------*/
+/**
+ * discard all received data and management frame.
+ * @param  pPort : the pointer to the S_STUB_PORT
+ * @return nothing.
+ * @note   assumed to call with holding stub lock.
+ *         C-Req is kept, the peer repeats it until it stops connecting.
+ */
+/*-----------------------------------------------------------------*/
+static void
+STUB_flushRx(S_STUB_PORT *pPort)
+{
+
+    pPort->rxHead      = 0;
+    pPort->rxCnt       = 0;
+    pPort->rxPos       = 0;
+    if(!pPort->creqPending) {
+        pPort->rxLicc  = 0;
+    }
+
+    return;
+}
+
+
+/*=================================================================*/
+/* Driver registration                                             */
+/*=================================================================*/
+/*-------------------------------------------------------------------
+ * Function : STUB_probe
+ *-----------------------------------------------------------------*/
+/**
+ * setup a loopback device and register it to CNL.
+ * @param  pPort : the pointer to the S_STUB_PORT
+ * @return 0  (normally completion)
+ * @return -1 (failed dureing probe sequence)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static int
+STUB_probe(S_STUB_PORT *pPort)
+{
+
+    T_CMN_ERR  retval;
+    S_CNL_DEV *pCnlDev;
+    void      *pMem;
+
+    //
+    // allocate and set S_CNL_DEV
+    //
+    pCnlDev = CNL_allocDevice();
+    if(pCnlDev == NULL) {
+        return -1;
+    }
+
+    //
+    // set device dependent data and function.
+    //
+    pCnlDev->pDev       = (void *)pPort;
+    pCnlDev->pDeviceOps = &g_cnlDeviceOps;
+
+    retval = CMN_allocMem(&pMem, sizeof(S_STUB_CSDU) * STUB_RX_CSDU_NUM);
+    if(retval != SUCCESS) {
+        DBG_ERR("allocate RX CSDU failed[%d].\n", retval);
+        // RX CSDU is checked in releaseDeviceData.
+        pPort->pRxCsdu = NULL;
+        CNL_releaseDevice(pCnlDev);
+        return -1;
+    }
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    pPort->pRxCsdu     = (S_STUB_CSDU *)pMem;
+    pPort->open        = FALSE;
+    pPort->waitConnect = FALSE;
+    pPort->creqPending = FALSE;
+    STUB_flushRx(pPort);
+    pPort->pCnlDev     = pCnlDev;
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    retval = CNL_registerDevice(pCnlDev);
+    if(retval != SUCCESS) {
+        DBG_ERR("register device failed.\n");
+        CNL_releaseDevice(pCnlDev);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_remove
+ *-----------------------------------------------------------------*/
+/**
+ * unregister a loopback device from CNL.
+ * @param  pPort : the pointer to the S_STUB_PORT
+ * @return 0  (normally completion)
+ * @return -1 (failed during remove sequence)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static int
+STUB_remove(S_STUB_PORT *pPort)
+{
+
+    S_CNL_DEV *pCnlDev;
+
+    pCnlDev = CNL_devToCnlDev((void *)pPort);
+    if(pCnlDev == NULL) {
+        DBG_ERR("not found CNL device related device.\n");
+        return -1;
+    }
+
+    CNL_unregisterDevice(pCnlDev);
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_releaseDeviceData
+ *-----------------------------------------------------------------*/
+/**
+ * device data field cleanup function
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @return nothing.
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static void
+STUB_releaseDeviceData(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT *pPort;
+    void        *pMem;
+
+    pPort = STUB_cnlDevToPort(pCnlDev);
+
+    // peer does not write to this device any more.
+    CMN_LOCK_MUTEX(g_stubLockId);
+    pMem           = (void *)pPort->pRxCsdu;
+    pPort->pRxCsdu = NULL;
+    pPort->pCnlDev = NULL;
+    pPort->open    = FALSE;
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    if(pMem != NULL) {
+        CMN_releaseMem(pMem);
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_registerDriver
+ *-----------------------------------------------------------------*/
+/**
+ * register loopback devices to CNL.
+ * @param  nothing.
+ * @return SUCCESS    (normally completion)
+ * @return ERR_SYSTEM (register failed)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_registerDriver() 
+{
+
+    T_CMN_ERR retval;
+    u8        i;
+
+    retval = CMN_INIT_MUTEX(g_stubLockId);
+    if(retval != SUCCESS) {
+        DBG_ERR("create stub mutex object failed[%d].\n", retval);
+        return ERR_SYSTEM;
+    }
+
+    for(i=0; i<STUB_DEV_NUM; i++) {
+        CMN_MEMSET(&g_stubPort[i], 0x00, sizeof(S_STUB_PORT));
+        g_stubPort[i].pPeer = &g_stubPort[(i + 1) % STUB_DEV_NUM];
+        g_stubPort[i].devUID[CNL_UID_SIZE - 1] = i + 1;
+        CMN_MEMCPY(g_stubPort[i].ownUID, g_stubPort[i].devUID, CNL_UID_SIZE);
+    }
+
+    for(i=0; i<STUB_DEV_NUM; i++) {
+        if(STUB_probe(&g_stubPort[i]) != 0) {
+            DBG_ERR("register loopback device[%u] failed.\n", i);
+            goto EXIT;
+        }
+    }
+
+    return SUCCESS;
+
+EXIT:
+    while(i-- > 0) {
+        STUB_remove(&g_stubPort[i]);
+    }
+    CMN_deleteSem(g_stubLockId);
+
+    return ERR_SYSTEM;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_unregisterDriver
+ *-----------------------------------------------------------------*/
+/**
+ * unregister loopback devices from CNL.
+ * @return SUCCESS    (normally completion)
+ * @return ERR_SYSTEM (unregister failed)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CNL_unregisterDriver() 
+{
+
+    T_CMN_ERR retval = SUCCESS;
+    u8        i;
+
+    for(i=0; i<STUB_DEV_NUM; i++) {
+        if(STUB_remove(&g_stubPort[i]) != 0) {
+            retval = ERR_SYSTEM;
+        }
+    }
+
+    CMN_deleteSem(g_stubLockId);
+
+    return retval;
+}
+
+
+/*=================================================================*/
+/* External Device Operations                                      */
+/*=================================================================*/
+/*-------------------------------------------------------------------
+ * Function : STUB_getDeviceParam
+ *-----------------------------------------------------------------*/
+/**
+ * get device dependent CNL parameters.
+ * @param  pCnlDev      : the pointer to the S_CNL_DEV
+ * @param  pDeviceParam : the poniter to the S_CNL_DEVICE_PARAM
+ * @return SUCCESS (normally completion)
+ * @note   same as IZAN.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR 
+STUB_getDeviceParam(S_CNL_DEV          *pCnlDev,
+                    S_CNL_DEVICE_PARAM *pDeviceParam)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_MEMCPY(pDeviceParam->ownUID, pPort->ownUID, CNL_UID_SIZE);
+    pDeviceParam->txCsduNum   = IZAN_TX_CSDU_NUM;
+    pDeviceParam->rxCsduNum   = IZAN_RX_CSDU_NUM;
+    pDeviceParam->tConnect    = IZAN_TCONNECT_TIMER;
+    pDeviceParam->tAccept     = IZAN_TACCEPT_TIMER;
+    pDeviceParam->tRetry      = IZAN_TRETRY_TIMER;
+    pDeviceParam->tResend     = IZAN_TRESEND_TIMER;
+    pDeviceParam->tKeepAlive  = IZAN_TKEEPALIVE_TIMER;
+    pDeviceParam->tas         = IZAN_TAS_TIMER;
+    pDeviceParam->tds         = IZAN_SRCHDMT_TIMER;
+    pDeviceParam->tac         = IZAN_TAC_TIMER;
+    pDeviceParam->tdc         = IZAN_HBNTDMT_TIMER;
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_init
+ *-----------------------------------------------------------------*/
+/**
+ * initialize loopback device.
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return CNL_SUCCESS (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_init(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+    u8           i;
+
+    // use the requested UID, all zero means the device UID.
+    for(i=0; i<CNL_UID_SIZE; i++) {
+        if(pCnlDev->deviceParam.ownUID[i] != 0x00) {
+            break;
+        }
+    }
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    if(i == CNL_UID_SIZE) {
+        CMN_MEMCPY(pPort->ownUID, pPort->devUID, CNL_UID_SIZE);
+        CMN_MEMCPY(pCnlDev->deviceParam.ownUID, pPort->devUID, CNL_UID_SIZE);
+    } else {
+        CMN_MEMCPY(pPort->ownUID, pCnlDev->deviceParam.ownUID, CNL_UID_SIZE);
+    }
+    pPort->open        = TRUE;
+    pPort->waitConnect = FALSE;
+    STUB_flushRx(pPort);
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    STUB_addEvent(pCnlDev, CNL_EVENT_COMP_REQUEST, CNL_COMP_INIT, 0);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_close
+ *-----------------------------------------------------------------*/
+/**
+ * close loopback device.
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return CNL_SUCCESS (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_close(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    pPort->open        = FALSE;
+    pPort->waitConnect = FALSE;
+    STUB_flushRx(pPort);
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    STUB_addEvent(pCnlDev, CNL_EVENT_COMP_REQUEST, CNL_COMP_CLOSE, 0);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_wake
+ *-----------------------------------------------------------------*/
+/**
+ * wake loopback device.(powersave -> awake)
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return CNL_SUCCESS (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_wake(S_CNL_DEV *pCnlDev)
+{
+
+    STUB_addEvent(pCnlDev, CNL_EVENT_COMP_REQUEST, CNL_COMP_WAKE, 0);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_sleep
+ *-----------------------------------------------------------------*/
+/**
+ * sleep loopback device.(awake -> powersave)
+ * @param  pCnlDev : the pointer to the CNL device.
+ * @return CNL_SUCCESS (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_sleep(S_CNL_DEV *pCnlDev)
+{
+
+    STUB_addEvent(pCnlDev, CNL_EVENT_COMP_REQUEST, CNL_COMP_SLEEP, 0);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_sendMngFrame
+ *-----------------------------------------------------------------*/
+/**
+ * send management frame to the peer.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  licc       : which LiCC(extended LiCC type)
+ * @param  pTargetUID : target UID
+ * @param  pLiccInfo  : LiCC information
+ * @return CNL_SUCCESS     (normally completion)
+ * @return CNL_ERR_BADPARM (invalid parameter)
+ * @note   completion of the sender and reception of the peer are
+ *         notified in the same order as IZAN interrupts.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_sendMngFrame(S_CNL_DEV *pCnlDev,
+                  u16        licc,
+                  void      *pTargetUID,
+                  void      *pLiccInfo)
+{
+
+    S_STUB_PORT *pPort;
+    S_STUB_PORT *pPeer;
+    u32          compReq;
+    u8           needBody;
+
+    pPort = STUB_cnlDevToPort(pCnlDev);
+    pPeer = pPort->pPeer;
+
+    switch(licc) {
+    case CNL_EXT_LICC_C_RLS :
+        compReq  = CNL_COMP_RELEASE_REQ;
+        needBody = TRUE;
+        break;
+    case CNL_EXT_LICC_C_REQ :
+        compReq  = CNL_COMP_CONNECT_REQ;
+        needBody = TRUE;
+        break;
+    case CNL_EXT_LICC_C_ACC :
+        compReq  = CNL_COMP_ACCEPT_REQ;
+        needBody = TRUE;
+        break;
+    case CNL_EXT_LICC_ACK_FOR_C_ACC :
+        compReq  = CNL_COMP_ACCEPT_RES;
+        needBody = FALSE;
+        break;
+    case CNL_EXT_LICC_C_SLEEP :
+        compReq  = CNL_COMP_SLEEP_REQ;
+        needBody = TRUE;
+        break;
+    case CNL_EXT_LICC_C_WAKE :
+        compReq  = CNL_COMP_WAKE_REQ;
+        needBody = FALSE;
+        break;
+    case CNL_EXT_LICC_C_PROBE :
+    default :
+        DBG_ASSERT(0);
+        return CNL_ERR_BADPARM;
+    }
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+
+    //
+    // C-Req to the other UID is not received by the peer.
+    //
+    if((licc == CNL_EXT_LICC_C_REQ) && (pTargetUID != NULL) &&
+       (CMN_MEMCMP(pTargetUID, pPeer->ownUID, CNL_UID_SIZE) != 0)) {
+        goto COMPLETE;
+    }
+
+    if(needBody) {
+        pPeer->rxLicc = licc;
+        CMN_MEMCPY(pPeer->rxUID, pPort->ownUID, CNL_UID_SIZE);
+        if(pLiccInfo != NULL) {
+            CMN_MEMCPY(pPeer->rxLiccInfo, pLiccInfo, CNL_LICC_INFO_SIZE);
+        } else {
+            CMN_MEMSET(pPeer->rxLiccInfo, 0x00, CNL_LICC_INFO_SIZE);
+        }
+    }
+
+    if(licc == CNL_EXT_LICC_C_REQ) {
+        //
+        // C-Req is repeated until the peer waits connect.
+        //
+        if(!pPeer->waitConnect) {
+            pPeer->creqPending = TRUE;
+            goto COMPLETE;
+        }
+        pPeer->waitConnect = FALSE;
+    } else if(licc == CNL_EXT_LICC_C_RLS) {
+        pPeer->creqPending = FALSE;
+    }
+
+    if(pPeer->open) {
+        STUB_addEvent(pPeer->pCnlDev, CNL_EVENT_RECVD_MNG_FRAME, 0, licc);
+    }
+
+COMPLETE:
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    STUB_addEvent(pCnlDev, CNL_EVENT_COMP_REQUEST, compReq, 0);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_sendData
+ *-----------------------------------------------------------------*/
+/**
+ * send data frame.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  profileId  : profileId (0 or 1)
+ * @param  fragment   : more fragment or not
+ * @param  length     : data length to be write
+ * @param  pData      : pointer to the data buffer.
+ * @return CNL_SUCCESS      (normally completion)
+ * @return CNL_ERR_BADPARM  (frame exceeds TX buffer)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_sendData(S_CNL_DEV *pCnlDev,
+              u8         profileId,
+              u8         fragment,
+              u32        length,
+              void      *pData)
+{
+
+    S_CNL_TX_FRAME frame;
+    u8             sentNum;
+
+    frame.profileId = profileId;
+    frame.fragment  = fragment;
+    frame.length    = length;
+    frame.pData     = pData;
+
+    return STUB_sendDataMulti(pCnlDev, &frame, 1, &sentNum);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_sendDataMulti
+ *-----------------------------------------------------------------*/
+/**
+ * send data frames, they are stored in RX CSDU of the peer.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pFrame     : the pointer to the S_CNL_TX_FRAME array.
+ * @param  num        : number of frames.
+ * @param  pSentNum   : number of frames written.(OUT)
+ * @return CNL_SUCCESS      (normally completion)
+ * @return CNL_ERR_BADPARM  (frames exceed TX buffer)
+ * @note   TX buffer is the free RX CSDU of the peer, it is returned
+ *         as TX completion when the peer reads the data.
+ *         frames are checked before the copy, so all or none is written.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_sendDataMulti(S_CNL_DEV      *pCnlDev,
+                   S_CNL_TX_FRAME *pFrame,
+                   u8              num,
+                   u8             *pSentNum)
+{
+
+    T_CNL_ERR    retval = CNL_SUCCESS;
+    S_STUB_PORT *pPeer;
+    S_STUB_CSDU *pCsdu;
+    u8          *pData;
+    u32          rest;
+    u32          cnt;
+    u8           i;
+
+    pPeer = STUB_cnlDevToPort(pCnlDev)->pPeer;
+
+    DBG_ASSERT(num > 0);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+
+    if(pPeer->pRxCsdu == NULL) {
+        // peer is already released, data is lost.
+        goto COMPLETE;
+    }
+
+    cnt = 0;
+    for(i=0; i<num; i++) {
+        DBG_ASSERT(pFrame[i].pData != NULL);
+        cnt += LENGTH_TO_CSDU(pFrame[i].length);
+        if((pFrame[i].length == 0) ||
+           (pPeer->rxCnt + cnt > STUB_RX_CSDU_NUM)) {
+            DBG_ERR("SendData : frames exceed TX banks[%u].\n", i);
+            retval = CNL_ERR_BADPARM;
+            goto COMPLETE;
+        }
+    }
+
+    //
+    // divide each frame to CSDUs.
+    //
+    for(i=0; i<num; i++) {
+        pData = (u8 *)pFrame[i].pData;
+        rest  = pFrame[i].length;
+        while(rest > 0) {
+            pCsdu = &pPeer->pRxCsdu[(pPeer->rxHead + pPeer->rxCnt) % STUB_RX_CSDU_NUM];
+            pCsdu->profileId = pFrame[i].profileId;
+            pCsdu->length    = MIN(rest, CNL_CSDU_SIZE);
+            pCsdu->fragment  = (rest > CNL_CSDU_SIZE) ? \
+                CNL_FRAGMENTED_DATA : pFrame[i].fragment;
+            CMN_MEMCPY(pCsdu->data, pData, pCsdu->length);
+
+            pData += pCsdu->length;
+            rest  -= pCsdu->length;
+            pPeer->rxCnt++;
+        }
+    }
+
+    if(pPeer->open) {
+        STUB_addEvent(pPeer->pCnlDev, CNL_EVENT_RX_READY, 0, 0);
+    }
+
+COMPLETE:
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    *pSentNum = (retval == CNL_SUCCESS) ? num : 0;
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_sendDataIntUnmask
+ *-----------------------------------------------------------------*/
+/**
+ * enable send interrupt.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   TX ready is notified at once if TX buffer is left,
+ *         else when the peer reads the data.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_sendDataIntUnmask(S_CNL_DEV *pCnlDev)
+{
+
+    u32 length;
+
+    STUB_readReadyTxBuffer(pCnlDev, &length);
+    if(length > 0) {
+        STUB_addEvent(pCnlDev, CNL_EVENT_TX_READY, 0, 0);
+    }
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_receiveData.
+ *-----------------------------------------------------------------*/
+/**
+ * receive data frame.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  profileId  : profileId (0 or 1) (not effect)
+ * @param  pFragment  : more fragment or not(OUT)
+ * @param  pLength    : pointer to the data buffer length.(IN/OUT)
+ * @param  pData      : pointer to the data buffer.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_receiveData(S_CNL_DEV *pCnlDev,
+                 u8         profileId,
+                 u8        *pFragment,
+                 u32       *pLength,
+                 void      *pData)
+{
+
+    S_STUB_PORT *pPort;
+    S_STUB_PORT *pPeer;
+    S_STUB_CSDU *pCsdu;
+    u8          *pDst;
+    u32          length, remain, copy;
+    u8           frag;
+    u8           freed = 0;
+
+    pPort = STUB_cnlDevToPort(pCnlDev);
+    pPeer = pPort->pPeer;
+
+    DBG_ASSERT(pData != NULL);
+    DBG_ASSERT(*pLength > 0);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+
+    remain = STUB_readyRxLength(pPort, &frag);
+
+    //
+    // compare SW buffer size and remained data length.
+    //
+    if(*pLength < remain) {
+        // SW buffer is smaller than remained data. force FRAGMENTED.
+        length = *pLength;
+        frag   = CNL_FRAGMENTED_DATA;
+    } else {
+        // SW buffer is enough to read remained data.
+        length = remain;
+    }
+
+    *pLength   = length;
+    *pFragment = frag;
+
+    //
+    // copy data, free the CSDU which is read to the end.
+    //
+    pDst = (u8 *)pData;
+    while(length > 0) {
+        pCsdu = &pPort->pRxCsdu[pPort->rxHead];
+        copy  = MIN(length, pCsdu->length - pPort->rxPos);
+        CMN_MEMCPY(pDst, &pCsdu->data[pPort->rxPos], copy);
+
+        pDst         += copy;
+        length       -= copy;
+        pPort->rxPos += copy;
+        if(pPort->rxPos == pCsdu->length) {
+            pPort->rxHead = (pPort->rxHead + 1) % STUB_RX_CSDU_NUM;
+            pPort->rxCnt--;
+            pPort->rxPos  = 0;
+            freed++;
+        }
+    }
+
+    // TX buffer of the peer is freed.
+    if((freed > 0) && pPeer->open) {
+        STUB_addEvent(pPeer->pCnlDev, CNL_EVENT_TX_COMP | CNL_EVENT_TX_READY, 0, 0);
+    }
+
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_receiveDataIntUnmask.
+ *-----------------------------------------------------------------*/
+/**
+ * enable receive interrupt.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_receiveDataIntUnmask(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT        *pPort;
+    S_CNL_DEVICE_EVENT  event;
+    u8                  rxCnt;
+
+    pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    rxCnt = pPort->rxCnt;
+
+    CMN_MEMSET(&event, 0x00, sizeof(S_CNL_DEVICE_EVENT));
+    event.type = CNL_EVENT_RX_READY;
+    if(rxCnt > 0) {
+        CNL_addEvent(pCnlDev, &event);
+    } else {
+        // next data is notified by STUB_sendDataMulti of the peer.
+        CNL_clearEvent(pCnlDev, &event);
+    }
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readReadyPid
+ *-----------------------------------------------------------------*/
+/**
+ * check which ProfileID's data is ready.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pProfileId : which profileId head of stored CSDU.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_readReadyPid(S_CNL_DEV *pCnlDev, 
+                  u8        *pProfileId)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    *pProfileId = (pPort->rxCnt > 0) ? \
+        pPort->pRxCsdu[pPort->rxHead].profileId : CNL_PROFILE_ID_0;
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readReadyBuffer
+ *-----------------------------------------------------------------*/
+/**
+ * read ready buffer length.
+ * TX : number of free RX CSDU of the peer * CSDU_SIZE.
+ * RX : length of CSDU same PID - position of RX head CSDU.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  which      : which CSDU (CNL_TX_CSDU or CNL_RX_CSDU)
+ * @param  pLength    : ready buffer length.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note 
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_readReadyBuffer(S_CNL_DEV *pCnlDev, 
+                     u8         which,
+                     u32       *pLength)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+    u8           frag;
+
+    if(which == CNL_TX_CSDU) {
+        return STUB_readReadyTxBuffer(pCnlDev, pLength);
+    }
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    *pLength = STUB_readyRxLength(pPort, &frag);
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readReadyTxBuffer
+ *-----------------------------------------------------------------*/
+/**
+ * read ready TX buffer length.
+ * TX : number of free RX CSDU of the peer * CSDU_SIZE.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pLength    : ready buffer length.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_readReadyTxBuffer(S_CNL_DEV *pCnlDev,
+                       u32       *pLength)
+{
+
+    S_STUB_PORT *pPeer = STUB_cnlDevToPort(pCnlDev)->pPeer;
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    *pLength = (u32)((STUB_RX_CSDU_NUM - pPeer->rxCnt) * CNL_CSDU_SIZE);
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readReadyRxBuffer
+ *-----------------------------------------------------------------*/
+/**
+ * read ready RX buffer length.
+ * RX : length of CSDU same PID - position of RX head CSDU.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pLength    : ready buffer length.
+ * @param  pid        : profile id.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note 
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_readReadyRxBuffer(S_CNL_DEV *pCnlDev, 
+                       u32       *pLength, 
+                       u8         pid)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+    u8           frag;
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    if((pPort->rxCnt == 0) ||
+       (pPort->pRxCsdu[pPort->rxHead].profileId != pid)) {
+        *pLength = 0;
+    } else {
+        *pLength = STUB_readyRxLength(pPort, &frag);
+    }
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_readMngBody
+ *-----------------------------------------------------------------*/
+/**
+ * read management frame data body.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @param  pLicc      : which LiCC(extended LiCC type)
+ * @param  pTargetUID : the pointer to the target UID.
+ * @param  pLiccInfo  : the pointer to the liccInfo.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_readMngBody(S_CNL_DEV *pCnlDev, 
+                 u16       *pLicc,
+                 void      *pTargetUID,
+                 void      *pLiccInfo)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    DBG_ASSERT(*pLicc != 0);
+
+    switch(*pLicc) {
+    case CNL_EXT_LICC_C_RLS :
+    case CNL_EXT_LICC_C_REQ :
+    case CNL_EXT_LICC_C_ACC :
+    case CNL_EXT_LICC_C_SLEEP :
+        break;
+    default :
+        // do nothing for C_WAKE/C_PROBE
+        return CNL_SUCCESS;
+    }
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    DBG_ASSERT(pPort->rxLicc == *pLicc);
+    CMN_MEMCPY(pTargetUID, pPort->rxUID, CNL_UID_SIZE);
+    CMN_MEMCPY(pLiccInfo, pPort->rxLiccInfo, CNL_LICC_INFO_SIZE);
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_changeState
+ *-----------------------------------------------------------------*/
+/**
+ * indicates state change to device
+ * @param  pCnlDev   : the pointer to the S_CNL_DEV
+ * @param  prevState : the Current CNL state.
+ * @param  newState  : the New CNL state to be changed.
+ * @return CNL_SUCCESS     (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_changeState(S_CNL_DEV   *pCnlDev,
+                 T_CNL_STATE  prevState,
+                 T_CNL_STATE  newState)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+    u8           prevMain;
+    u8           newMain;
+
+    prevMain = CNLSTATE_TO_MAINSTATE(prevState);
+    newMain  = CNLSTATE_TO_MAINSTATE(newState);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+
+    // C-Req is received only while waiting connect in SEARCH.
+    if((prevMain != CNL_STATE_SEARCH) || (newMain != CNL_STATE_SEARCH)) {
+        pPort->waitConnect = FALSE;
+    }
+
+    //
+    // *(Not CLOSE) -> SEARCH or CLOSE
+    // stop TX MngFrame and clear RX CSDU.
+    //
+    if(((newMain == CNL_STATE_SEARCH) && (prevMain != CNL_STATE_CLOSE)) ||
+       (newMain == CNL_STATE_CLOSE)) {
+        pPort->pPeer->creqPending = FALSE;
+        STUB_flushRx(pPort);
+    }
+
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    // TX buffer is empty in SEARCH, same as TXBANKEMPT of IZAN.
+    if(newMain == CNL_STATE_SEARCH) {
+        STUB_addEvent(pCnlDev, CNL_EVENT_TX_READY, 0, 0);
+    }
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_waitConnect
+ *-----------------------------------------------------------------*/
+/**
+ * wait connect.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   C-Req sent by the peer before is received at once.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_waitConnect(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    if(pPort->creqPending) {
+        pPort->creqPending = FALSE;
+        STUB_addEvent(pCnlDev, CNL_EVENT_RECVD_MNG_FRAME, 0, CNL_EXT_LICC_C_REQ);
+    } else {
+        pPort->waitConnect = TRUE;
+    }
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_cancelWaitConnect
+ *-----------------------------------------------------------------*/
+/**
+ * cancel wait connect.
+ * @param  pCnlDev    : the pointer to the S_CNL_DEV
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+STUB_cancelWaitConnect(S_CNL_DEV *pCnlDev)
+{
+
+    S_STUB_PORT *pPort = STUB_cnlDevToPort(pCnlDev);
+
+    CMN_LOCK_MUTEX(g_stubLockId);
+    pPort->waitConnect = FALSE;
+    CMN_UNLOCK_MUTEX(g_stubLockId);
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_getStats
+ *-----------------------------------------------------------------*/
+/**
+ * get current statistics value.
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @param  pStats  : the poniter to store RSSI value.
+ * @return CNL_SUCCESS      (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR 
+STUB_getStats(S_CNL_DEV   *pCnlDev,
+              S_CNL_STATS *pStats)
+{
+
+    pStats->RSSI = 0;
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : STUB_regPassthrough
+ *-----------------------------------------------------------------*/
+/**
+ * get current reg value and set value to reg.
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @param  pregPT  : the poniter to the S_CNL_REG_PASSTHROUGH
+ * @return CNL_ERR_BADPARM (no register)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR 
+STUB_regPassthrough(S_CNL_DEV             *pCnlDev,
+                    S_CNL_REG_PASSTHROUGH *pregPT)
+{
+
+    DBG_ERR("regPassthrough : loopback device has no register.\n");
+
+    return CNL_ERR_BADPARM;
+}
@@ -61,6 +61,8 @@ static T_CNL_ERR  CNL_actionSendMngFrame(S_CNL_DEV *, S_CNL_ACTION *);
 static T_CNL_ERR  CNL_actionSendData(S_CNL_DEV *, S_CNL_ACTION *);
 static void       CNL_compSendReq(S_CNL_DEV *, S_CNL_ACTION *);
 static T_CNL_ERR  CNL_execSendReq(S_CNL_DEV *, S_CNL_ACTION *);
+static T_CNL_ERR  CNL_submitTxFrame(S_CNL_DEV *, S_CNL_TX_FRAME *, u8, u8 *);
+static void       CNL_unwindTxFrame(S_CNL_DEV *, S_CNL_TX_FRAME *, S_CNL_CMN_REQ **, u8, u8);
 static T_CNL_ERR  CNL_actionReceiveData(S_CNL_DEV *, S_CNL_ACTION *);
 
 
@@ -91,7 +93,8 @@ static T_CNL_ERR  CNL_actionReceiveData(S_CNL_DEV *, S_CNL_ACTION *);
  * @return CNL_ERR_HOST_IO (HostI/O failed)
  * @return CNL_ERR_HW_PROT (HW protocol error)
  * @return CNL_ERR_BADPARM (invalid parameter)
- * @note   
+ * @note   data request completions of the list are delivered together
+ *         after all actions are handled.
  */
 /*-----------------------------------------------------------------*/
 static T_CNL_ERR
@@ -101,12 +104,27 @@ CNL_actionHandler(S_CNL_DEV    *pCnlDev,
 
     T_CNL_ERR     retval = CNL_SUCCESS;
     S_CNL_ACTION *pAction;
+    S_CNL_ACTION *pCompAction = NULL; // data completions of this list.
+    T_CNL_STATE   cnlState;
     int i;
 
+    cnlState = pCnlDev->cnlState;
+
     for(i=0; i<CNL_ACTION_LIST_NUM; i++) {
         pAction = &pActionList[i];
         if(pAction->type == CNL_ACTION_NOP) {
-            return CNL_SUCCESS;
+            break;
+        }
+
+        //
+        // actions in the list are scheduled at once.
+        // if previous one failed or changed state, drop the rest.
+        // they are scheduled again in the next pass.
+        //
+        if((i > 0) &&
+           ((retval != CNL_SUCCESS) || (pCnlDev->cnlState != cnlState))) {
+            DBG_INFO("drop Action[%x], state is changed.\n", pAction->type);
+            break;
         }
 
         DBG_INFO("HandleAction[%x].\n", pAction->type);
@@ -144,7 +162,8 @@ CNL_actionHandler(S_CNL_DEV    *pCnlDev,
 
         default :
             DBG_ERR("Unknown Action[0x%x].\n", pAction->type);
-            return CNL_ERR_BADPARM;
+            retval = CNL_ERR_BADPARM;
+            goto EXIT;
         }
 
         if(retval != CNL_SUCCESS) {
@@ -156,12 +175,32 @@ CNL_actionHandler(S_CNL_DEV    *pCnlDev,
         }
 
 HANDLER:
+        if(IS_DATA_COMP_ACTION(pAction)) {
+            // chain to the completions of previous action.
+            if((pCompAction != NULL) && (pCompAction->status == pAction->status)) {
+                CMN_LIST_SPLICE(&pAction->compQueue, &pCompAction->compQueue,
+                                S_CNL_CMN_REQ, list);
+                continue;
+            }
+            if(pCompAction != NULL) {
+                CNL_stateMachine(pCnlDev, pCompAction);
+            }
+            pCompAction = pAction;
+            continue;
+        }
+
         if(IS_HANDLER_ACTION(pAction->type)) {
             // this action is fall through to the state machine.
             retval = CNL_stateMachine(pCnlDev, pAction);
         }
     }
 
+EXIT:
+    if(pCompAction != NULL) {
+        // no change state, just complete the request(s).
+        CNL_stateMachine(pCnlDev, pCompAction);
+    }
+
     return retval;
 
 }
@@ -613,6 +652,104 @@ CNL_compSendReq(S_CNL_DEV    *pCnlDev,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : CNL_submitTxFrame
+ *-----------------------------------------------------------------*/
+/**
+ * write TX frames to the device.
+ * @param  pCnlDev  : the pointer to the S_CNL_DEV
+ * @param  pFrame   : the pointer to the S_CNL_TX_FRAME array.
+ * @param  frameNum : number of frames.
+ * @param  pSentNum : number of frames written to the device.
+ * @return CNL_SUCCESS     (normally completion)
+ * @return CNL_ERR_HOST_IO (HostI/O failed)
+ * @note   frames are sent one by one if device has no pSendDataMulti.
+ *         on failure, pSentNum frames may be already in the device and
+ *         only the rest shall be sent again.
+ */
+/*-----------------------------------------------------------------*/
+static T_CNL_ERR
+CNL_submitTxFrame(S_CNL_DEV      *pCnlDev,
+                  S_CNL_TX_FRAME *pFrame,
+                  u8              frameNum,
+                  u8             *pSentNum)
+{
+
+    T_CNL_ERR retval = CNL_SUCCESS;
+    u8        i;
+
+    *pSentNum = 0;
+
+    if(pCnlDev->pDeviceOps->pSendDataMulti != NULL) {
+        retval = pCnlDev->pDeviceOps->pSendDataMulti(pCnlDev, pFrame, frameNum, &i);
+    } else {
+        for(i=0; i<frameNum; i++) {
+            retval = pCnlDev->pDeviceOps->pSendData(pCnlDev,
+                                                    pFrame[i].profileId,
+                                                    pFrame[i].fragment,
+                                                    pFrame[i].length,
+                                                    pFrame[i].pData);
+            if(retval != CNL_SUCCESS) {
+                break;
+            }
+        }
+    }
+
+    *pSentNum = i;
+
+    for(i=0; i<*pSentNum; i++) {
+        pCnlDev->devStat.txBytes += pFrame[i].length;
+        pCnlDev->devStat.txCsdu  += LENGTH_TO_CSDU(pFrame[i].length);
+    }
+
+    if(retval != CNL_SUCCESS) {
+        DBG_ERR("SendData failed[%d].\n", retval);
+        return retval;
+    }
+
+    return CNL_SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : CNL_unwindTxFrame
+ *-----------------------------------------------------------------*/
+/**
+ * give back the frames which were not written to the device.
+ * @param  pCnlDev  : the pointer to the S_CNL_DEV
+ * @param  pFrame   : the pointer to the S_CNL_TX_FRAME array.
+ * @param  ppReq    : the requests of each frame.
+ * @param  from     : first frame not written.
+ * @param  frameNum : number of frames.
+ * @return nothing
+ * @note   frames are unwound from the last one, so the position of
+ *         a request split in several frames goes back to the first
+ *         unwritten one.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNL_unwindTxFrame(S_CNL_DEV       *pCnlDev,
+                  S_CNL_TX_FRAME  *pFrame,
+                  S_CNL_CMN_REQ  **ppReq,
+                  u8               from,
+                  u8               frameNum)
+{
+
+    S_DATA_REQ_EXT *pExt;
+    u8              i;
+
+    for(i=frameNum; i>from; i--) {
+        pExt = (S_DATA_REQ_EXT *)(&ppReq[i-1]->extData);
+
+        pExt->sendingLen       -= pFrame[i-1].length;
+        pExt->position         -= pFrame[i-1].length;
+        pCnlDev->txSendingCsdu -= LENGTH_TO_CSDU(pFrame[i-1].length);
+    }
+
+    return;
+}
+
+
 /*-------------------------------------------------------------------
  * Function : CNL_execSendReq
  *-----------------------------------------------------------------*/
@@ -643,8 +780,24 @@ CNL_execSendReq(S_CNL_DEV    *pCnlDev,
     u32             post_length;
     u8              ite_num   = 0;
     u8              req_flag  = FALSE;
+    u8              capped    = FALSE;
+    u32             done      = 0;
+
+    S_CNL_TX_FRAME  frame[CNL_TX_FRAME_MAX];
+    S_CNL_CMN_REQ  *frameReq[CNL_TX_FRAME_MAX];
+    u8              frameNum  = 0;
+    u8              sentNum;
 
     while(pAction->readyLength > 0) {
+        //
+        // stop at the budget given by arbitration, rest is sent next pass.
+        //
+        if((pAction->budget != 0) && (done >= pAction->budget)) {
+            pCnlDev->schdStat.txCapped++;
+            capped = TRUE;
+            break;
+        }
+
         //
         // get next send request.
         //
@@ -676,25 +829,40 @@ CNL_execSendReq(S_CNL_DEV    *pCnlDev,
         fragment = (pReq->dataReq.length > pExt->position + length) ? \
             CNL_FRAGMENTED_DATA : pReq->dataReq.fragmented;
 
-        DBG_INFO("execSendReq : call sendData(reqLength=%u, rest=%u, length=%u(%u CSDU(s)), fragment=%u, readyLength=%u\n",
+        DBG_INFO("execSendReq : add frame(reqLength=%u, rest=%u, length=%u(%u CSDU(s)), fragment=%u, readyLength=%u\n",
                   pReq->dataReq.length,rest,length, sendCsdu, fragment, pAction->readyLength);
+        trace_cnl_send_data(pCnlDev->devnum, pReq->id, pExt->position, length, sendCsdu, fragment);
 
+        //
+        // coalesce frames while they fit in ready TX buffer.
+        //
+        frame[frameNum].profileId = pReq->dataReq.profileId;
+        frame[frameNum].fragment  = fragment;
+        frame[frameNum].length    = length;
+        frame[frameNum].pData     = pDataPtr;
+        frameReq[frameNum]        = pReq;
+        frameNum++;
+
+        // update information, unwound if the frame is not written.
+        pExt->sendingLen       += length;
+        pExt->position         += length;
+        pCnlDev->txSendingCsdu += sendCsdu;
+        done                   += length;
 
         //
-        // call Send Data device operation.
+        // submit frames before re-confirming tx buffer.
         //
-        retval = pCnlDev->pDeviceOps->pSendData(pCnlDev,
-                                                pReq->dataReq.profileId,
-                                                fragment,
-                                                length,
-                                                pDataPtr);
-        if(retval != CNL_SUCCESS) {
-            DBG_ERR("SendData failed[%d].\n", retval);
-            return retval;
+        if((length != rest) || (frameNum == CNL_TX_FRAME_MAX)) {
+            retval = CNL_submitTxFrame(pCnlDev, frame, frameNum, &sentNum);
+            if(retval != CNL_SUCCESS) {
+                CNL_unwindTxFrame(pCnlDev, frame, frameReq, sentNum, frameNum);
+                return retval;
+            }
+            frameNum = 0;
         }
-            
+
         if ((length != rest) && (ite_num < RECONFIRM_TX_BUFFER_MAXCOUNT) ) {
-            // re-confirm tx buffer
+            // re-confirm tx buffer, device may answer from its TX credit.
             retval = pCnlDev->pDeviceOps->pReadReadyTxBuffer(pCnlDev, &post_length);
             DBG_INFO("execSendReq : post_length = %d\n", post_length);
             if(retval != CNL_SUCCESS) {
@@ -709,11 +877,21 @@ CNL_execSendReq(S_CNL_DEV    *pCnlDev,
         }
 
         DBG_INFO("execSendReq : update readyLength=%u\n",pAction->readyLength);
-        
-        // update information.
-        pExt->sendingLen       += length;
-        pExt->position         += length;
-        pCnlDev->txSendingCsdu += sendCsdu;
+    }
+
+    if(frameNum > 0) {
+        retval = CNL_submitTxFrame(pCnlDev, frame, frameNum, &sentNum);
+        if(retval != CNL_SUCCESS) {
+            CNL_unwindTxFrame(pCnlDev, frame, frameReq, sentNum, frameNum);
+            return retval;
+        }
+    }
+
+    //
+    // pay the bytes sent, or drop the deficit if TX ran dry.
+    //
+    if(pAction->budget != 0) {
+        pCnlDev->txDeficit = capped ? (pCnlDev->txDeficit - (s32)done) : 0;
     }
 
     //
@@ -761,10 +939,21 @@ CNL_actionReceiveData(S_CNL_DEV    *pCnlDev,
     S_LIST         *pHead;
 
     u32             post_length;
+    u32             done   = 0;
+    u8              capped = FALSE;
 
     profileId = pCnlDev->rxReadyPid;
 
     while(pAction->readyLength > 0) {
+        //
+        // stop at the budget given by arbitration, rest is read next pass.
+        //
+        if((pAction->budget != 0) && (done >= pAction->budget)) {
+            pCnlDev->schdStat.rxCapped++;
+            capped = TRUE;
+            break;
+        }
+
         //
         // get receive data request from RX queue(Pid 0 or 1)
         // 
@@ -807,8 +996,12 @@ CNL_actionReceiveData(S_CNL_DEV    *pCnlDev,
             return retval;
         }
 
+        trace_cnl_receive_data(pCnlDev->devnum, pReq->id, pExt->position, length, fragment);
+        pCnlDev->devStat.rxBytes += length;
+
         pExt->position       += length;
         pAction->readyLength -= length;
+        done                 += length;
 
         DBG_INFO("RecvDumpAfter(pos=%u, total=%u, recvd=%u, frag=%d, readyLength=%u\n",
                  pExt->position, pReq->dataReq.length, length, fragment, pAction->readyLength);
@@ -857,6 +1050,13 @@ CNL_actionReceiveData(S_CNL_DEV    *pCnlDev,
         }
     }
 
+    //
+    // pay the bytes read, or drop the deficit if RX ran dry.
+    //
+    if(pAction->budget != 0) {
+        pCnlDev->rxDeficit = capped ? (pCnlDev->rxDeficit - (s32)done) : 0;
+    }
+
     retval = pCnlDev->pDeviceOps->pReceiveDataIntUnmask(pCnlDev);
     if(retval != CNL_SUCCESS) {
         DBG_ERR("ReceiveData IntUnmask failed[%d].\n", retval);
@@ -886,27 +1086,27 @@ CNL_actionReceiveData(S_CNL_DEV    *pCnlDev,
  * Function : CNL_task
  *-----------------------------------------------------------------*/
 /**
- * CNL main thread.
- * @param  pUnuse : unused parameter.
+ * CNL main thread. one thread is running per CNL device.
+ * @param  pArg : the pointer to the S_CNL_DEV served by this thread.
  * @return 
  * @note   
  */
 /*-----------------------------------------------------------------*/
 void
-CNL_task(void *pUnuse) 
+CNL_task(void *pArg) 
 {
 
     T_CMN_ERR     retval;
-    S_CNL_DEV    *pCnlDev = NULL;
+    S_CNL_DEV    *pCnlDev = (S_CNL_DEV *)pArg;
     S_CNL_ACTION  actionList[CNL_ACTION_LIST_NUM];
 
-    DBG_INFO("CNL core task started\n");
+    DBG_INFO("CNL core task started[%d]\n", pCnlDev->devnum);
 
     do {
         //
-        // get signaled device.
+        // wait for this device signaled.
         //
-        retval = CNL_getSignaledDev(&pCnlDev);
+        retval = CNL_waitSignal(pCnlDev);
         if(retval == ERR_RLWAIT) {
             // terminate task is called or system interrupted.
             break; // exit task.
@@ -915,11 +1115,8 @@ CNL_task(void *pUnuse)
         do {
             //
             // get Action from scheduler.
-            // handle action coutinuously while action exists in one device.
-            //
-            // -- note --
-            // this may cause task occupy when multi-device is supported.
-            // consider priority management if necessary.
+            // handle action coutinuously while action exists.
+            // other devices are served by their own threads.
             //
             retval = CNL_getAction(pCnlDev, actionList);
 
@@ -0,0 +1,323 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cnl_trace.h
+ *
+ *  @brief    CNL core and IZAN tracepoints.
+ *
+ *
+ *  @note     events are under "toscnl" in tracefs. requestId is the id
+ *            given by the upper layer, it matches the cnlio events.
+ *            tracepoints are linux only, others get empty macros.
+ */
+/*=================================================================*/
+
+#if !defined(__CNL_TRACE_H__) || defined(TRACE_HEADER_MULTI_READ)
+#define __CNL_TRACE_H__
+
+#if defined(USE_OS_LINUX)
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM toscnl
+
+#include <linux/tracepoint.h>
+
+/*-------------------------------------------------------------------
+ * CNL core events
+ *-----------------------------------------------------------------*/
+/**
+ * @brief request is queued(status 0) or refused by CNL_request.
+ */
+TRACE_EVENT(cnl_request,
+    TP_PROTO(u8 devnum, unsigned long id, u32 type, u8 profileId, u32 length, int status),
+    TP_ARGS(devnum, id, type, profileId, length, status),
+    TP_STRUCT__entry(
+        __field(u8,            devnum)
+        __field(unsigned long, id)
+        __field(u32,           type)
+        __field(u8,            profileId)
+        __field(u32,           length)
+        __field(int,           status)
+    ),
+    TP_fast_assign(
+        __entry->devnum    = devnum;
+        __entry->id        = id;
+        __entry->type      = type;
+        __entry->profileId = profileId;
+        __entry->length    = length;
+        __entry->status    = status;
+    ),
+    TP_printk("dev=%u id=0x%lx type=%u pid=%u len=%u csdu=%u status=%d",
+              __entry->devnum, __entry->id, __entry->type, __entry->profileId,
+              __entry->length, LENGTH_TO_CSDU(__entry->length), __entry->status)
+);
+
+/**
+ * @brief actions scheduled in one pass, [1] is the TX batched with RX.
+ */
+TRACE_EVENT(cnl_get_action,
+    TP_PROTO(u8 devnum, u32 type0, u32 ready0, u32 budget0, u32 type1, u32 ready1, u32 budget1),
+    TP_ARGS(devnum, type0, ready0, budget0, type1, ready1, budget1),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u32, type0)
+        __field(u32, ready0)
+        __field(u32, budget0)
+        __field(u32, type1)
+        __field(u32, ready1)
+        __field(u32, budget1)
+    ),
+    TP_fast_assign(
+        __entry->devnum  = devnum;
+        __entry->type0   = type0;
+        __entry->ready0  = ready0;
+        __entry->budget0 = budget0;
+        __entry->type1   = type1;
+        __entry->ready1  = ready1;
+        __entry->budget1 = budget1;
+    ),
+    TP_printk("dev=%u action0=0x%x ready=%u budget=%u action1=0x%x ready=%u budget=%u",
+              __entry->devnum,
+              __entry->type0, __entry->ready0, __entry->budget0,
+              __entry->type1, __entry->ready1, __entry->budget1)
+);
+
+/**
+ * @brief data frame of a send request is built for Action.SendData.
+ */
+TRACE_EVENT(cnl_send_data,
+    TP_PROTO(u8 devnum, unsigned long id, u32 position, u32 length, u8 csdu, u8 fragment),
+    TP_ARGS(devnum, id, position, length, csdu, fragment),
+    TP_STRUCT__entry(
+        __field(u8,            devnum)
+        __field(unsigned long, id)
+        __field(u32,           position)
+        __field(u32,           length)
+        __field(u8,            csdu)
+        __field(u8,            fragment)
+    ),
+    TP_fast_assign(
+        __entry->devnum   = devnum;
+        __entry->id       = id;
+        __entry->position = position;
+        __entry->length   = length;
+        __entry->csdu     = csdu;
+        __entry->fragment = fragment;
+    ),
+    TP_printk("dev=%u id=0x%lx pos=%u len=%u csdu=%u frag=%u",
+              __entry->devnum, __entry->id, __entry->position,
+              __entry->length, __entry->csdu, __entry->fragment)
+);
+
+/**
+ * @brief data of a receive request is read by Action.ReceiveData.
+ */
+TRACE_EVENT(cnl_receive_data,
+    TP_PROTO(u8 devnum, unsigned long id, u32 position, u32 length, u8 fragment),
+    TP_ARGS(devnum, id, position, length, fragment),
+    TP_STRUCT__entry(
+        __field(u8,            devnum)
+        __field(unsigned long, id)
+        __field(u32,           position)
+        __field(u32,           length)
+        __field(u8,            fragment)
+    ),
+    TP_fast_assign(
+        __entry->devnum   = devnum;
+        __entry->id       = id;
+        __entry->position = position;
+        __entry->length   = length;
+        __entry->fragment = fragment;
+    ),
+    TP_printk("dev=%u id=0x%lx pos=%u len=%u csdu=%u frag=%u",
+              __entry->devnum, __entry->id, __entry->position, __entry->length,
+              LENGTH_TO_CSDU(__entry->length), __entry->fragment)
+);
+
+/**
+ * @brief request completion is called.
+ */
+TRACE_EVENT(cnl_complete,
+    TP_PROTO(u8 devnum, unsigned long id, u32 type, int status),
+    TP_ARGS(devnum, id, type, status),
+    TP_STRUCT__entry(
+        __field(u8,            devnum)
+        __field(unsigned long, id)
+        __field(u32,           type)
+        __field(int,           status)
+    ),
+    TP_fast_assign(
+        __entry->devnum = devnum;
+        __entry->id     = id;
+        __entry->type   = type;
+        __entry->status = status;
+    ),
+    TP_printk("dev=%u id=0x%lx type=%u status=%d",
+              __entry->devnum, __entry->id, __entry->type, __entry->status)
+);
+
+
+/*-------------------------------------------------------------------
+ * IZAN events
+ *-----------------------------------------------------------------*/
+/**
+ * @brief TX data frames are written to the device.
+ */
+TRACE_EVENT(izan_send_data,
+    TP_PROTO(u8 devnum, u8 num, u32 length, u8 csdu),
+    TP_ARGS(devnum, num, length, csdu),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u8,  num)
+        __field(u32, length)
+        __field(u8,  csdu)
+    ),
+    TP_fast_assign(
+        __entry->devnum = devnum;
+        __entry->num    = num;
+        __entry->length = length;
+        __entry->csdu   = csdu;
+    ),
+    TP_printk("dev=%u frames=%u len=%u csdu=%u",
+              __entry->devnum, __entry->num, __entry->length, __entry->csdu)
+);
+
+TRACE_EVENT(izan_send_data_done,
+    TP_PROTO(u8 devnum, u8 csdu, int retval),
+    TP_ARGS(devnum, csdu, retval),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u8,  csdu)
+        __field(int, retval)
+    ),
+    TP_fast_assign(
+        __entry->devnum = devnum;
+        __entry->csdu   = csdu;
+        __entry->retval = retval;
+    ),
+    TP_printk("dev=%u csdu=%u ret=%d",
+              __entry->devnum, __entry->csdu, __entry->retval)
+);
+
+/**
+ * @brief RX data is read from the device.
+ */
+TRACE_EVENT(izan_receive_data,
+    TP_PROTO(u8 devnum, u8 profileId, u32 length, u32 remain),
+    TP_ARGS(devnum, profileId, length, remain),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u8,  profileId)
+        __field(u32, length)
+        __field(u32, remain)
+    ),
+    TP_fast_assign(
+        __entry->devnum    = devnum;
+        __entry->profileId = profileId;
+        __entry->length    = length;
+        __entry->remain    = remain;
+    ),
+    TP_printk("dev=%u pid=%u buf=%u remain=%u",
+              __entry->devnum, __entry->profileId, __entry->length, __entry->remain)
+);
+
+TRACE_EVENT(izan_receive_data_done,
+    TP_PROTO(u8 devnum, u32 length, u8 fragment, int rewind, int retval),
+    TP_ARGS(devnum, length, fragment, rewind, retval),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u32, length)
+        __field(u8,  fragment)
+        __field(int, rewind)
+        __field(int, retval)
+    ),
+    TP_fast_assign(
+        __entry->devnum   = devnum;
+        __entry->length   = length;
+        __entry->fragment = fragment;
+        __entry->rewind   = rewind;
+        __entry->retval   = retval;
+    ),
+    TP_printk("dev=%u len=%u csdu=%u frag=%u rewind=%d ret=%d",
+              __entry->devnum, __entry->length, LENGTH_TO_CSDU(__entry->length),
+              __entry->fragment, __entry->rewind, __entry->retval)
+);
+
+/**
+ * @brief top half, wakeup 0 means coalesced to the pending bottom half.
+ */
+TRACE_EVENT(izan_irq,
+    TP_PROTO(u8 devnum, u8 wakeup),
+    TP_ARGS(devnum, wakeup),
+    TP_STRUCT__entry(
+        __field(u8, devnum)
+        __field(u8, wakeup)
+    ),
+    TP_fast_assign(
+        __entry->devnum = devnum;
+        __entry->wakeup = wakeup;
+    ),
+    TP_printk("dev=%u wakeup=%u", __entry->devnum, __entry->wakeup)
+);
+
+/**
+ * @brief bottom half, interrupt status and handled bits.
+ */
+TRACE_EVENT(izan_irq_status,
+    TP_PROTO(u8 devnum, u32 intst, u32 bits),
+    TP_ARGS(devnum, intst, bits),
+    TP_STRUCT__entry(
+        __field(u8,  devnum)
+        __field(u32, intst)
+        __field(u32, bits)
+    ),
+    TP_fast_assign(
+        __entry->devnum = devnum;
+        __entry->intst  = intst;
+        __entry->bits   = bits;
+    ),
+    TP_printk("dev=%u int=0x%08x bits=0x%08x",
+              __entry->devnum, __entry->intst, __entry->bits)
+);
+
+#else  /* !defined(USE_OS_LINUX) */
+
+#define trace_cnl_request(...)           do { } while(0)
+#define trace_cnl_get_action(...)        do { } while(0)
+#define trace_cnl_send_data(...)         do { } while(0)
+#define trace_cnl_receive_data(...)      do { } while(0)
+#define trace_cnl_complete(...)          do { } while(0)
+#define trace_izan_send_data(...)        do { } while(0)
+#define trace_izan_send_data_done(...)   do { } while(0)
+#define trace_izan_receive_data(...)     do { } while(0)
+#define trace_izan_receive_data_done(...) do { } while(0)
+#define trace_izan_irq(...)              do { } while(0)
+#define trace_izan_irq_status(...)       do { } while(0)
+
+#endif /* defined(USE_OS_LINUX) */
+
+#endif /* __CNL_TRACE_H__ */
+
+#if defined(USE_OS_LINUX)
+// this part must be outside the header guard.
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE cnl_trace
+#include <trace/define_trace.h>
+#endif
@@ -52,7 +52,7 @@
 /*-------------------------------------------------------------------
  * Prototypes
  *-----------------------------------------------------------------*/
-
+static S_CNL_CMN_REQ *CNL_searchPrioPosition(S_CNL_DEV *, S_CNL_CMN_REQ *);
 
 /*-------------------------------------------------------------------
  * Globals
@@ -105,6 +105,48 @@ CNL_addRequestToCtrlQueue(S_CNL_DEV     *pCnlDev,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function : CNL_searchPrioPosition
+ *-----------------------------------------------------------------*/
+/**
+ * search TX queue position for the high priority send request.
+ * @param  pCnlDev : the pointer to the S_CNL_DEV
+ * @param  pReq    : the pointer to the S_CNL_CMN_REQ to add.
+ * @return pointer to the request to insert before, NULL adds to tail.
+ * @note   CNL_compSendReq completes from head of TX queue, so the request
+ *         never goes ahead of started ones or a fragmented data.
+ */
+/*-----------------------------------------------------------------*/
+static S_CNL_CMN_REQ *
+CNL_searchPrioPosition(S_CNL_DEV     *pCnlDev,
+                       S_CNL_CMN_REQ *pReq)
+{
+
+    S_CNL_CMN_REQ  *pPos;
+    S_CNL_CMN_REQ  *pPrevReq = NULL;
+    S_DATA_REQ_EXT *pExt;
+
+    pExt = (S_DATA_REQ_EXT *)(&pReq->extData);
+    if(pExt->priority != CNL_PRIO_HIGH) {
+        return NULL;
+    }
+
+    CMN_LIST_FOR(&pCnlDev->txQueue, pPos, S_CNL_CMN_REQ, list) {
+        pExt = (S_DATA_REQ_EXT *)(&pPos->extData);
+        if((pPos->state     == CNL_REQ_QUEUED)  &&
+           (pExt->position  == 0)               &&
+           (pExt->priority  == CNL_PRIO_NORMAL) &&
+           ((pPrevReq == NULL) ||
+            (pPrevReq->dataReq.fragmented != CNL_FRAGMENTED_DATA))) {
+            return pPos;
+        }
+        pPrevReq = pPos;
+    }
+
+    return NULL;
+}
+
+
 /*-------------------------------------------------------------------
  * Function : CNL_addRequestToTxQueue
  *-----------------------------------------------------------------*/
@@ -122,16 +164,23 @@ CNL_addRequestToTxQueue(S_CNL_DEV     *pCnlDev,
                         S_CNL_CMN_REQ *pReq)
 {
 
-    T_CMN_ERR retval;
+    T_CMN_ERR      retval;
+    S_CNL_CMN_REQ *pPos;
 
-    if(pCnlDev->txReqCnt >= CNL_TX_QUEUE_SIZE) {
+    if(pCnlDev->txReqCnt >= pCnlDev->txQueueSize) {
         DBG_ERR("TX queue overflow(current[%u]:max[%u])\n", 
-                pCnlDev->txReqCnt, CNL_TX_QUEUE_SIZE);
+                pCnlDev->txReqCnt, pCnlDev->txQueueSize);
         retval = CNL_ERR_QOVR;
     } else {
         pReq->state = CNL_REQ_QUEUED;
         pCnlDev->txReqCnt++;
-        CMN_LIST_ADD_TAIL(&pCnlDev->txQueue, pReq, S_CNL_CMN_REQ, list);
+        pPos = CNL_searchPrioPosition(pCnlDev, pReq);
+        if(pPos != NULL) {
+            CMN_LIST_INSERT_BEFORE(&pCnlDev->txQueue, pPos, pReq, S_CNL_CMN_REQ, list);
+            pCnlDev->schdStat.prioCnt++;
+        } else {
+            CMN_LIST_ADD_TAIL(&pCnlDev->txQueue, pReq, S_CNL_CMN_REQ, list);
+        }
         retval = CNL_SUCCESS;
     }
 
@@ -160,9 +209,9 @@ CNL_addRequestToRxQueue(S_CNL_DEV     *pCnlDev,
     T_CMN_ERR retval;
 
     if(pReq->dataReq.profileId == CNL_PROFILE_ID_0) {
-        if(pCnlDev->rx0ReqCnt >= CNL_RX_QUEUE0_SIZE) {
+        if(pCnlDev->rx0ReqCnt >= pCnlDev->rx0QueueSize) {
             DBG_ERR("RX0 queue overflow(current[%u]:max[%u])\n", 
-                    pCnlDev->rx0ReqCnt, CNL_RX_QUEUE0_SIZE);
+                    pCnlDev->rx0ReqCnt, pCnlDev->rx0QueueSize);
             retval = CNL_ERR_QOVR;
         } else {
             pReq->state = CNL_REQ_QUEUED;
@@ -171,9 +220,9 @@ CNL_addRequestToRxQueue(S_CNL_DEV     *pCnlDev,
             retval = CNL_SUCCESS;
         }
     } else {
-        if(pCnlDev->rx1ReqCnt >= CNL_RX_QUEUE1_SIZE) {
+        if(pCnlDev->rx1ReqCnt >= pCnlDev->rx1QueueSize) {
             DBG_ERR("RX1 queue overflow(current[%u]:max[%u])\n", 
-                    pCnlDev->rx1ReqCnt, CNL_RX_QUEUE1_SIZE);
+                    pCnlDev->rx1ReqCnt, pCnlDev->rx1QueueSize);
             retval = CNL_ERR_QOVR;
         } else {
             pReq->state = CNL_REQ_QUEUED;
@@ -300,7 +349,8 @@ CNL_searchNextSendRequest(S_CNL_DEV *pCnlDev)
  * @param  pCnlDev : the pointer to the S_CNL_DEV
  * @param  reqId   : request Id to indicate target request.
  * @return pointer to the cancel target request.
- * @note   
+ * @note   queues are scanned linearly, the number of requests compared
+ *         is counted in devStat to show the cost with deep queues.
  */
 /*-----------------------------------------------------------------*/
 S_CNL_CMN_REQ *
@@ -308,30 +358,45 @@ CNL_searchCancelRequest(S_CNL_DEV     *pCnlDev,
                         T_CNL_REQ_ID   reqId)
 {
     S_CNL_CMN_REQ *pReq;
+    u32            probe = 0;
 
     CMN_LIST_FOR(&pCnlDev->rx1Queue, pReq, S_CNL_CMN_REQ, list) {
+        probe++;
         if(pReq->id == reqId) {
-            return pReq;
+            goto FOUND;
         }
     }
 
     CMN_LIST_FOR(&pCnlDev->rx0Queue, pReq, S_CNL_CMN_REQ, list) {
+        probe++;
         if(pReq->id == reqId) {
-            return pReq;
+            goto FOUND;
         }
     }
 
     CMN_LIST_FOR(&pCnlDev->txQueue, pReq, S_CNL_CMN_REQ, list) {
+        probe++;
         if(pReq->id == reqId) {
-            return pReq;
+            goto FOUND;
         }
     }
 
     CMN_LIST_FOR(&pCnlDev->ctrlQueue, pReq, S_CNL_CMN_REQ, list) {
+        probe++;
         if(pReq->id == reqId) {
-            return pReq;
+            goto FOUND;
         }
     }
 
-    return NULL;
+    pReq = NULL;
+    pCnlDev->devStat.cancelMiss++;
+
+FOUND:
+    pCnlDev->devStat.cancelLookup++;
+    pCnlDev->devStat.cancelProbe += probe;
+    if(probe > pCnlDev->devStat.cancelProbeMax) {
+        pCnlDev->devStat.cancelProbeMax = probe;
+    }
+
+    return pReq;
 }
@@ -78,6 +78,17 @@ static u8          g_ctrlIocontMplId = CNLFIT_IOCONT_MPL_ID;
 static u8          g_ctrlLockId      = CNLFIT_CTRL_LOCK_ID;
 static u8          g_adptLockId      = CNLFIT_ADPT_LOCK_ID;
 
+// IO container count per CNL device, shall cover the request queue depths of CNL.
+static ushort      g_ctrlIocontMplCnt = CNLFIT_IOCONT_MPL_CNT;
+module_param_named(IocontMplCnt, g_ctrlIocontMplCnt, ushort, S_IRUGO);
+
+#ifndef USE_OS_POSIX
+// chips of the simulated bus served as CnlFitCtrl<n>, same as SimDevNum
+// of the bus module. 0 serves the single chip of SDIO.
+static ushort      g_ctrlSimDevNum    = 0;
+module_param_named(SimDevNum, g_ctrlSimDevNum, ushort, S_IRUGO);
+#endif
+
 /*-------------------------------------------------------------------
  * Inline function definition
  *-----------------------------------------------------------------*/
@@ -393,6 +404,11 @@ CNLFIT_open(int                type,
 
     T_CMN_ERR  retval = SUCCESS;
 
+    if((id < 0) || (id >= CNLFIT_getDevNum())) {
+        DBG_ERR("Open : invalid device id[%d].\n", id);
+        return ERR_NOOBJ;
+    }
+
     //
     // open ctrl/adpt
     //
@@ -547,7 +563,7 @@ CNLUP_registerCNL(void      *pDev,
 
     CMN_LOCK_MUTEX(g_ctrlDevMtxId);
 
-    for(i=0; i<CNLFIT_DEV_NUM; i++) {
+    for(i=0; i<CNLFIT_getDevNum(); i++) {
         if(g_pCtrlTable[i] == NULL) {
             found = TRUE;
             break;
@@ -610,7 +626,7 @@ CNLUP_unregisterCNL(void  *pDev)
     CMN_LOCK_MUTEX(g_ctrlDevMtxId);
 
     for(i=0; i<CNLFIT_DEV_NUM; i++) {
-        if(g_pCtrlTable[i]->pCnlPtr == pDev) {
+        if((g_pCtrlTable[i] != NULL) && (g_pCtrlTable[i]->pCnlPtr == pDev)) {
             // found device.
             found = TRUE;
             pCtrlMgr = g_pCtrlTable[i];
@@ -648,6 +664,33 @@ EXIT :
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CNLFIT_getDevNum
+ *-----------------------------------------------------------------*/
+/**
+ * get number of CNL devices served by fitting module.
+ * @param     nothing.
+ * @return    number of CNL devices.
+ * @note      the single chip of SDIO, SimDevNum chips of the simulated
+ *            bus, or the loopback device pair of POSIX.
+ */
+/*-----------------------------------------------------------------*/
+int
+CNLFIT_getDevNum(void)
+{
+
+#ifdef USE_OS_POSIX
+    return CNLFIT_DEV_NUM;
+#else
+    if(g_ctrlSimDevNum == 0) {
+        return 1;
+    }
+
+    return (g_ctrlSimDevNum < CNLFIT_DEV_NUM) ? g_ctrlSimDevNum : CNLFIT_DEV_NUM;
+#endif
+}
+
+
 /*-------------------------------------------------------------------
  * Function   : CNLFIT_initMod
  *-----------------------------------------------------------------*/
@@ -677,9 +720,12 @@ CNLFIT_initMod(void)
                            CNLFIT_DEV_MPL_CNT,
                            CNLFIT_DEV_MPL_SIZE);
 
+    if(g_ctrlIocontMplCnt == 0) {
+        g_ctrlIocontMplCnt = CNLFIT_IOCONT_MPL_CNT;
+    }
     CMN_createFixedMemPool(g_ctrlIocontMplId,
-                           0, 
-                           CNLFIT_IOCONT_MPL_CNT,
+                           CMN_MPL_ATTR_PERCPU, 
+                           g_ctrlIocontMplCnt * CNLFIT_getDevNum(),
                            CNLFIT_IOCONT_MPL_SIZE);
 
     CMN_createCpuLock(g_ctrlLockId);
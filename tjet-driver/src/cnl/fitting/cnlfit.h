@@ -48,7 +48,8 @@
 /*-------------------------------------------------------------------
  * Macro definition
  *-----------------------------------------------------------------*/
-#define CNLFIT_DEV_NUM                       1 // same as CNLFIT_DEV_MPL_CNT
+// max, loopback device pair or chip pair of the simulated bus.
+#define CNLFIT_DEV_NUM                       2 // same as CNLFIT_DEV_MPL_CNT
 
 
 #define DEVTYPE_CTRL                         0
@@ -106,6 +107,7 @@ typedef struct tagS_IO_CONTAINER {
         S_CNL_CMN_EVT                        cnlEvt;
         u8                                   portEvt;
     };
+    S_CNLIO_DONE_PACK                        done;     // inline send only.
 }S_IO_CONTAINER;
 
 
@@ -188,6 +190,12 @@ CNLFIT_cmdToString(uint cmd) {
         return "CNLWRAPIOC_CANCEL";
     case CNLWRAPIOC_GETEVENT :
         return "CNLWRAPIOC_GETEVENT";
+    case CNLWRAPIOC_GETEVENT_MULTI :
+        return "CNLWRAPIOC_GETEVENT_MULTI";
+    case CNLWRAPIOC_SENDFILE :
+        return "CNLWRAPIOC_SENDFILE";
+    case CNLWRAPIOC_SENDDATA_INLINE :
+        return "CNLWRAPIOC_SENDDATA_INLINE";
     case CNLWRAPIOC_STOP_EVENT :
         return "CNLWRAPIOC_STOP_EVENT";
     case CNLWRAPIOC_ENABLE_PORT :
@@ -202,6 +210,10 @@ CNLFIT_cmdToString(uint cmd) {
         return "CNLWRAPIOC_SYNCRECV";
     case CNLWRAPIOC_POWERSAVE :
         return "CNLWRAPIOC_POWERSAVE";
+    case CNLWRAPIOC_GETSTATS :
+        return "CNLWRAPIOC_GETSTATS";
+    case CNLWRAPIOC_RING_ENTER :
+        return "CNLWRAPIOC_RING_ENTER";
     default :
         return "unknown";
     }
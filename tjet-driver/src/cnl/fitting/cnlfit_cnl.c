@@ -62,6 +62,7 @@ static void            CNLFIT_convertEvent(S_CTRL_MGR *, S_CNLWRAP_EVENT *, S_IO
 
 // CNL request completion callback related functions
 static void            CNLFIT_asyncCbk(S_CNL_CMN_REQ *, void *, void *);
+static void            CNLFIT_inlineCbk(S_CNL_CMN_REQ *, void *, void *);
 static T_CMN_ERR       CNLFIT_cnlInit(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlClose(S_CTRL_MGR *,S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlConnect(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
@@ -70,9 +71,11 @@ static T_CMN_ERR       CNLFIT_cnlAccept(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlConfirm(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlRelease(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlSendData(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *, int);
+static T_CMN_ERR       CNLFIT_cnlSendInline(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *);
 static T_CMN_ERR       CNLFIT_cnlRecvData(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *, int);
 static T_CMN_ERR       CNLFIT_cnlCancel(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *, int);
 static T_CMN_ERR       CNLFIT_getEvent(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *, int);
+static T_CMN_ERR       CNLFIT_getEventMulti(S_CTRL_MGR *, S_CNLIO_ARG_BUCKET *, int);
 static T_CMN_ERR       CNLFIT_stopEvent(S_CTRL_MGR *, int);
 static T_CMN_ERR       CNLFIT_enablePort(S_CTRL_MGR *);
 static T_CMN_ERR       CNLFIT_disablePort(S_CTRL_MGR *);
@@ -186,9 +189,11 @@ CNLFIT_checkCmd(uint cmd,
         break;
 
     case CNLWRAPIOC_GETEVENT :
+    case CNLWRAPIOC_GETEVENT_MULTI :
     case CNLWRAPIOC_SYNCRECV :
     case CNLWRAPIOC_STOP_EVENT : 
     case CNLWRAPIOC_SENDDATA :
+    case CNLWRAPIOC_SENDDATA_INLINE :
     case CNLWRAPIOC_RECVDATA :
     case CNLWRAPIOC_CANCEL :
         // common command
@@ -239,6 +244,41 @@ CNLFIT_asyncCbk(S_CNL_CMN_REQ *pCnlReq,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CNLFIT_inlineCbk
+ *-----------------------------------------------------------------*/
+/**
+ * CNL request completion callback function.
+ * this callback is used for inline send request, which is completed
+ * to the requester directly instead of the event list.
+ * @param     pCnlReq : the pointer to S_CNL_CMN_REQ
+ * @param     pMgr    : not used.
+ * @param     pCont   : the pointer to S_IO_CONTAINER
+ * @return    nothing.
+ * @note      IO_CONTAINER is the storage of the requester, and it may be
+ *            freed in done.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLFIT_inlineCbk(S_CNL_CMN_REQ *pCnlReq,
+                 void          *pMgr,
+                 void          *pCont)
+{
+
+    S_IO_CONTAINER    *pIoCont;
+    S_CNLIO_DONE_PACK  done;
+
+    pIoCont = (S_IO_CONTAINER *)pCont;
+
+    DBG_ASSERT(pCnlReq->type == CNL_REQ_TYPE_SEND_REQ);
+
+    done = pIoCont->done;
+    done.pioDone(done.pioArg, pCnlReq->status);
+
+    return;
+}
+
+
 /*-------------------------------------------------------------------
  * Function   : CNLFIT_convertEvent
  *-----------------------------------------------------------------*/
@@ -858,7 +898,11 @@ CNLFIT_cnlSendData(S_CTRL_MGR         *pCtrlMgr,
     // create SENDDATA request
     pIoCont->ioType            = CNLFIT_IO_TYPE_REQ;
     pIoCont->cnlReq.type       = CNL_REQ_TYPE_SEND_REQ;
-    pIoCont->cnlReq.pComplete  = CNLFIT_asyncCbk; // AsyncRequest.
+    if(pWrapData->sync == SYNC_REQUEST) {
+        pIoCont->cnlReq.pComplete  = NULL; // SyncRequest.
+    } else {
+        pIoCont->cnlReq.pComplete  = CNLFIT_asyncCbk; // AsyncRequest.
+    }
     pIoCont->cnlReq.pArg1      = (void *)pIoMgr;
     pIoCont->cnlReq.pArg2      = (void *)pIoCont;
     pIoCont->cnlReq.status     = CNL_SUCCESS;
@@ -875,6 +919,8 @@ CNLFIT_cnlSendData(S_CTRL_MGR         *pCtrlMgr,
     if((retval != SUCCESS) || (pIoCont->cnlReq.status != CNL_SUCCESS)) {
         DBG_ERR("cnlSendData : CNL_DATA.request failed[%d]\n", retval);
 
+        // SyncRequest may be failed at completion.
+        pWrapData->status = pIoCont->cnlReq.status;
         CNLFIT_freeIoContainer(pCtrlMgr, pIoCont);
 
         goto EXIT;
@@ -883,12 +929,82 @@ CNLFIT_cnlSendData(S_CTRL_MGR         *pCtrlMgr,
     // return back parameter
     pWrapData->status = pIoCont->cnlReq.status;
 
+    if(pWrapData->sync == SYNC_REQUEST) {
+        // SyncRequest is already completed, no completion event.
+        CNLFIT_freeIoContainer(pCtrlMgr, pIoCont);
+    }
+
 EXIT :
     return retval;
 
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CNLFIT_cnlSendInline
+ *-----------------------------------------------------------------*/
+/**
+ * CNL inline SENDDATA command (CNLWRAPIOC_SENDDATA_INLINE) handler.
+ * @param  pCtrlMgr : the pointer to S_CTRL_MGR.
+ * @param  pArg     : the pointer to S_CNLIO_ARG_BUCKET.
+ * @return SUCCESS (normally completion)
+ * @note   the request is AsyncRequest of lower module in the storage of
+ *         the requester, and it is not queued to the event list.
+ *         sendInline.done is called when it is completed, if
+ *         sendInline.accepted is set. it does not share the mutex and
+ *         the wait of SyncRequest, so the requester can cancel it and
+ *         bound the wait.
+ */
+/*-----------------------------------------------------------------*/
+static T_CMN_ERR
+CNLFIT_cnlSendInline(S_CTRL_MGR         *pCtrlMgr,
+                     S_CNLIO_ARG_BUCKET *pArg)
+{
+
+    T_CMN_ERR           retval = SUCCESS;
+    S_IO_CONTAINER     *pIoCont;
+    S_CNL_DATA_REQ     *pCnlData;
+    S_CNLWRAP_REQ_DATA *pWrapData;
+
+    pIoCont   = (S_IO_CONTAINER *)pArg->req.sendInline.pIoCont;
+    pCnlData  = &pIoCont->cnlReq.dataReq;
+    pWrapData = &pArg->req.sendInline.data;
+
+    CMN_MEMSET(pIoCont, 0x00, sizeof(S_IO_CONTAINER));
+
+    // create SENDDATA request
+    pIoCont->ioType            = CNLFIT_IO_TYPE_REQ;
+    pIoCont->cnlReq.type       = CNL_REQ_TYPE_SEND_REQ;
+    pIoCont->cnlReq.pComplete  = CNLFIT_inlineCbk;
+    pIoCont->cnlReq.pArg1      = (void *)pCtrlMgr;
+    pIoCont->cnlReq.pArg2      = (void *)pIoCont;
+    pIoCont->cnlReq.status     = CNL_SUCCESS;
+    pIoCont->done              = pArg->req.sendInline.done;
+
+    // convert request.
+    pCnlData->profileId   = pWrapData->profileId;
+    pCnlData->fragmented  = pWrapData->fragmented;
+    pCnlData->length      = pWrapData->length;
+    pCnlData->pData       = (void *)pWrapData->userBufAddr;
+
+    pIoCont->cnlReq.id    = pWrapData->requestId;
+
+    retval = pCtrlMgr->cnlOps.pRequest(pCtrlMgr->pCnlPtr, &pIoCont->cnlReq);
+
+    // status may be changed by the completion once it is queued.
+    pArg->req.sendInline.accepted = CNL_REQ_IS_ACCEPTED(&pIoCont->cnlReq);
+    if(!pArg->req.sendInline.accepted) {
+        DBG_ERR("cnlSendInline : CNL_DATA.request failed[%d]\n", retval);
+        pWrapData->status = pIoCont->cnlReq.status;
+    } else {
+        pWrapData->status = CNL_SUCCESS;
+    }
+
+    return retval;
+
+}
+
+
 /*-------------------------------------------------------------------
  * Function   : CNLFIT_cnlRecvData
  *-----------------------------------------------------------------*/
@@ -949,6 +1065,8 @@ CNLFIT_cnlRecvData(S_CTRL_MGR         *pCtrlMgr,
     if((retval != SUCCESS) || (pIoCont->cnlReq.status != CNL_SUCCESS)) {
         DBG_ERR("cnlRecvData : CNL_DATA.request failed[%d]\n", retval);
 
+        // queue overflow is returned by status.
+        pWrapData->status = pIoCont->cnlReq.status;
         CNLFIT_freeIoContainer(pCtrlMgr, pIoCont);
 
         goto EXIT;
@@ -1049,6 +1167,82 @@ CNLFIT_getEvent(S_CTRL_MGR         *pCtrlMgr,
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CNLFIT_getEventMulti
+ *-----------------------------------------------------------------*/
+/**
+ * GETEVENT_MULTI command(CNLWRAPIOC_GETEVENT_MULTI) handler.
+ * @param  pCtrlMgr : the pointer to the S_CTRL_MGR
+ * @param  pArg     : the pointer to S_CNLIO_ARG_BUCKET.
+ * @param  type     : request to WRAP or ADPT
+ * @return SUCCESS     (normally completion)
+ * @return ERR_BADPARM (invalid parameter)
+ * @return ERR_NOOBJ   (no event has occured)
+ * @note   events are taken from event queue by one lock.
+ */
+/*-----------------------------------------------------------------*/
+static T_CMN_ERR
+CNLFIT_getEventMulti(S_CTRL_MGR         *pCtrlMgr,
+                     S_CNLIO_ARG_BUCKET *pArg,
+                     int                 type)
+{
+
+    S_IO_MGR             *pIoMgr;
+    S_IO_CONTAINER       *pIoCont;
+    S_CNLWRAP_REQ_EVENTS *pEvents;
+    S_LIST                taken;
+    u32                   num = 0;
+
+    pEvents = &pArg->req.events;
+    pEvents->num = 0;
+
+    if((pEvents->pEvents == NULL) || (pEvents->maxNum == 0)) {
+        DBG_ERR("invalid event buffer(%p, %u).\n", pEvents->pEvents, pEvents->maxNum);
+        return ERR_BADPARM;
+    }
+
+    if(type == CNLFIT_DEVTYPE_CTRL) {
+        pIoMgr = &pCtrlMgr->ioMgr;
+    } else {
+        pIoMgr = &pCtrlMgr->adptMgr.ioMgr;
+    }
+
+    //
+    // take events from event queue at once.
+    //
+    CMN_LIST_INIT(&taken);
+
+    CMN_lockCpu(pIoMgr->lockId);
+    while(num < pEvents->maxNum) {
+        pIoCont = (S_IO_CONTAINER *)
+            CMN_LIST_REMOVE_HEAD(&pIoMgr->eventList, S_IO_CONTAINER, list);
+        if(pIoCont == NULL) {
+            break;
+        }
+        CMN_LIST_ADD_TAIL(&taken, pIoCont, S_IO_CONTAINER, list);
+        num++;
+    }
+    CMN_unlockCpu(pIoMgr->lockId);
+
+    if(num == 0) {
+        DBG_INFO("no event is queued.\n");
+        return ERR_NOOBJ;
+    }
+
+    //
+    // convert local events to I/F events.
+    //
+    while((pIoCont = (S_IO_CONTAINER *)
+           CMN_LIST_REMOVE_HEAD(&taken, S_IO_CONTAINER, list)) != NULL) {
+        CNLFIT_convertEvent(pCtrlMgr, &pEvents->pEvents[pEvents->num], pIoCont);
+        CNLFIT_freeIoContainer(pCtrlMgr, pIoCont);
+        pEvents->num++;
+    }
+
+    return SUCCESS;
+}
+
+
 /*-------------------------------------------------------------------
  * Function   : CNLFIT_stopEvent
  *-----------------------------------------------------------------*/
@@ -1449,6 +1643,10 @@ CNLFIT_cnlRequest(int                 type,
         retval = CNLFIT_cnlSendData(pCtrlMgr, pArg, type);
         break;
 
+    case CNLWRAPIOC_SENDDATA_INLINE :
+        retval = CNLFIT_cnlSendInline(pCtrlMgr, pArg);
+        break;
+
     case CNLWRAPIOC_RECVDATA :
         retval = CNLFIT_cnlRecvData(pCtrlMgr, pArg, type);
         break;
@@ -1467,6 +1665,10 @@ CNLFIT_cnlRequest(int                 type,
         retval = CNLFIT_getEvent(pCtrlMgr, pArg, type);
         break;
 
+    case CNLWRAPIOC_GETEVENT_MULTI :
+        retval = CNLFIT_getEventMulti(pCtrlMgr, pArg, type);
+        break;
+
     case CNLWRAPIOC_STOP_EVENT :
         retval = CNLFIT_stopEvent(pCtrlMgr, type);
         break;
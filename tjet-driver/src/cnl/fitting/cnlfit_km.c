@@ -111,5 +111,6 @@ EXPORT_SYMBOL(CNLFIT_open);
 EXPORT_SYMBOL(CNLFIT_close);
 EXPORT_SYMBOL(CNLFIT_searchEvent);
 EXPORT_SYMBOL(CNLFIT_ctrl);
+EXPORT_SYMBOL(CNLFIT_getDevNum);
 EXPORT_SYMBOL(CNLUP_registerCNL);
 EXPORT_SYMBOL(CNLUP_unregisterCNL);
@@ -45,6 +45,31 @@
 /*-------------------------------------------------------------------
  * Structure Definitions
  *-----------------------------------------------------------------*/
+/*
+ * @brief the structure that packages the completion function of the
+ *        inline send and that argument. it is called with the status
+ *        of the request in the context of lower module.
+ */
+typedef struct tagS_CNLIO_DONE_PACK {
+    void (*pioDone)(void *, S_CNLWRAP_STATUS);
+    void  *pioArg;
+} S_CNLIO_DONE_PACK;
+
+
+/**
+ * @brief CNL IO inline send request (not from user space).
+ *        data.userBufAddr and pIoCont are given by the requester, and
+ *        shall be kept until done is called. done is called only if
+ *        accepted is set on return.
+ */
+typedef struct tagS_CNLIO_REQ_INLINE {
+    S_CNLWRAP_REQ_DATA     data;
+    S_CNLIO_DONE_PACK      done;
+    void                  *pIoCont;  // storage of the request (S_IO_CONTAINER).
+    u8                     accepted; // queued to lower module.
+} S_CNLIO_REQ_INLINE;
+
+
 /**
  * @brief CNL IO argument bucket management box
  */
@@ -56,12 +81,15 @@ typedef struct tag_S_CNLIO_ARG_BUCKET  {
         S_CNLWRAP_REQ_ACCEPT   accept;
         S_CNLWRAP_REQ_RELEASE  release;
         S_CNLWRAP_REQ_DATA     data;
+        S_CNLWRAP_REQ_SENDFILE sendfile;
         S_CNLWRAP_REQ_CANCEL   cancel;
         S_CNLWRAP_REQ_PORT     port;
         S_CNLWRAP_EVENT        event;
+        S_CNLWRAP_REQ_EVENTS   events;
         u32                    adptId; // obsolete.
         S_CNLWRAP_STATS        stats;
         S_CNLWRAP_REQ_POWERSAVE powersave;
+        S_CNLIO_REQ_INLINE     sendInline;
     }req;
 }S_CNLIO_ARG_BUCKET;
 
@@ -93,5 +121,6 @@ extern T_CMN_ERR CNLFIT_open       (int, int, void **, S_CNLIO_FIT_CBKS *);
 extern T_CMN_ERR CNLFIT_close      (int, int, void *);
 extern T_CMN_ERR CNLFIT_searchEvent(int, void *);
 extern T_CMN_ERR CNLFIT_ctrl       (int, void *, uint, S_CNLIO_ARG_BUCKET *);
+extern int       CNLFIT_getDevNum  (void);
 
 #endif /* __CNLFIT_UPIF_H__ */
@@ -45,6 +45,7 @@ typedef enum tagE_BUSCMN_TYPE {
     BUSCMN_TYPE_PCI = 0x01,
     BUSCMN_TYPE_SDIO,
     BUSCMN_TYPE_USB,
+    BUSCMN_TYPE_SIM,   // simulated IZAN, no hardware.
 }E_BUSCMN_TYPE;
 typedef u8 T_BUSCMN_TYPE;
 
@@ -116,6 +117,8 @@ typedef struct tagS_BUSCMN_DRIVER {
 
 typedef void (*T_IRQ_HANDLER)(void *);
 
+struct scatterlist;
+
 
 /**
  * @brief profile for SDIO bus.
@@ -144,6 +147,10 @@ extern T_CMN_ERR BUSCMN_setIrqHandler(void *, T_IRQ_HANDLER, void *);
 extern T_CMN_ERR BUSCMN_ioctl(void *, T_BUSCMN_IOTYPE, void *);
 extern T_CMN_ERR BUSCMN_read(void *, u32, u32, void *, void *);
 extern T_CMN_ERR BUSCMN_write(void *, u32, u32, void *, void *);
+extern T_CMN_ERR BUSCMN_readSg(void *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUSCMN_writeSg(void *, u32, struct scatterlist *, u32, void *);
+extern T_CMN_ERR BUSCMN_beginBatch(void *);
+extern void      BUSCMN_endBatch(void *);
 
 // bus dependent function.
 extern int BUSCMN_busRequest(u8, void *);
@@ -35,13 +35,21 @@
 /*-------------------------------------------------------------------
  * Macro Definitions
  *-----------------------------------------------------------------*/
+/**
+ * @brief the number of CNL devices the per-device resources are reserved.
+ *        the resource of device n is (xxx_ID + n).
+ */
+#define CNL_DEV_RSC_NUM                  4
+
+
 /**
  * @brief Fixed memory pool object resource IDs
  */
 enum tagE_CMN_MPL_RSC_ID {
     // toscnl
     CNL_DEV_MPL_ID                   = 1,
-    CNL_DUMMY_REQ_MPL_ID,
+    CNL_DUMMY_REQ_MPL_ID,                                    // per device
+    CNL_DUMMY_REQ_MPL_ID_END         = CNL_DUMMY_REQ_MPL_ID + CNL_DEV_RSC_NUM - 1,
 
     // toscnlev
     CNLEV_DEV_MPL_ID,
@@ -52,6 +60,7 @@ enum tagE_CMN_MPL_RSC_ID {
 
     // cnl fit buffer
     CNLFIT_TXRX_MPL_ID,
+    CNLFIT_SMALL_MPL_ID,
 
 
     CMN_MPL_RSC_ID_MAX,
@@ -63,7 +72,7 @@ enum tagE_CMN_MPL_RSC_ID {
  */
 enum tagE_CMN_MPL_SIZE {
     // toscnl
-    CNL_DEV_MPL_SIZE                 = 640, // It is actual 512B, when a 64-bit data model is LP64.
+    CNL_DEV_MPL_SIZE                 = 1536, // It is actual 1360B, when a 64-bit data model is LP64.
     CNL_DUMMY_REQ_MPL_SIZE           = 144, // It is actual 136B, when a 64-bit data model is LP64.
 
     // toscnlev
@@ -80,7 +89,7 @@ enum tagE_CMN_MPL_SIZE {
  */
 enum tagE_CMN_MPL_CNT {
     // toscnl
-    CNL_DEV_MPL_CNT                  = 1,
+    CNL_DEV_MPL_CNT                  = CNL_DEV_RSC_NUM,
     CNL_DUMMY_REQ_MPL_CNT            = 10,
 
     // toscnlev
@@ -98,10 +107,11 @@ enum tagE_CMN_MPL_CNT {
 enum tagE_CMN_SEM_RSC_IDS {
     // toscnl
     CNL_DEV_MTX_ID                   = 1,
-    CNL_REQ_MTX_ID,
-    CNL_REQ_WAIT_ID,
-    CNL_CANCEL_WAIT_ID,
-    CNL_INT_MTX_ID,
+    CNL_REQ_MTX_ID,                                          // per device
+    CNL_REQ_WAIT_ID                  = CNL_REQ_MTX_ID     + CNL_DEV_RSC_NUM,
+    CNL_CANCEL_WAIT_ID               = CNL_REQ_WAIT_ID    + CNL_DEV_RSC_NUM,
+    CNL_INT_MTX_ID                   = CNL_CANCEL_WAIT_ID + CNL_DEV_RSC_NUM,
+    CNL_INT_MTX_ID_END               = CNL_INT_MTX_ID     + CNL_DEV_RSC_NUM - 1,
 
     // toscnlev
     CNLEV_DEV_MTX_ID,
@@ -122,8 +132,9 @@ enum tagE_CMN_SEM_RSC_IDS {
  */
 enum tagE_CMN_LOC_RSC_ID {
     // toscnl
-    CNL_DEV_SIG_LOC_ID               = 1,
-    CNL_DEV_MNG_LOC_ID,
+    CNL_DEV_MNG_LOC_ID               = 1,                    // per device
+    CNL_IRQ_LOC_ID                   = CNL_DEV_MNG_LOC_ID + CNL_DEV_RSC_NUM,
+    CNL_IRQ_LOC_ID_END               = CNL_IRQ_LOC_ID     + CNL_DEV_RSC_NUM - 1,
 
     CMN_LOC_RSC_ID_MAX,
 };
@@ -134,7 +145,9 @@ enum tagE_CMN_LOC_RSC_ID {
  */
 enum tagE_CMN_TASK_RSC_IDS {
     // toscnl
-    CNL_TASK_ID                      = 1,
+    CNL_TASK_ID                      = 1,                    // per device
+    CNL_IRQ_TASK_ID                  = CNL_TASK_ID + CNL_DEV_RSC_NUM,
+    CNL_IRQ_TASK_ID_END              = CNL_IRQ_TASK_ID + CNL_DEV_RSC_NUM - 1,
 
     CMN_TASK_RSC_ID_MAX,
 };
@@ -145,8 +158,9 @@ enum tagE_CMN_TASK_RSC_IDS {
  */
 enum tagE_CMN_TIMER_RSC_IDS {
     // toscnl
-    CNL_CMD_TOUT_TIM_ID              = 1,
-    CNL_CANCEL_TOUT_TIM_ID,
+    CNL_CMD_TOUT_TIM_ID              = 1,                    // per device
+    CNL_CANCEL_TOUT_TIM_ID           = CNL_CMD_TOUT_TIM_ID + CNL_DEV_RSC_NUM,
+    CNL_CANCEL_TOUT_TIM_ID_END       = CNL_CANCEL_TOUT_TIM_ID + CNL_DEV_RSC_NUM - 1,
 
     CNL_TIM_ID_MAX,
 };
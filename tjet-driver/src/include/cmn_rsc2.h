@@ -56,8 +56,9 @@ enum tagE_CMN_MPL_RSC_ID_EXT {
 enum tagE_CMN_MPL_SIZE_EXT {
     // toscnlfit
     CNLFIT_DEV_MPL_SIZE             = 256, // It is actual 248B, when a 64-bit data model is LP64.
-    CNLFIT_IOCONT_MPL_SIZE          = 160, // It is actual 160B, when a 64-bit data model is LP64.
+    CNLFIT_IOCONT_MPL_SIZE          = 176, // It is actual 176B, when a 64-bit data model is LP64.
     CNLFIT_TXRX_MPL_SIZE            = 65536, // SEND/RECEIVE Buffer size
+    CNLFIT_SMALL_MPL_SIZE           = 4096,  // inline SEND Buffer size
 
     // sipipe
     SIPIPE_MPL_INFO_SIZE             = 64, // temporary(acturl 38)
@@ -70,13 +71,14 @@ enum tagE_CMN_MPL_SIZE_EXT {
  */
 enum tagE_CMN_MPL_CNT_EXT {
     // toscnlfit
-    CNLFIT_DEV_MPL_CNT              = 1,
-    CNLFIT_IOCONT_MPL_CNT           = 10,
+    CNLFIT_DEV_MPL_CNT              = 2,
+    CNLFIT_IOCONT_MPL_CNT           = 10, // per CNL device.
 
     // sipipe
     SIPIPE_MPL_INFO_CNT              = 1,
     SIPIPE_MPL_CMD_CNT               = 10, 
     CNLFIT_TXRX_MPL_CNT              = 12,
+    CNLFIT_SMALL_MPL_CNT             = 16,
 };
 
 
@@ -34,6 +34,10 @@
 // reference types definition from kernel.
 #if defined(USE_OS_LINUX)
 #include <linux/types.h>
+#elif defined(USE_OS_POSIX)
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>  // uint, ulong, ushort.
 #endif
 
 
@@ -47,6 +51,17 @@
 /*-------------------------------------------------------------------
  * Structure definition
  *-----------------------------------------------------------------*/
+#if defined(USE_OS_POSIX)
+// same names as the kernel types.
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+#endif
 
 
 /*-------------------------------------------------------------------
@@ -34,6 +34,8 @@
 
 #if defined(USE_OS_LINUX)
 #include "../os/linux/include/sys_base.h"
+#elif defined(USE_OS_POSIX)
+#include "../os/posix/include/sys_base.h"
 #endif
 
 
@@ -56,6 +58,12 @@
 #define  CMN_TIME_FEVR            0xFFFF
 
 
+/**
+ * @breif the macros to define the attribute of the fixed memory pool
+ */
+#define  CMN_MPL_ATTR_PERCPU  0x00000001  // cache free blocks per CPU
+
+
 /*===================================================================
  * macros related to Semaphore
  *==================================================================*/
@@ -328,6 +336,19 @@ typedef struct tagS_RFPARAM_PLIST {
     }                                                               \
 }
 
+#define CMN_LIST_INSERT_BEFORE(hd, pos, elm, type, field) {         \
+    ((type *)(elm))->field.pNext = (void *)(pos);                   \
+    ((type *)(elm))->field.pPrev = ((type *)(pos))->field.pPrev;    \
+    if ((hd)->pNext == (void *)(pos)) {                             \
+        (hd)->pNext = (void *)(elm);                                \
+    }                                                               \
+    else {                                                          \
+        ((type *)(((type *)(pos))->field.pPrev))->field.pNext =     \
+            (void *)(elm);                                          \
+    }                                                               \
+    ((type *)(pos))->field.pPrev = (void *)(elm);                   \
+}
+
 /*-------------------------------------------------------------------
  * External Functions
  *-----------------------------------------------------------------*/
@@ -390,7 +411,9 @@ extern void        CMN_exitTask(void);
 extern T_CMN_ERR   CMN_terminateTask(u8);
 extern T_CMN_ERR   CMN_sleepTask(u16);
 extern T_CMN_ERR   CMN_wakeupTask(u8);
+extern T_CMN_ERR   CMN_setTaskAffinity(u8, int);
 extern T_CMN_ERR   CMN_delayTask(u16);
+extern T_CMN_ERR   CMN_delayTaskUs(u16);
 extern T_CMN_ERR   CMN_referTask(u8, S_CMN_REF_TSK *); // not supported
 
 /*===================================================================
@@ -402,6 +425,7 @@ extern T_CMN_ERR   CMN_deleteAlarmTim(u8);
 extern T_CMN_ERR   CMN_startAlarmTim(u8, u16);
 extern T_CMN_ERR   CMN_stopAlarmTim(u8);
 extern T_CMN_ERR   CMN_getTime(u32 *);
+extern T_CMN_ERR   CMN_getTimeUs(u32 *);
 extern T_CMN_ERR   CMN_referAlarmTim(u8, S_CMN_REF_TIM *); // not supported
 
 /*===================================================================
@@ -48,6 +48,18 @@
 #include <linux/slab.h>
 #include <linux/sched.h>
 #include <linux/list.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/highmem.h>
+#include <linux/workqueue.h>
+#include <linux/file.h>
+#include <linux/pagemap.h>
+#include <linux/hash.h>
+#include <linux/ktime.h>
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/completion.h>
 
 
 #include "cmn_type.h"
@@ -59,6 +71,10 @@
 #include "cmn_rsc.h"
 #include "cmn_rsc2.h"
 
+// tracepoints of toscnlfit are instantiated here.
+#define CREATE_TRACE_POINTS
+#include "cnlio_trace.h"
+
 
 /*-------------------------------------------------------------------
  * Macro Definitions
@@ -71,11 +87,68 @@
 #define CNLIO_ADPT_MAJOR_NO            0
 #define CNLIO_ADPT_MINOR_NO            0
 
-#define CNLIO_CTRL_MAX_CHANNEL         1
+#define CNLIO_CTRL_MAX_CHANNEL         CNLFIT_DEV_NUM // minors reserved for CnlFitCtrl<minor>
 #define CNLIO_ADPT_MAX_CHANNEL         1
 
 #define PADDING_4B(x)                  ((x + 3) & ~0x03)
 
+/**
+ * @brief zero-copy data request setting
+ *        the user buffer which satisfies these conditions is pinned and
+ *        passed to lower module directly. otherwise, TXRX memory pool
+ *        (or vmalloc area for the large request) is used as the bounce
+ *        buffer.
+ *        receive buffer shall not share the cache line with others.
+ */
+#define CNLIO_ZCOPY_MIN_LENGTH         PAGE_SIZE
+#define CNLIO_ZCOPY_SEND_ALIGN         4
+#define CNLIO_ZCOPY_RECV_ALIGN         PAGE_SIZE
+
+/**
+ * @brief max length of one data request.
+ *        lower module sends/receives it fragment by fragment.
+ */
+#define CNLIO_DATA_MAX_LENGTH          (16 * 1024 * 1024)
+
+/**
+ * @brief default wait of the inline send (ms), before it is cancelled.
+ *        the same wait is given to the completion of the cancel.
+ */
+#define CNLIO_INLINE_TOUT_MS           5000
+
+/**
+ * @brief shared ring index access (shared with user space)
+ */
+#define CNLIO_RING_READ(x)             (*(volatile u32 *)&(x))
+
+/**
+ * @brief requestId of ring data request (tagged slot index)
+ * @note  kernel addresses shall not be exposed to user space via
+ *        requestId (event, CQE, tracepoint).
+ */
+#define CNLIO_RING_REQ_ID_TAG          0x52490000UL
+#define CNLIO_RING_REQ_ID(slot)        (CNLIO_RING_REQ_ID_TAG | (ulong)(slot))
+#define CNLIO_RING_REQ_SLOT(id)        ((ulong)(id) - CNLIO_RING_REQ_ID_TAG)
+
+/**
+ * @brief async argument box index by requestId
+ */
+#define CNLIO_ASYNC_HASH_BITS          6
+#define CNLIO_ASYNC_HASH_SIZE          (1 << CNLIO_ASYNC_HASH_BITS)
+#define CNLIO_ASYNC_HASH(id)           hash_long((ulong)(id), CNLIO_ASYNC_HASH_BITS)
+
+/**
+ * @brief ioctl statistics (indexed by ioctl number - CNLIO_STAT_NR_BASE)
+ */
+#define CNLIO_STAT_NR_BASE             0x80
+#define CNLIO_STAT_NR_NUM              0x20
+
+/**
+ * @brief debugfs entry names.
+ */
+#define CNLIO_DEBUGFS_DIR              "toscnlfit"
+#define CNLIO_DEBUGFS_IOCTL            "ioctl"
+
 /*-------------------------------------------------------------------
  * Macro definition
  *-----------------------------------------------------------------*/
@@ -94,6 +167,8 @@
 typedef struct tag_S_CNLIO_ARG_BOX     {
     // list head
     struct list_head                   elm;
+    // requestId index (async data request only)
+    struct hlist_node                  hashElm;
     // indicator to be able to free or not to
     uint                               free;
     // command relative to this box
@@ -103,6 +178,13 @@ typedef struct tag_S_CNLIO_ARG_BOX     {
     // the pointer of user buffer
     void                              *pusr;
 
+    // pinned user pages (zero-copy data request only)
+    struct page                      **ppPages;
+    int                                nrPages;
+    void                              *pvmap;
+    // bounce buffer for the large data request
+    void                              *pvbuf;
+
     // the pointer to arg included in this box
     void                              *parg;
 
@@ -114,6 +196,53 @@ typedef struct tag_S_CNLIO_ARG_BOX     {
 } S_CNLIO_ARG_BOX;
 
 
+/**
+ * @brief CNL IO inline send wait
+ *        it is shared by the requester and the completion, and freed
+ *        with the data buffer by the last one, so the requester can
+ *        return before the request completes.
+ */
+typedef struct tagS_CNLIO_INLINE_WAIT {
+    // CNL request, kept until completion.
+    S_IO_CONTAINER                     ioCont;
+    // data buffer (SMALL memory pool)
+    void                              *pnBuf;
+
+    struct completion                  done;
+    S_CNLWRAP_STATUS                   status;
+    // requester and completion
+    atomic_t                           ref;
+
+} S_CNLIO_INLINE_WAIT;
+
+
+/**
+ * @brief CNL IO shared TX/RX ring
+ */
+typedef struct tagS_CNLIO_RING        {
+    // shared area(mmap) and its layout
+    void                              *pArea;
+    S_CNLWRAP_RING_HDR                *pHdr;
+    S_CNLWRAP_RING_SQE                *pSqe;
+    S_CNLWRAP_RING_CQE                *pCqe;
+    u8                                *pData;
+
+    // data slot management
+    u64                                slotUserData[CNLWRAP_RING_SLOT_NUM];
+    unsigned long                      slotBusy[BITS_TO_LONGS(CNLWRAP_RING_SLOT_NUM)];
+    u8                                 stopped;
+
+    // lock for submission/completion queue
+    struct semaphore                   sqSem;
+    struct semaphore                   cqSem;
+
+    // completion reaper
+    struct work_struct                 reapWork;
+    struct tagS_CNLIO_FIT_PRIV        *pPriv;
+
+} S_CNLIO_RING;
+
+
 /**
  * @brief CNL IO structure for control
  */
@@ -129,19 +258,57 @@ typedef struct tagS_CNLIO_FIT_PRIV    {
 
     // list head
     struct list_head                   async;
+    struct hlist_head                  asyncHash[CNLIO_ASYNC_HASH_SIZE];
 
     // CNL control information for fitting module.
     void                              *pInfo;
 
+    // shared TX/RX ring (NULL if not mapped)
+    S_CNLIO_RING                      *pRing;
+
 } S_CNLIO_FIT_PRIV;
 
 
+/**
+ * @brief CNL IO statistics of one ioctl command
+ */
+typedef struct tagS_CNLIO_IOC_STAT    {
+    uint                               cmd;
+    u64                                cnt;
+    u64                                errCnt;
+    u64                                totalNs;
+    u64                                maxNs;
+} S_CNLIO_IOC_STAT;
+
+
+/**
+ * @brief CNL IO statistics of async argument box lookup
+ */
+typedef struct tagS_CNLIO_LOOKUP_STAT {
+    u64                                cnt;
+    u64                                missCnt;
+    u64                                probeCnt;
+    u64                                totalNs;
+    u64                                maxNs;
+} S_CNLIO_LOOKUP_STAT;
+
+
+/**
+ * @brief CNL IO statistics of one CPU
+ */
+typedef struct tagS_CNLIO_IO_STAT     {
+    S_CNLIO_IOC_STAT                   ioc[CNLIO_STAT_NR_NUM];
+    S_CNLIO_LOOKUP_STAT                lookup;
+} S_CNLIO_IO_STAT;
+
+
 /*-------------------------------------------------------------------
  * Global Definitions
  *-----------------------------------------------------------------*/
 
 
 static dev_t                           g_ctrlDevNo;
+static int                             g_ctrlChNum; // CNL devices served, see CNLFIT_getDevNum.
 static dev_t                           g_adptDevNo;
 
 static struct cdev                     g_ctrlChar;
@@ -151,6 +318,22 @@ static struct cdev                     g_adptChar;
 struct class				*g_ctrlClass;
 struct class				*g_adptClass;
 
+/* ioctl statistics (per-CPU, summed up at debugfs read) */
+static DEFINE_PER_CPU(S_CNLIO_IO_STAT, g_ioStat);
+static struct dentry                  *g_debugfsDir;
+
+/* send/receive buffer count */
+static ushort                          g_txrxMplCnt = CNLFIT_TXRX_MPL_CNT;
+module_param_named(TxrxMplCnt, g_txrxMplCnt, ushort, S_IRUGO);
+
+/* inline send buffer count */
+static ushort                          g_smallMplCnt = CNLFIT_SMALL_MPL_CNT;
+module_param_named(SmallMplCnt, g_smallMplCnt, ushort, S_IRUGO);
+
+/* inline send wait (ms), then the request is cancelled */
+static uint                            g_inlineTout = CNLIO_INLINE_TOUT_MS;
+module_param_named(InlineTimeout, g_inlineTout, uint, S_IRUGO | S_IWUSR);
+
 /*-------------------------------------------------------------------
  * Inline Functions
  *-----------------------------------------------------------------*/
@@ -203,6 +386,70 @@ CNLIO_FIT_UNLOCK(S_CNLIO_FIT_PRIV *pPriv)
 }
 
 
+/**
+ * @brief async argument box list/index management.
+ *        caller shall hold CNLIO_FIT_LOCK.
+ */
+static inline void
+CNLIO_fitAddAsyncBox(S_CNLIO_FIT_PRIV *pPriv, S_CNLIO_ARG_BOX *pBox)
+{
+    list_add_tail(&pBox->elm, &pPriv->async);
+    hlist_add_head(&pBox->hashElm,
+                   &pPriv->asyncHash[CNLIO_ASYNC_HASH(pBox->arg.req.data.requestId)]);
+}
+
+static inline void
+CNLIO_fitDelAsyncBox(S_CNLIO_ARG_BOX *pBox)
+{
+    list_del(&pBox->elm);
+    hlist_del_init(&pBox->hashElm);
+}
+
+/**
+ * @brief account elapsed time of ioctl command.
+ */
+static inline void
+CNLIO_fitAddIocStat(uint cmd, ktime_t start, long retval)
+{
+    S_CNLIO_IOC_STAT *pStat;
+    u64               ns;
+    uint              nr = _IOC_NR(cmd) - CNLIO_STAT_NR_BASE;
+
+    if(nr >= CNLIO_STAT_NR_NUM) {
+        return;
+    }
+    ns    = (u64)ktime_to_ns(ktime_sub(ktime_get(), start));
+    pStat = &get_cpu_ptr(&g_ioStat)->ioc[nr];
+
+    pStat->cmd      = cmd;
+    pStat->cnt++;
+    pStat->totalNs += ns;
+    pStat->maxNs    = MAX(pStat->maxNs, ns);
+    if(retval != 0) {
+        pStat->errCnt++;
+    }
+    put_cpu_ptr(&g_ioStat);
+}
+
+/**
+ * @brief account async argument box lookup.
+ */
+static inline void
+CNLIO_fitAddLookupStat(ktime_t start, u32 probe, u32 miss)
+{
+    S_CNLIO_LOOKUP_STAT *pStat;
+    u64                  ns = (u64)ktime_to_ns(ktime_sub(ktime_get(), start));
+
+    pStat = &get_cpu_ptr(&g_ioStat)->lookup;
+
+    pStat->cnt++;
+    pStat->missCnt  += miss;
+    pStat->probeCnt += probe;
+    pStat->totalNs  += ns;
+    pStat->maxNs     = MAX(pStat->maxNs, ns);
+    put_cpu_ptr(&g_ioStat);
+}
+
 static inline int
 CNLIO_cmnErrToSysErr(T_CMN_ERR cmnErr) {
     switch(cmnErr) {
@@ -222,6 +469,27 @@ CNLIO_cmnErrToSysErr(T_CMN_ERR cmnErr) {
 }
 
 
+#if (KERNEL_VERSION(2,6,36) <= LINUX_VERSION_CODE) && (defined(_LP64) == 1)
+static inline void
+CNLIO_compat_convertEvent(S_CNLWRAP32_EVENT *pEv32, S_CNLWRAP_EVENT *pEv64)
+{
+    if (CNLWRAP_EVENT_DATA_REQ_COMP == pEv64->type) {
+        pEv32->type = pEv64->type;
+        pEv32->length = pEv64->length;
+        pEv32->dataReqComp.status = pEv64->dataReqComp.status;
+        pEv32->dataReqComp.requestId = (u32)pEv64->dataReqComp.requestId;
+        pEv32->dataReqComp.profileId = pEv64->dataReqComp.profileId;
+        pEv32->dataReqComp.direction = pEv64->dataReqComp.direction;
+        pEv32->dataReqComp.fragmented = pEv64->dataReqComp.fragmented;
+        pEv32->dataReqComp.length = pEv64->dataReqComp.length;
+    } else
+        memcpy(pEv32, pEv64, sizeof *pEv32);
+
+    return;
+}
+#endif
+
+
 static inline S_CNLWRAP_STATUS
 CNLIO_fitArgToStatus(int cmd, S_CNLIO_ARG_BUCKET *pArg)
 {
@@ -236,6 +504,7 @@ CNLIO_fitArgToStatus(int cmd, S_CNLIO_ARG_BUCKET *pArg)
         return pArg->req.release.status;
     case CNLWRAPIOC_SENDDATA :
     case CNLWRAPIOC_RECVDATA :
+    case CNLWRAPIOC_SENDFILE :
         return pArg->req.data.status;
     case CNLWRAPIOC_CANCEL:
         return pArg->req.cancel.status;
@@ -250,6 +519,7 @@ CNLIO_fitArgToStatus(int cmd, S_CNLIO_ARG_BUCKET *pArg)
         return pArg->req.powersave.status;
 
     case CNLWRAPIOC_GETEVENT :
+    case CNLWRAPIOC_GETEVENT_MULTI :
     case CNLWRAPIOC_SYNCRECV :
     case CNLWRAPIOC_STOP_EVENT :
     default :
@@ -281,6 +551,10 @@ CNLIO_fitGetInParamLength(int cmd)
         return sizeof(S_CNLWRAP_REQ_DATA);
         break;
 
+    case CNLWRAPIOC_SENDFILE :
+        return sizeof(S_CNLWRAP_REQ_SENDFILE);
+        break;
+
     case CNLWRAPIOC_CANCEL:
         return sizeof(S_CNLWRAP_REQ_CANCEL);
         break;
@@ -289,6 +563,10 @@ CNLIO_fitGetInParamLength(int cmd)
         return sizeof(S_CNLWRAP_REQ_POWERSAVE);
         break;
 
+    case CNLWRAPIOC_GETEVENT_MULTI:
+        return sizeof(S_CNLWRAP_REQ_EVENTS);
+        break;
+
     case CNLWRAPIOC_CLOSE :
     case CNLWRAPIOC_WAIT_CONNECT :
     case CNLWRAPIOC_CONFIRM :
@@ -332,6 +610,9 @@ CNLIO_fitGetOutParamLength(int cmd)
     case CNLWRAPIOC_GETEVENT:
         return sizeof(S_CNLWRAP_EVENT);
 
+    case CNLWRAPIOC_GETEVENT_MULTI:
+        return sizeof(S_CNLWRAP_REQ_EVENTS);
+
     case CNLWRAPIOC_CLOSE :
     case CNLWRAPIOC_WAIT_CONNECT :
     case CNLWRAPIOC_CONFIRM :
@@ -347,6 +628,9 @@ CNLIO_fitGetOutParamLength(int cmd)
     case CNLWRAPIOC_POWERSAVE:
         return sizeof(S_CNLWRAP_REQ_POWERSAVE);
 
+    case CNLWRAPIOC_SENDFILE :
+        // the argument is replaced with data request, only status is
+        // copied back in CNLIO_fitCmdFinisher().
     case CNLWRAPIOC_ENABLE_PORT :
     case CNLWRAPIOC_DISABLE_PORT :
     case CNLWRAPIOC_SYNCRECV :
@@ -374,13 +658,31 @@ static long             CNLIO_compat_fitIoctl(struct file *, uint, ulong);
 #endif
 #endif
 static uint             CNLIO_fitPoll(struct file *, struct poll_table_struct *);
+static int              CNLIO_fitMmap(struct file *, struct vm_area_struct *);
 
+static long             CNLIO_fitIoctlCmd      (S_CNLIO_FIT_PRIV *, uint, ulong);
 static void             CNLIO_fitNotifyEvent   (void *);
 static int              CNLIO_fitIoctlPreProc  (S_CNLIO_FIT_PRIV *, uint, void *, S_CNLIO_ARG_BOX *);
 static int              CNLIO_fitIoctlPostProc (S_CNLIO_FIT_PRIV *, S_CNLIO_ARG_BOX *, int);
 static int              CNLIO_fitCmdInitializer(S_CNLIO_FIT_PRIV *, S_CNLIO_ARG_BOX *);
 static int              CNLIO_fitCmdFinisher   (S_CNLIO_FIT_PRIV *, S_CNLIO_ARG_BOX *, int);
+static int              CNLIO_fitSendInline    (S_CNLIO_FIT_PRIV *, S_CNLWRAP_REQ_INLINE_DATA __user *);
+static void             CNLIO_fitInlineDone    (void *, S_CNLWRAP_STATUS);
+static void             CNLIO_fitPutInlineWait (S_CNLIO_INLINE_WAIT *);
+static S_CNLIO_ARG_BOX *CNLIO_fitLookupAsyncBox(S_CNLIO_FIT_PRIV *, ulong, u32 *);
 static S_CNLIO_ARG_BOX *CNLIO_fitSearchAsyncBox(S_CNLIO_FIT_PRIV *, ulong);
+static void             CNLIO_fitSearchAsyncBoxes(S_CNLIO_FIT_PRIV *, S_CNLWRAP_EVENT *, u32, S_CNLIO_ARG_BOX **);
+static int              CNLIO_fitFinishAsyncBox(S_CNLIO_ARG_BOX *, S_CNLWRAP_EVENT *);
+static void            *CNLIO_fitPinUserBuf    (S_CNLIO_ARG_BOX *, void *, u32);
+static int              CNLIO_fitMapFile       (S_CNLIO_ARG_BOX *, S_CNLWRAP_REQ_SENDFILE *, void **);
+static void            *CNLIO_fitPinFilePages  (S_CNLIO_ARG_BOX *, struct file *, u64, u32);
+static void             CNLIO_fitReleaseDataBuf(S_CNLIO_ARG_BOX *, void *, int);
+
+static S_CNLIO_RING    *CNLIO_fitRingCreate    (S_CNLIO_FIT_PRIV *);
+static void             CNLIO_fitRingDestroy   (S_CNLIO_RING *);
+static int              CNLIO_fitRingEnter     (S_CNLIO_FIT_PRIV *, S_CNLWRAP_RING_ENTER *);
+static int              CNLIO_fitRingReap      (S_CNLIO_RING *);
+static void             CNLIO_fitRingReapWork  (struct work_struct *);
 
 static int              CNLIO_fitArgBucketPurge(S_CNLIO_FIT_PRIV *);
 
@@ -412,6 +714,7 @@ CNLIO_fitOpen(struct inode *pInode,
 
     int                 major;
     int                 minor;
+    int                 i;
 
     major = MAJOR(pInode->i_rdev);
     minor = MINOR(pInode->i_rdev);
@@ -454,6 +757,9 @@ CNLIO_fitOpen(struct inode *pInode,
         init_waitqueue_head(&pfitPriv->waitEvt);
 
         INIT_LIST_HEAD(&pfitPriv->async);
+        for(i = 0; i < CNLIO_ASYNC_HASH_SIZE; i++) {
+            INIT_HLIST_HEAD(&pfitPriv->asyncHash[i]);
+        }
 
         // prepare for callbacks
         cbks.event.pioCbk = CNLIO_fitNotifyEvent;
@@ -511,6 +817,13 @@ CNLIO_fitRelease(struct inode *pInode,
         goto EXIT;
     }
 
+    // stop ring completion, events are discarded by close.
+    if(pfitPriv->pRing) {
+        ioctl_lock(&pfitPriv->pRing->cqSem);
+        pfitPriv->pRing->stopped = TRUE;
+        ioctl_unlock(&pfitPriv->pRing->cqSem);
+    }
+
     retval = CNLFIT_close(pfitPriv->type, pfitPriv->id, pfitPriv->pInfo);
 
     if(retval != SUCCESS) {
@@ -525,6 +838,9 @@ CNLIO_fitRelease(struct inode *pInode,
     //kfree(pfitPriv);
 
 EXIT:
+    if(pfitPriv->pRing) {
+        CNLIO_fitRingDestroy(pfitPriv->pRing);
+    }
     kfree(pfitPriv);
     return retval;
 }
@@ -558,6 +874,23 @@ CNLIO_fitPoll(struct file              *pFile,
     // wait event
     poll_wait(pFile, &pfitPriv->waitEvt, pWait);
 
+    if(pfitPriv->pRing) {
+        //
+        // shared ring is mapped, all events are delivered by
+        // completion queue.
+        //
+        S_CNLWRAP_RING_HDR *pHdr = pfitPriv->pRing->pHdr;
+
+        if(CNLFIT_searchEvent(pfitPriv->type, pfitPriv->pInfo) == ERR_INVSTAT) {
+            pollBitMask |= POLLHUP;
+        }
+        if(pHdr->cqTail != CNLIO_RING_READ(pHdr->cqHead)) {
+            pollBitMask |= (POLLIN | POLLRDNORM);
+        }
+
+        return pollBitMask;
+    }
+
     // if event is found, set bit to mask
     ret = CNLFIT_searchEvent(pfitPriv->type, pfitPriv->pInfo);
     switch(ret) {
@@ -575,6 +908,80 @@ CNLIO_fitPoll(struct file              *pFile,
     return pollBitMask;
 }
 
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitMmap
+ *-----------------------------------------------------------------*/
+/**
+ * method that maps the shared TX/RX ring to user space.
+ * @param     pFile     : the pointer to the file structure
+ * @param     pVma      : the pointer to the vm_area_struct structure
+ * @return    0           (success)
+ * @return    -ENODEV     (not controller device)
+ * @return    -EINVAL     (invalid mapping size or offset)
+ * @return    -EBUSY      (ioctl data request is pending)
+ * @return    -ENOMEM     (out of memory)
+ * @note      the ring is created at first mmap, and it is deleted
+ *            when the file is released.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitMmap(struct file           *pFile,
+              struct vm_area_struct *pVma)
+{
+
+    int                 retval = 0;
+    S_CNLIO_FIT_PRIV   *pfitPriv = NULL;
+    S_CNLIO_RING       *pRing    = NULL;
+
+
+    pfitPriv = (S_CNLIO_FIT_PRIV *)pFile->private_data;
+
+    if(pfitPriv->type != CNLFIT_DEVTYPE_CTRL) {
+        return -ENODEV;
+    }
+
+    if((pVma->vm_pgoff != 0) ||
+       ((pVma->vm_end - pVma->vm_start) != PAGE_ALIGN(CNLWRAP_RING_MMAP_SIZE))) {
+        DBG_ERR("invalid ring mapping(offset=%lu, size=%lu).\n",
+                pVma->vm_pgoff, pVma->vm_end - pVma->vm_start);
+        return -EINVAL;
+    }
+
+    CNLIO_FIT_LOCK(pfitPriv);
+
+    pRing = pfitPriv->pRing;
+    if(pRing == NULL) {
+        if(!list_empty(&pfitPriv->async)) {
+            DBG_ERR("ioctl data request is pending, can not create ring.\n");
+            retval = -EBUSY;
+            goto EXIT;
+        }
+
+        pRing = CNLIO_fitRingCreate(pfitPriv);
+        if(pRing == NULL) {
+            retval = -ENOMEM;
+            goto EXIT;
+        }
+    }
+
+    retval = remap_vmalloc_range(pVma, pRing->pArea, 0);
+    if(retval != 0) {
+        DBG_ERR("remap ring failed[%d].\n", retval);
+        if(pfitPriv->pRing == NULL) {
+            CNLIO_fitRingDestroy(pRing);
+        }
+        goto EXIT;
+    }
+
+    pfitPriv->pRing = pRing;
+
+EXIT:
+    CNLIO_FIT_UNLOCK(pfitPriv);
+
+    return retval;
+}
+
 /*-------------------------------------------------------------------
  * Function   : CNLIO_fitIoCtl
  *-----------------------------------------------------------------*/
@@ -603,17 +1010,79 @@ CNLIO_fitIoctl(struct file  *pFile,
                uint          cmd,
                ulong         arg)
 #endif
+{
+    long                retval;
+    ktime_t             start = ktime_get();
+
+    trace_cnlio_ioctl_enter(cmd);
+
+    // get the private data of the Jet driver
+    retval = CNLIO_fitIoctlCmd((S_CNLIO_FIT_PRIV *)pFile->private_data, cmd, arg);
+
+    CNLIO_fitAddIocStat(cmd, start, retval);
+    trace_cnlio_ioctl_exit(cmd, retval);
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitIoctlCmd
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that handles the ioctl command.
+ * @param     pfitPriv  : the pointer to the S_CNLIO_FIT_PRIV structure
+ * @param     cmd       : the command  of ioctl
+ * @param     arg       : the argument of ioctl
+ * @return    0           (success)
+ * @return    -EBUSY      (device busy)
+ * @return    -ENOMEM     (out of memory)
+ * @return    -EFALUT     (bad address)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static long
+CNLIO_fitIoctlCmd(S_CNLIO_FIT_PRIV *pfitPriv,
+                  uint              cmd,
+                  ulong             arg)
 {
     int                 retval   = 0;
     T_CMN_ERR           status;
 
-    S_CNLIO_FIT_PRIV  *pfitPriv = NULL;
     S_CNLIO_ARG_BOX    *pBox     = NULL;
     int                 free;
 
 
-    // get the private data of the Jet driver
-    pfitPriv = (S_CNLIO_FIT_PRIV *)pFile->private_data;
+    if(cmd == CNLWRAPIOC_RING_ENTER) {
+        S_CNLWRAP_RING_ENTER enter;
+
+        if(copy_from_user(&enter, (void *)arg, sizeof(enter))) {
+            return -EFAULT;
+        }
+        retval = CNLIO_fitRingEnter(pfitPriv, &enter);
+        if(retval != 0) {
+            return retval;
+        }
+        if(copy_to_user((void *)arg, &enter, sizeof(enter))) {
+            return -EFAULT;
+        }
+        return 0;
+    }
+
+    if(cmd == CNLWRAPIOC_SENDDATA_INLINE) {
+        // small message is completed in this ioctl without the arg box.
+        return CNLIO_fitSendInline(pfitPriv, (S_CNLWRAP_REQ_INLINE_DATA __user *)arg);
+    }
+
+    if((pfitPriv->pRing != NULL) &&
+       ((cmd == CNLWRAPIOC_SENDDATA) ||
+        (cmd == CNLWRAPIOC_RECVDATA) ||
+        (cmd == CNLWRAPIOC_SENDFILE) ||
+        (cmd == CNLWRAPIOC_GETEVENT) ||
+        (cmd == CNLWRAPIOC_GETEVENT_MULTI))) {
+        // data request and event are handled by the shared ring.
+        return -EBUSY;
+    }
 
     //
     // allocate the memory for the argument
@@ -635,11 +1104,23 @@ CNLIO_fitIoctl(struct file  *pFile,
         goto EXIT;
     }
 
+    if((cmd == CNLWRAPIOC_SENDDATA) ||
+       (cmd == CNLWRAPIOC_RECVDATA) ||
+       (cmd == CNLWRAPIOC_SENDFILE)) {
+        trace_cnlio_data_req(cmd,
+                             pBox->arg.req.data.requestId,
+                             pBox->arg.req.data.profileId,
+                             pBox->arg.req.data.length);
+    }
+
 
     //
     // handle ioctl command
     //
-    status = CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo, cmd, pBox->parg);
+    // SENDFILE is requested to lower module as SENDDATA.
+    status = CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo,
+                         (cmd == CNLWRAPIOC_SENDFILE) ? CNLWRAPIOC_SENDDATA : cmd,
+                         pBox->parg);
     if(status != SUCCESS) {
         retval = CNLIO_cmnErrToSysErr(status);
     }
@@ -689,6 +1170,12 @@ CNLIO_fitNotifyEvent(void *pArg)
 
     pfitPriv = (S_CNLIO_FIT_PRIV *)pArg;
 
+    if(pfitPriv->pRing) {
+        // move event to completion queue, then wake poll.
+        schedule_work(&pfitPriv->pRing->reapWork);
+        return;
+    }
+
     // wake poll
     wake_up_interruptible(&pfitPriv->waitEvt);
 
@@ -745,10 +1232,16 @@ CNLIO_fitIoctlPreProc(S_CNLIO_FIT_PRIV *pfitPriv,
     pArg = &pBox->arg;
 
     INIT_LIST_HEAD(&pBox->elm);
+    INIT_HLIST_NODE(&pBox->hashElm);
     pBox->cmd    = cmd;
     pBox->puarg  = puArg;
     pBox->parg   = (void *)pArg;
 
+    pBox->ppPages = NULL;
+    pBox->nrPages = 0;
+    pBox->pvmap   = NULL;
+    pBox->pvbuf   = NULL;
+
     retval = CNLIO_fitCmdInitializer(pfitPriv, pBox);
 
 
@@ -796,9 +1289,10 @@ CNLIO_fitIoctlPostProc(S_CNLIO_FIT_PRIV *pfitPriv,
         goto EXIT;
     }
 
-    if((pBox->cmd == CNLWRAPIOC_SENDDATA) || (pBox->cmd == CNLWRAPIOC_RECVDATA)) {
+    if((pBox->cmd == CNLWRAPIOC_SENDDATA) || (pBox->cmd == CNLWRAPIOC_RECVDATA) ||
+       (pBox->cmd == CNLWRAPIOC_SENDFILE)) {
         //
-        // SENDDATA/RECVDATA request is Async request.
+        // SENDDATA/RECVDATA/SENDFILE request is Async request.
         // return only status.
         //
         pArg->req.data.status = CNLWRAP_REQ_PENDING;
@@ -825,35 +1319,27 @@ CNLIO_fitIoctlPostProc(S_CNLIO_FIT_PRIV *pfitPriv,
 
         // if found
         if(pListedBox) {
-            void *puBuf;
-            void *pnBuf;
-
-            ioctl_lock(&pListedBox->sema);
-
-            puBuf = (void *)pListedBox->pusr;
-            pnBuf = (void *)pListedBox->arg.req.data.userBufAddr;
-
-            if((pListedBox->cmd == CNLWRAPIOC_RECVDATA) &&
-               (pevent->dataReqComp.status == CNL_SUCCESS)) {
-                //
-                // Async receive request normally completed.
-                // copy back the received data to user buffer.
-                //
-                DBG_ASSERT((ulong)pListedBox->pusr == pevent->dataReqComp.requestId);
-                if(copy_to_user(puBuf, pnBuf, pevent->dataReqComp.length)) {
-                    DBG_ASSERT(0);
-                    retval = -EFAULT;
-                }
-            }
-            if(pnBuf){
-                CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, pnBuf);
-                DBG_INFO("CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
-            }
+            retval = CNLIO_fitFinishAsyncBox(pListedBox, pevent);
+        }
+    }
+
+    //
+    // finish the async requests of the got events in bulk.
+    //
+    if(pBox->cmd == CNLWRAPIOC_GETEVENT_MULTI) {
+
+        S_CNLWRAP_REQ_EVENTS *pevents;
+        S_CNLIO_ARG_BOX      *pListedBoxes[CNLWRAP_EVENT_MULTI_MAX];
+        u32                   i;
 
+        pevents = &pBox->arg.req.events;
 
-            ioctl_unlock(&pListedBox->sema);
+        CNLIO_fitSearchAsyncBoxes(pfitPriv, pevents->pEvents, pevents->num, pListedBoxes);
 
-            kfree(pListedBox);
+        for(i = 0; i < pevents->num; i++) {
+            if(pListedBoxes[i]) {
+                retval = CNLIO_fitFinishAsyncBox(pListedBoxes[i], &pevents->pEvents[i]);
+            }
         }
     }
     
@@ -883,9 +1369,13 @@ CNLIO_fitCmdInitializer(S_CNLIO_FIT_PRIV *pfitPriv,
     int  retval  = 0;
     u32  ubufLen = 0;
     u32  copyLen = 0;
+    u8   zcopy   = FALSE;
 
     S_CNLIO_ARG_BUCKET  *pArg   = NULL;
     S_CNLWRAP_REQ_DATA  *pdataReq;
+    S_CNLWRAP_REQ_SENDFILE sendfile;
+    S_CNLWRAP_REQ_EVENTS *pevents;
+    S_CNLWRAP_EVENT     *pnEvents;
     void                *puBuf  = NULL;
     void                *pnBuf  = NULL;
     void               **ppData = NULL;
@@ -903,17 +1393,77 @@ CNLIO_fitCmdInitializer(S_CNLIO_FIT_PRIV *pfitPriv,
     case CNLWRAPIOC_RECVDATA:
         pdataReq = &pArg->req.data;
 
+        // the arg box is completed by event, SyncRequest is only for inline.
+        pdataReq->sync = ASYNC_REQUEST;
+
         if((pdataReq->length == 0) || ((void *)pdataReq->userBufAddr == NULL))
            break;  // because these are checked in lower moudule.
 
         puBuf   = (void *)pdataReq->userBufAddr;
         ppData  = (void **)(&pdataReq->userBufAddr);
 
+        if(pdataReq->length > CNLIO_DATA_MAX_LENGTH) {
+            DBG_ERR("data length[%u] exceeds max length.\n", pdataReq->length);
+            retval = -EINVAL;
+            goto EXIT;
+        }
+
         ubufLen =  PADDING_4B(pdataReq->length);
 
+        // the device writes 4B padded length, so the user pages receive
+        // whole words only. a request with partial last word is bounced.
+        zcopy = (pBox->cmd == CNLWRAPIOC_SENDDATA) || (ubufLen == pdataReq->length);
+
         if(pBox->cmd == CNLWRAPIOC_SENDDATA)
             copyLen = pdataReq->length;
 
+        break;
+    case CNLWRAPIOC_SENDFILE:
+        // the argument is rewritten to data request below.
+        sendfile = pArg->req.sendfile;
+
+        if((sendfile.length == 0) || (sendfile.length > CNLIO_DATA_MAX_LENGTH)) {
+            DBG_ERR("invalid sendfile length[%u].\n", sendfile.length);
+            retval = -EINVAL;
+            goto EXIT;
+        }
+
+        retval = CNLIO_fitMapFile(pBox, &sendfile, &pnBuf);
+        if(retval != 0) {
+            goto EXIT;
+        }
+
+        pdataReq = &pArg->req.data;
+        pdataReq->profileId   = sendfile.profileId;
+        pdataReq->fragmented  = sendfile.fragmented;
+        pdataReq->length      = sendfile.length;
+        pdataReq->userBufAddr = pnBuf;
+        pdataReq->sync        = FALSE;
+        pdataReq->requestId   = sendfile.requestId;
+
+        CNLIO_FIT_LOCK(pfitPriv);
+        CNLIO_fitAddAsyncBox(pfitPriv, pBox);
+        CNLIO_FIT_UNLOCK(pfitPriv);
+
+        break;
+    case CNLWRAPIOC_GETEVENT_MULTI:
+        pevents = &pArg->req.events;
+
+        if((pevents->maxNum == 0) || (pevents->pEvents == NULL))
+           break;  // because these are checked in lower moudule.
+
+        pevents->maxNum = MIN(pevents->maxNum, CNLWRAP_EVENT_MULTI_MAX);
+
+        pnEvents = kmalloc(sizeof(S_CNLWRAP_EVENT) * pevents->maxNum, GFP_KERNEL);
+        if(pnEvents == NULL) {
+            retval = -ENOMEM;
+            goto EXIT;
+        }
+
+        // exchange the pointer to the event array between user and kernel
+        pBox->pusr       = pevents->pEvents;
+        pevents->pEvents = pnEvents;
+
         break;
     default:
         break;
@@ -921,15 +1471,33 @@ CNLIO_fitCmdInitializer(S_CNLIO_FIT_PRIV *pfitPriv,
 
 
     if(puBuf) {
-        retval = CMN_getFixedMemPool(CNLFIT_TXRX_MPL_ID,
-                                            &pnBuf, CMN_TIME_FEVR);
-        DBG_INFO("CMN_getFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
-
-        if(copyLen) {
-            if(copy_from_user(pnBuf, puBuf, copyLen)) {
-                retval = -EFAULT;
+        //
+        // try to pin the user buffer at first.
+        // if it is not suitable, fall back to the bounce buffer.
+        //
+        pnBuf = (zcopy) ? CNLIO_fitPinUserBuf(pBox, puBuf, ubufLen) : NULL;
+        if((pnBuf == NULL) && (ubufLen > CNLFIT_TXRX_MPL_SIZE)) {
+            // large request, lower module streams it from vmalloc area.
+            pnBuf = vmalloc_32(ubufLen);
+            if(pnBuf == NULL) {
+                DBG_ERR("allocate bounce buffer[%u] failed.\n", ubufLen);
+                retval = -ENOMEM;
                 goto EXIT;
             }
+            pBox->pvbuf = pnBuf;
+        } else if(pnBuf == NULL) {
+            retval = CMN_getFixedMemPool(CNLFIT_TXRX_MPL_ID,
+                                                &pnBuf, CMN_TIME_FEVR);
+            DBG_INFO("CMN_getFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
+        }
+
+        if(pBox->ppPages == NULL) {
+            if(copyLen) {
+                if(copy_from_user(pnBuf, puBuf, copyLen)) {
+                    retval = -EFAULT;
+                    goto EXIT;
+                }
+            }
         }
 
         // exchange the pointer to the memroy between user and kernel
@@ -937,15 +1505,14 @@ CNLIO_fitCmdInitializer(S_CNLIO_FIT_PRIV *pfitPriv,
         *ppData    = pnBuf;
 
          CNLIO_FIT_LOCK(pfitPriv);
-         list_add_tail(&pBox->elm, &pfitPriv->async);
+         CNLIO_fitAddAsyncBox(pfitPriv, pBox);
          CNLIO_FIT_UNLOCK(pfitPriv);
     }
 
 EXIT:
     if(retval != 0) {
 	if(pnBuf){
-		CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, pnBuf);
-		DBG_INFO("CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
+		CNLIO_fitReleaseDataBuf(pBox, pnBuf, FALSE);
 	}
     }
 
@@ -983,6 +1550,20 @@ CNLIO_fitCmdFinisher(S_CNLIO_FIT_PRIV *pfitPriv,
     // execute post-processing if needed.
     // this prosess depends on each command.
     //
+    if((pBox->cmd == CNLWRAPIOC_GETEVENT_MULTI) && (pBox->pusr != NULL)) {
+        S_CNLWRAP_REQ_EVENTS *pevents = &pArg->req.events;
+
+        // copy back the got events, and restore the user pointer.
+        if((errFlag == 0) && (pevents->num > 0)) {
+            if(copy_to_user(pBox->pusr, pevents->pEvents,
+                            sizeof(S_CNLWRAP_EVENT) * pevents->num)) {
+                retval = -EFAULT;
+            }
+        }
+        kfree(pevents->pEvents);
+        pevents->pEvents = pBox->pusr;
+    }
+
     length = CNLIO_fitGetOutParamLength(pBox->cmd);
 
     if(length > 0) {
@@ -991,18 +1572,25 @@ CNLIO_fitCmdFinisher(S_CNLIO_FIT_PRIV *pfitPriv,
         }
     }
 
-    if((pBox->cmd == CNLWRAPIOC_SENDDATA) || (pBox->cmd == CNLWRAPIOC_RECVDATA)) {
+    if(pBox->cmd == CNLWRAPIOC_SENDFILE) {
+        if(copy_to_user(&((S_CNLWRAP_REQ_SENDFILE *)pBox->puarg)->status,
+                        &pArg->req.data.status, sizeof(S_CNLWRAP_STATUS))) {
+            retval = -EFAULT;
+        }
+    }
+
+    if((pBox->cmd == CNLWRAPIOC_SENDDATA) || (pBox->cmd == CNLWRAPIOC_RECVDATA) ||
+       (pBox->cmd == CNLWRAPIOC_SENDFILE)) {
         if(errFlag) {
             DBG_INFO("DataRequest failed, remove from async queue and free data buffer.\n");
 
             CNLIO_FIT_LOCK(pfitPriv);
-            list_del(&pBox->elm);
+            CNLIO_fitDelAsyncBox(pBox);
             CNLIO_FIT_UNLOCK(pfitPriv);
 
             pnBuf = (void *)pBox->arg.req.data.userBufAddr;
 
-            CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, pnBuf);
-            DBG_INFO("CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
+            CNLIO_fitReleaseDataBuf(pBox, pnBuf, FALSE);
 
             pBox->free = TRUE;
         } else {
@@ -1020,198 +1608,1239 @@ CNLIO_fitCmdFinisher(S_CNLIO_FIT_PRIV *pfitPriv,
     return retval;
 }
 
-#if (KERNEL_VERSION(2,6,36) <= LINUX_VERSION_CODE) && (defined(_LP64) == 1)
+
 /*-------------------------------------------------------------------
- * Function   : CNLIO_compat_fitIoctl
+ * Function   : CNLIO_fitSendInline
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that sends the data embedded in the argument,
+ * and waits for its completion.
+ * @param     pfitPriv  : the pointer to the S_CNLIO_FIT_PRIV structure
+ * @param     puReq     : the pointer to the user S_CNLWRAP_REQ_INLINE_DATA
+ * @return    0           (success)
+ * @return    -EINVAL     (invalid length)
+ * @return    -ENOMEM     (out of memory)
+ * @return    -EFALUT     (bad address)
+ * @return    -EINTR      (interrupted, the request is cancelled)
+ * @return    -ETIMEDOUT  (not completed in InlineTimeout ms)
+ * @note      the request does not make the arg box, the async list entry
+ *            and the completion event. it has own completion, and does
+ *            not share the mutex and the wait of SyncRequest.
+ *            on signal or timeout the request is cancelled by requestId,
+ *            and the completion of the cancel is waited for the same
+ *            time. the data is copied into SMALL memory pool, which is
+ *            released with the wait by the completion if it comes later.
+ *            status of the request is returned to puReq->status.
+ *            requestId is the one given by user.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitSendInline(S_CNLIO_FIT_PRIV                 *pfitPriv,
+                    S_CNLWRAP_REQ_INLINE_DATA __user *puReq)
+{
+
+    int                  retval = 0;
+    long                 wait;
+    T_CMN_ERR            status;
+    S_CNLIO_ARG_BUCKET   arg;
+    S_CNLWRAP_REQ_DATA  *pdataReq;
+    S_CNLIO_INLINE_WAIT *pWait;
+
+
+    memset(&arg, 0, sizeof(arg));
+    pdataReq = &arg.req.sendInline.data;
+
+    if(get_user(pdataReq->profileId,  &puReq->profileId)  ||
+       get_user(pdataReq->fragmented, &puReq->fragmented) ||
+       get_user(pdataReq->length,     &puReq->length)     ||
+       get_user(pdataReq->requestId,  &puReq->requestId)) {
+        return -EFAULT;
+    }
+
+    if((pdataReq->length == 0) || (pdataReq->length > CNLWRAP_INLINE_DATA_MAX)) {
+        DBG_ERR("invalid inline data length[%u].\n", pdataReq->length);
+        return -EINVAL;
+    }
+
+    pWait = kmalloc(sizeof(S_CNLIO_INLINE_WAIT), GFP_KERNEL);
+    if(pWait == NULL) {
+        return -ENOMEM;
+    }
+    memset(&pWait->ioCont, 0, sizeof(pWait->ioCont));
+    init_completion(&pWait->done);
+    pWait->status = CNL_SUCCESS;
+    atomic_set(&pWait->ref, 1);
+
+    status = CMN_getFixedMemPool(CNLFIT_SMALL_MPL_ID, &pWait->pnBuf, CMN_TIME_FEVR);
+    if(status != SUCCESS) {
+        kfree(pWait);
+        return -ENOMEM;
+    }
+
+    if(copy_from_user(pWait->pnBuf, puReq->data, pdataReq->length)) {
+        retval = -EFAULT;
+        goto EXIT;
+    }
+
+    pdataReq->userBufAddr           = pWait->pnBuf;
+    pdataReq->sync                  = ASYNC_REQUEST;
+    arg.req.sendInline.pIoCont      = &pWait->ioCont;
+    arg.req.sendInline.done.pioDone = CNLIO_fitInlineDone;
+    arg.req.sendInline.done.pioArg  = pWait;
+
+    // the completion holds the wait until it is called.
+    atomic_inc(&pWait->ref);
+    status = CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo,
+                         CNLWRAPIOC_SENDDATA_INLINE, &arg);
+    if(!arg.req.sendInline.accepted) {
+        // not queued, the completion is never called.
+        atomic_dec(&pWait->ref);
+        if(status != SUCCESS) {
+            retval = CNLIO_cmnErrToSysErr(status);
+            goto EXIT;
+        }
+        pWait->status = pdataReq->status;
+        goto STATUS;
+    }
+
+    wait = wait_for_completion_interruptible_timeout(&pWait->done,
+                                                     msecs_to_jiffies(g_inlineTout));
+    if(wait <= 0) {
+        retval = (wait == 0) ? -ETIMEDOUT : -EINTR;
+        DBG_ERR("inline send[0x%lx] is not completed[%d], cancel it.\n",
+                pdataReq->requestId, retval);
+
+        memset(&arg, 0, sizeof(arg));
+        arg.req.cancel.requestId = pdataReq->requestId;
+        CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo, CNLWRAPIOC_CANCEL, &arg);
+
+        // the cancelled or completing request calls the completion.
+        wait = wait_for_completion_killable_timeout(&pWait->done,
+                                                    msecs_to_jiffies(g_inlineTout));
+        if(wait <= 0) {
+            // the buffer is released by the completion.
+            goto EXIT;
+        }
+        if(pWait->status == CNL_SUCCESS) {
+            // completed before cancel.
+            retval = 0;
+        }
+    }
+
+STATUS:
+    if(put_user(pWait->status, &puReq->status)) {
+        retval = -EFAULT;
+    }
+
+EXIT:
+    CNLIO_fitPutInlineWait(pWait);
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitInlineDone
+ *-----------------------------------------------------------------*/
+/**
+ * completion of the inline send, called by lower module.
+ * @param     pArg      : the pointer to the S_CNLIO_INLINE_WAIT
+ * @param     status    : the status of the request
+ * @return    nothing.
+ * @note      the requester may be gone, the wait is released here then.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitInlineDone(void             *pArg,
+                    S_CNLWRAP_STATUS  status)
+{
+
+    S_CNLIO_INLINE_WAIT *pWait = (S_CNLIO_INLINE_WAIT *)pArg;
+
+    pWait->status = status;
+    complete(&pWait->done);
+    CNLIO_fitPutInlineWait(pWait);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitPutInlineWait
+ *-----------------------------------------------------------------*/
+/**
+ * drop a reference of the inline send wait.
+ * @param     pWait     : the pointer to the S_CNLIO_INLINE_WAIT
+ * @return    nothing.
+ * @note      the last one releases the data buffer and the wait.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitPutInlineWait(S_CNLIO_INLINE_WAIT *pWait)
+{
+
+    if(atomic_dec_and_test(&pWait->ref)) {
+        CMN_releaseFixedMemPool(CNLFIT_SMALL_MPL_ID, pWait->pnBuf);
+        kfree(pWait);
+    }
+
+    return;
+}
+
+#if (KERNEL_VERSION(2,6,36) <= LINUX_VERSION_CODE) && (defined(_LP64) == 1)
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_compat_fitIoctl
  *-----------------------------------------------------------------*/
 static long
 CNLIO_compat_fitIoctl(struct file * pFile,
                       uint          cmd,
                       ulong         arg)
 {
-    long retval = -EINVAL;
-    void __user * arg32 = compat_ptr(arg);
+    long retval = -EINVAL;
+    void __user * arg32 = compat_ptr(arg);
+
+    DBG_INFO("CNLIO_compat_fitIoctl(cmd=%s)+\n", CNLFIT_cmdToString(cmd));
+    DBG_INFO("#####CNLIO_compat_fitIoctl(cmd=%x)+\n", cmd);
+
+    switch (cmd) {
+    case CNLWRAPIOC_SENDDATA:
+    case CNLWRAPIOC_RECVDATA: {
+        S_CNLWRAP32_REQ_DATA req32;
+        S_CNLWRAP_REQ_DATA req64;
+        S_CNLWRAP_REQ_DATA __user * arg64;
+
+        arg64 = compat_alloc_user_space(sizeof *arg64);
+
+        if (copy_from_user(&req32, arg32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req64.profileId = req32.profileId;
+        req64.fragmented = req32.fragmented;
+        req64.length = req32.length;
+        req64.userBufAddr = compat_ptr(req32.userBufAddr);
+        req64.sync = req32.sync;
+        req64.requestId = (ulong)compat_ptr(req32.requestId);
+
+        if (copy_to_user(arg64, &req64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+
+        if (copy_from_user(&req64, arg64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req32.status = req64.status;
+
+        if (copy_to_user(arg32, &req32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        }
+        break;
+
+    case CNLWRAPIOC_SENDFILE: {
+        S_CNLWRAP32_REQ_SENDFILE req32;
+        S_CNLWRAP_REQ_SENDFILE req64;
+        S_CNLWRAP_REQ_SENDFILE __user * arg64;
+
+        arg64 = compat_alloc_user_space(sizeof *arg64);
+
+        if (copy_from_user(&req32, arg32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req64.profileId = req32.profileId;
+        req64.fragmented = req32.fragmented;
+        req64.fd = req32.fd;
+        req64.offset = ((u64)req32.offsetHigh << 32) | req32.offsetLow;
+        req64.length = req32.length;
+        req64.requestId = (ulong)compat_ptr(req32.requestId);
+
+        if (copy_to_user(arg64, &req64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+
+        if (copy_from_user(&req64, arg64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req32.status = req64.status;
+
+        if (copy_to_user(arg32, &req32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        }
+        break;
+
+    case CNLWRAPIOC_GETEVENT: {
+        S_CNLWRAP32_EVENT req32;
+        S_CNLWRAP_EVENT req64;
+        S_CNLWRAP_EVENT __user * arg64;
+
+        arg64 = compat_alloc_user_space(sizeof *arg64);
+
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+
+        if (copy_from_user(&req64, arg64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        CNLIO_compat_convertEvent(&req32, &req64);
+
+        if (copy_to_user(arg32, &req32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        }
+        break;
+
+    case CNLWRAPIOC_GETEVENT_MULTI: {
+        u32 i;
+        S_CNLWRAP32_REQ_EVENTS req32;
+        S_CNLWRAP_REQ_EVENTS req64;
+        S_CNLWRAP_REQ_EVENTS __user * arg64;
+        S_CNLWRAP32_EVENT ev32;
+        S_CNLWRAP_EVENT ev64;
+        S_CNLWRAP32_EVENT __user * events32;
+        S_CNLWRAP_EVENT __user * events64;
+
+        if (copy_from_user(&req32, arg32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req32.maxNum = MIN(req32.maxNum, CNLWRAP_EVENT_MULTI_MAX);
+
+        // the header and the 64bit event array.
+        arg64 = compat_alloc_user_space(sizeof *arg64 + sizeof ev64 * req32.maxNum);
+        events64 = (S_CNLWRAP_EVENT __user *)(arg64 + 1);
+        events32 = compat_ptr(req32.pEvents);
+
+        req64.maxNum = req32.maxNum;
+        req64.num = 0;
+        req64.pEvents = (req32.pEvents) ? events64 : NULL;
+
+        if (copy_to_user(arg64, &req64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+
+        if (copy_from_user(&req64, arg64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        for (i = 0; i < req64.num; i++) {
+            if (copy_from_user(&ev64, &events64[i], sizeof ev64)) {
+                retval = -EFAULT;
+                break;
+            }
+
+            CNLIO_compat_convertEvent(&ev32, &ev64);
+
+            if (copy_to_user(&events32[i], &ev32, sizeof ev32)) {
+                retval = -EFAULT;
+                break;
+            }
+        }
+
+        req32.num = req64.num;
+        req32.status = req64.status;
+
+        if (copy_to_user(arg32, &req32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        }
+        break;
+
+    case CNLWRAPIOC_CANCEL: {
+        S_CNLWRAP32_REQ_CANCEL req32;
+        S_CNLWRAP_REQ_CANCEL req64;
+        S_CNLWRAP_REQ_CANCEL __user * arg64;
+
+        arg64 = compat_alloc_user_space(sizeof *arg64);
+
+        if (copy_from_user(&req32, arg32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req64.requestId = (req32.requestId == (u32)CNL_DISCARD_RECVDATA_1)
+                        ? CNL_DISCARD_RECVDATA_1
+                        : (ulong)compat_ptr(req32.requestId);
+
+        if (copy_to_user(arg64, &req64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+
+        if (copy_from_user(&req64, arg64, sizeof req64)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        req32.status = req64.status;
+
+        if (copy_to_user(arg32, &req32, sizeof req32)) {
+            retval = -EFAULT;
+            break;
+        }
+
+        }
+        break;
+
+    default:
+        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg32);
+        break;
+    }
+
+    DBG_INFO("CNLIO_compat_fitIoctl(cmd=%s)- %s\n", CNLFIT_cmdToString(cmd)
+        , retval ? "failed" : "success");
+
+    return retval;
+}
+#endif
+
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitLookupAsyncBox
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that looks up the argument box of requestId in the
+ * index, and if it is found, removes it from list.
+ * @param     pfitPriv   : the pointer to the S_CNLIO_FIT_PRIV structure
+ * @param     requestId  : requestId
+ * @param     pProbe     : the counter of compared boxes
+ * @return    the pointer to the S_CNLIO_ARG_BOX structure
+ * @note      caller shall hold CNLIO_FIT_LOCK.
+ *            requestId is given by user, and may not be unique. the
+ *            oldest one is returned as same as FIFO list.
+ */
+/*-----------------------------------------------------------------*/
+static S_CNLIO_ARG_BOX *
+CNLIO_fitLookupAsyncBox(S_CNLIO_FIT_PRIV *pfitPriv,
+                        ulong             requestId,
+                        u32              *pProbe)
+{
+    struct hlist_node  *pNode;
+    S_CNLIO_ARG_BOX    *pBox;
+    S_CNLIO_ARG_BOX    *pFound = NULL;
+
+
+    // boxes are added to the head of bucket, the last match is the oldest.
+    hlist_for_each(pNode, &pfitPriv->asyncHash[CNLIO_ASYNC_HASH(requestId)]) {
+        pBox = hlist_entry(pNode, S_CNLIO_ARG_BOX, hashElm);
+        (*pProbe)++;
+        if(pBox->arg.req.data.requestId == requestId) {
+            pFound = pBox;
+        }
+    }
+
+    if(pFound) {
+        CNLIO_fitDelAsyncBox(pFound);
+    }
+
+    return pFound;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitSearchAsyncBox
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that searches the specifed argument box, and if the
+ * specified argument box is found, removes it from list.
+ * @param     pcioPriv   : the pointer to the S_CNLIO_CTRL_PRIV structure
+ * @param     requestId  : requestId
+ * @return    the pointer to the S_CNLIO_ARG_BOX structure
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static S_CNLIO_ARG_BOX *
+CNLIO_fitSearchAsyncBox(S_CNLIO_FIT_PRIV *pfitPriv,
+                        ulong             requestId)
+{
+    S_CNLIO_ARG_BOX    *pBox  = NULL;
+    u32                 probe = 0;
+    ktime_t             start = ktime_get();
+
+
+    CNLIO_FIT_LOCK(pfitPriv);
+
+    pBox = CNLIO_fitLookupAsyncBox(pfitPriv, requestId, &probe);
+
+    CNLIO_FIT_UNLOCK(pfitPriv);
+
+    CNLIO_fitAddLookupStat(start, probe, (pBox == NULL));
+
+
+    return pBox;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitSearchAsyncBoxes
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that searches the argument boxes of the data request
+ * completion events, and removes found boxes from list.
+ * @param     pcioPriv   : the pointer to the S_CNLIO_CTRL_PRIV structure
+ * @param     pEvents    : the pointer to the event array
+ * @param     num        : the number of events
+ * @param     ppBoxes    : the array to return found boxes (NULL if not found)
+ * @return    nothing
+ * @note      list is locked only once for all events.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitSearchAsyncBoxes(S_CNLIO_FIT_PRIV *pfitPriv,
+                          S_CNLWRAP_EVENT  *pEvents,
+                          u32               num,
+                          S_CNLIO_ARG_BOX **ppBoxes)
+{
+    u32                 i;
+    u32                 probe = 0;
+    u32                 miss  = 0;
+    ktime_t             start = ktime_get();
+
+
+    CNLIO_FIT_LOCK(pfitPriv);
+
+    for(i = 0; i < num; i++) {
+        ppBoxes[i] = NULL;
+
+        if(pEvents[i].type != CNLWRAP_EVENT_DATA_REQ_COMP) {
+            continue;
+        }
+
+        ppBoxes[i] = CNLIO_fitLookupAsyncBox(pfitPriv,
+                                             pEvents[i].dataReqComp.requestId,
+                                             &probe);
+        if(ppBoxes[i] == NULL) {
+            miss++;
+        }
+    }
+
+    CNLIO_FIT_UNLOCK(pfitPriv);
+
+    CNLIO_fitAddLookupStat(start, probe, miss);
+
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitFinishAsyncBox
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that finishes the async data request.
+ * @param     pBox      : the pointer to the S_CNLIO_ARG_BOX structure
+ * @param     pevent    : the pointer to the completion event
+ * @return    0           (success)
+ * @return    -EFALUT     (bad address)
+ * @note      the box is deallocated.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitFinishAsyncBox(S_CNLIO_ARG_BOX *pBox,
+                        S_CNLWRAP_EVENT *pevent)
+{
+    int   retval  = 0;
+    void *puBuf;
+    void *pnBuf;
+
+    ioctl_lock(&pBox->sema);
+
+    puBuf = (void *)pBox->pusr;
+    pnBuf = (void *)pBox->arg.req.data.userBufAddr;
+
+    if((pBox->cmd == CNLWRAPIOC_RECVDATA) &&
+       (pevent->dataReqComp.status == CNL_SUCCESS) &&
+       (pBox->ppPages == NULL)) {
+        //
+        // Async receive request normally completed.
+        // copy back the received data to user buffer.
+        // (zero-copy request is received into user buffer directly.)
+        //
+        DBG_ASSERT((ulong)pBox->pusr == pevent->dataReqComp.requestId);
+        if(copy_to_user(puBuf, pnBuf, pevent->dataReqComp.length)) {
+            DBG_ASSERT(0);
+            retval = -EFAULT;
+        }
+    }
+    if(pnBuf){
+        CNLIO_fitReleaseDataBuf(pBox, pnBuf,
+                                (pBox->cmd == CNLWRAPIOC_RECVDATA));
+    }
+
+    ioctl_unlock(&pBox->sema);
+
+    kfree(pBox);
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitPinUserBuf
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that pins the user buffer of the data request,
+ * and maps it to the kernel virtual address for zero-copy.
+ * @param     pBox      : the pointer to the S_CNLIO_ARG_BOX structure
+ * @param     puBuf     : the pointer to the user buffer
+ * @param     length    : the length of the user buffer(4B padded)
+ * @return    the kernel address of the user buffer
+ * @return    NULL        (not suitable for zero-copy, use bounce buffer)
+ * @note      the highmem page is not mapped linearly, and it can not be
+ *            handled by the SDIO host. such buffer uses bounce buffer.
+ */
+/*-----------------------------------------------------------------*/
+static void *
+CNLIO_fitPinUserBuf(S_CNLIO_ARG_BOX *pBox,
+                    void            *puBuf,
+                    u32              length)
+{
+    int                 i;
+    int                 nrPages;
+    int                 pinned  = 0;
+    ulong               start;
+    ulong               align;
+    struct page       **ppPages = NULL;
+    void               *pvmap   = NULL;
+
+
+    align = (pBox->cmd == CNLWRAPIOC_RECVDATA) ?
+        CNLIO_ZCOPY_RECV_ALIGN : CNLIO_ZCOPY_SEND_ALIGN;
+
+    if((length < CNLIO_ZCOPY_MIN_LENGTH) ||
+       ((ulong)puBuf & (align - 1))) {
+        return NULL;
+    }
+
+    start   = (ulong)puBuf & PAGE_MASK;
+    nrPages = (int)((PAGE_ALIGN((ulong)puBuf + length) - start) >> PAGE_SHIFT);
+
+    ppPages = kmalloc(sizeof(struct page *) * nrPages, GFP_KERNEL);
+    if(ppPages == NULL) {
+        return NULL;
+    }
+
+    //
+    // pin the user pages.
+    // RECVDATA writes the received data to these pages.
+    //
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,2,0)
+    pinned = get_user_pages_fast(start, nrPages,
+                                 (pBox->cmd == CNLWRAPIOC_RECVDATA) ? FOLL_WRITE : 0,
+                                 ppPages);
+#else
+    pinned = get_user_pages_fast(start, nrPages,
+                                 (pBox->cmd == CNLWRAPIOC_RECVDATA),
+                                 ppPages);
+#endif
+    if(pinned != nrPages) {
+        DBG_INFO("pin user buffer failed[%d/%d], use bounce buffer.\n", pinned, nrPages);
+        goto FAIL;
+    }
+
+    for(i = 0; i < nrPages; i++) {
+        if(PageHighMem(ppPages[i])) {
+            goto FAIL;
+        }
+    }
+
+    pvmap = vmap(ppPages, nrPages, VM_MAP, PAGE_KERNEL);
+    if(pvmap == NULL) {
+        goto FAIL;
+    }
+
+    pBox->ppPages = ppPages;
+    pBox->nrPages = nrPages;
+    pBox->pvmap   = pvmap;
+
+    DBG_INFO("pin user buffer(uptr= %p, kptr= %p, pages= %d)\n", puBuf, pvmap, nrPages);
+
+    return (u8 *)pvmap + offset_in_page(puBuf);
+
+FAIL:
+    for(i = 0; i < pinned; i++) {
+        put_page(ppPages[i]);
+    }
+    kfree(ppPages);
+
+    return NULL;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitPinFilePages
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that takes the page cache pages of the file,
+ * and maps them to the kernel virtual address for zero-copy.
+ * @param     pBox      : the pointer to the S_CNLIO_ARG_BOX structure
+ * @param     pFile     : the pointer to the file to send
+ * @param     offset    : the file offset
+ * @param     length    : the length to send
+ * @return    the kernel address of the file data
+ * @return    NULL        (not suitable for zero-copy, use bounce buffer)
+ * @note      the file data is read into the page cache if needed.
+ *            the pages are released by CNLIO_fitReleaseDataBuf().
+ */
+/*-----------------------------------------------------------------*/
+static void *
+CNLIO_fitPinFilePages(S_CNLIO_ARG_BOX *pBox,
+                      struct file     *pFile,
+                      u64              offset,
+                      u32              length)
+{
+    int                 i;
+    int                 nrPages;
+    int                 pinned  = 0;
+    pgoff_t             index;
+    struct address_space *pMapping;
+    struct page       **ppPages = NULL;
+    struct page        *pPage;
+    void               *pvmap   = NULL;
+
+
+    pMapping = pFile->f_mapping;
+
+    if((length < CNLIO_ZCOPY_MIN_LENGTH) ||
+       (offset & ~PAGE_MASK) ||
+       (offset + length > i_size_read(pMapping->host))) {
+        return NULL;
+    }
+
+    // the file system which does not read via page cache (e.g. tmpfs).
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,18,0)
+    if(pMapping->a_ops->read_folio == NULL) {
+#else
+    if(pMapping->a_ops->readpage == NULL) {
+#endif
+        return NULL;
+    }
+
+    index   = (pgoff_t)(offset >> PAGE_SHIFT);
+    nrPages = (int)(PAGE_ALIGN(PADDING_4B(length)) >> PAGE_SHIFT);
+
+    ppPages = kmalloc(sizeof(struct page *) * nrPages, GFP_KERNEL);
+    if(ppPages == NULL) {
+        return NULL;
+    }
+
+    for(pinned = 0; pinned < nrPages; pinned++) {
+        pPage = read_mapping_page(pMapping, index + pinned, pFile);
+        if(IS_ERR(pPage)) {
+            DBG_INFO("read file page failed[%ld], use bounce buffer.\n", PTR_ERR(pPage));
+            goto FAIL;
+        }
+        ppPages[pinned] = pPage;
+        if(PageHighMem(pPage)) {
+            pinned++;
+            goto FAIL;
+        }
+    }
+
+    pvmap = vmap(ppPages, nrPages, VM_MAP, PAGE_KERNEL);
+    if(pvmap == NULL) {
+        goto FAIL;
+    }
+
+    pBox->ppPages = ppPages;
+    pBox->nrPages = nrPages;
+    pBox->pvmap   = pvmap;
+
+    DBG_INFO("pin file pages(offset= %llu, kptr= %p, pages= %d)\n", offset, pvmap, nrPages);
+
+    return pvmap;
+
+FAIL:
+    for(i = 0; i < pinned; i++) {
+        put_page(ppPages[i]);
+    }
+    kfree(ppPages);
+
+    return NULL;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitMapFile
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that prepares the data buffer of the send file request.
+ * @param     pBox      : the pointer to the S_CNLIO_ARG_BOX structure
+ * @param     pReq      : the pointer to the S_CNLWRAP_REQ_SENDFILE structure
+ * @param     ppnBuf    : the pointer to store the data buffer
+ * @return    0           (success)
+ * @return    -EBADF      (the file is not readable)
+ * @return    -ENOMEM     (out of memory)
+ * @return    -EIO        (failed to read the file)
+ * @note      page cache pages are passed to lower module directly if
+ *            possible, otherwise the file is read into the bounce buffer.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitMapFile(S_CNLIO_ARG_BOX        *pBox,
+                 S_CNLWRAP_REQ_SENDFILE *pReq,
+                 void                  **ppnBuf)
+{
+    int                 retval  = 0;
+    u32                 bufLen;
+    ssize_t             readLen;
+    loff_t              pos;
+    struct file        *pFile;
+    void               *pnBuf   = NULL;
+
+
+    pFile = fget(pReq->fd);
+    if(pFile == NULL) {
+        return -EBADF;
+    }
+
+    if(!(pFile->f_mode & FMODE_READ)) {
+        retval = -EBADF;
+        goto EXIT;
+    }
+
+    pnBuf = CNLIO_fitPinFilePages(pBox, pFile, pReq->offset, pReq->length);
+    if(pnBuf) {
+        goto EXIT;
+    }
+
+    //
+    // read the file into the bounce buffer.
+    //
+    bufLen = PADDING_4B(pReq->length);
+    if(bufLen > CNLFIT_TXRX_MPL_SIZE) {
+        pnBuf = vmalloc_32(bufLen);
+        if(pnBuf == NULL) {
+            retval = -ENOMEM;
+            goto EXIT;
+        }
+        pBox->pvbuf = pnBuf;
+    } else {
+        CMN_getFixedMemPool(CNLFIT_TXRX_MPL_ID, &pnBuf, CMN_TIME_FEVR);
+        if(pnBuf == NULL) {
+            retval = -ENOMEM;
+            goto EXIT;
+        }
+    }
+
+    pos = (loff_t)pReq->offset;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4,14,0)
+    readLen = kernel_read(pFile, pnBuf, pReq->length, &pos);
+#else
+    readLen = kernel_read(pFile, pos, pnBuf, pReq->length);
+#endif
+    if(readLen != (ssize_t)pReq->length) {
+        DBG_ERR("read file failed[%zd/%u].\n", readLen, pReq->length);
+        CNLIO_fitReleaseDataBuf(pBox, pnBuf, FALSE);
+        pnBuf  = NULL;
+        retval = -EIO;
+    }
+
+EXIT:
+    fput(pFile);
+
+    *ppnBuf = pnBuf;
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitReleaseDataBuf
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that releases the data buffer of the data request.
+ * @param     pBox      : the pointer to the S_CNLIO_ARG_BOX structure
+ * @param     pnBuf     : the pointer to the data buffer
+ * @param     dirty     : TRUE if the data is written to the buffer
+ * @return    nothing
+ * @note      pinned user pages are unpinned, vmalloc area for the large
+ *            request is freed, otherwise the buffer is returned to TXRX
+ *            memory pool.
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitReleaseDataBuf(S_CNLIO_ARG_BOX *pBox,
+                        void            *pnBuf,
+                        int              dirty)
+{
+    int                 i;
 
-    DBG_INFO("CNLIO_compat_fitIoctl(cmd=%s)+\n", CNLFIT_cmdToString(cmd));
-    DBG_INFO("#####CNLIO_compat_fitIoctl(cmd=%x)+\n", cmd);
+    if(pBox->pvbuf) {
+        vfree(pBox->pvbuf);
+        pBox->pvbuf = NULL;
+        return;
+    }
 
-    switch (cmd) {
-    case CNLWRAPIOC_SENDDATA:
-    case CNLWRAPIOC_RECVDATA: {
-        S_CNLWRAP32_REQ_DATA req32;
-        S_CNLWRAP_REQ_DATA req64;
-        S_CNLWRAP_REQ_DATA __user * arg64;
+    if(pBox->ppPages == NULL) {
+        CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, pnBuf);
+        DBG_INFO("CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pnBuf);
+        return;
+    }
 
-        arg64 = compat_alloc_user_space(sizeof *arg64);
+    vunmap(pBox->pvmap);
 
-        if (copy_from_user(&req32, arg32, sizeof req32)) {
-            retval = -EFAULT;
-            break;
+    for(i = 0; i < pBox->nrPages; i++) {
+        if(dirty) {
+            set_page_dirty_lock(pBox->ppPages[i]);
         }
+        put_page(pBox->ppPages[i]);
+    }
+    kfree(pBox->ppPages);
 
-        req64.profileId = req32.profileId;
-        req64.fragmented = req32.fragmented;
-        req64.length = req32.length;
-        req64.userBufAddr = compat_ptr(req32.userBufAddr);
-        req64.sync = req32.sync;
-        req64.requestId = (ulong)compat_ptr(req32.requestId);
+    DBG_INFO("unpin user buffer(kptr= %p, pages= %d)\n", pBox->pvmap, pBox->nrPages);
 
-        if (copy_to_user(arg64, &req64, sizeof req64)) {
-            retval = -EFAULT;
-            break;
-        }
+    pBox->ppPages = NULL;
+    pBox->nrPages = 0;
+    pBox->pvmap   = NULL;
 
-        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+    return;
+}
 
-        if (copy_from_user(&req64, arg64, sizeof req64)) {
-            retval = -EFAULT;
-            break;
-        }
 
-        req32.status = req64.status;
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitRingCreate
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that creates the shared TX/RX ring.
+ * @param     pfitPriv  : the pointer to the S_CNLIO_FIT_PRIV structure
+ * @return    the pointer to the S_CNLIO_RING structure
+ * @return    NULL        (out of memory)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static S_CNLIO_RING *
+CNLIO_fitRingCreate(S_CNLIO_FIT_PRIV *pfitPriv)
+{
 
-        if (copy_to_user(arg32, &req32, sizeof req32)) {
-            retval = -EFAULT;
-            break;
-        }
+    S_CNLIO_RING       *pRing = NULL;
+    u8                 *pArea;
 
-        }
-        break;
 
-    case CNLWRAPIOC_GETEVENT: {
-        void * src32;
-        S_CNLWRAP32_EVENT req32;
-        S_CNLWRAP_EVENT req64;
-        S_CNLWRAP_EVENT __user * arg64;
+    pRing = kmalloc(sizeof(S_CNLIO_RING), GFP_KERNEL);
+    if(pRing == NULL) {
+        return NULL;
+    }
+    memset(pRing, 0, sizeof(S_CNLIO_RING));
 
-        arg64 = compat_alloc_user_space(sizeof *arg64);
+    //
+    // shared area is zero cleared.
+    // data slots are passed to SDIO host, so that lowmem pages are used.
+    //
+    pRing->pArea = vmalloc_32_user(PAGE_ALIGN(CNLWRAP_RING_MMAP_SIZE));
+    if(pRing->pArea == NULL) {
+        kfree(pRing);
+        return NULL;
+    }
 
-        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+    pArea        = (u8 *)pRing->pArea;
+    pRing->pHdr  = (S_CNLWRAP_RING_HDR *)(pArea + CNLWRAP_RING_HDR_OFFSET);
+    pRing->pSqe  = (S_CNLWRAP_RING_SQE *)(pArea + CNLWRAP_RING_SQ_OFFSET);
+    pRing->pCqe  = (S_CNLWRAP_RING_CQE *)(pArea + CNLWRAP_RING_CQ_OFFSET);
+    pRing->pData = pArea + CNLWRAP_RING_DATA_OFFSET;
 
-        if (copy_from_user(&req64, arg64, sizeof req64)) {
-            retval = -EFAULT;
-            break;
-        }
+    pRing->pHdr->sqEntries = CNLWRAP_RING_SQ_ENTRIES;
+    pRing->pHdr->cqEntries = CNLWRAP_RING_CQ_ENTRIES;
+    pRing->pHdr->slotNum   = CNLWRAP_RING_SLOT_NUM;
+    pRing->pHdr->slotSize  = CNLWRAP_RING_SLOT_SIZE;
 
-        if (CNLWRAP_EVENT_DATA_REQ_COMP == req64.type) {
-            req32.type = req64.type;
-            req32.length = req64.length;
-            req32.dataReqComp.status = req64.dataReqComp.status;
-            req32.dataReqComp.requestId = (u32)req64.dataReqComp.requestId;
-            req32.dataReqComp.profileId = req64.dataReqComp.profileId;
-            req32.dataReqComp.direction = req64.dataReqComp.direction;
-            req32.dataReqComp.fragmented = req64.dataReqComp.fragmented;
-            req32.dataReqComp.length = req64.dataReqComp.length;
+    sema_init(&pRing->sqSem, 1);
+    sema_init(&pRing->cqSem, 1);
+    INIT_WORK(&pRing->reapWork, CNLIO_fitRingReapWork);
+    pRing->pPriv = pfitPriv;
 
-            src32 = &req32;
-        } else
-            src32 = &req64;
+    DBG_INFO("ring created(area=%p, size=%lu).\n",
+             pRing->pArea, (ulong)PAGE_ALIGN(CNLWRAP_RING_MMAP_SIZE));
 
-        if (copy_to_user(arg32, src32, sizeof req32)) {
-            retval = -EFAULT;
-            break;
-        }
+    return pRing;
+}
 
-        }
-        break;
 
-    case CNLWRAPIOC_CANCEL: {
-        S_CNLWRAP32_REQ_CANCEL req32;
-        S_CNLWRAP_REQ_CANCEL req64;
-        S_CNLWRAP_REQ_CANCEL __user * arg64;
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitRingDestroy
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that deletes the shared TX/RX ring.
+ * @param     pRing     : the pointer to the S_CNLIO_RING structure
+ * @return    nothing
+ * @note      all data request on the ring must be finished(closed).
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitRingDestroy(S_CNLIO_RING *pRing)
+{
 
-        arg64 = compat_alloc_user_space(sizeof *arg64);
+    pRing->stopped = TRUE;
+    cancel_work_sync(&pRing->reapWork);
 
-        if (copy_from_user(&req32, arg32, sizeof req32)) {
-            retval = -EFAULT;
-            break;
-        }
+    vfree(pRing->pArea);
+    kfree(pRing);
 
-        req64.requestId = (req32.requestId == (u32)CNL_DISCARD_RECVDATA_1)
-                        ? CNL_DISCARD_RECVDATA_1
-                        : (ulong)compat_ptr(req32.requestId);
+    return;
+}
 
-        if (copy_to_user(arg64, &req64, sizeof req64)) {
-            retval = -EFAULT;
-            break;
-        }
 
-        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg64);
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitRingEnter
+ *-----------------------------------------------------------------*/
+/**
+ * utility function that submits the data requests queued in the
+ * submission queue, and reaps completed events.
+ * @param     pfitPriv  : the pointer to the S_CNLIO_FIT_PRIV structure
+ * @param     pEnter    : the pointer to the S_CNLWRAP_RING_ENTER structure
+ * @return    0           (success)
+ * @return    -EINVAL     (ring is not mapped)
+ * @note      if a request is failed, submission is stopped at it.
+ *            the failed entry is consumed, and its status is returned
+ *            to pEnter->status.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitRingEnter(S_CNLIO_FIT_PRIV     *pfitPriv,
+                   S_CNLWRAP_RING_ENTER *pEnter)
+{
 
-        if (copy_from_user(&req64, arg64, sizeof req64)) {
-            retval = -EFAULT;
+    T_CMN_ERR           retval;
+    S_CNLIO_RING       *pRing;
+    S_CNLWRAP_RING_HDR *pHdr;
+    S_CNLWRAP_RING_SQE  sqe;
+    S_CNLWRAP_REQ_DATA *pdataReq;
+    S_CNLIO_ARG_BUCKET  arg;
+    S_CNLWRAP_STATUS    status = CNL_SUCCESS;
+    u32                 head;
+
+
+    pRing = pfitPriv->pRing;
+    if(pRing == NULL) {
+        return -EINVAL;
+    }
+    pHdr = pRing->pHdr;
+
+    pEnter->submitted = 0;
+
+    ioctl_lock(&pRing->sqSem);
+
+    head = pHdr->sqHead;
+
+    while(pEnter->submitted < pEnter->toSubmit) {
+        if(head == CNLIO_RING_READ(pHdr->sqTail)) {
+            // submission queue is empty.
+            break;
+        }
+        smp_rmb();
+
+        // take a snapshot, user may rewrite the entry.
+        memcpy(&sqe, &pRing->pSqe[head & (CNLWRAP_RING_SQ_ENTRIES - 1)], sizeof(sqe));
+        head++;
+
+        if((sqe.slot >= CNLWRAP_RING_SLOT_NUM) ||
+           (sqe.length == 0) ||
+           (sqe.length > CNLWRAP_RING_SLOT_SIZE) ||
+           ((sqe.opcode != CNLWRAP_RING_OP_SEND) && (sqe.opcode != CNLWRAP_RING_OP_RECV))) {
+            DBG_ERR("invalid SQE(slot=%u, length=%u, opcode=%u).\n",
+                    sqe.slot, sqe.length, sqe.opcode);
+            status = CNLWRAP_REQ_CNL_ERR_BADPARAM;
             break;
         }
 
-        req32.status = req64.status;
-
-        if (copy_to_user(arg32, &req32, sizeof req32)) {
-            retval = -EFAULT;
+        // busy bit is cleared by the reaper, which runs under cqSem.
+        if(test_and_set_bit(sqe.slot, pRing->slotBusy)) {
+            DBG_ERR("SQE slot %u is busy.\n", sqe.slot);
+            status = CNLWRAP_REQ_CNL_ERR_BADPARAM;
             break;
         }
 
+        //
+        // data slot is passed to lower module directly.
+        // the tagged slot index is used as requestId.
+        //
+        memset(&arg, 0, sizeof(arg));
+        pdataReq              = &arg.req.data;
+        pdataReq->profileId   = sqe.profileId;
+        pdataReq->fragmented  = sqe.fragmented;
+        pdataReq->length      = sqe.length;
+        pdataReq->userBufAddr = pRing->pData + (sqe.slot * CNLWRAP_RING_SLOT_SIZE);
+        pdataReq->sync        = ASYNC_REQUEST;
+        pdataReq->requestId   = CNLIO_RING_REQ_ID(sqe.slot);
+
+        pRing->slotUserData[sqe.slot] = sqe.userData;
+
+        retval = CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo,
+                             (sqe.opcode == CNLWRAP_RING_OP_SEND) ?
+                             CNLWRAPIOC_SENDDATA : CNLWRAPIOC_RECVDATA,
+                             &arg);
+        if((retval != SUCCESS) || (pdataReq->status != CNL_SUCCESS)) {
+            DBG_ERR("ring data request failed[%d][%d].\n", retval, pdataReq->status);
+            clear_bit(sqe.slot, pRing->slotBusy);
+            status = (pdataReq->status != CNL_SUCCESS) ?
+                pdataReq->status : CNLWRAP_REQ_CNL_ERR_INVSTAT;
+            break;
         }
-        break;
 
-    default:
-        retval = CNLIO_fitIoctl(pFile, cmd, (ulong)arg32);
-        break;
+        pEnter->submitted++;
     }
 
-    DBG_INFO("CNLIO_compat_fitIoctl(cmd=%s)- %s\n", CNLFIT_cmdToString(cmd)
-        , retval ? "failed" : "success");
+    // release consumed entries to user.
+    smp_mb();
+    pHdr->sqHead = head;
 
-    return retval;
-}
-#endif
+    ioctl_unlock(&pRing->sqSem);
+
+    pEnter->status = status;
+
+    // reap completion here, completion queue may be full at last reaping.
+    if(CNLIO_fitRingReap(pRing) > 0) {
+        wake_up_interruptible(&pfitPriv->waitEvt);
+    }
 
+    return 0;
+}
 
 
 /*-------------------------------------------------------------------
- * Function   : CNLIO_fitSearchAsyncBox
+ * Function   : CNLIO_fitRingReap
  *-----------------------------------------------------------------*/
 /**
- * utility function that searches the specifed argument box, and if the
- * specified argument box is found, removes it from list.
- * @param     pcioPriv   : the pointer to the S_CNLIO_CTRL_PRIV structure
- * @param     requestId  : requestId
- * @return    the pointer to the S_CNLIO_ARG_BOX structure
- * @note      nothing
+ * utility function that moves events to the completion queue.
+ * @param     pRing     : the pointer to the S_CNLIO_RING structure
+ * @return    the number of posted completion queue entries
+ * @note      if completion queue is full, remaining events are kept in
+ *            fitting module until next reaping.
  */
 /*-----------------------------------------------------------------*/
-static S_CNLIO_ARG_BOX *
-CNLIO_fitSearchAsyncBox(S_CNLIO_FIT_PRIV *pfitPriv,
-                        ulong             requestId)
+static int
+CNLIO_fitRingReap(S_CNLIO_RING *pRing)
 {
-    u8                  find = FALSE;
-    S_CNLIO_ARG_BOX    *pBox = NULL;
-    S_CNLWRAP_REQ_DATA *pdataReq;
 
+    int                 posted = 0;
+    T_CMN_ERR           retval;
+    S_CNLIO_FIT_PRIV   *pfitPriv;
+    S_CNLWRAP_RING_HDR *pHdr;
+    S_CNLWRAP_RING_CQE *pCqe;
+    S_CNLWRAP_EVENT    *pEvent;
+    S_CNLIO_ARG_BUCKET  arg;
+    u32                 tail;
+    ulong               slot;
 
-    CNLIO_FIT_LOCK(pfitPriv);
 
+    pfitPriv = pRing->pPriv;
+    pHdr     = pRing->pHdr;
 
-    list_for_each_entry(pBox, &pfitPriv->async, elm)
-    {
-        pdataReq = &pBox->arg.req.data;
-        if(pdataReq->requestId == requestId) {
-            find = TRUE;
+    ioctl_lock(&pRing->cqSem);
+
+    while(!pRing->stopped) {
+        tail = pHdr->cqTail;
+        if((u32)(tail - CNLIO_RING_READ(pHdr->cqHead)) >= CNLWRAP_RING_CQ_ENTRIES) {
+            // completion queue is full.
             break;
         }
-    }
 
+        retval = CNLFIT_ctrl(pfitPriv->type, pfitPriv->pInfo, CNLWRAPIOC_GETEVENT, &arg);
+        if(retval != SUCCESS) {
+            // no more event.
+            break;
+        }
 
-    if(find) {
-        list_del(&pBox->elm);
-    } else {
-        pBox = NULL;
+        pEvent = &arg.req.event;
+        pCqe   = &pRing->pCqe[tail & (CNLWRAP_RING_CQ_ENTRIES - 1)];
+        memset(pCqe, 0, sizeof(S_CNLWRAP_RING_CQE));
+
+        pCqe->type = pEvent->type;
+        slot       = CNLWRAP_RING_SLOT_NUM;
+
+        if(pEvent->type == CNLWRAP_EVENT_DATA_REQ_COMP) {
+            slot = CNLIO_RING_REQ_SLOT(pEvent->dataReqComp.requestId);
+            if((slot < CNLWRAP_RING_SLOT_NUM) &&
+               test_bit(slot, pRing->slotBusy)) {
+                pCqe->userData = pRing->slotUserData[slot];
+                pCqe->slot     = (u32)slot;
+            } else {
+                // discard request etc. not submitted by ring.
+                pCqe->userData = pEvent->dataReqComp.requestId;
+                pCqe->slot     = CNLWRAP_RING_SLOT_NUM;
+                slot           = CNLWRAP_RING_SLOT_NUM;
+            }
+            pCqe->status     = pEvent->dataReqComp.status;
+            pCqe->length     = pEvent->dataReqComp.length;
+            pCqe->profileId  = pEvent->dataReqComp.profileId;
+            pCqe->direction  = pEvent->dataReqComp.direction;
+            pCqe->fragmented = pEvent->dataReqComp.fragmented;
+        } else {
+            pCqe->length = MIN(pEvent->length, CNLWRAP_RING_CQE_PARAM_SIZE);
+            memcpy(pCqe->param, &pEvent->errorInd, pCqe->length);
+        }
+
+        // publish the entry to user.
+        smp_wmb();
+        pHdr->cqTail = tail + 1;
+        posted++;
+
+        // the slot can be resubmitted after its CQE is published.
+        if(slot < CNLWRAP_RING_SLOT_NUM) {
+            clear_bit(slot, pRing->slotBusy);
+        }
     }
 
+    ioctl_unlock(&pRing->cqSem);
 
-    CNLIO_FIT_UNLOCK(pfitPriv);
+    return posted;
+}
 
 
-    return pBox;
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitRingReapWork
+ *-----------------------------------------------------------------*/
+/**
+ * work function that reaps events notified by fitting module.
+ * @param     pWork     : the pointer to the work_struct structure
+ * @return    nothing
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static void
+CNLIO_fitRingReapWork(struct work_struct *pWork)
+{
+
+    S_CNLIO_RING       *pRing;
+
+    pRing = container_of(pWork, S_CNLIO_RING, reapWork);
+
+    CNLIO_fitRingReap(pRing);
+
+    // wake poll. (POLLHUP is also checked)
+    wake_up_interruptible(&pRing->pPriv->waitEvt);
+
+    return;
 }
 
 
@@ -1252,13 +2881,11 @@ CNLIO_fitArgBucketPurge(S_CNLIO_FIT_PRIV *pfitPriv)
         pData = (void *)(pdataReq->userBufAddr);
         if(pData != NULL) {
             // deallocate data buffer
-            DBG_INFO("(rel)releaseFixedMemPool pData[%p]\n",pData);
-            CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, pData);
-            DBG_INFO("CMN_releaseFixedMemPool(CNLFIT_TXRX_MPL_ID, ptr= %p)\n",pData);
-
+            DBG_INFO("(rel)release data buffer pData[%p]\n",pData);
+            CNLIO_fitReleaseDataBuf(pBox, pData, FALSE);
         }
         // deallocate arg box
-        list_del(&pBox->elm);
+        CNLIO_fitDelAsyncBox(pBox);
         DBG_INFO("(rel)kfree pBox[%p]\n", pBox);
         kfree(pBox);
     }
@@ -1271,6 +2898,89 @@ EXIT:
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CNLIO_fitShowIocStat
+ *-----------------------------------------------------------------*/
+/**
+ * show the ioctl and async argument box lookup statistics (debugfs).
+ * @param     m         : the seq_file
+ * @param     v         : not used
+ * @return    0           (success)
+ * @note      the per-CPU counters are summed up without lock, so the
+ *            result may miss the ioctl in progress.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CNLIO_fitShowIocStat(struct seq_file *m, void *v)
+{
+
+    S_CNLIO_IOC_STAT     iocStat;
+    S_CNLIO_LOOKUP_STAT  lookupStat;
+    S_CNLIO_IOC_STAT    *pIoc;
+    S_CNLIO_LOOKUP_STAT *pLookup;
+    int                  i;
+    int                  cpu;
+
+
+    seq_printf(m, "%-28s %10s %10s %10s %10s\n", "ioctl", "count", "error", "avg(ns)", "max(ns)");
+    for(i = 0; i < CNLIO_STAT_NR_NUM; i++) {
+        memset(&iocStat, 0, sizeof(iocStat));
+        for_each_possible_cpu(cpu) {
+            pIoc = &per_cpu_ptr(&g_ioStat, cpu)->ioc[i];
+            if(pIoc->cnt == 0) {
+                continue;
+            }
+            iocStat.cmd      = pIoc->cmd;
+            iocStat.cnt     += pIoc->cnt;
+            iocStat.errCnt  += pIoc->errCnt;
+            iocStat.totalNs += pIoc->totalNs;
+            iocStat.maxNs    = MAX(iocStat.maxNs, pIoc->maxNs);
+        }
+        if(iocStat.cnt == 0) {
+            continue;
+        }
+        seq_printf(m, "%-28s %10llu %10llu %10llu %10llu\n",
+                   CNLFIT_cmdToString(iocStat.cmd),
+                   iocStat.cnt, iocStat.errCnt,
+                   div64_u64(iocStat.totalNs, iocStat.cnt),
+                   iocStat.maxNs);
+    }
+
+    memset(&lookupStat, 0, sizeof(lookupStat));
+    for_each_possible_cpu(cpu) {
+        pLookup = &per_cpu_ptr(&g_ioStat, cpu)->lookup;
+        lookupStat.cnt      += pLookup->cnt;
+        lookupStat.missCnt  += pLookup->missCnt;
+        lookupStat.probeCnt += pLookup->probeCnt;
+        lookupStat.totalNs  += pLookup->totalNs;
+        lookupStat.maxNs     = MAX(lookupStat.maxNs, pLookup->maxNs);
+    }
+
+    seq_printf(m, "lookup: count %llu miss %llu probe %llu avg %llu max %llu nsec\n",
+               lookupStat.cnt, lookupStat.missCnt, lookupStat.probeCnt,
+               (lookupStat.cnt) ? div64_u64(lookupStat.totalNs, lookupStat.cnt) : 0,
+               lookupStat.maxNs);
+
+    return 0;
+}
+
+
+static int
+CNLIO_fitOpenIocStat(struct inode *pInode, struct file *pFile)
+{
+    return single_open(pFile, CNLIO_fitShowIocStat, NULL);
+}
+
+
+static const struct file_operations  g_iocStatOps = {
+    .owner                             = THIS_MODULE,
+    .open                              = CNLIO_fitOpenIocStat,
+    .read                              = seq_read,
+    .llseek                            = seq_lseek,
+    .release                           = single_release,
+};
+
+
 /*
  * @brief I/O methods structure global
  */
@@ -1279,6 +2989,7 @@ static const struct file_operations  g_ctrlOps = {
     .read                              = NULL,
     .write                             = NULL,
     .poll                              = CNLIO_fitPoll,
+    .mmap                              = CNLIO_fitMmap,
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,36)
     .ioctl                             = CNLIO_fitIoctl,
 #else
@@ -1310,6 +3021,7 @@ CNLIO_fitInit(void)
 {
 
     int  retval = 0;
+    int  ch;
 
     g_ctrlDevNo = CNLIO_CTRL_MAJOR_NO;
     retval = alloc_chrdev_region(&g_ctrlDevNo,
@@ -1328,13 +3040,16 @@ CNLIO_fitInit(void)
 	if (g_ctrlClass == NULL)
 		goto ctrl_class_exit;
 
-	/* auto udev node creation */
-	if (device_create(g_ctrlClass, NULL, g_ctrlDevNo,
-				NULL, "CnlFitCtrl0") == NULL) {
-		goto ctrl_device_exit;
+	/* auto udev node creation, one node per CNL device */
+    g_ctrlChNum = CNLFIT_getDevNum();
+    for(ch = 0; ch < g_ctrlChNum; ch++) {
+        if (device_create(g_ctrlClass, NULL, g_ctrlDevNo + ch,
+                          NULL, "CnlFitCtrl%d", ch) == NULL) {
+            goto ctrl_device_exit;
+        }
     }
 
-    retval = cdev_add(&g_ctrlChar, g_ctrlDevNo, CNLIO_CTRL_MAX_CHANNEL);
+    retval = cdev_add(&g_ctrlChar, g_ctrlDevNo, g_ctrlChNum);
     if(retval != 0){
 		goto ctrl_exit;
     }
@@ -1376,9 +3091,12 @@ CNLIO_fitInit(void)
              MAJOR(g_adptDevNo));
 
     // create send/receive buffer
+    if(g_txrxMplCnt == 0) {
+        g_txrxMplCnt = CNLFIT_TXRX_MPL_CNT;
+    }
     retval = CMN_createFixedMemPool(CNLFIT_TXRX_MPL_ID,
-                                    0,
-                                    CNLFIT_TXRX_MPL_CNT,
+                                    CMN_MPL_ATTR_PERCPU,
+                                    g_txrxMplCnt,
                                     CNLFIT_TXRX_MPL_SIZE);
     DBG_INFO("CMN_createFixedMemPool(CNLFIT_TXRX_MPL_ID)\n");
 
@@ -1387,6 +3105,31 @@ CNLIO_fitInit(void)
         goto adpt_exit;
     }
 
+    // create inline send buffer
+    if(g_smallMplCnt == 0) {
+        g_smallMplCnt = CNLFIT_SMALL_MPL_CNT;
+    }
+    retval = CMN_createFixedMemPool(CNLFIT_SMALL_MPL_ID,
+                                    CMN_MPL_ATTR_PERCPU,
+                                    g_smallMplCnt,
+                                    CNLFIT_SMALL_MPL_SIZE);
+    DBG_INFO("CMN_createFixedMemPool(CNLFIT_SMALL_MPL_ID)\n");
+
+    if(retval != SUCCESS) {
+        DBG_ERR("create CNL Fixed memory pool object failed\n");
+        CMN_deleteFixedMemPool(CNLFIT_TXRX_MPL_ID);
+        goto adpt_exit;
+    }
+
+    // statistics are optional, failure is not fatal.
+    g_debugfsDir = debugfs_create_dir(CNLIO_DEBUGFS_DIR, NULL);
+    if(IS_ERR_OR_NULL(g_debugfsDir)) {
+        g_debugfsDir = NULL;
+        return 0;
+    }
+    debugfs_create_file(CNLIO_DEBUGFS_IOCTL, S_IRUGO, g_debugfsDir,
+                        NULL, &g_iocStatOps);
+
     return 0;
 
 adpt_exit:
@@ -1398,8 +3141,11 @@ adpt_class_exit:
 adpt_cdev_exit:
 	cdev_del(&g_ctrlChar);
 ctrl_exit:
-	device_destroy(g_ctrlClass, g_ctrlDevNo);
+    ch = g_ctrlChNum;
 ctrl_device_exit:
+    while(ch-- > 0) {
+        device_destroy(g_ctrlClass, g_ctrlDevNo + ch);
+    }
 	class_destroy(g_ctrlClass);
 ctrl_class_exit:
 	unregister_chrdev_region(g_ctrlDevNo, CNLIO_CTRL_MAX_CHANNEL);
@@ -1421,6 +3167,13 @@ static void __exit
 CNLIO_fitExit(void)
 {
 
+    int  ch;
+
+    debugfs_remove_recursive(g_debugfsDir);
+
+    CMN_deleteFixedMemPool(CNLFIT_SMALL_MPL_ID);
+    DBG_INFO("CMN_deleteFixedMemPool(CNLFIT_SMALL_MPL_ID)\n");
+
     CMN_deleteFixedMemPool(CNLFIT_TXRX_MPL_ID);
     DBG_INFO("CMN_deleteFixedMemPool(CNLFIT_TXRX_MPL_ID)\n");
 
@@ -1429,7 +3182,9 @@ CNLIO_fitExit(void)
 	class_destroy(g_adptClass);
     DBG_INFO("destroy ADPT class and device completed.\n");
 
-	device_destroy(g_ctrlClass, g_ctrlDevNo);
+    for(ch = 0; ch < g_ctrlChNum; ch++) {
+        device_destroy(g_ctrlClass, g_ctrlDevNo + ch);
+    }
 	class_destroy(g_ctrlClass);
     DBG_INFO("destroy CTRL class and device completed.\n");
 
@@ -0,0 +1,98 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cnlio_trace.h
+ *
+ *  @brief    CNL fitting I/O tracepoints.
+ *
+ *
+ *  @note     events are under "toscnlfit" in tracefs. requestId of
+ *            cnlio_data_req is the id of the toscnl events.
+ */
+/*=================================================================*/
+
+#if !defined(__CNLIO_TRACE_H__) || defined(TRACE_HEADER_MULTI_READ)
+#define __CNLIO_TRACE_H__
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM toscnlfit
+
+#include <linux/tracepoint.h>
+
+/**
+ * @brief ioctl is entered.
+ */
+TRACE_EVENT(cnlio_ioctl_enter,
+    TP_PROTO(uint cmd),
+    TP_ARGS(cmd),
+    TP_STRUCT__entry(
+        __field(uint, cmd)
+    ),
+    TP_fast_assign(
+        __entry->cmd = cmd;
+    ),
+    TP_printk("cmd=0x%x", __entry->cmd)
+);
+
+/**
+ * @brief ioctl returns, async data request returns before completion.
+ */
+TRACE_EVENT(cnlio_ioctl_exit,
+    TP_PROTO(uint cmd, long retval),
+    TP_ARGS(cmd, retval),
+    TP_STRUCT__entry(
+        __field(uint, cmd)
+        __field(long, retval)
+    ),
+    TP_fast_assign(
+        __entry->cmd    = cmd;
+        __entry->retval = retval;
+    ),
+    TP_printk("cmd=0x%x ret=%ld", __entry->cmd, __entry->retval)
+);
+
+/**
+ * @brief data request is passed to CNL, SENDFILE is already rewritten to data.
+ */
+TRACE_EVENT(cnlio_data_req,
+    TP_PROTO(uint cmd, unsigned long requestId, u8 profileId, u32 length),
+    TP_ARGS(cmd, requestId, profileId, length),
+    TP_STRUCT__entry(
+        __field(uint,          cmd)
+        __field(unsigned long, requestId)
+        __field(u8,            profileId)
+        __field(u32,           length)
+    ),
+    TP_fast_assign(
+        __entry->cmd       = cmd;
+        __entry->requestId = requestId;
+        __entry->profileId = profileId;
+        __entry->length    = length;
+    ),
+    TP_printk("cmd=0x%x id=0x%lx pid=%u len=%u",
+              __entry->cmd, __entry->requestId, __entry->profileId, __entry->length)
+);
+
+#endif /* __CNLIO_TRACE_H__ */
+
+// this part must be outside the header guard.
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE cnlio_trace
+#include <trace/define_trace.h>
@@ -124,6 +124,7 @@ typedef enum tagE_CNLWRAP_ADPT_TYPE {
 #define CNLWRAP_REQ_SUCCESS            0x00000000
 #define CNLWRAP_REQ_CNL_ERR_INVSTAT    (-2)
 #define CNLWRAP_REQ_CNL_ERR_BADPARAM   (-3)
+#define CNLWRAP_REQ_CNL_ERR_QOVR       (-5)
 #define CNLWRAP_REQ_CNL_ERR_HOST_IO    (-7)
 #define CNLWRAP_REQ_CNL_ERR_CANCELLED  (-9)
 
@@ -131,6 +132,50 @@ typedef enum tagE_CNLWRAP_ADPT_TYPE {
 #define CNLWRAP_STS_CNL_ERR_HW_SUSPEND     (-17)
 #define CNLWRAP_STS_CNL_ERR_HW_RESUME      (-18)
 
+
+//
+// parameter definitions for shared TX/RX ring(mmap).
+//
+// mmap layout (offset 0, CNLWRAP_RING_MMAP_SIZE byte) :
+//   +------------------------------+ CNLWRAP_RING_HDR_OFFSET
+//   | S_CNLWRAP_RING_HDR           |
+//   +------------------------------+ CNLWRAP_RING_SQ_OFFSET
+//   | S_CNLWRAP_RING_SQE * SQ num  |
+//   +------------------------------+ CNLWRAP_RING_CQ_OFFSET
+//   | S_CNLWRAP_RING_CQE * CQ num  |
+//   +------------------------------+ CNLWRAP_RING_DATA_OFFSET
+//   | data slot * slot num         |
+//   +------------------------------+
+//
+#define CNLWRAP_RING_SQ_ENTRIES        32
+#define CNLWRAP_RING_CQ_ENTRIES        64
+#define CNLWRAP_RING_SLOT_NUM          8
+#define CNLWRAP_RING_SLOT_SIZE         65536
+
+#define CNLWRAP_RING_HDR_OFFSET        0x00000000
+#define CNLWRAP_RING_SQ_OFFSET         0x00001000
+#define CNLWRAP_RING_CQ_OFFSET         0x00002000
+#define CNLWRAP_RING_DATA_OFFSET       0x00004000
+#define CNLWRAP_RING_MMAP_SIZE         (CNLWRAP_RING_DATA_OFFSET + \
+                                        CNLWRAP_RING_SLOT_NUM * CNLWRAP_RING_SLOT_SIZE)
+
+#define CNLWRAP_RING_OP_SEND           0
+#define CNLWRAP_RING_OP_RECV           1
+
+#define CNLWRAP_RING_CQE_PARAM_SIZE    32
+
+
+//
+// parameter definitions for ioctl(GETEVENT_MULTI).
+//
+#define CNLWRAP_EVENT_MULTI_MAX        32
+
+
+//
+// parameter definitions for ioctl(SENDDATA_INLINE).
+//
+#define CNLWRAP_INLINE_DATA_MAX        4096
+
 /*-------------------------------------------------------------------
  * structure definition.
  *-----------------------------------------------------------------*/
@@ -350,6 +395,28 @@ typedef struct tagS_CNLWRAP_REQ_POWERSAVE{
 }S_CNLWRAP_REQ_POWERSAVE;
 
 
+/**
+ * @brief cnl wrapper ioctl get multiple events request.
+ */
+typedef struct tagS_CNLWRAP_REQ_EVENTS{
+    u32                                maxNum;    // number of entries of pEvents.
+    u32                                num;       // number of got events.
+    S_CNLWRAP_EVENT *                  pEvents;
+    S_CNLWRAP_STATUS                   status;
+}S_CNLWRAP_REQ_EVENTS;
+
+
+/**
+ * @brief cnl wrapper ioctl get multiple events request. (32bit compatible)
+ */
+typedef struct {
+    u32                                maxNum;
+    u32                                num;
+    u32                                pEvents;   // S_CNLWRAP32_EVENT array.
+    S_CNLWRAP_STATUS                   status;
+} S_CNLWRAP32_REQ_EVENTS;
+
+
 /**
  * @brief cnl wrapper ioctl data request.
  */
@@ -378,6 +445,53 @@ typedef struct {
 } S_CNLWRAP32_REQ_DATA;
 
 
+/**
+ * @brief cnl wrapper ioctl send file request.
+ *        the file data is sent as one data request, and it is completed
+ *        by CNLWRAP_EVENT_DATA_REQ_COMP with requestId.
+ */
+typedef struct tagS_CNLWRAP_REQ_SENDFILE{
+    u8                                 profileId;
+    u8                                 fragmented;
+    s32                                fd;
+    u64                                offset;    // file offset.
+    u32                                length;
+    unsigned long                      requestId;//unsigned long is 32bit/64bit compatible id(pointer size).
+    S_CNLWRAP_STATUS                   status;
+}S_CNLWRAP_REQ_SENDFILE;
+
+
+/**
+ * @brief cnl wrapper ioctl send file request. (32bit compatible)
+ */
+typedef struct {
+    u8                                 profileId;
+    u8                                 fragmented;
+    s32                                fd;
+    u32                                offsetLow;  // u64 is not 8B aligned on 32bit.
+    u32                                offsetHigh;
+    u32                                length;
+    u32                                requestId;
+    S_CNLWRAP_STATUS                   status;
+} S_CNLWRAP32_REQ_SENDFILE;
+
+
+/**
+ * @brief cnl wrapper ioctl inline send data request.
+ *        data is embedded in the argument, and the request is completed
+ *        in the ioctl. only length bytes of data are copied in.
+ *        it has no pointer, so it is 32bit/64bit compatible.
+ */
+typedef struct tagS_CNLWRAP_REQ_INLINE_DATA{
+    u8                                 profileId;
+    u8                                 fragmented;
+    u32                                length;
+    u32                                requestId;
+    S_CNLWRAP_STATUS                   status;
+    u8                                 data[CNLWRAP_INLINE_DATA_MAX];
+}S_CNLWRAP_REQ_INLINE_DATA;
+
+
 /**
  * @brief cnl wrapper ioctl register cbk
  */
@@ -432,6 +546,66 @@ typedef struct tagS_CNLWRAP_STATS{
     S_CNLWRAP_STATUS                   status;
 }S_CNLWRAP_STATS;
 
+
+/**
+ * @brief shared ring header.
+ *        sqTail and cqHead are updated by user, others are updated by driver.
+ */
+typedef struct tagS_CNLWRAP_RING_HDR{
+    u32                                sqHead;
+    u32                                sqTail;
+    u32                                cqHead;
+    u32                                cqTail;
+    u32                                sqEntries;
+    u32                                cqEntries;
+    u32                                slotNum;
+    u32                                slotSize;
+    u32                                cqOverflow;
+}S_CNLWRAP_RING_HDR;
+
+
+/**
+ * @brief shared ring submission queue entry.
+ */
+typedef struct tagS_CNLWRAP_RING_SQE{
+    u64                                userData;
+    u32                                slot;      // data slot index.
+    u32                                length;
+    u8                                 opcode;    // CNLWRAP_RING_OP_SEND/RECV
+    u8                                 profileId;
+    u8                                 fragmented;
+    u8                                 reserved[13];
+}S_CNLWRAP_RING_SQE;
+
+
+/**
+ * @brief shared ring completion queue entry.
+ *        DATA_REQ_COMP event is set to userData ~ fragmented,
+ *        and other event parameter is set to param.
+ */
+typedef struct tagS_CNLWRAP_RING_CQE{
+    u64                                userData;
+    S_CNLWRAP_STATUS                   status;
+    u32                                length;
+    u32                                slot;
+    u8                                 type;      // E_CNLWRAP_EVENT_TYPE
+    u8                                 profileId;
+    u8                                 direction;
+    u8                                 fragmented;
+    u8                                 param[CNLWRAP_RING_CQE_PARAM_SIZE];
+    u8                                 reserved[8];
+}S_CNLWRAP_RING_CQE;
+
+
+/**
+ * @brief cnl wrapper ioctl ring enter request.
+ */
+typedef struct tagS_CNLWRAP_RING_ENTER{
+    u32                                toSubmit;
+    u32                                submitted;
+    S_CNLWRAP_STATUS                   status;
+}S_CNLWRAP_RING_ENTER;
+
 #pragma pack(pop)
 
 /* CNLWRAP I/O control number definitions */
@@ -461,5 +635,10 @@ typedef struct tagS_CNLWRAP_STATS{
 #define CNLWRAPIOC_GETSTATS            _IOR(CNLWRAPIOC_MAGIC,  0x91, S_CNLWRAP_STATS)
 // optional ioctl
 #define CNLWRAPIOC_POWERSAVE           _IOWR(CNLWRAPIOC_MAGIC, 0x92, S_CNLWRAP_REQ_POWERSAVE)
+// shared ring ioctl(after mmap)
+#define CNLWRAPIOC_RING_ENTER          _IOWR(CNLWRAPIOC_MAGIC, 0x93, S_CNLWRAP_RING_ENTER)
+#define CNLWRAPIOC_GETEVENT_MULTI      _IOWR(CNLWRAPIOC_MAGIC, 0x94, S_CNLWRAP32_REQ_EVENTS)
+#define CNLWRAPIOC_SENDFILE            _IOWR(CNLWRAPIOC_MAGIC, 0x95, S_CNLWRAP32_REQ_SENDFILE)
+#define CNLWRAPIOC_SENDDATA_INLINE     _IOWR(CNLWRAPIOC_MAGIC, 0x96, S_CNLWRAP_REQ_INLINE_DATA)
 
 #endif /* __CNLWRAP_IF_H__ */
@@ -80,6 +80,15 @@
 #define	CMN_STRLEN                     strlen     // ANSI C
 
 
+/**
+ *	@brief macros to handle the atomic variable
+ */
+#define	CMN_ATOMIC_SET(p, v)           atomic_set(p, v)
+#define	CMN_ATOMIC_READ(p)             atomic_read(p)
+#define	CMN_ATOMIC_CMPXCHG(p, o, n)    atomic_cmpxchg(p, o, n)
+#define	CMN_ATOMIC_INC(p)              atomic_inc(p)
+
+
 #define MAX(x,y) ((x) > (y)) ? (x) : (y)
 #define MIN(x,y) ((x) > (y)) ? (y) : (x)
 /*------------------------------------------------------------------
@@ -89,4 +98,6 @@ typedef struct tagS_OS_MSG{
     u32 dummy;
 }S_OS_MSG;
 
+typedef atomic_t T_CMN_ATOMIC;
+
 #endif	/* __SYS_BASE_H__ */
@@ -36,26 +36,26 @@
 /**
  * @brief for memory pool configuration
  */
-#define CMN_MEM_POOL_MAX_NUM 11
+#define CMN_MEM_POOL_MAX_NUM 16
 
 //#define USE_IN_INTR_CONTEXT // default no.
 
 /**
  * @brief for semaphore configuration
  */
-#define CMN_SEM_MAX_NUM 15
+#define CMN_SEM_MAX_NUM 32
 
 
 /**
  * @brief for CPU Lock configuration
  */
-#define CMN_LOC_MAX_NUM 10
+#define CMN_LOC_MAX_NUM 16
 
 
 /**
  * @brief for task configuration
  */
-#define CMN_TASK_MAX_NUM 2
+#define CMN_TASK_MAX_NUM 8 // 2 tasks per CNL device(CNL_DEV_RSC_NUM)
 
 
 /**
@@ -34,9 +34,15 @@
 
 #include <linux/spinlock.h> // spinlock API
 #include <linux/list.h>     // list API
+#include <linux/llist.h>    // lock-less list API
+#include <linux/gfp.h>      // alloc_pages_exact
+#include <linux/cache.h>    // L1_CACHE_BYTES
 #include <linux/sched.h>    // waitqueue API
 #include <linux/wait.h>     // waitqueue API
 #include <linux/time.h>     // waitqueue API
+#include <linux/percpu.h>   // per-CPU API
+#include <linux/debugfs.h>  // debugfs API
+#include <linux/seq_file.h> // seq_file API
 
 #include <linux/version.h> // MUTEX API.
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,26)
@@ -49,36 +55,91 @@
 /*-------------------------------------------------------------------
  * Macro Definitions
  *-----------------------------------------------------------------*/
+/**
+ * @brief memory block header.
+ *        header is placed just before the memory block, and it is aligned
+ *        to cache line not to share the line with the memory block(DMA).
+ */
+#define CMN_MEMBLK_HDR_SIZE      ALIGN(sizeof(S_MEMBLK_MGR), L1_CACHE_BYTES)
+#define CMN_MEMBLK_TO_MGR(p)     ((S_MEMBLK_MGR *)((u8 *)(p) - CMN_MEMBLK_HDR_SIZE))
+#define CMN_MGR_TO_MEMBLK(p)     ((void *)((u8 *)(p) + CMN_MEMBLK_HDR_SIZE))
+
+/**
+ * @brief the max number of free blocks cached on each CPU.
+ *        the magazine is shrunk to share the blocks among online CPUs,
+ *        but it has 1 block at least. the blocks of all magazines are
+ *        added to the pool as the reserve, up to the requested count.
+ */
+#define CMN_MPL_MAG_SIZE         4
+
+/**
+ * @brief debugfs entry names.
+ */
+#define CMN_DEBUGFS_DIR          "tososcmn"
+#define CMN_DEBUGFS_MPL          "mempool"
 
 
 /*-------------------------------------------------------------------
  * Structure Definitions
  *-----------------------------------------------------------------*/
+struct tagS_CMN_MPF;
+
 /**
- * @brief memory pool block.
+ * @brief memory pool block header.
  */
 typedef struct tagS_MEMBLK_MGR{
-    struct list_head  list;
-    void             *pMemBlk;
+    struct llist_node     node;
+    struct tagS_CMN_MPF  *pMpf;   // owner memory pool.
+    ulong                 inUse;
 } S_MEMBLK_MGR;
 
 
+/**
+ * @brief per-CPU magazine of free blocks (CMN_MPL_ATTR_PERCPU).
+ *        lock is taken by the owner CPU only, except when a getter
+ *        steals a block before sleeping.
+ */
+typedef struct tagS_CMN_MPF_MAG{
+    spinlock_t         lock;
+    u16                count;
+    S_MEMBLK_MGR      *pMgr[CMN_MPL_MAG_SIZE];
+
+    // statistics.
+    ulong              hit;   // get served from the own magazine.
+    ulong              miss;  // get fell back to the shared queue.
+} S_CMN_MPF_MAG;
+
+
 /**
  * @brief memory pool manager
+ *        free block is released to readyQ without lock.
+ *        lock serializes only the getters, because llist_del_first()
+ *        does not allow concurrent deleters.
  */
 typedef struct tagS_CMN_MPF{
     u8                 id;
     uint               size;
     u16                maxcnt;
+    u32                attr;
 
     spinlock_t         lock;
-    struct list_head   readyQ;
-    struct list_head   usedQ;
+    struct llist_head  readyQ;
     wait_queue_head_t  delWait;
     wait_queue_head_t  getWait;
     u8                 deleting;
 
-    S_MEMBLK_MGR      *pMgr;
+    S_MEMBLK_MGR     **ppMgr;
+    S_MEMBLK_MGR      *pLow;     // the lowest block header.
+    S_MEMBLK_MGR      *pHigh;    // the highest block header.
+
+    u16                magSize;
+    S_CMN_MPF_MAG __percpu *pMag;
+
+    // statistics.
+    atomic_t           freeCnt;  // blocks in readyQ and magazines.
+    u16                hwm;      // high-water mark of blocks out of readyQ.
+    ulong              getCnt;   // get served from readyQ.
+    ulong              waitCnt;  // get waited for a free block.
 } S_CMN_MPF;
 
 
@@ -91,11 +152,45 @@ static DECLARE_MUTEX(mutex);
 static DEFINE_SEMAPHORE(mutex); 
 #endif
 static S_CMN_MPF g_cmnMemPool[CMN_MEM_POOL_MAX_NUM] = {};
+static struct dentry *g_cmnDebugfsDir = NULL;
+
+static int CMN_openMplStat(struct inode *, struct file *);
+static const struct file_operations g_cmnMplStatFops = {
+    .owner   = THIS_MODULE,
+    .open    = CMN_openMplStat,
+    .read    = seq_read,
+    .llseek  = seq_lseek,
+    .release = single_release,
+};
 
 
 /*-------------------------------------------------------------------
  * Inline Functions
  *-----------------------------------------------------------------*/
+inline static int
+CMN_isMemBlkReady(S_CMN_MPF *pCmnMpf)
+{
+
+    int cpu;
+
+    if(!llist_empty(&pCmnMpf->readyQ) || pCmnMpf->deleting) {
+        return TRUE;
+    }
+
+    if(pCmnMpf->pMag) {
+        // free block may be cached on the other CPU.
+        for_each_possible_cpu(cpu) {
+            if(*(volatile u16 *)&per_cpu_ptr(pCmnMpf->pMag, cpu)->count) {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+
+}
+
+
 inline static T_CMN_ERR
 CMN_waitMemBlkReady(S_CMN_MPF *pCmnMpf, u16 timeOut) 
 {
@@ -105,8 +200,7 @@ CMN_waitMemBlkReady(S_CMN_MPF *pCmnMpf, u16 timeOut)
     if(timeOut == CMN_TIME_FEVR) {
         retval = 
             wait_event_interruptible(pCmnMpf->getWait, 
-                                     (!list_empty(&pCmnMpf->readyQ)) || 
-                                     (pCmnMpf->deleting));
+                                     CMN_isMemBlkReady(pCmnMpf));
         if(retval != 0) {
             // interrupted.
             return ERR_RLWAIT;
@@ -114,8 +208,7 @@ CMN_waitMemBlkReady(S_CMN_MPF *pCmnMpf, u16 timeOut)
     } else {
         retval = 
             wait_event_interruptible_timeout(pCmnMpf->getWait, 
-                                             (!list_empty(&pCmnMpf->readyQ)) || 
-                                             (pCmnMpf->deleting),
+                                             CMN_isMemBlkReady(pCmnMpf),
                                              msecs_to_jiffies(timeOut));
         if(retval < 0) {
             // interrupted.
@@ -136,12 +229,171 @@ CMN_waitMemBlkReady(S_CMN_MPF *pCmnMpf, u16 timeOut)
 
 }
 
+
+inline static S_MEMBLK_MGR *
+CMN_allocMemBlk(S_CMN_MPF *pCmnMpf)
+{
+
+    uint total = CMN_MEMBLK_HDR_SIZE + pCmnMpf->size;
+
+    // avoid power-of-2 round up of kmalloc for the large block.
+    if(total > PAGE_SIZE) {
+        return (S_MEMBLK_MGR *)alloc_pages_exact(total, GFP_KERNEL);
+    }
+
+    return (S_MEMBLK_MGR *)kmalloc(total, GFP_KERNEL);
+
+}
+
+
+inline static void
+CMN_freeMemBlk(S_CMN_MPF *pCmnMpf, S_MEMBLK_MGR *pMgr)
+{
+
+    uint total = CMN_MEMBLK_HDR_SIZE + pCmnMpf->size;
+
+    if(total > PAGE_SIZE) {
+        free_pages_exact(pMgr, total);
+    } else {
+        kfree(pMgr);
+    }
+
+    return;
+
+}
+
+
+inline static void
+CMN_countMemBlkOut(S_CMN_MPF *pCmnMpf)
+{
+
+    u16 out;
+
+    // statistics only, hwm may be updated concurrently.
+    out = pCmnMpf->maxcnt - atomic_dec_return(&pCmnMpf->freeCnt);
+    if(out > pCmnMpf->hwm) {
+        pCmnMpf->hwm = out;
+    }
+
+    return;
+
+}
+
+
+inline static S_MEMBLK_MGR *
+CMN_takeMagBlk(S_CMN_MPF_MAG *pMag)
+{
+
+    S_MEMBLK_MGR  *pMgr = NULL;
+    unsigned long  flag;
+
+    spin_lock_irqsave(&pMag->lock, flag);
+    if(pMag->count) {
+        pMgr = pMag->pMgr[--pMag->count];
+    }
+    spin_unlock_irqrestore(&pMag->lock, flag);
+
+    return pMgr;
+
+}
+
+
+inline static S_MEMBLK_MGR *
+CMN_getMemBlk(S_CMN_MPF *pCmnMpf)
+{
+
+    S_CMN_MPF_MAG     *pMag;
+    S_MEMBLK_MGR      *pMgr;
+    struct llist_node *pNode;
+    unsigned long      flag;
+    int                cpu;
+
+    // 1st : own CPU magazine, no shared cache line is touched.
+    if(pCmnMpf->pMag) {
+        pMag = get_cpu_ptr(pCmnMpf->pMag);
+        pMgr = CMN_takeMagBlk(pMag);
+        if(pMgr) {
+            pMag->hit++;
+        } else {
+            pMag->miss++;
+        }
+        put_cpu_ptr(pCmnMpf->pMag);
+        if(pMgr) {
+            CMN_countMemBlkOut(pCmnMpf);
+            return pMgr;
+        }
+    }
+
+    // 2nd : shared queue.
+    spin_lock_irqsave(&pCmnMpf->lock, flag);
+    pNode = llist_del_first(&pCmnMpf->readyQ);
+    if(pNode) {
+        CMN_countMemBlkOut(pCmnMpf);
+        pCmnMpf->getCnt++;
+    }
+    spin_unlock_irqrestore(&pCmnMpf->lock, flag);
+
+    if(pNode) {
+        return llist_entry(pNode, S_MEMBLK_MGR, node);
+    }
+
+    // 3rd : steal from the other CPU magazines before sleeping.
+    if(pCmnMpf->pMag) {
+        for_each_possible_cpu(cpu) {
+            pMgr = CMN_takeMagBlk(per_cpu_ptr(pCmnMpf->pMag, cpu));
+            if(pMgr) {
+                CMN_countMemBlkOut(pCmnMpf);
+                return pMgr;
+            }
+        }
+    }
+
+    return NULL;
+
+}
+
+
+inline static void
+CMN_putMemBlk(S_CMN_MPF *pCmnMpf, S_MEMBLK_MGR *pMgr)
+{
+
+    S_CMN_MPF_MAG *pMag;
+    unsigned long  flag;
+    int            cached = FALSE;
+
+    // count first, freeCnt must not be less than the real number.
+    atomic_inc(&pCmnMpf->freeCnt);
+
+    if(pCmnMpf->pMag) {
+        pMag = get_cpu_ptr(pCmnMpf->pMag);
+        spin_lock_irqsave(&pMag->lock, flag);
+        if(pMag->count < pCmnMpf->magSize) {
+            pMag->pMgr[pMag->count++] = pMgr;
+            cached = TRUE;
+        }
+        spin_unlock_irqrestore(&pMag->lock, flag);
+        put_cpu_ptr(pCmnMpf->pMag);
+        if(cached) {
+            // pairs with the waiter's check in CMN_isMemBlkReady().
+            smp_mb();
+            return;
+        }
+    }
+
+    // chain to available queue. (llist_add implies full barrier)
+    llist_add(&pMgr->node, &pCmnMpf->readyQ);
+
+    return;
+
+}
+
 /*-------------------------------------------------------------------
  * Prototypes Functions
  *-----------------------------------------------------------------*/
 static T_CMN_ERR CMN_initMpf(S_CMN_MPF *);
 static void      CMN_cleanMpf(S_CMN_MPF *);
 extern void      CMN_initFixedMemPool(void);
+extern void      CMN_exitFixedMemPool(void);
 
 
 /*-------------------------------------------------------------------
@@ -160,40 +412,83 @@ CMN_initMpf(S_CMN_MPF *pCmnMpf)
 {
 
     int           i;
+    int           cpu;
+    uint          rsv;
     S_MEMBLK_MGR *pMgr;
 
     spin_lock_init(&pCmnMpf->lock);
-    INIT_LIST_HEAD(&pCmnMpf->usedQ);
-    INIT_LIST_HEAD(&pCmnMpf->readyQ);
+    init_llist_head(&pCmnMpf->readyQ);
     init_waitqueue_head(&pCmnMpf->delWait);
     init_waitqueue_head(&pCmnMpf->getWait);
     pCmnMpf->deleting = 0;
 
-    pCmnMpf->pMgr   = 
-        (S_MEMBLK_MGR *)kmalloc(sizeof(S_MEMBLK_MGR) * pCmnMpf->maxcnt, GFP_KERNEL);
-    if(pCmnMpf->pMgr == NULL) {
-        return ERR_NOMEM;
+    atomic_set(&pCmnMpf->freeCnt, 0);
+    pCmnMpf->hwm     = 0;
+    pCmnMpf->getCnt  = 0;
+    pCmnMpf->waitCnt = 0;
+
+    // per-CPU magazine, sized apart from the requested count.
+    pCmnMpf->pMag    = NULL;
+    pCmnMpf->magSize = 0;
+    if(pCmnMpf->attr & CMN_MPL_ATTR_PERCPU) {
+        pCmnMpf->pMag = alloc_percpu(S_CMN_MPF_MAG);
+        if(pCmnMpf->pMag == NULL) {
+            return ERR_NOMEM;
+        }
+        for_each_possible_cpu(cpu) {
+            spin_lock_init(&per_cpu_ptr(pCmnMpf->pMag, cpu)->lock);
+        }
+
+        pCmnMpf->magSize = pCmnMpf->maxcnt / num_online_cpus();
+        if(pCmnMpf->magSize > CMN_MPL_MAG_SIZE) {
+            pCmnMpf->magSize = CMN_MPL_MAG_SIZE;
+        } else if(pCmnMpf->magSize == 0) {
+            pCmnMpf->magSize = 1;
+        }
+
+        // reserve for the magazines, up to the requested count.
+        rsv = pCmnMpf->magSize * num_online_cpus();
+        rsv = MIN(rsv, (uint)pCmnMpf->maxcnt);
+        rsv = MIN(rsv, (uint)(0xFFFF - pCmnMpf->maxcnt));
+        pCmnMpf->maxcnt += (u16)rsv;
+    }
+
+    pCmnMpf->ppMgr  = 
+        (S_MEMBLK_MGR **)kmalloc(sizeof(S_MEMBLK_MGR *) * pCmnMpf->maxcnt, GFP_KERNEL);
+    if(pCmnMpf->ppMgr == NULL) {
+        goto ERR_MAG;
     }
 
     for(i=0; i<pCmnMpf->maxcnt; i++) {
-        pMgr = &(pCmnMpf->pMgr[i]);
-        INIT_LIST_HEAD(&pMgr->list);
-        pMgr->pMemBlk = (void *)kmalloc(pCmnMpf->size, GFP_KERNEL);
-        if(pMgr->pMemBlk == NULL) {
+        pMgr = CMN_allocMemBlk(pCmnMpf);
+        if(pMgr == NULL) {
             goto ERR;
         }
-        list_add(&pMgr->list, &pCmnMpf->readyQ);
+        pMgr->pMpf  = pCmnMpf;
+        pMgr->inUse = FALSE;
+        pCmnMpf->ppMgr[i] = pMgr;
+        if((i == 0) || (pMgr < pCmnMpf->pLow)) {
+            pCmnMpf->pLow = pMgr;
+        }
+        if((i == 0) || (pMgr > pCmnMpf->pHigh)) {
+            pCmnMpf->pHigh = pMgr;
+        }
+        llist_add(&pMgr->node, &pCmnMpf->readyQ);
+        atomic_inc(&pCmnMpf->freeCnt);
     }
     
     return SUCCESS;
 
 ERR:
     for(i=i-1;i>=0; i--){
-        pMgr = &(pCmnMpf->pMgr[i]);
-        list_del_init(&pMgr->list);
-        kfree(pMgr->pMemBlk);
+        CMN_freeMemBlk(pCmnMpf, pCmnMpf->ppMgr[i]);
+    }
+    kfree(pCmnMpf->ppMgr);
+ERR_MAG:
+    if(pCmnMpf->pMag) {
+        free_percpu(pCmnMpf->pMag);
+        pCmnMpf->pMag = NULL;
     }
-    kfree(pCmnMpf->pMgr);
 
     return ERR_NOMEM;
 }
@@ -213,17 +508,84 @@ static void
 CMN_cleanMpf(S_CMN_MPF *pCmnMpf)
 {
 
-    S_MEMBLK_MGR      *pMgr;
     int               i;
 
     for(i=0; i<pCmnMpf->maxcnt; i++) {
-        pMgr = &(pCmnMpf->pMgr[i]);
-        list_del_init(&pMgr->list);
-        kfree(pMgr->pMemBlk);
+        CMN_freeMemBlk(pCmnMpf, pCmnMpf->ppMgr[i]);
+    }
+
+    kfree(pCmnMpf->ppMgr);
+
+    // the blocks cached in magazines are already freed above.
+    if(pCmnMpf->pMag) {
+        free_percpu(pCmnMpf->pMag);
+        pCmnMpf->pMag = NULL;
+    }
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_showMplStat
+ *-----------------------------------------------------------------*/
+/**
+ * show the statistics of all fixed memory pools (debugfs).
+ * @param     m : the seq_file.
+ * @param     v : not used.
+ * @return    0 (normally completion)
+ * @note      counters are sampled without lock, values are approximate.
+ *            free includes the blocks cached in magazines, and maxcnt
+ *            includes the reserve for magazines.
+ */
+/*-----------------------------------------------------------------*/
+static int
+CMN_showMplStat(struct seq_file *m, void *v)
+{
+
+    S_CMN_MPF     *pCmnMpf;
+    S_CMN_MPF_MAG *pMag;
+    ulong          hit, miss;
+    uint           cached;
+    int            i, cpu;
+
+    seq_printf(m, "%2s %6s %6s %4s %4s %6s %6s %4s %10s %10s %10s %10s\n",
+               "id", "size", "maxcnt", "attr", "mag", "free", "cached",
+               "hwm", "get", "hit", "miss", "wait");
+
+    down(&mutex);
+    for(i=0; i<CMN_MEM_POOL_MAX_NUM; i++) {
+        pCmnMpf = &(g_cmnMemPool[i]);
+        if(pCmnMpf->id == 0) {
+            continue;
+        }
+
+        hit = miss = cached = 0;
+        if(pCmnMpf->pMag) {
+            for_each_possible_cpu(cpu) {
+                pMag    = per_cpu_ptr(pCmnMpf->pMag, cpu);
+                hit    += pMag->hit;
+                miss   += pMag->miss;
+                cached += pMag->count;
+            }
+        }
+
+        seq_printf(m, "%2u %6u %6u %4x %4u %6d %6u %4u %10lu %10lu %10lu %10lu\n",
+                   pCmnMpf->id, pCmnMpf->size, pCmnMpf->maxcnt,
+                   pCmnMpf->attr, pCmnMpf->magSize,
+                   atomic_read(&pCmnMpf->freeCnt), cached, pCmnMpf->hwm,
+                   pCmnMpf->getCnt, hit, miss, pCmnMpf->waitCnt);
     }
+    up(&mutex);
+
+    return 0;
+
+}
 
-    kfree(pCmnMpf->pMgr);
 
+static int
+CMN_openMplStat(struct inode *inode, struct file *file)
+{
+    return single_open(file, CMN_showMplStat, NULL);
 }
 
 
@@ -247,6 +609,36 @@ CMN_initFixedMemPool()
         g_cmnMemPool[i].id = 0; // 0 means unused.
     }
 
+    // statistics are optional, failure is not fatal.
+    g_cmnDebugfsDir = debugfs_create_dir(CMN_DEBUGFS_DIR, NULL);
+    if(IS_ERR_OR_NULL(g_cmnDebugfsDir)) {
+        g_cmnDebugfsDir = NULL;
+        return;
+    }
+    debugfs_create_file(CMN_DEBUGFS_MPL, S_IRUGO, g_cmnDebugfsDir,
+                        NULL, &g_cmnMplStatFops);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_exitFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function finalize fixed memory pool manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_exitFixedMemPool()
+{
+
+    debugfs_remove_recursive(g_cmnDebugfsDir);
+    g_cmnDebugfsDir = NULL;
+
     return;
 }
 
@@ -294,10 +686,14 @@ CMN_createFixedMemPool(u8   memPoolID,
         return ERR_INVSTAT;
     }
 
-    pCmnMpf->id     = memPoolID;
     pCmnMpf->maxcnt = memBlkCount;
     pCmnMpf->size   = memBlkSize;
-    CMN_initMpf(pCmnMpf);
+    pCmnMpf->attr   = memAttr;
+    if(CMN_initMpf(pCmnMpf) != SUCCESS) {
+        up(&mutex);
+        return ERR_NOMEM;
+    }
+    pCmnMpf->id     = memPoolID;
     up(&mutex);
 
     return SUCCESS;
@@ -334,10 +730,14 @@ CMN_acreateFixedMemPool(u32  memAttr,
         pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
         if(pCmnMpf->id == 0) {
             // found
-            pCmnMpf->id = memPoolID;
             pCmnMpf->maxcnt = memBlkCount;
             pCmnMpf->size   = memBlkSize;
-            CMN_initMpf(pCmnMpf);
+            pCmnMpf->attr   = memAttr;
+            if(CMN_initMpf(pCmnMpf) != SUCCESS) {
+                up(&mutex);
+                return ERR_NOMEM;
+            }
+            pCmnMpf->id = memPoolID;
             up(&mutex);
             return memPoolID;
         }
@@ -408,11 +808,10 @@ CMN_getFixedMemPool(u8   memPoolID,
                     u16  timeOut)
 {
 
-    S_CMN_MPF    *pCmnMpf;
-    S_MEMBLK_MGR *pMgr = NULL;
+    S_CMN_MPF         *pCmnMpf;
+    S_MEMBLK_MGR      *pMgr = NULL;
 
-    T_CMN_ERR     retval;
-    unsigned long flag;
+    T_CMN_ERR          retval;
 
     // check parameter
     if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
@@ -426,28 +825,24 @@ CMN_getFixedMemPool(u8   memPoolID,
     }
 
     do {
+        //
+        // take free block at first, wait only when pool is empty.
+        //
+        pMgr = CMN_getMemBlk(pCmnMpf);
+        if(pMgr) {
+            // found available memory block
+            break;
+        }
 
+        pCmnMpf->waitCnt++; // statistics only, no lock.
         retval = CMN_waitMemBlkReady(pCmnMpf, timeOut);
         if(retval != SUCCESS) {
             return retval;
         }
-
-        spin_lock_irqsave(&pCmnMpf->lock, flag);
-        if(!list_empty(&pCmnMpf->readyQ)) {
-            // chain to used queue.
-            pMgr = list_entry(pCmnMpf->readyQ.next, S_MEMBLK_MGR, list);
-            list_del_init(&pMgr->list);
-            list_add(&pMgr->list, &pCmnMpf->usedQ);
-        }
-        spin_unlock_irqrestore(&pCmnMpf->lock, flag);
-
-        if(pMgr) {
-            // found available memory block
-            break;
-        }
     } while(1);
     
-    *pMemBlk = pMgr->pMemBlk;
+    pMgr->inUse = TRUE;
+    *pMemBlk    = CMN_MGR_TO_MEMBLK(pMgr);
 
     return SUCCESS;
 
@@ -464,7 +859,8 @@ CMN_getFixedMemPool(u8   memPoolID,
  * @return    SUCCESS     (normally completion)
  * @return    ERR_INVID   (the ID is invalid)
  * @return    ERR_NOOBJ   (the object don't exist)
- * @note      nothing.
+ * @return    ERR_BADPARM (the block is not allocated from the pool)
+ * @note      the block is found from its header in O(1).
  */
 /*-----------------------------------------------------------------*/
 T_CMN_ERR
@@ -473,9 +869,7 @@ CMN_releaseFixedMemPool(u8   memPoolID,
 {
 
     S_CMN_MPF    *pCmnMpf;
-    S_MEMBLK_MGR *pMgr, *pNext;
-
-    unsigned long flag;
+    S_MEMBLK_MGR *pMgr;
 
     // check parameter
     if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
@@ -488,19 +882,35 @@ CMN_releaseFixedMemPool(u8   memPoolID,
         return ERR_NOOBJ;
     }
 
-    spin_lock_irqsave(&pCmnMpf->lock, flag);
-    list_for_each_entry_safe(pMgr, pNext, &pCmnMpf->usedQ, list) {
-        if(pMgr->pMemBlk == pMemBlk) {
-            // chain to available queue.
-            list_del_init(&pMgr->list);
-            list_add(&pMgr->list, &pCmnMpf->readyQ);
-            break;
-        }
+    if (pMemBlk == NULL) {
+        return ERR_BADPARM;
+    }
+
+    //
+    // blocks are allocated one by one, so the range of the pool is
+    // checked before the header is read. a foreign pointer within the
+    // range is still in the linear map, and is rejected by its header.
+    //
+    pMgr = CMN_MEMBLK_TO_MGR(pMemBlk);
+    if ((pMgr < pCmnMpf->pLow) || (pMgr > pCmnMpf->pHigh) ||
+        (!IS_ALIGNED((ulong)pMgr, sizeof(void *))) || (!virt_addr_valid(pMgr))) {
+        return ERR_BADPARM;
     }
-    spin_unlock_irqrestore(&pCmnMpf->lock, flag);
 
-    wake_up_interruptible(&pCmnMpf->getWait);
-    wake_up_interruptible(&pCmnMpf->delWait);
+    // the header of the block indicates the owner pool.
+    if ((pMgr->pMpf != pCmnMpf) || (xchg(&pMgr->inUse, FALSE) == FALSE)) {
+        // not a block of this pool, or already released.
+        return ERR_BADPARM;
+    }
+
+    CMN_putMemBlk(pCmnMpf, pMgr);
+
+    if (waitqueue_active(&pCmnMpf->getWait)) {
+        wake_up_interruptible(&pCmnMpf->getWait);
+    }
+    if (waitqueue_active(&pCmnMpf->delWait)) {
+        wake_up_interruptible(&pCmnMpf->delWait);
+    }
 
     return SUCCESS;
 }
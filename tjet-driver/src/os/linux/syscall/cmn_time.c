@@ -31,6 +31,7 @@
 #include <linux/module.h>  // EXPORT_SYMBOL
 #include <linux/time.h>    // timer API
 #include <linux/jiffies.h> // get system time
+#include <linux/ktime.h>   // get monotonic time
 
 #include <linux/version.h>
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,26)
@@ -334,3 +335,23 @@ CMN_getTime(u32 *pTime)
 
     return SUCCESS;
 }
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_getTimeUs
+ *-----------------------------------------------------------------*/
+/**
+ * get monotonic system time in usecs.
+ * @param     pTime   : pointer to the System time stored.
+ * @return    SUCCESS     (normally completion)
+ * @note      wraps about every 71 minutes, use the difference only.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_getTimeUs(u32 *pTime)
+{
+
+    *pTime = (u32)ktime_to_us(ktime_get());
+
+    return SUCCESS;
+}
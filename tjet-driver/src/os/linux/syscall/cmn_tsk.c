@@ -33,6 +33,8 @@
 #include <linux/module.h>  // EXPORT_SYMBOL
 #include <linux/wait.h>    // waitqueue API
 #include <linux/delay.h>   // msleep.
+#include <linux/sched.h>   // set_cpus_allowed_ptr.
+#include <linux/cpumask.h> // cpumask API.
 #include <asm/atomic.h>    // atomic API.
 #include <linux/version.h>
 
@@ -84,8 +86,14 @@ static S_CMN_TSK g_cmnTsk[CMN_TASK_MAX_NUM] = {};
 
 static const char *task_names[] = 
 {
-    "CNL_thread",
-    "XXX_thread",
+    "CNL_thread/0",
+    "CNL_thread/1",
+    "CNL_thread/2",
+    "CNL_thread/3",
+    "CNL_irq/0",
+    "CNL_irq/1",
+    "CNL_irq/2",
+    "CNL_irq/3",
     // add if needed.
 };
 
@@ -358,11 +366,13 @@ CMN_terminateTask(u8 tskID)
 
     pCmnTsk = &(g_cmnTsk[tskID-1]);
 
-    if(pCmnTsk->id == 0) {
+    if((pCmnTsk->id == 0) || (pCmnTsk->pTsk == NULL)) {
         return ERR_NOOBJ;
     }
 
     kthread_stop(pCmnTsk->pTsk);
+    // the task_struct may be reused, do not match it in CMN_sleepTask.
+    pCmnTsk->pTsk = NULL;
 
     return SUCCESS;
 }
@@ -460,6 +470,56 @@ CMN_wakeupTask(u8 tskID)
 }
 
 
+/*-------------------------------------------------------------------
+ * Function   : CMN_setTaskAffinity
+ *-----------------------------------------------------------------*/
+/**
+ * This function binds the specified task to a CPU.
+ * @param     tskID     : ID of the task
+ * @param     cpu       : CPU number, wrapped by the number of CPUs.
+ *                        negative value lets the task run on any CPU.
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @return    ERR_INVSTAT (the CPU is offline)
+ * @note      call after CMN_startTask.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_setTaskAffinity(u8  tskID,
+                    int cpu)
+{
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    if((pCmnTsk->id == 0) || (pCmnTsk->pTsk == NULL)) {
+        return ERR_NOOBJ;
+    }
+
+    if(cpu < 0) {
+        set_cpus_allowed_ptr(pCmnTsk->pTsk, cpu_possible_mask);
+        return SUCCESS;
+    }
+
+    cpu = cpu % nr_cpu_ids;
+    if(!cpu_online(cpu)) {
+        return ERR_INVSTAT;
+    }
+
+    if(set_cpus_allowed_ptr(pCmnTsk->pTsk, cpumask_of(cpu)) != 0) {
+        return ERR_INVSTAT;
+    }
+
+    return SUCCESS;
+}
+
+
 /*-------------------------------------------------------------------
  * Function   : CMN_delayTask
  *-----------------------------------------------------------------*/
@@ -484,3 +544,27 @@ CMN_delayTask(u16 dlyTime)
 
     return SUCCESS;
 }
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_delayTaskUs
+ *-----------------------------------------------------------------*/
+/**
+ * This function make the own task delayed in usec order.
+ * @param     dlyTime  : the value of time to make the task delayed (us)
+ * @return    SUCCESS     (normally completion)
+ * @note      the task may sleep up to a quarter longer than requested.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_delayTaskUs(u16 dlyTime)
+{
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,36)
+    usleep_range(dlyTime, dlyTime + (dlyTime >> 2) + 1);
+#else
+    udelay(dlyTime);
+#endif
+
+    return SUCCESS;
+}
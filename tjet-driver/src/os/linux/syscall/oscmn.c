@@ -67,6 +67,7 @@
 extern void CMN_initSem(void);
 extern void CMN_initCpuLock(void);
 extern void CMN_initFixedMemPool(void);
+extern void CMN_exitFixedMemPool(void);
 extern void CMN_initTask(void);
 extern void CMN_initTimer(void);
 #ifdef CONFIG_HAS_EARLYSUSPEND
@@ -117,6 +118,7 @@ OSCMN_exit(void)
 #ifdef CONFIG_HAS_EARLYSUSPEND
     CMN_exitEarlySuspend();
 #endif
+    CMN_exitFixedMemPool();
     return;
 }
 
@@ -164,7 +166,9 @@ EXPORT_SYMBOL(CMN_exitTask);
 EXPORT_SYMBOL(CMN_terminateTask);
 EXPORT_SYMBOL(CMN_sleepTask);
 EXPORT_SYMBOL(CMN_wakeupTask);
+EXPORT_SYMBOL(CMN_setTaskAffinity);
 EXPORT_SYMBOL(CMN_delayTask);
+EXPORT_SYMBOL(CMN_delayTaskUs);
 
 // from cmn_time.c
 EXPORT_SYMBOL(CMN_createAlarmTim);
@@ -173,6 +177,7 @@ EXPORT_SYMBOL(CMN_deleteAlarmTim);
 EXPORT_SYMBOL(CMN_startAlarmTim);
 EXPORT_SYMBOL(CMN_stopAlarmTim);
 EXPORT_SYMBOL(CMN_getTime);
+EXPORT_SYMBOL(CMN_getTimeUs);
 
 // from cmn_util.c
 EXPORT_SYMBOL(CMN_print);
@@ -0,0 +1,543 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cmn_mem.c
+ *
+ *  @brief    This file defines the functions which handle fixed memory
+ *            pool object and method. (POSIX user space)
+ *
+ *
+ *  @note     CMN_MPL_ATTR_PERCPU is accepted but has no effect,
+ *            all blocks are kept in one free list.
+ */
+/*=================================================================*/
+
+#include "oscmn.h"
+#include "cmn_cnf.h"
+#include "cmn_posix.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <stdint.h>
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @brief memory block header.
+ *        header is placed just before the memory block, and it is aligned
+ *        to cache line not to share the line with the memory block.
+ */
+#define CMN_CACHE_LINE_BYTES     64
+#define CMN_MEMBLK_HDR_SIZE      \
+    ((sizeof(S_MEMBLK_MGR) + CMN_CACHE_LINE_BYTES - 1) & ~(CMN_CACHE_LINE_BYTES - 1))
+#define CMN_MEMBLK_TO_MGR(p)     ((S_MEMBLK_MGR *)((u8 *)(p) - CMN_MEMBLK_HDR_SIZE))
+#define CMN_MGR_TO_MEMBLK(p)     ((void *)((u8 *)(p) + CMN_MEMBLK_HDR_SIZE))
+#define CMN_MEMBLK_STRIDE(size)  \
+    (CMN_MEMBLK_HDR_SIZE + (((size) + CMN_CACHE_LINE_BYTES - 1) & ~(CMN_CACHE_LINE_BYTES - 1)))
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+struct tagS_CMN_MPF;
+
+/**
+ * @brief memory pool block header.
+ */
+typedef struct tagS_MEMBLK_MGR{
+    struct tagS_MEMBLK_MGR *pNext;  // next free block.
+    struct tagS_CMN_MPF    *pMpf;   // owner memory pool.
+    ulong                   inUse;
+} S_MEMBLK_MGR;
+
+
+/**
+ * @brief memory pool manager
+ *        free list is protected by lock.
+ *        all blocks are placed in one area by stride, so that a released
+ *        pointer is checked by range before its header is read.
+ */
+typedef struct tagS_CMN_MPF{
+    u8                 id;
+    uint               size;
+    u16                maxcnt;
+    u32                attr;
+
+    pthread_mutex_t    lock;
+    pthread_cond_t     getWait;
+    S_MEMBLK_MGR      *pFree;
+    u16                freeCnt;
+
+    u8                *pArea;
+    size_t             stride;
+} S_CMN_MPF;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static S_CMN_MPF g_cmnMemPool[CMN_MEM_POOL_MAX_NUM] = {};
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Prototypes Functions
+ *-----------------------------------------------------------------*/
+extern void CMN_initFixedMemPool(void);
+extern void CMN_exitFixedMemPool(void);
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_initMpf
+ *-----------------------------------------------------------------*/
+/**
+ * initialize a fixed memory pool.
+ * @param     pCmnMpf : the pointer to the fixed memory pool.
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_NOMEM   (the memory or resource is depleted)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static T_CMN_ERR
+CMN_initMpf(S_CMN_MPF *pCmnMpf)
+{
+
+    int           i;
+    S_MEMBLK_MGR *pMgr;
+
+    pCmnMpf->stride = CMN_MEMBLK_STRIDE(pCmnMpf->size);
+    if(posix_memalign((void **)&pCmnMpf->pArea, CMN_CACHE_LINE_BYTES,
+                      pCmnMpf->stride * pCmnMpf->maxcnt) != 0) {
+        pCmnMpf->pArea = NULL;
+        return ERR_NOMEM;
+    }
+
+    // chain in reverse order, so that the lowest block is taken first.
+    pCmnMpf->pFree   = NULL;
+    pCmnMpf->freeCnt = 0;
+    for(i=pCmnMpf->maxcnt-1; i>=0; i--) {
+        pMgr = (S_MEMBLK_MGR *)(pCmnMpf->pArea + (pCmnMpf->stride * i));
+        pMgr->pMpf        = pCmnMpf;
+        pMgr->inUse       = FALSE;
+        pMgr->pNext       = pCmnMpf->pFree;
+        pCmnMpf->pFree    = pMgr;
+        pCmnMpf->freeCnt++;
+    }
+
+    pthread_mutex_init(&pCmnMpf->lock, NULL);
+    CMN_initCond(&pCmnMpf->getWait);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_cleanMpf
+ *-----------------------------------------------------------------*/
+/**
+ * cleanup a fixed memory pool.
+ * @param     pCmnMpf : the pointer to the fixed memory pool.
+ * @return    nothing
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static void
+CMN_cleanMpf(S_CMN_MPF *pCmnMpf)
+{
+
+    free(pCmnMpf->pArea);
+    pCmnMpf->pArea = NULL;
+
+    pthread_cond_destroy(&pCmnMpf->getWait);
+    pthread_mutex_destroy(&pCmnMpf->lock);
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_initFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function initialize fixed memory pool manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_initFixedMemPool()
+{
+
+    int i;
+
+    for(i=0; i<CMN_MEM_POOL_MAX_NUM; i++) {
+        g_cmnMemPool[i].id = 0; // 0 means unused.
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_exitFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function finalize fixed memory pool manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_exitFixedMemPool()
+{
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_createFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a fixed memory pool with the specified ID.
+ * @param     memPoolID    : ID of the memory pool
+ * @param     memAttr      : the attribute of the memory pool
+ * @param     memBlkCount  : the number of memory block to allocate
+ * @param     memBlkSize   : the size of memory block to allocate
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_BADPARM (the input parameter is invalid)
+ * @return    ERR_NOMEM   (the momory or resource is depleted)
+ * @return    ERR_INVSTAT (the internal status of the object is invalid)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_createFixedMemPool(u8   memPoolID,
+                       u32  memAttr,
+                       u16  memBlkCount,
+                       uint memBlkSize)
+{
+
+    S_CMN_MPF *pCmnMpf;
+
+    // check parameter
+    if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    if (memBlkCount == 0 || memBlkSize == 0) {
+        return ERR_BADPARM;
+    }
+
+    pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
+    pthread_mutex_lock(&mutex);
+    if(pCmnMpf->id != 0) {
+        // arleady used.
+        pthread_mutex_unlock(&mutex);
+        return ERR_INVSTAT;
+    }
+
+    pCmnMpf->maxcnt = memBlkCount;
+    pCmnMpf->size   = memBlkSize;
+    pCmnMpf->attr   = memAttr;
+    if(CMN_initMpf(pCmnMpf) != SUCCESS) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOMEM;
+    }
+    pCmnMpf->id     = memPoolID;
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_acreateFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a fixed memory pool with the specified ID.
+ * @param     memAttr      : the attribute of the memory pool
+ * @param     memBlkCount  : the number of memory block to allocate
+ * @param     memBlkSize   : the size of memory block to allocate
+ * @return    assigned ID (normally completion)
+ * @return    ERR_BADPARM (the input parameter is invalid)
+ * @return    ERR_NOMEM   (the momory or resource is depleted)
+ * @return    ERR_NOID    (no more memory pool object is available)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_acreateFixedMemPool(u32  memAttr,
+                        u16  memBlkCount,
+                        uint memBlkSize)
+{
+
+    S_CMN_MPF *pCmnMpf;
+    u8         memPoolID;
+
+    if (memBlkCount == 0 || memBlkSize == 0) {
+        return ERR_BADPARM;
+    }
+
+    pthread_mutex_lock(&mutex);
+    for(memPoolID=1; memPoolID<=CMN_MEM_POOL_MAX_NUM; memPoolID++) {
+        pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
+        if(pCmnMpf->id == 0) {
+            // found
+            pCmnMpf->maxcnt = memBlkCount;
+            pCmnMpf->size   = memBlkSize;
+            pCmnMpf->attr   = memAttr;
+            if(CMN_initMpf(pCmnMpf) != SUCCESS) {
+                pthread_mutex_unlock(&mutex);
+                return ERR_NOMEM;
+            }
+            pCmnMpf->id = memPoolID;
+            pthread_mutex_unlock(&mutex);
+            return memPoolID;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return ERR_NOID;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_deleteFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function deletes a memory pool with the specified ID.
+ * @param     memPoolID  : ID of memory pool
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_deleteFixedMemPool(u8 memPoolID)
+{
+
+    S_CMN_MPF *pCmnMpf;
+
+    // check parameter
+    if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
+    pthread_mutex_lock(&mutex);
+    if(pCmnMpf->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+    CMN_cleanMpf(pCmnMpf);
+    pCmnMpf->id = 0;
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_getFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function gets a memory block from the specified fixed memory pool.
+ * @param     memPoolID  : ID of message box
+ * @param     pMemBlk    : the pointer to the pointer to memory block
+ * @param     timeOut    : the value of timeout (ms)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @return    ERR_TIMEOUT (no free block within timeOut)
+ * @note      CMN_TIME_FEVR waits forever, CMN_TIME_POLL does not wait.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_getFixedMemPool(u8   memPoolID,
+                    void **pMemBlk,
+                    u16  timeOut)
+{
+
+    S_CMN_MPF         *pCmnMpf;
+    S_MEMBLK_MGR      *pMgr;
+    struct timespec    ts;
+    int                retval = 0;
+
+    // check parameter
+    if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
+
+    if(pCmnMpf->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    if(timeOut != CMN_TIME_FEVR) {
+        CMN_getAbsTime(&ts, timeOut);
+    }
+
+    pthread_mutex_lock(&pCmnMpf->lock);
+    while((pCmnMpf->pFree == NULL) && (retval != ETIMEDOUT)) {
+        if(timeOut == CMN_TIME_FEVR) {
+            pthread_cond_wait(&pCmnMpf->getWait, &pCmnMpf->lock);
+        } else {
+            retval = pthread_cond_timedwait(&pCmnMpf->getWait, &pCmnMpf->lock, &ts);
+        }
+    }
+    pMgr = pCmnMpf->pFree;
+    if(pMgr == NULL) {
+        pthread_mutex_unlock(&pCmnMpf->lock);
+        return ERR_TIMEOUT;
+    }
+    pCmnMpf->pFree = pMgr->pNext;
+    pCmnMpf->freeCnt--;
+    pMgr->inUse    = TRUE;
+    pthread_mutex_unlock(&pCmnMpf->lock);
+
+    *pMemBlk = CMN_MGR_TO_MEMBLK(pMgr);
+
+    return SUCCESS;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_releaseFixedMemPool
+ *-----------------------------------------------------------------*/
+/**
+ * This function releases a memory block into the specified fixed memory pool.
+ * @param     memPoolID  : ID of memory pool
+ * @param     pMemBlk    : the pointer to memory block
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @return    ERR_BADPARM (the block is not allocated from the pool)
+ * @note      the block is found from its header in O(1).
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_releaseFixedMemPool(u8   memPoolID,
+                        void *pMemBlk)
+{
+
+    S_CMN_MPF    *pCmnMpf;
+    S_MEMBLK_MGR *pMgr;
+    uintptr_t     offset;
+
+    // check parameter
+    if (memPoolID == 0 || memPoolID > CMN_MEM_POOL_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnMpf = &(g_cmnMemPool[memPoolID-1]);
+
+    if (pCmnMpf->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    if (pMemBlk == NULL) {
+        return ERR_BADPARM;
+    }
+
+    // check the range before the header is read.
+    offset = (uintptr_t)CMN_MEMBLK_TO_MGR(pMemBlk) - (uintptr_t)pCmnMpf->pArea;
+    if ((offset >= (pCmnMpf->stride * pCmnMpf->maxcnt)) ||
+        ((offset % pCmnMpf->stride) != 0)) {
+        return ERR_BADPARM;
+    }
+
+    // the header of the block indicates the owner pool.
+    pMgr = CMN_MEMBLK_TO_MGR(pMemBlk);
+    if (pMgr->pMpf != pCmnMpf) {
+        return ERR_BADPARM;
+    }
+
+    pthread_mutex_lock(&pCmnMpf->lock);
+    if (pMgr->inUse == FALSE) {
+        // already released.
+        pthread_mutex_unlock(&pCmnMpf->lock);
+        return ERR_BADPARM;
+    }
+    pMgr->inUse    = FALSE;
+    pMgr->pNext    = pCmnMpf->pFree;
+    pCmnMpf->pFree = pMgr;
+    pCmnMpf->freeCnt++;
+    pthread_cond_signal(&pCmnMpf->getWait);
+    pthread_mutex_unlock(&pCmnMpf->lock);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_allocMem
+ *-----------------------------------------------------------------*/
+/**
+ * This function allocate memory and set memory address
+ * @param     memAddr    : set allocate memory address pointer
+ * @param     memSize    : allocate memory size (byte)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_NOMEM   (the momory or resource is depleted)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_allocMem(void **memAddr, uint memSize)
+{
+
+    *memAddr = malloc(memSize);
+
+    if (*memAddr == NULL) {
+        return ERR_NOMEM;
+    }
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_releaseMem
+ *-----------------------------------------------------------------*/
+/**
+ * This function release memory
+ * @param     memAddr    : release memory address
+ * @return    nothing
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_releaseMem(void *memAddr)
+{
+
+    free(memAddr);
+
+    return;
+}
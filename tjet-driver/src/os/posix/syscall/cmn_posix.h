@@ -0,0 +1,86 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cmn_posix.h
+ *
+ *  @brief    This header file defines the helpers shared by the POSIX
+ *            implementation of common functions.
+ *
+ *
+ *  @note     all timed waits use CLOCK_MONOTONIC not to be affected by
+ *            the change of wall clock.
+ */
+/*=================================================================*/
+
+#if !defined(__CMN_POSIX_H__)
+#define __CMN_POSIX_H__
+
+#include <pthread.h>
+#include <time.h>
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+#define CMN_NSEC_PER_SEC               1000000000L
+#define CMN_NSEC_PER_MSEC              1000000L
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+/**
+ * initialize a condition variable which waits on CLOCK_MONOTONIC.
+ */
+inline static int
+CMN_initCond(pthread_cond_t *pCond)
+{
+
+    pthread_condattr_t attr;
+    int                retval;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    retval = pthread_cond_init(pCond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    return retval;
+
+}
+
+
+/**
+ * get the absolute CLOCK_MONOTONIC time after msec.
+ */
+inline static void
+CMN_getAbsTime(struct timespec *pTs, u32 msec)
+{
+
+    clock_gettime(CLOCK_MONOTONIC, pTs);
+    pTs->tv_sec  += msec / 1000;
+    pTs->tv_nsec += (long)(msec % 1000) * CMN_NSEC_PER_MSEC;
+    if(pTs->tv_nsec >= CMN_NSEC_PER_SEC) {
+        pTs->tv_sec++;
+        pTs->tv_nsec -= CMN_NSEC_PER_SEC;
+    }
+
+    return;
+
+}
+
+#endif //__CMN_POSIX_H__
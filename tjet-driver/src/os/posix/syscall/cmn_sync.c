@@ -0,0 +1,326 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cmn_sync.c
+ *
+ *  @brief    This file defines the functions which handle synchronization
+ *            object and method like the semaphore. (POSIX user space)
+ *
+ *
+ *  @note
+ */
+/*=================================================================*/
+
+#include "oscmn.h"
+#include "cmn_cnf.h"
+#include "cmn_posix.h"
+
+#include <errno.h>
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @breif semaphore object (for POSIX)
+ *        counting semaphore built on mutex and condition variable,
+ *        sem_timedwait() is not used because it waits on CLOCK_REALTIME.
+ */
+typedef struct tagS_CMN_SEM {
+    u8               id;
+    pthread_mutex_t  lock;
+    pthread_cond_t   wait;
+    u32              count;
+    u16              semMax;
+} S_CMN_SEM;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static S_CMN_SEM g_cmnSem[CMN_SEM_MAX_NUM] = {};
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+inline static void
+CMN_setupSem(S_CMN_SEM *pCmnSem, u8 semID, u16 semInit)
+{
+
+    // max value is not effective.
+    pCmnSem->id    = semID;
+    pCmnSem->count = semInit;
+    pthread_mutex_init(&pCmnSem->lock, NULL);
+    CMN_initCond(&pCmnSem->wait);
+
+    return;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Prototypes Functions
+ *-----------------------------------------------------------------*/
+extern void CMN_initSem(void);
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_initSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function initialize semaphore manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_initSem()
+{
+
+    int i;
+
+    for(i=0; i<CMN_SEM_MAX_NUM; i++) {
+        g_cmnSem[i].id = 0; // 0 means unused.
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_createSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a semaphore with the specified ID.
+ * @param     semID    : ID of the semaphore
+ * @param     semAttr  : the attribute of the semaphore
+ * @param     semInit  : the number of initial resources
+ * @param     semMax   : the number of maximum resources
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_BADPARM (the input parameter is invalid)
+ * @return    ERR_INVSTAT (the internal status of the object is invalid)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_createSem(u8   semID,
+              u32  semAttr,
+              u16  semInit,
+              u16  semMax)
+{
+
+    S_CMN_SEM      *pCmnSem;
+
+    // check parameter
+    if (semID == 0 || semID > CMN_SEM_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnSem = &(g_cmnSem[semID-1]);
+    pthread_mutex_lock(&mutex);
+    if(pCmnSem->id != 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_INVSTAT;
+    }
+
+    CMN_setupSem(pCmnSem, semID, semInit);
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_acreateSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a semaphore
+ * @param     semAttr  : the attribute of the semaphore
+ * @param     semInit  : the number of initial resources
+ * @param     semMax   : the number of maximum resources
+ * @return    assigned ID (normally completion)
+ * @return    ERR_NOID    (no more semaphore object is availbale)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_acreateSem(u32  semAttr,
+               u16  semInit,
+               u16  semMax)
+{
+
+    S_CMN_SEM      *pCmnSem;
+    u8              semID;
+
+    pthread_mutex_lock(&mutex);
+    for(semID=1; semID<=CMN_SEM_MAX_NUM; semID++) {
+        pCmnSem = &(g_cmnSem[semID-1]);
+        if(pCmnSem->id == 0) {
+            // found.
+            CMN_setupSem(pCmnSem, semID, semInit);
+            pthread_mutex_unlock(&mutex);
+            return semID;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return ERR_NOID;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_deleteSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function deletes a semaphore with the specified ID.
+ * @param     semID  : ID of the semaphore
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_deleteSem(u8 semID)
+{
+
+    S_CMN_SEM      *pCmnSem;
+
+    // check parameter
+    if (semID == 0 || semID > CMN_SEM_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnSem = &(g_cmnSem[semID-1]);
+
+    pthread_mutex_lock(&mutex);
+    if(pCmnSem->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+
+    pCmnSem->id = 0;
+    pthread_cond_destroy(&pCmnSem->wait);
+    pthread_mutex_destroy(&pCmnSem->lock);
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_singnalSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function returns a resource to the specified semaphore.
+ * @param     semID  : ID of the semaphore
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_signalSem(u8 semID)
+{
+
+    S_CMN_SEM      *pCmnSem;
+
+    // check parameter
+    if (semID == 0 || semID > CMN_SEM_MAX_NUM)
+    {
+        return ERR_INVID;
+    }
+    pCmnSem = &(g_cmnSem[semID-1]);
+
+    if(pCmnSem->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    pthread_mutex_lock(&pCmnSem->lock);
+    pCmnSem->count++;
+    pthread_cond_signal(&pCmnSem->wait);
+    pthread_mutex_unlock(&pCmnSem->lock);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_waitSem
+ *-----------------------------------------------------------------*/
+/**
+ * This function gets a resource from the specified semaphore.
+ * @param     semID    : ID of the semaphore
+ * @param     timeOut  : the value of timeout (ms)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @return    ERR_TIMEOUT (no resource within timeOut)
+ * @note      CMN_TIME_FEVR waits forever, CMN_TIME_POLL does not wait.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_waitSem(u8  semID,
+            u16 timeOut)
+{
+
+    int              retval = 0;
+    S_CMN_SEM       *pCmnSem;
+    struct timespec  ts;
+
+    // check parameter
+    if (semID == 0 || semID > CMN_SEM_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnSem = &(g_cmnSem[semID-1]);
+
+    if(pCmnSem->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    if(timeOut != CMN_TIME_FEVR) {
+        CMN_getAbsTime(&ts, timeOut);
+    }
+
+    pthread_mutex_lock(&pCmnSem->lock);
+    while((pCmnSem->count == 0) && (retval != ETIMEDOUT)) {
+        if(timeOut == CMN_TIME_FEVR) {
+            pthread_cond_wait(&pCmnSem->wait, &pCmnSem->lock);
+        } else {
+            retval = pthread_cond_timedwait(&pCmnSem->wait, &pCmnSem->lock, &ts);
+        }
+    }
+    if(pCmnSem->count == 0) {
+        pthread_mutex_unlock(&pCmnSem->lock);
+        return ERR_TIMEOUT;
+    }
+    pCmnSem->count--;
+    pthread_mutex_unlock(&pCmnSem->lock);
+
+    return SUCCESS;
+}
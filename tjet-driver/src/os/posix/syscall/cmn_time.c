@@ -0,0 +1,480 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cmn_time.c
+ *
+ *  @brief    This file defines the functions which handle timer object
+ *            and method. (POSIX user space)
+ *
+ *
+ *  @note     one timer thread runs all alarm handlers in turn, as the
+ *            timer softirq does in the kernel.
+ */
+/*=================================================================*/
+
+#include "oscmn.h"
+#include "cmn_cnf.h"
+#include "cmn_posix.h"
+
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @breif alarm/cyclic timer object (for POSIX)
+ */
+typedef struct tagS_CMN_TIM {
+    u8                id;
+    u8                active;    // started and not expired.
+    struct timespec   expires;
+    void             *pExtInfo;
+    void             *pAlmFunc;
+} S_CMN_TIM;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static S_CMN_TIM g_cmnTim[CMN_TIM_MAX_NUM] = {};
+
+static pthread_t       g_cmnTimThread;
+static u8              g_cmnTimThreadRun = FALSE;
+static pthread_cond_t  g_cmnTimWait;     // wake the timer thread.
+static pthread_cond_t  g_cmnTimDone;     // handler finished.
+static u8              g_cmnTimRunning   = 0; // ID of the running handler.
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+inline static int
+CMN_isTimeBefore(struct timespec *pA, struct timespec *pB)
+{
+    return ((pA->tv_sec < pB->tv_sec) ||
+            ((pA->tv_sec == pB->tv_sec) && (pA->tv_nsec < pB->tv_nsec)));
+}
+
+
+/*-------------------------------------------------------------------
+ * Prototypes Functions
+ *-----------------------------------------------------------------*/
+extern void CMN_initTimer(void);
+extern void CMN_exitTimer(void);
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_timerThread
+ *-----------------------------------------------------------------*/
+/**
+ * the timer thread, calls the handler of the expired alarm timer.
+ * @param     pArg : not used.
+ * @return    NULL.
+ * @note      the handler is called without lock.
+ */
+/*-----------------------------------------------------------------*/
+static void *
+CMN_timerThread(void *pArg)
+{
+
+    S_CMN_TIM       *pCmnTim;
+    S_CMN_TIM       *pNext;
+    struct timespec  now;
+    int              i;
+
+    pthread_mutex_lock(&mutex);
+    while(g_cmnTimThreadRun) {
+        // find the earliest timer.
+        pNext = NULL;
+        for(i=0; i<CMN_TIM_MAX_NUM; i++) {
+            pCmnTim = &(g_cmnTim[i]);
+            if((pCmnTim->id == 0) || (!pCmnTim->active)) {
+                continue;
+            }
+            if((pNext == NULL) || CMN_isTimeBefore(&pCmnTim->expires, &pNext->expires)) {
+                pNext = pCmnTim;
+            }
+        }
+
+        if(pNext == NULL) {
+            pthread_cond_wait(&g_cmnTimWait, &mutex);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(CMN_isTimeBefore(&now, &pNext->expires)) {
+            // timer may be started or stopped during waiting, look up again.
+            pthread_cond_timedwait(&g_cmnTimWait, &mutex, &pNext->expires);
+            continue;
+        }
+
+        // expired.
+        pNext->active   = FALSE;
+        g_cmnTimRunning = pNext->id;
+        pthread_mutex_unlock(&mutex);
+
+        ((void (*)(unsigned long))pNext->pAlmFunc)((unsigned long)pNext->pExtInfo);
+
+        pthread_mutex_lock(&mutex);
+        g_cmnTimRunning = 0;
+        pthread_cond_broadcast(&g_cmnTimDone);
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return NULL;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_initTimer
+ *-----------------------------------------------------------------*/
+/**
+ * This function initialize timer manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_initTimer()
+{
+
+    int i;
+
+    for(i=0; i<CMN_TIM_MAX_NUM; i++) {
+        g_cmnTim[i].id = 0; // 0 means unused.
+    }
+
+    CMN_initCond(&g_cmnTimWait);
+    CMN_initCond(&g_cmnTimDone);
+    g_cmnTimThreadRun = TRUE;
+    if(pthread_create(&g_cmnTimThread, NULL, CMN_timerThread, NULL) != 0) {
+        g_cmnTimThreadRun = FALSE;
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_exitTimer
+ *-----------------------------------------------------------------*/
+/**
+ * This function finalize timer manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_exitTimer()
+{
+
+    pthread_mutex_lock(&mutex);
+    if(!g_cmnTimThreadRun) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    g_cmnTimThreadRun = FALSE;
+    pthread_cond_signal(&g_cmnTimWait);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(g_cmnTimThread, NULL);
+    pthread_cond_destroy(&g_cmnTimWait);
+    pthread_cond_destroy(&g_cmnTimDone);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_createAlarmTim
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a alarm timer with the specified ID.
+ * @param     almID     : ID of the alarm timer
+ * @param     almAttr   : the attribute of the alarm timer
+ *                        (ignored in this version)
+ * @param     pExInfo   : the extended information to the alarm timer
+ * @param     pAlmFunc  : the pointer to the starting address
+ *                        when the alarm timer expires
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_BADPARM (the input parameter is invalid)
+ * @return    ERR_INVSTAT (the status of message box is already created)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_createAlarmTim(u8   almID,
+                   u32  almAttr,
+                   void *pExtInfo,
+                   void *pAlmFunc)
+{
+
+    S_CMN_TIM      *pCmnTim;
+
+    // check parameter
+    if (almID == 0 || almID > CMN_TIM_MAX_NUM) {
+        return ERR_INVID;
+    }
+    if (pAlmFunc == NULL) {
+        return ERR_BADPARM;
+    }
+
+    pCmnTim = &(g_cmnTim[almID-1]);
+
+    pthread_mutex_lock(&mutex);
+    if(pCmnTim->id != 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_INVSTAT;
+    }
+    pCmnTim->id       = almID;
+    pCmnTim->active   = FALSE;
+    pCmnTim->pExtInfo = pExtInfo;
+    pCmnTim->pAlmFunc = pAlmFunc;
+    // delay will be set later.
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_acreateAlarmTim
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a alarm timer with the specified ID.
+ * @param     almAttr   : the attribute of the alarm timer
+ *                        (ignored in this version)
+ * @param     pExInfo   : the extended information to the alarm timer
+ * @param     pAlmFunc  : the pointer to the starting address
+ *                        when the alarm timer expires
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_BADPARM (the input parameter is invalid)
+ * @return    ERR_NOID    (no more timer object is availbale)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_acreateAlarmTim(u32  almAttr,
+                    void *pExtInfo,
+                    void *pAlmFunc)
+{
+
+    S_CMN_TIM      *pCmnTim;
+    u8             almID;
+
+    if (pAlmFunc == NULL) {
+        return ERR_BADPARM;
+    }
+
+    pthread_mutex_lock(&mutex);
+    for(almID=1; almID<=CMN_TIM_MAX_NUM; almID++) {
+        pCmnTim = &(g_cmnTim[almID-1]);
+        if(pCmnTim->id == 0) {
+            pCmnTim->id       = almID;
+            pCmnTim->active   = FALSE;
+            pCmnTim->pExtInfo = pExtInfo;
+            pCmnTim->pAlmFunc = pAlmFunc;
+            // delay will be set later.
+            pthread_mutex_unlock(&mutex);
+            return almID;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return ERR_NOID;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_deleteAlarmTim
+ *-----------------------------------------------------------------*/
+/**
+ * This function deletes a alarm timer with the specified ID.
+ * If the alarm timer is working, it is deleted after stopping the timer.
+ * @param     almID  : ID of the alarm timer
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_deleteAlarmTim(u8 almID)
+{
+    S_CMN_TIM      *pCmnTim;
+
+    // check parameter
+    if (almID == 0 || almID > CMN_TIM_MAX_NUM) {
+        return ERR_INVID;
+    }
+    pCmnTim = &(g_cmnTim[almID-1]);
+
+    pthread_mutex_lock(&mutex);
+    if(pCmnTim->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+    pCmnTim->active = FALSE;
+    pCmnTim->id     = 0;
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_startAlarmTim
+ *-----------------------------------------------------------------*/
+/**
+ * This function starts the specified  alarm timer with the relative time
+ * in which the handler will start.
+ * @param     almID   : ID of the alarm timer
+ * @param     almTim  : the relative time in which the handler will start(ms)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_startAlarmTim(u8  almID,
+                  u16 almTim)
+{
+
+    S_CMN_TIM      *pCmnTim;
+
+    // check parameter
+    if (almID == 0 || almID > CMN_TIM_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTim = &(g_cmnTim[almID-1]);
+
+    pthread_mutex_lock(&mutex);
+    if(pCmnTim->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+
+    // set delay time.
+    CMN_getAbsTime(&pCmnTim->expires, almTim);
+    pCmnTim->active = TRUE;
+    pthread_cond_signal(&g_cmnTimWait);
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_stopAlarmTim
+ *-----------------------------------------------------------------*/
+/**
+ * This function stops the specified  alarm timer.
+ * @param     almID  : ID of the alarm timer
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object dosen't exist)
+ * @note      waits for the running handler like del_timer_sync().
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_stopAlarmTim(u8 almID)
+{
+
+    S_CMN_TIM      *pCmnTim;
+
+    // check parameter
+    if (almID == 0 || almID > CMN_TIM_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTim = &(g_cmnTim[almID-1]);
+
+    pthread_mutex_lock(&mutex);
+    if(pCmnTim->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+
+    // delete timer
+    pCmnTim->active = FALSE;
+    if(!pthread_equal(pthread_self(), g_cmnTimThread)) {
+        while(g_cmnTimRunning == almID) {
+            pthread_cond_wait(&g_cmnTimDone, &mutex);
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_getTime
+ *-----------------------------------------------------------------*/
+/**
+ * get system time(msecs from system wakeup)
+ * @param     pTime   : pointer to the System time stored.
+ * @return    SUCCESS     (normally completion)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_getTime(u32 *pTime)
+{
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    *pTime = (u32)((u64)ts.tv_sec * 1000 + ts.tv_nsec / CMN_NSEC_PER_MSEC);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_getTimeUs
+ *-----------------------------------------------------------------*/
+/**
+ * get monotonic system time in usecs.
+ * @param     pTime   : pointer to the System time stored.
+ * @return    SUCCESS     (normally completion)
+ * @note      wraps about every 71 minutes, use the difference only.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_getTimeUs(u32 *pTime)
+{
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    *pTime = (u32)((u64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+
+    return SUCCESS;
+}
@@ -0,0 +1,594 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cmn_tsk.c
+ *
+ *  @brief    This file defines the functions which handle task object
+ *            and method. (POSIX user space)
+ *
+ *
+ *  @note     the semantics follow the kthread based linux version,
+ *            CMN_terminateTask() works like kthread_stop().
+ */
+/*=================================================================*/
+
+#define _GNU_SOURCE        // pthread_setaffinity_np.
+
+#include "oscmn.h"
+#include "cmn_cnf.h"
+#include "cmn_err.h"
+#include "cmn_posix.h"
+
+#include <sched.h>         // cpu_set_t.
+#include <unistd.h>        // sysconf.
+#include <errno.h>
+
+
+/*------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @breif task object (for POSIX)
+ */
+typedef struct tagS_CMN_TSK {
+    u8 id;
+
+    pthread_t           thread;   // thread.
+    u8                  running;  // thread is created and not joined.
+    u8                  stop;     // terminateTask called.
+    void               *pTskFunc; // task function.
+    void               *pArg;     // task function argument.
+
+    u32                 cnt;      // count to implement slp_tsk/wup_tsk
+    pthread_mutex_t     lock;     // protects cnt and stop.
+    pthread_cond_t      wait;     // count to implement slp_tsk/wup_tsk
+} S_CMN_TSK;
+
+
+/*------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static S_CMN_TSK g_cmnTsk[CMN_TASK_MAX_NUM] = {};
+
+// task object of the calling thread, replaces "current" of kernel.
+static __thread S_CMN_TSK *g_pCmnTskSelf = NULL;
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+inline static void
+CMN_setupTask(S_CMN_TSK *pCmnTsk, u8 tskID, void *pTskFunc, void *pExtInfo)
+{
+
+    pCmnTsk->id       = tskID;
+    pCmnTsk->pTskFunc = pTskFunc;
+    pCmnTsk->pArg     = pExtInfo;
+    pCmnTsk->running  = FALSE;
+    pCmnTsk->stop     = FALSE;
+    pCmnTsk->cnt      = 0;
+    pthread_mutex_init(&pCmnTsk->lock, NULL);
+    CMN_initCond(&pCmnTsk->wait);
+
+    return;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Prototypes Functions
+ *-----------------------------------------------------------------*/
+extern void CMN_initTask(void);
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_taskEntry
+ *-----------------------------------------------------------------*/
+/**
+ * entry of the thread, calls the task function.
+ * @param     pArg : the pointer to the task object.
+ * @return    NULL.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+static void *
+CMN_taskEntry(void *pArg)
+{
+
+    S_CMN_TSK *pCmnTsk = (S_CMN_TSK *)pArg;
+
+    g_pCmnTskSelf = pCmnTsk;
+    ((void (*)(void *))pCmnTsk->pTskFunc)(pCmnTsk->pArg);
+
+    return NULL;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_initTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function initialize task manager.
+ * @param     nothing.
+ * @return    nothing.
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_initTask()
+{
+
+    int i;
+
+    for(i=0; i<CMN_TASK_MAX_NUM; i++) {
+        g_cmnTsk[i].id = 0; // 0 means unused.
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_createTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a task with the specified ID.
+ * @param     tskID     : ID of the task
+ * @param     tskAttr   : the attribute of the task
+ * @param     pExtInfo  : the extended information to the task
+ * @param     pTskFunc  : the pointer to the starting address of the task
+ * @param     tskPri    : the priority of the task
+ * @param     stkSize   : the stack size used in the task
+ *                        (ignored in this version)
+ * @param     pStkPtr   : the pointer to the stack used in the task
+ *                        (ignored in this version)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_INVSTAT (the internal status of the object is invalid)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_createTask(u8   tskID,
+               u32  tskAttr,
+               void *pExtInfo,
+               void *pTskFunc,
+               u8   tskPri,
+               u32  stkSize,
+               void *pStkPtr)
+{
+
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    pthread_mutex_lock(&mutex);
+    // setup common task struct.
+    if(pCmnTsk->id != 0) {
+        // already used.
+        pthread_mutex_unlock(&mutex);
+        return ERR_INVSTAT;
+    }
+    CMN_setupTask(pCmnTsk, tskID, pTskFunc, pExtInfo);
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_acreateTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function creates a task with the specified ID.
+ * @param     tskAttr   : the attribute of the task
+ * @param     pExtInfo  : the extended information to the task
+ * @param     pTskFunc  : the pointer to the starting address of the task
+ * @param     tskPri    : the priority of the task
+ * @param     stkSize   : the stack size used in the task
+ *                        (ignored in this version)
+ * @param     pStkPtr   : the pointer to the stack used in the task
+ *                        (ignored in this version)
+ * @return    assigned ID (normally completion)
+ * @return    ERR_NOID    (no ID)
+ * @note      nothing
+ */
+/*------------------------------------------------------------------*/
+T_CMN_ERR
+CMN_acreateTask(u32  tskAttr,
+                void *pExtInfo,
+                void *pTskFunc,
+                u8   tskPri,
+                u32  stkSize,
+                void *pStkPtr)
+{
+
+    S_CMN_TSK *pCmnTsk;
+    u8         tskID;
+
+    pthread_mutex_lock(&mutex);
+    for(tskID=1; tskID<=CMN_TASK_MAX_NUM; tskID++) {
+        pCmnTsk = &(g_cmnTsk[tskID-1]);
+        if(pCmnTsk->id == 0) {
+            // found.
+            CMN_setupTask(pCmnTsk, tskID, pTskFunc, pExtInfo);
+            pthread_mutex_unlock(&mutex);
+            return tskID;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return ERR_NOID; // no more empty task.
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_deleteTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function deletes a task with the specified ID.
+ * @param     tskID  : ID of the task
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_INVSTAT (the internal status of the object is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @note      nothing
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_deleteTask(u8 tskID)
+{
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+    pthread_mutex_lock(&mutex);
+    if(pCmnTsk->id == 0) {
+        pthread_mutex_unlock(&mutex);
+        return ERR_NOOBJ;
+    }
+    if(pCmnTsk->running) {
+        // not terminated yet.
+        pthread_mutex_unlock(&mutex);
+        return ERR_INVSTAT;
+    }
+    pCmnTsk->id = 0;
+    pthread_cond_destroy(&pCmnTsk->wait);
+    pthread_mutex_destroy(&pCmnTsk->lock);
+    pthread_mutex_unlock(&mutex);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_startTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function start the specified task.
+ * @param     tskID     : ID of the task
+ * @param     pInParam  : the pointer to the parameter on task starting
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object doesn't exist)
+ * @return    ERR_INVSTAT (internal error)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_startTask(u8   tskID,
+              void *pInParam)
+{
+
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    if(pCmnTsk->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    if(pInParam)
+        pCmnTsk->pArg = pInParam;
+
+    pCmnTsk->stop = FALSE;
+    if(pthread_create(&pCmnTsk->thread, NULL, CMN_taskEntry, pCmnTsk) != 0) {
+        return ERR_INVSTAT;
+    }
+    pCmnTsk->running = TRUE;
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_exitTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function ends the own task.
+ * @param     nothing
+ * @return    nothing
+ * @return    nothing
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+void
+CMN_exitTask(void)
+{
+    return; // do nothing
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_terminateTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function ends the specified task.
+ * @param     tskID  : ID of the task
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @note      waits for the task function to return.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_terminateTask(u8 tskID)
+{
+
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    if((pCmnTsk->id == 0) || (pCmnTsk->running == FALSE)) {
+        return ERR_NOOBJ;
+    }
+
+    pthread_mutex_lock(&pCmnTsk->lock);
+    pCmnTsk->stop = TRUE;
+    pthread_cond_broadcast(&pCmnTsk->wait);
+    pthread_mutex_unlock(&pCmnTsk->lock);
+
+    if(g_pCmnTskSelf == pCmnTsk) {
+        // terminated by itself, can not join.
+        pthread_detach(pCmnTsk->thread);
+    } else {
+        pthread_join(pCmnTsk->thread, NULL);
+    }
+    pCmnTsk->running = FALSE;
+
+    return SUCCESS;
+}
+
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_sleepTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function makes the own task wait for starting.
+ * @param     timeOut  : value of timeout // not supported.
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_RLWAIT  (force release during wait)
+ * @return    ERR_SYSTEM  (internal error)
+ * @note      only a thread started by CMN_startTask can sleep.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_sleepTask(u16 timeOut)
+{
+
+    S_CMN_TSK *pCmnTsk = g_pCmnTskSelf;
+    T_CMN_ERR  retval  = SUCCESS;
+
+    if(pCmnTsk == NULL) {
+        return ERR_SYSTEM;
+    }
+
+    // timeout not supported.
+    pthread_mutex_lock(&pCmnTsk->lock);
+    while((pCmnTsk->cnt == 0) && (!pCmnTsk->stop)) {
+        pthread_cond_wait(&pCmnTsk->wait, &pCmnTsk->lock);
+    }
+
+    if(pCmnTsk->stop) {
+        // terminateTask called.
+        retval = ERR_RLWAIT; // E_RLWAI
+    }
+    else {
+        // wakeupTask called.
+        // decrement wakeup count.
+        pCmnTsk->cnt--;
+    }
+    pthread_mutex_unlock(&pCmnTsk->lock);
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_wakeupTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function makes the specified task wake up.
+ * @param     tskID     : ID of the task
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_wakeupTask(u8 tskID)
+{
+    S_CMN_TSK *pCmnTsk;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    if(pCmnTsk->id == 0) {
+        return ERR_NOOBJ;
+    }
+
+    pthread_mutex_lock(&pCmnTsk->lock);
+    pCmnTsk->cnt++;
+    pthread_cond_signal(&pCmnTsk->wait);
+    pthread_mutex_unlock(&pCmnTsk->lock);
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_setTaskAffinity
+ *-----------------------------------------------------------------*/
+/**
+ * This function binds the specified task to a CPU.
+ * @param     tskID     : ID of the task
+ * @param     cpu       : CPU number, wrapped by the number of CPUs.
+ *                        negative value lets the task run on any CPU.
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_INVID   (the ID is invalid)
+ * @return    ERR_NOOBJ   (the object don't exist)
+ * @return    ERR_INVSTAT (the CPU is not allowed for this process)
+ * @note      call after CMN_startTask.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_setTaskAffinity(u8  tskID,
+                    int cpu)
+{
+    S_CMN_TSK *pCmnTsk;
+    cpu_set_t  set;
+    long       ncpu;
+
+    // check parameter
+    if (tskID == 0 || tskID > CMN_TASK_MAX_NUM) {
+        return ERR_INVID;
+    }
+
+    pCmnTsk = &(g_cmnTsk[tskID-1]);
+
+    if((pCmnTsk->id == 0) || (pCmnTsk->running == FALSE)) {
+        return ERR_NOOBJ;
+    }
+
+    ncpu = sysconf(_SC_NPROCESSORS_CONF);
+    if(ncpu <= 0) {
+        ncpu = 1;
+    }
+
+    CPU_ZERO(&set);
+    if(cpu < 0) {
+        for(cpu=0; (cpu<ncpu) && (cpu<CPU_SETSIZE); cpu++) {
+            CPU_SET(cpu, &set);
+        }
+    } else {
+        CPU_SET(cpu % ncpu, &set);
+    }
+
+    if(pthread_setaffinity_np(pCmnTsk->thread, sizeof(set), &set) != 0) {
+        return ERR_INVSTAT;
+    }
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_delayTask
+ *-----------------------------------------------------------------*/
+/**
+ * This function make the own task delayed.
+ * @param     dlyTime  : the value of time to make the task delayed (ms)
+ * @return    SUCCESS     (normally completion)
+ * @return    ERR_RLWAIT  (force release during wait)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_delayTask(u16 dlyTime)
+{
+
+    struct timespec ts;
+
+    ts.tv_sec  = dlyTime / 1000;
+    ts.tv_nsec = (long)(dlyTime % 1000) * CMN_NSEC_PER_MSEC;
+    if(nanosleep(&ts, NULL) != 0) {
+        return ERR_RLWAIT; // E_RLWAI
+    }
+
+    return SUCCESS;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function   : CMN_delayTaskUs
+ *-----------------------------------------------------------------*/
+/**
+ * This function make the own task delayed in usec order.
+ * @param     dlyTime  : the value of time to make the task delayed (us)
+ * @return    SUCCESS     (normally completion)
+ * @note      nothing.
+ */
+/*-----------------------------------------------------------------*/
+T_CMN_ERR
+CMN_delayTaskUs(u16 dlyTime)
+{
+
+    struct timespec ts;
+
+    ts.tv_sec  = 0;
+    ts.tv_nsec = (long)dlyTime * 1000;
+    while(nanosleep(&ts, &ts) != 0) {
+        if(errno != EINTR) {
+            break;
+        }
+    }
+
+    return SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     oscmn.c
+ *
+ *  @brief    This file defines the functions which initialize and finalize
+ *            common functions. (POSIX user space)
+ *
+ *
+ *  @note     the user of the library calls OSCMN_init() before any other
+ *            CMN_* function, instead of loading the module.
+ */
+/*=================================================================*/
+
+#include "oscmn.h"
+#include "cmn_cnf.h"
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+
+
+/*-------------------------------------------------------------------
+ * Prototypes Functions
+ *-----------------------------------------------------------------*/
+extern void CMN_initSem(void);
+extern void CMN_initCpuLock(void);
+extern void CMN_initFixedMemPool(void);
+extern void CMN_exitFixedMemPool(void);
+extern void CMN_initTask(void);
+extern void CMN_initTimer(void);
+extern void CMN_exitTimer(void);
+
+
+/*-------------------------------------------------------------------
+ * Function : OSCMN_init
+ *-----------------------------------------------------------------*/
+/**
+ * Initialize routine of common functions.
+ * @param   nothing.
+ * @return  0  (normally completion)
+ * @note   
+ */
+/*-----------------------------------------------------------------*/
+int
+OSCMN_init(void) 
+{
+    
+    CMN_initSem();
+    CMN_initCpuLock();
+    CMN_initFixedMemPool();
+    CMN_initTask();
+    CMN_initTimer();
+    return 0;
+
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : OSCMN_exit
+ *-----------------------------------------------------------------*/
+/**
+ * Finalize routine of common functions.
+ * @param   nothing.
+ * @return  nothing.
+ * @note    stops the timer thread, all timers shall be stopped before.
+ */
+/*-----------------------------------------------------------------*/
+void
+OSCMN_exit(void) 
+{
+    CMN_exitTimer();
+    CMN_exitFixedMemPool();
+    return;
+}
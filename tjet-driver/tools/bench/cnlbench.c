@@ -0,0 +1,1288 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     cnlbench.c
+ *
+ *  @brief    throughput and latency benchmark of the CnlFitCtrl I/F.
+ *
+ *  @note     the initiator and the responder set up the connection by
+ *            INIT, CONNECT/WAIT_CONNECT and ACCEPT/CONFIRM, then one side
+ *            streams SENDDATA and the other side RECVDATA.
+ *            the sending side releases the connection after the last
+ *            completion, and the receiving side waits for RELEASE_IND.
+ *
+ *            cnlbench      : drives CNLWRAP_DEVFILE, one role per process.
+ *                            with -F, the sending side sends the file by
+ *                            SENDFILE, and the receiving side compares
+ *                            the received data with the same file.
+ *            cnlbench_loop : links the user space CNL library and drives
+ *                            both ends of the loopback device, so results
+ *                            do not depend on radios.
+ */
+/*=================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+
+#include "cmn_type.h"
+#if defined(BENCH_LOOPBACK)
+#include "cmn_err.h"
+#include "oscmn.h"
+#include "cnl_type.h"
+#include "cnl_err.h"
+#endif /* BENCH_LOOPBACK */
+#include "cnlwrap_if.h"
+#if defined(BENCH_LOOPBACK)
+#include "cnlfit_upif.h"
+#include "cnlfit.h"
+#endif /* BENCH_LOOPBACK */
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+#define BENCH_ROLE_INITIATOR           0
+#define BENCH_ROLE_RESPONDER           1
+
+#define BENCH_DIR_TX                   0
+#define BENCH_DIR_RX                   1
+
+#define BENCH_DEF_SIZE                 65536
+#define BENCH_DEF_DEPTH                4
+#define BENCH_DEF_COUNT                10000
+#define BENCH_DEF_TIMEOUT              10     // sec
+
+#define BENCH_DEPTH_MAX                64
+
+// RECVDATA length should be 4B * n.
+#define BENCH_ALIGN4(x)                (((x) + 3) & ~3U)
+
+#define BENCH_NSEC_PER_SEC             1000000000ULL
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @brief benchmark configuration.
+ */
+typedef struct tagS_BENCH_CONF {
+    const char *pDevFile;
+    int         role;      // BENCH_ROLE_xxx (cnlbench only)
+    int         dir;       // direction of the initiator, BENCH_DIR_xxx.
+    u32         size;      // message size.
+    u32         depth;     // async requests in flight.
+    u32         count;     // measured messages.
+    u32         warmup;    // messages before measurement.
+    u8          profileId;
+    u8          sync;      // send by SyncRequest.
+    u8          inlineData;// send by SENDDATA_INLINE.
+    int         timeout;   // sec, for connection and each completion.
+    const char *pFile;     // SENDFILE and verification (cnlbench only)
+} S_BENCH_CONF;
+
+
+/**
+ * @brief one end of the connection.
+ */
+typedef struct tagS_BENCH_PORT {
+    const char      *pName;
+    int              role;
+    int              dir;     // BENCH_DIR_xxx of this end.
+    int              fd;      // cnlbench.
+    int              fileFd;  // -F, SENDFILE source.
+    u8              *pFileBuf;// -F, expected receive data.
+    u32              fileMsgs;// -F, messages in the file.
+#if defined(BENCH_LOOPBACK)
+    int              id;      // CNL device number.
+    void            *pMgr;
+    pthread_mutex_t  lock;
+    pthread_cond_t   wait;
+    u32              evSeq;   // count of event callback.
+#endif /* BENCH_LOOPBACK */
+
+    // data slots.
+    u32              depth;   // may be limited by the CNL queue depth.
+    u8              *pBuf;
+    u32              bufSize;
+    u64              submitNs[BENCH_DEPTH_MAX];
+    u32              slotSeq[BENCH_DEPTH_MAX];
+
+    // result.
+    u64             *pLatNs;
+    u32              latCnt;
+    u64              bytes;
+    u64              startNs;
+    u64              endNs;
+    int              error;
+} S_BENCH_PORT;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static S_BENCH_CONF g_conf = {
+    .pDevFile   = CNLWRAP_DEVFILE,
+    .role       = BENCH_ROLE_INITIATOR,
+    .dir        = BENCH_DIR_TX,
+    .size       = BENCH_DEF_SIZE,
+    .depth      = BENCH_DEF_DEPTH,
+    .count      = BENCH_DEF_COUNT,
+    .warmup     = 0,
+    .profileId  = PROFILE_ID_0,
+    .sync       = ASYNC_REQUEST,
+    .inlineData = 0,
+    .timeout    = BENCH_DEF_TIMEOUT,
+    .pFile      = NULL,
+};
+
+
+/*-------------------------------------------------------------------
+ * Prototypes
+ *-----------------------------------------------------------------*/
+#if defined(BENCH_LOOPBACK)
+extern void  CNLFIT_initMod(void);
+extern void  CNLFIT_cleanMod(void);
+extern int   CNL_init(void);
+extern void  CNL_exit(void);
+#endif /* BENCH_LOOPBACK */
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+static inline u64
+BENCH_nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u64)ts.tv_sec * BENCH_NSEC_PER_SEC) + ts.tv_nsec;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_openPort
+ *-----------------------------------------------------------------*/
+/**
+ * open the control device.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return 0 (normally completion), -errno (error)
+ * @note   cnlbench_loop opens CNL device pPort->id of the fitting layer.
+ */
+/*-----------------------------------------------------------------*/
+#if defined(BENCH_LOOPBACK)
+static void
+BENCH_eventCbk(void *pArg)
+{
+    S_BENCH_PORT *pPort = (S_BENCH_PORT *)pArg;
+
+    pthread_mutex_lock(&pPort->lock);
+    pPort->evSeq++;
+    pthread_cond_broadcast(&pPort->wait);
+    pthread_mutex_unlock(&pPort->lock);
+
+    return;
+}
+
+static int
+BENCH_openPort(S_BENCH_PORT *pPort)
+{
+    S_CNLIO_FIT_CBKS cbks;
+
+    pthread_mutex_init(&pPort->lock, NULL);
+    pthread_cond_init(&pPort->wait, NULL);
+
+    cbks.event.pioCbk = BENCH_eventCbk;
+    cbks.event.pioArg = pPort;
+    if(CNLFIT_open(CNLFIT_DEVTYPE_CTRL, pPort->id, &pPort->pMgr, &cbks) != SUCCESS) {
+        return -ENODEV;
+    }
+
+    return 0;
+}
+#else  /* BENCH_LOOPBACK */
+static int
+BENCH_openPort(S_BENCH_PORT *pPort)
+{
+    pPort->fd = open(g_conf.pDevFile, O_RDWR);
+    if(pPort->fd < 0) {
+        return -errno;
+    }
+
+    return 0;
+}
+#endif /* BENCH_LOOPBACK */
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_closePort
+ *-----------------------------------------------------------------*/
+/**
+ * close the control device.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void
+BENCH_closePort(S_BENCH_PORT *pPort)
+{
+#if defined(BENCH_LOOPBACK)
+    CNLFIT_close(CNLFIT_DEVTYPE_CTRL, pPort->id, pPort->pMgr);
+    pthread_cond_destroy(&pPort->wait);
+    pthread_mutex_destroy(&pPort->lock);
+#else  /* BENCH_LOOPBACK */
+    close(pPort->fd);
+#endif /* BENCH_LOOPBACK */
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_ctrl
+ *-----------------------------------------------------------------*/
+/**
+ * issue the ioctl command.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @param  cmd   : CNLWRAPIOC_xxx
+ * @param  pReq  : the pointer to the request parameter.
+ * @param  size  : the size of the request parameter.
+ * @return 0 (normally completion), -errno (error)
+ * @note   cnlbench_loop passes the request to CNLFIT_ctrl() in the
+ *         argument bucket, and waits for SENDDATA_INLINE by its own
+ *         completion as the ioctl handler does.
+ */
+/*-----------------------------------------------------------------*/
+#if defined(BENCH_LOOPBACK)
+/**
+ * @brief completion of SENDDATA_INLINE in cnlbench_loop.
+ */
+typedef struct tagS_BENCH_INLINE_WAIT {
+    S_IO_CONTAINER   ioCont;
+    pthread_mutex_t  lock;
+    pthread_cond_t   cond;
+    u8               done;
+    S_CNLWRAP_STATUS status;
+} S_BENCH_INLINE_WAIT;
+
+
+static void
+BENCH_inlineDone(void             *pArg,
+                 S_CNLWRAP_STATUS  status)
+{
+    S_BENCH_INLINE_WAIT *pWait = (S_BENCH_INLINE_WAIT *)pArg;
+
+    pthread_mutex_lock(&pWait->lock);
+    pWait->status = status;
+    pWait->done   = 1;
+    pthread_cond_signal(&pWait->cond);
+    pthread_mutex_unlock(&pWait->lock);
+
+    return;
+}
+
+
+static int
+BENCH_ctrl(S_BENCH_PORT *pPort,
+           uint          cmd,
+           void         *pReq,
+           size_t        size)
+{
+    S_CNLIO_ARG_BUCKET         arg;
+    S_CNLWRAP_REQ_INLINE_DATA *pInline;
+    S_BENCH_INLINE_WAIT        wait;
+    T_CMN_ERR                  retval;
+
+    memset(&arg, 0, sizeof(arg));
+
+    if(cmd == CNLWRAPIOC_SENDDATA_INLINE) {
+        pInline = (S_CNLWRAP_REQ_INLINE_DATA *)pReq;
+        if((pInline->length == 0) || (pInline->length > CNLWRAP_INLINE_DATA_MAX)) {
+            return -EINVAL;
+        }
+        arg.req.sendInline.data.profileId   = pInline->profileId;
+        arg.req.sendInline.data.fragmented  = pInline->fragmented;
+        arg.req.sendInline.data.length      = pInline->length;
+        arg.req.sendInline.data.userBufAddr = pInline->data;
+        arg.req.sendInline.data.sync        = ASYNC_REQUEST;
+        arg.req.sendInline.data.requestId   = pInline->requestId;
+        arg.req.sendInline.pIoCont          = &wait.ioCont;
+        arg.req.sendInline.done.pioDone     = BENCH_inlineDone;
+        arg.req.sendInline.done.pioArg      = &wait;
+
+        pthread_mutex_init(&wait.lock, NULL);
+        pthread_cond_init(&wait.cond, NULL);
+        wait.done = 0;
+        retval = CNLFIT_ctrl(CNLFIT_DEVTYPE_CTRL, pPort->pMgr, CNLWRAPIOC_SENDDATA_INLINE, &arg);
+        if(arg.req.sendInline.accepted) {
+            // loopback always completes, no cancel here.
+            pthread_mutex_lock(&wait.lock);
+            while(!wait.done) {
+                pthread_cond_wait(&wait.cond, &wait.lock);
+            }
+            pthread_mutex_unlock(&wait.lock);
+            pInline->status = wait.status;
+        } else {
+            pInline->status = arg.req.sendInline.data.status;
+        }
+        pthread_cond_destroy(&wait.cond);
+        pthread_mutex_destroy(&wait.lock);
+    } else {
+        memcpy(&arg.req, pReq, size);
+        retval = CNLFIT_ctrl(CNLFIT_DEVTYPE_CTRL, pPort->pMgr, cmd, &arg);
+        memcpy(pReq, &arg.req, size);
+    }
+
+    switch(retval) {
+    case SUCCESS :
+        return 0;
+    case ERR_NOMEM :
+        return -ENOMEM;
+    default :
+        return -EINVAL;
+    }
+}
+#else  /* BENCH_LOOPBACK */
+static int
+BENCH_ctrl(S_BENCH_PORT *pPort,
+           uint          cmd,
+           void         *pReq,
+           size_t        size)
+{
+    if(ioctl(pPort->fd, cmd, pReq) < 0) {
+        return -errno;
+    }
+
+    return 0;
+}
+#endif /* BENCH_LOOPBACK */
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_getEvent
+ *-----------------------------------------------------------------*/
+/**
+ * get one event, wait for it if no event is queued.
+ * @param  pPort   : the pointer to the S_BENCH_PORT.
+ * @param  pEvent  : the pointer to the event to return.
+ * @return 0 (normally completion), -ETIMEDOUT, -errno (error)
+ * @note   GETEVENT fails if no event is queued.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_getEvent(S_BENCH_PORT    *pPort,
+               S_CNLWRAP_EVENT *pEvent)
+{
+#if defined(BENCH_LOOPBACK)
+    struct timespec ts;
+    u32             seq;
+    int             retval = 0;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += g_conf.timeout;
+
+    for(;;) {
+        pthread_mutex_lock(&pPort->lock);
+        seq = pPort->evSeq;
+        pthread_mutex_unlock(&pPort->lock);
+
+        if(BENCH_ctrl(pPort, CNLWRAPIOC_GETEVENT, pEvent, sizeof(*pEvent)) == 0) {
+            return 0;
+        }
+
+        // wait for the callback after the check.
+        pthread_mutex_lock(&pPort->lock);
+        while((seq == pPort->evSeq) && (retval == 0)) {
+            retval = pthread_cond_timedwait(&pPort->wait, &pPort->lock, &ts);
+        }
+        pthread_mutex_unlock(&pPort->lock);
+        if(retval != 0) {
+            return -ETIMEDOUT;
+        }
+    }
+#else  /* BENCH_LOOPBACK */
+    struct pollfd pfd;
+    int           retval;
+
+    for(;;) {
+        if(BENCH_ctrl(pPort, CNLWRAPIOC_GETEVENT, pEvent, sizeof(*pEvent)) == 0) {
+            return 0;
+        }
+
+        pfd.fd      = pPort->fd;
+        pfd.events  = POLLIN;
+        pfd.revents = 0;
+        retval = poll(&pfd, 1, g_conf.timeout * 1000);
+        if(retval < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        if(retval == 0) {
+            return -ETIMEDOUT;
+        }
+        if(pfd.revents & POLLHUP) {
+            return -ENODEV;
+        }
+    }
+#endif /* BENCH_LOOPBACK */
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_waitEvent
+ *-----------------------------------------------------------------*/
+/**
+ * wait for the specified event.
+ * @param  pPort   : the pointer to the S_BENCH_PORT.
+ * @param  type    : CNLWRAP_EVENT_xxx
+ * @return 0 (normally completion), -errno (error)
+ * @note   the other events are reported and dropped.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_waitEvent(S_BENCH_PORT *pPort,
+                u8            type)
+{
+    S_CNLWRAP_EVENT event;
+    int             retval;
+
+    for(;;) {
+        retval = BENCH_getEvent(pPort, &event);
+        if(retval != 0) {
+            fprintf(stderr, "%s: wait event[%u] failed[%d].\n", pPort->pName, type, retval);
+            return retval;
+        }
+        if(event.type == type) {
+            return 0;
+        }
+        fprintf(stderr, "%s: unexpected event[%u] while waiting event[%u].\n",
+                pPort->pName, event.type, type);
+        if((event.type == CNLWRAP_EVENT_RELEASE_IND) ||
+           (event.type == CNLWRAP_EVENT_ERROR_IND)) {
+            return -ECONNRESET;
+        }
+    }
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_connect
+ *-----------------------------------------------------------------*/
+/**
+ * initialize CNL and set up the connection.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return 0 (normally completion), -errno (error)
+ * @note   initiator : CONNECT, ACCEPT_IND, CONFIRM
+ *         responder : WAIT_CONNECT, CONNECT_IND, ACCEPT, ACCEPT_CNF
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_connect(S_BENCH_PORT *pPort)
+{
+    S_CNLWRAP_REQ_INIT    init;
+    S_CNLWRAP_REQ_CONNECT connect;
+    S_CNLWRAP_REQ_ACCEPT  accept;
+    S_CNLWRAP_STATUS      status;
+    int                   retval;
+
+    memset(&init, 0, sizeof(init)); // ownUID is given by the device.
+    retval = BENCH_ctrl(pPort, CNLWRAPIOC_INIT, &init, sizeof(init));
+    if((retval != 0) || (init.status != CNLWRAP_REQ_SUCCESS)) {
+        fprintf(stderr, "%s: INIT failed[%d/%d].\n", pPort->pName, retval, init.status);
+        return (retval != 0) ? retval : -EIO;
+    }
+
+    if(pPort->role == BENCH_ROLE_INITIATOR) {
+        memset(&connect, 0, sizeof(connect));
+        connect.targetSpecified = TARGET_UNSPECIFIED;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_CONNECT, &connect, sizeof(connect));
+        if((retval != 0) || (connect.status != CNLWRAP_REQ_SUCCESS)) {
+            fprintf(stderr, "%s: CONNECT failed[%d/%d].\n", pPort->pName, retval, connect.status);
+            return (retval != 0) ? retval : -EIO;
+        }
+        retval = BENCH_waitEvent(pPort, CNLWRAP_EVENT_ACCEPT_IND);
+        if(retval != 0) {
+            return retval;
+        }
+        status = 0;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_CONFIRM, &status, sizeof(status));
+        if((retval != 0) || (status != CNLWRAP_REQ_SUCCESS)) {
+            fprintf(stderr, "%s: CONFIRM failed[%d/%d].\n", pPort->pName, retval, status);
+            return (retval != 0) ? retval : -EIO;
+        }
+    } else {
+        status = 0;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_WAIT_CONNECT, &status, sizeof(status));
+        if((retval != 0) || (status != CNLWRAP_REQ_SUCCESS)) {
+            fprintf(stderr, "%s: WAIT_CONNECT failed[%d/%d].\n", pPort->pName, retval, status);
+            return (retval != 0) ? retval : -EIO;
+        }
+        retval = BENCH_waitEvent(pPort, CNLWRAP_EVENT_CONNECT_IND);
+        if(retval != 0) {
+            return retval;
+        }
+        memset(&accept, 0, sizeof(accept));
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_ACCEPT, &accept, sizeof(accept));
+        if((retval != 0) || (accept.status != CNLWRAP_REQ_SUCCESS)) {
+            fprintf(stderr, "%s: ACCEPT failed[%d/%d].\n", pPort->pName, retval, accept.status);
+            return (retval != 0) ? retval : -EIO;
+        }
+        retval = BENCH_waitEvent(pPort, CNLWRAP_EVENT_ACCEPT_CNF);
+        if(retval != 0) {
+            return retval;
+        }
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_disconnect
+ *-----------------------------------------------------------------*/
+/**
+ * release the connection and close CNL.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return nothing.
+ * @note   the sending side releases after the last completion,
+ *         the receiving side can lose the last completions by the
+ *         release of the peer if it releases first.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BENCH_disconnect(S_BENCH_PORT *pPort)
+{
+    S_CNLWRAP_REQ_RELEASE release;
+    S_CNLWRAP_STATUS      status;
+
+    if(pPort->error == 0) {
+        if(pPort->dir == BENCH_DIR_TX) {
+            memset(&release, 0, sizeof(release));
+            BENCH_ctrl(pPort, CNLWRAPIOC_RELEASE, &release, sizeof(release));
+        } else {
+            BENCH_waitEvent(pPort, CNLWRAP_EVENT_RELEASE_IND);
+        }
+    }
+
+    status = 0;
+    BENCH_ctrl(pPort, CNLWRAPIOC_CLOSE, &status, sizeof(status));
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_submit
+ *-----------------------------------------------------------------*/
+/**
+ * submit one async data request on the slot.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @param  slot  : the slot index.
+ * @param  seq   : the sequence number of the message.
+ * @return 0 (normally completion), -EAGAIN (CNL queue is full),
+ *         -errno (error)
+ * @note   requestId is unique while in flight, and gives the slot.
+ *         with -F, message seq is sent from the file by SENDFILE.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_submit(S_BENCH_PORT *pPort,
+             u32           slot,
+             u32           seq)
+{
+    S_CNLWRAP_REQ_DATA     data;
+    S_CNLWRAP_REQ_SENDFILE sendfile;
+    int                    retval;
+
+    memset(&data, 0, sizeof(data));
+    data.profileId   = g_conf.profileId;
+    data.fragmented  = NOT_FRAGMENTED;
+    data.userBufAddr = pPort->pBuf + (slot * pPort->bufSize);
+    data.sync        = ASYNC_REQUEST;
+    data.requestId   = ((ulong)pPort->slotSeq[slot]++ * g_conf.depth) + slot + 1;
+
+    pPort->submitNs[slot] = BENCH_nowNs();
+    if((pPort->dir == BENCH_DIR_TX) && (pPort->fileFd >= 0)) {
+        memset(&sendfile, 0, sizeof(sendfile));
+        sendfile.profileId  = data.profileId;
+        sendfile.fragmented = data.fragmented;
+        sendfile.fd         = pPort->fileFd;
+        sendfile.offset     = (u64)(seq % pPort->fileMsgs) * g_conf.size;
+        sendfile.length     = g_conf.size;
+        sendfile.requestId  = data.requestId;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_SENDFILE, &sendfile, sizeof(sendfile));
+        data.status = sendfile.status;
+    } else if(pPort->dir == BENCH_DIR_TX) {
+        data.length = g_conf.size;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_SENDDATA, &data, sizeof(data));
+    } else {
+        data.length = pPort->bufSize;
+        retval = BENCH_ctrl(pPort, CNLWRAPIOC_RECVDATA, &data, sizeof(data));
+    }
+
+    if(data.status == CNLWRAP_REQ_CNL_ERR_QOVR) {
+        pPort->slotSeq[slot]--;
+        return -EAGAIN;
+    }
+    if((retval != 0) ||
+       ((data.status != CNLWRAP_REQ_SUCCESS) && (data.status != CNLWRAP_REQ_PENDING))) {
+        fprintf(stderr, "%s: data request failed[%d/%d].\n", pPort->pName, retval, data.status);
+        return (retval != 0) ? retval : -EIO;
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_record
+ *-----------------------------------------------------------------*/
+/**
+ * record one completed message.
+ * @param  pPort  : the pointer to the S_BENCH_PORT.
+ * @param  seq    : the sequence number of the message.
+ * @param  latNs  : latency of the message.
+ * @param  length : length of the message.
+ * @return nothing.
+ * @note   the warmup messages are not recorded, the measurement
+ *         starts at the completion of the last warmup message.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BENCH_record(S_BENCH_PORT *pPort,
+             u32           seq,
+             u64           latNs,
+             u32           length)
+{
+    u64 now = BENCH_nowNs();
+
+    if(seq < g_conf.warmup) {
+        pPort->startNs = now;
+        return;
+    }
+
+    pPort->pLatNs[pPort->latCnt++] = latNs;
+    pPort->bytes                  += length;
+    pPort->endNs                   = now;
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_runSync
+ *-----------------------------------------------------------------*/
+/**
+ * send the messages by SyncRequest.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return 0 (normally completion), -errno (error)
+ * @note   latency is the time of the ioctl.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_runSync(S_BENCH_PORT *pPort)
+{
+    S_CNLWRAP_REQ_INLINE_DATA *pInline = NULL;
+    S_CNLWRAP_REQ_DATA         data;
+    S_CNLWRAP_STATUS          *pStatus;
+    u32                        total = g_conf.warmup + g_conf.count;
+    u32                        seq;
+    u64                        start;
+    int                        retval;
+
+    if(g_conf.inlineData) {
+        pInline = calloc(1, sizeof(*pInline));
+        if(pInline == NULL) {
+            return -ENOMEM;
+        }
+        pInline->profileId  = g_conf.profileId;
+        pInline->fragmented = NOT_FRAGMENTED;
+        pInline->length     = g_conf.size;
+        memcpy(pInline->data, pPort->pBuf, g_conf.size);
+        pStatus = &pInline->status;
+    } else {
+        pStatus = &data.status;
+    }
+
+    retval = 0;
+    for(seq=0; seq<total; seq++) {
+        start = BENCH_nowNs();
+        if(pInline != NULL) {
+            pInline->status    = 0;
+            pInline->requestId = seq + 1;
+            retval = BENCH_ctrl(pPort, CNLWRAPIOC_SENDDATA_INLINE, pInline, sizeof(*pInline));
+        } else {
+            memset(&data, 0, sizeof(data));
+            data.profileId   = g_conf.profileId;
+            data.fragmented  = NOT_FRAGMENTED;
+            data.length      = g_conf.size;
+            data.userBufAddr = pPort->pBuf;
+            data.sync        = SYNC_REQUEST;
+            data.requestId   = seq + 1;
+            retval = BENCH_ctrl(pPort, CNLWRAPIOC_SENDDATA, &data, sizeof(data));
+        }
+        if((retval != 0) || (*pStatus != CNLWRAP_REQ_SUCCESS)) {
+            fprintf(stderr, "%s: sync send failed[%d/%d].\n", pPort->pName, retval, *pStatus);
+            retval = (retval != 0) ? retval : -EIO;
+            break;
+        }
+        BENCH_record(pPort, seq, BENCH_nowNs() - start, g_conf.size);
+    }
+
+    free(pInline);
+
+    return retval;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_runAsync
+ *-----------------------------------------------------------------*/
+/**
+ * stream the messages keeping depth requests in flight.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return 0 (normally completion), -errno (error)
+ * @note   latency is from the submission to DATA_REQ_COMP.
+ *         a slot refused by the full CNL request queue is retried
+ *         at the next completion, pPort->depth is the depth reached.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_runAsync(S_BENCH_PORT *pPort)
+{
+    S_CNLWRAP_EVENT event;
+    u32             freeSlot[BENCH_DEPTH_MAX];
+    u32             freeCnt;
+    u32             total  = g_conf.warmup + g_conf.count;
+    u32             issued = 0;
+    u32             done   = 0;
+    u32             slot;
+    u64             latNs;
+    int             retval;
+
+    for(freeCnt=0; freeCnt<g_conf.depth; freeCnt++) {
+        freeSlot[freeCnt] = g_conf.depth - freeCnt - 1;
+    }
+    pPort->depth = 0;
+
+    for(;;) {
+        //
+        // submit free slots while the queue accepts.
+        //
+        while((freeCnt > 0) && (issued < total)) {
+            retval = BENCH_submit(pPort, freeSlot[freeCnt - 1], issued);
+            if(retval == -EAGAIN) {
+                if(issued == done) {
+                    // nothing in flight to wait for.
+                    fprintf(stderr, "%s: CNL request queue is full.\n", pPort->pName);
+                    return retval;
+                }
+                break;
+            }
+            if(retval != 0) {
+                return retval;
+            }
+            freeCnt--;
+            issued++;
+            if(pPort->depth < issued - done) {
+                pPort->depth = issued - done;
+            }
+        }
+
+        if(done == total) {
+            break;
+        }
+
+        retval = BENCH_getEvent(pPort, &event);
+        if(retval != 0) {
+            fprintf(stderr, "%s: %u/%u messages completed, get event failed[%d].\n",
+                    pPort->pName, done, total, retval);
+            return retval;
+        }
+
+        if(event.type != CNLWRAP_EVENT_DATA_REQ_COMP) {
+            fprintf(stderr, "%s: unexpected event[%u] while streaming.\n",
+                    pPort->pName, event.type);
+            if((event.type == CNLWRAP_EVENT_RELEASE_IND) ||
+               (event.type == CNLWRAP_EVENT_ERROR_IND)) {
+                return -ECONNRESET;
+            }
+            continue;
+        }
+
+        if(event.dataReqComp.status != CNLWRAP_REQ_SUCCESS) {
+            fprintf(stderr, "%s: data request completed with error[%d].\n",
+                    pPort->pName, event.dataReqComp.status);
+            return -EIO;
+        }
+
+        slot  = (u32)((event.dataReqComp.requestId - 1) % g_conf.depth);
+        latNs = BENCH_nowNs() - pPort->submitNs[slot];
+
+        // messages are received in the order of sending.
+        if((pPort->dir == BENCH_DIR_RX) && (pPort->pFileBuf != NULL) &&
+           ((event.dataReqComp.length != g_conf.size) ||
+            (memcmp(pPort->pBuf + (slot * pPort->bufSize),
+                    pPort->pFileBuf + ((size_t)(done % pPort->fileMsgs) * g_conf.size),
+                    g_conf.size) != 0))) {
+            fprintf(stderr, "%s: message %u differs from the file.\n",
+                    pPort->pName, done);
+            return -EBADMSG;
+        }
+        BENCH_record(pPort, done, latNs, event.dataReqComp.length);
+        done++;
+
+        freeSlot[freeCnt++] = slot;
+    }
+
+    if((pPort->depth < g_conf.depth) && (pPort->depth < total)) {
+        fprintf(stderr, "%s: depth is limited to %u by CNL request queue.\n",
+                pPort->pName, pPort->depth);
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_openFile
+ *-----------------------------------------------------------------*/
+/**
+ * open the file of -F.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return 0 (normally completion), -errno (error)
+ * @note   the file is used by message size, the tail shorter than
+ *         the size is not used.
+ *         the sending side passes the fd to SENDFILE, the receiving
+ *         side reads the file to compare the received data.
+ */
+/*-----------------------------------------------------------------*/
+static int
+BENCH_openFile(S_BENCH_PORT *pPort)
+{
+    struct stat st;
+    size_t      len;
+    ssize_t     done;
+    ssize_t     ret;
+
+    pPort->fileFd = open(g_conf.pFile, O_RDONLY);
+    if(pPort->fileFd < 0) {
+        return -errno;
+    }
+    if(fstat(pPort->fileFd, &st) != 0) {
+        return -errno;
+    }
+
+    pPort->fileMsgs = (u32)(st.st_size / g_conf.size);
+    if(pPort->fileMsgs == 0) {
+        fprintf(stderr, "%s: %s is shorter than the message size.\n",
+                pPort->pName, g_conf.pFile);
+        return -EINVAL;
+    }
+    if(pPort->dir == BENCH_DIR_TX) {
+        return 0;
+    }
+
+    len = (size_t)pPort->fileMsgs * g_conf.size;
+    pPort->pFileBuf = malloc(len);
+    if(pPort->pFileBuf == NULL) {
+        return -ENOMEM;
+    }
+    for(done=0; done<(ssize_t)len; done+=ret) {
+        ret = pread(pPort->fileFd, pPort->pFileBuf + done, len - done, done);
+        if(ret <= 0) {
+            return (ret < 0) ? -errno : -EIO;
+        }
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_run
+ *-----------------------------------------------------------------*/
+/**
+ * run the benchmark on one end.
+ * @param  pArg : the pointer to the S_BENCH_PORT.
+ * @return NULL
+ * @note   the result is set to pPort.
+ */
+/*-----------------------------------------------------------------*/
+static void *
+BENCH_run(void *pArg)
+{
+    S_BENCH_PORT *pPort = (S_BENCH_PORT *)pArg;
+    u32           slots;
+    u32           i;
+
+    pPort->fileFd  = -1;
+    pPort->depth   = (g_conf.sync && (pPort->dir == BENCH_DIR_TX)) ? 1 : g_conf.depth;
+    pPort->bufSize = BENCH_ALIGN4(g_conf.size);
+    slots          = (g_conf.sync && (pPort->dir == BENCH_DIR_TX)) ? 1 : g_conf.depth;
+    pPort->pBuf    = malloc((size_t)pPort->bufSize * slots);
+    pPort->pLatNs  = malloc(sizeof(u64) * g_conf.count);
+    if((pPort->pBuf == NULL) || (pPort->pLatNs == NULL)) {
+        pPort->error = -ENOMEM;
+        return NULL;
+    }
+    for(i=0; i<pPort->bufSize * slots; i++) {
+        pPort->pBuf[i] = (u8)i;
+    }
+
+    if(g_conf.pFile != NULL) {
+        pPort->error = BENCH_openFile(pPort);
+        if(pPort->error != 0) {
+            fprintf(stderr, "%s: open %s failed[%d].\n",
+                    pPort->pName, g_conf.pFile, pPort->error);
+            return NULL;
+        }
+    }
+
+    pPort->error = BENCH_openPort(pPort);
+    if(pPort->error != 0) {
+        fprintf(stderr, "%s: open failed[%d].\n", pPort->pName, pPort->error);
+        return NULL;
+    }
+
+    pPort->error = BENCH_connect(pPort);
+    if(pPort->error == 0) {
+        pPort->startNs = BENCH_nowNs();
+        pPort->endNs   = pPort->startNs;
+        if(g_conf.sync && (pPort->dir == BENCH_DIR_TX)) {
+            pPort->error = BENCH_runSync(pPort);
+        } else {
+            pPort->error = BENCH_runAsync(pPort);
+        }
+    }
+
+    BENCH_disconnect(pPort);
+    BENCH_closePort(pPort);
+
+    return NULL;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_compareU64
+ *-----------------------------------------------------------------*/
+static int
+BENCH_compareU64(const void *pA,
+                 const void *pB)
+{
+    u64 a = *(const u64 *)pA;
+    u64 b = *(const u64 *)pB;
+
+    return (a > b) - (a < b);
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_percentile
+ *-----------------------------------------------------------------*/
+/**
+ * get the percentile of the sorted latency.
+ * @param  pLat  : the sorted latency.
+ * @param  cnt   : the number of pLat.
+ * @param  per   : per mille.
+ * @return latency in usec.
+ * @note   nearest rank.
+ */
+/*-----------------------------------------------------------------*/
+static double
+BENCH_percentile(const u64 *pLat,
+                 u32        cnt,
+                 u32        per)
+{
+    u64 rank;
+
+    rank = (((u64)cnt * per) + 999) / 1000;
+    if(rank == 0) {
+        rank = 1;
+    }
+
+    return pLat[rank - 1] / 1000.0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_report
+ *-----------------------------------------------------------------*/
+/**
+ * print the result of one end.
+ * @param  pPort : the pointer to the S_BENCH_PORT.
+ * @return nothing.
+ * @note   MB is 10^6 byte.
+ */
+/*-----------------------------------------------------------------*/
+static void
+BENCH_report(S_BENCH_PORT *pPort)
+{
+    double sec;
+
+    printf("%s: %s %s size=%u depth=%u count=%u warmup=%u profile=%u mode=%s\n",
+           pPort->pName,
+           (pPort->role == BENCH_ROLE_INITIATOR) ? "initiator" : "responder",
+           (pPort->dir == BENCH_DIR_TX) ? "tx" : "rx",
+           g_conf.size, pPort->depth, g_conf.count, g_conf.warmup, g_conf.profileId,
+           (pPort->dir == BENCH_DIR_RX) ? "async" :
+           g_conf.pFile ? "async-sendfile" :
+           g_conf.inlineData ? "sync-inline" : g_conf.sync ? "sync" : "async");
+
+    if(pPort->error != 0) {
+        printf("  failed[%d] after %u messages\n", pPort->error, pPort->latCnt);
+    }
+    if(pPort->latCnt == 0) {
+        return;
+    }
+
+    qsort(pPort->pLatNs, pPort->latCnt, sizeof(u64), BENCH_compareU64);
+
+    sec = (pPort->endNs - pPort->startNs) / (double)BENCH_NSEC_PER_SEC;
+    if(sec <= 0) {
+        sec = 1e-9;
+    }
+
+    printf("  messages    : %u\n", pPort->latCnt);
+    printf("  bytes       : %llu\n", (unsigned long long)pPort->bytes);
+    printf("  elapsed     : %.3f s\n", sec);
+    printf("  throughput  : %.2f MB/s, %.1f ops/s\n",
+           pPort->bytes / sec / 1e6, pPort->latCnt / sec);
+    printf("  latency(us) : p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n",
+           BENCH_percentile(pPort->pLatNs, pPort->latCnt, 500),
+           BENCH_percentile(pPort->pLatNs, pPort->latCnt, 990),
+           BENCH_percentile(pPort->pLatNs, pPort->latCnt, 999),
+           pPort->pLatNs[pPort->latCnt - 1] / 1000.0);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_usage
+ *-----------------------------------------------------------------*/
+static void
+BENCH_usage(const char *pProg)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+#if !defined(BENCH_LOOPBACK)
+            "  -r init|resp  role (default init)\n"
+            "  -D file       device file (default %s)\n"
+#endif /* !BENCH_LOOPBACK */
+            "  -d tx|rx      data direction of the initiator (default tx),\n"
+            "                the responder takes the other direction\n"
+            "  -s size       message size in byte (default %u)\n"
+            "  -q depth      async requests in flight, 1-%u (default %u),\n"
+            "                limited by the CNL request queue, and blocks\n"
+            "                above IocontMplCnt of toscnlfit\n"
+            "  -n count      measured messages (default %u)\n"
+            "  -w count      warmup messages (default 0)\n"
+            "  -p pid        profile id, 0 or 1 (default 0)\n"
+            "  -S            send by SyncRequest\n"
+            "  -I            send by SENDDATA_INLINE, size <= %u\n"
+            "  -t sec        timeout of connection and completion (default %u)\n"
+#if !defined(BENCH_LOOPBACK)
+            "  -F file       send the file by SENDFILE, or compare the received\n"
+            "                data with the file, by message size from offset 0\n"
+#endif /* !BENCH_LOOPBACK */
+            ,
+            pProg,
+#if !defined(BENCH_LOOPBACK)
+            CNLWRAP_DEVFILE,
+#endif /* !BENCH_LOOPBACK */
+            BENCH_DEF_SIZE, BENCH_DEPTH_MAX, BENCH_DEF_DEPTH, BENCH_DEF_COUNT,
+            CNLWRAP_INLINE_DATA_MAX, BENCH_DEF_TIMEOUT);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : BENCH_parseArgs
+ *-----------------------------------------------------------------*/
+static int
+BENCH_parseArgs(int    argc,
+                char **argv)
+{
+    int opt;
+
+    while((opt = getopt(argc, argv, "r:D:d:s:q:n:w:p:SIt:F:h")) != -1) {
+        switch(opt) {
+        case 'r' :
+            if(strcmp(optarg, "init") == 0) {
+                g_conf.role = BENCH_ROLE_INITIATOR;
+            } else if(strcmp(optarg, "resp") == 0) {
+                g_conf.role = BENCH_ROLE_RESPONDER;
+            } else {
+                return -1;
+            }
+            break;
+        case 'D' :
+            g_conf.pDevFile = optarg;
+            break;
+        case 'd' :
+            if(strcmp(optarg, "tx") == 0) {
+                g_conf.dir = BENCH_DIR_TX;
+            } else if(strcmp(optarg, "rx") == 0) {
+                g_conf.dir = BENCH_DIR_RX;
+            } else {
+                return -1;
+            }
+            break;
+        case 's' :
+            g_conf.size = strtoul(optarg, NULL, 0);
+            break;
+        case 'q' :
+            g_conf.depth = strtoul(optarg, NULL, 0);
+            break;
+        case 'n' :
+            g_conf.count = strtoul(optarg, NULL, 0);
+            break;
+        case 'w' :
+            g_conf.warmup = strtoul(optarg, NULL, 0);
+            break;
+        case 'p' :
+            g_conf.profileId = (u8)strtoul(optarg, NULL, 0);
+            break;
+        case 'S' :
+            g_conf.sync = SYNC_REQUEST;
+            break;
+        case 'I' :
+            g_conf.sync       = SYNC_REQUEST;
+            g_conf.inlineData = 1;
+            break;
+        case 't' :
+            g_conf.timeout = atoi(optarg);
+            break;
+#if !defined(BENCH_LOOPBACK)
+        case 'F' :
+            g_conf.pFile = optarg;
+            break;
+#endif /* !BENCH_LOOPBACK */
+        default :
+            return -1;
+        }
+    }
+
+    if((g_conf.size == 0) ||
+       (g_conf.depth == 0) || (g_conf.depth > BENCH_DEPTH_MAX) ||
+       (g_conf.count == 0) ||
+       (g_conf.profileId > PROFILE_ID_1) ||
+       (g_conf.timeout <= 0) ||
+       (g_conf.inlineData && (g_conf.size > CNLWRAP_INLINE_DATA_MAX)) ||
+       (g_conf.sync && (g_conf.pFile != NULL))) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : main
+ *-----------------------------------------------------------------*/
+int
+main(int    argc,
+     char **argv)
+{
+#if defined(BENCH_LOOPBACK)
+    S_BENCH_PORT port[2];
+    pthread_t    thread[2];
+    int          i;
+#else  /* BENCH_LOOPBACK */
+    S_BENCH_PORT port[1];
+#endif /* BENCH_LOOPBACK */
+    int          retval = 0;
+
+    if(BENCH_parseArgs(argc, argv) != 0) {
+        BENCH_usage(argv[0]);
+        return 2;
+    }
+
+    memset(port, 0, sizeof(port));
+
+#if defined(BENCH_LOOPBACK)
+    //
+    // both ends of the loopback device in one process.
+    // CNL device 0 is the initiator and 1 is the responder.
+    //
+    if(OSCMN_init() != 0) {
+        fprintf(stderr, "OSCMN_init failed.\n");
+        return 1;
+    }
+    CNLFIT_initMod();
+    if(CNL_init() != 0) {
+        fprintf(stderr, "CNL_init failed.\n");
+        CNLFIT_cleanMod();
+        OSCMN_exit();
+        return 1;
+    }
+
+    for(i=0; i<2; i++) {
+        port[i].pName = (i == 0) ? "loop0" : "loop1";
+        port[i].id    = i;
+        port[i].role  = (i == 0) ? BENCH_ROLE_INITIATOR : BENCH_ROLE_RESPONDER;
+        port[i].dir   = (i == 0) ? g_conf.dir : !g_conf.dir;
+        pthread_create(&thread[i], NULL, BENCH_run, &port[i]);
+    }
+    for(i=0; i<2; i++) {
+        pthread_join(thread[i], NULL);
+    }
+
+    CNL_exit();
+    CNLFIT_cleanMod();
+    OSCMN_exit();
+
+    for(i=0; i<2; i++) {
+        BENCH_report(&port[i]);
+        retval |= (port[i].error != 0);
+        free(port[i].pBuf);
+        free(port[i].pLatNs);
+    }
+#else  /* BENCH_LOOPBACK */
+    port[0].pName = CNLWRAP_DEVICENAME;
+    port[0].role  = g_conf.role;
+    port[0].dir   = (g_conf.role == BENCH_ROLE_INITIATOR) ? g_conf.dir : !g_conf.dir;
+    BENCH_run(&port[0]);
+
+    BENCH_report(&port[0]);
+    retval = (port[0].error != 0);
+    free(port[0].pBuf);
+    free(port[0].pLatNs);
+    free(port[0].pFileBuf);
+    if(port[0].fileFd >= 0) {
+        close(port[0].fileFd);
+    }
+#endif /* BENCH_LOOPBACK */
+
+    return retval;
+}
@@ -0,0 +1,261 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     mplbench_km.c
+ *
+ *  @brief    microbenchmark of the fixed memory pool of tososcmn.
+ *
+ *  @note     the same measurement as tools/bench/mplbench, but on the
+ *            kernel pool (readyQ llist, per-CPU magazines and the range
+ *            check of the release). it runs when the module is inserted,
+ *            prints the result to the kernel log and stays loaded until
+ *            rmmod.
+ *
+ *            insmod mplbench_km.ko Count=1000000 Size=2048 Depth=8 Threads=4
+ */
+/*=================================================================*/
+
+#include "cmn_type.h"
+#include "cmn_err.h"
+#include "oscmn.h"
+
+#include <linux/module.h>     // module API.
+#include <linux/kthread.h>    // kthread API.
+#include <linux/completion.h> // completion API.
+#include <linux/slab.h>       // kzalloc/kfree.
+#include <linux/ktime.h>      // ktime API.
+#include <linux/math64.h>     // div_u64.
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @brief module version informations
+ */
+#define DRIVER_VERSION "1.0.1";
+#define DRIVER_DESC "CNL fixed memory pool benchmark";
+
+#define MPLB_DEF_COUNT                 1000000
+#define MPLB_DEF_SIZE                  2048
+#define MPLB_DEF_DEPTH                 8
+#define MPLB_DEF_THREADS               1
+
+#define MPLB_DEPTH_MAX                 1024
+#define MPLB_THREADS_MAX               64
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @brief one thread.
+ */
+typedef struct tagS_MPLB_THREAD {
+    struct task_struct *pTsk;
+    struct completion   done;
+    void               *pInFlight[MPLB_DEPTH_MAX];
+    u64                 ns;
+    int                 error;
+} S_MPLB_THREAD;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * get/release pairs per thread, block size, blocks in flight per thread
+ * and the number of threads. thread n runs on CPU (n % online CPUs).
+ */
+static uint g_mplbCount   = MPLB_DEF_COUNT;
+static uint g_mplbSize    = MPLB_DEF_SIZE;
+static uint g_mplbDepth   = MPLB_DEF_DEPTH;
+static uint g_mplbThreads = MPLB_DEF_THREADS;
+module_param_named(Count,   g_mplbCount,   uint, S_IRUGO);
+module_param_named(Size,    g_mplbSize,    uint, S_IRUGO);
+module_param_named(Depth,   g_mplbDepth,   uint, S_IRUGO);
+module_param_named(Threads, g_mplbThreads, uint, S_IRUGO);
+
+static u8 g_mplbMplId;
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_run
+ *-----------------------------------------------------------------*/
+/**
+ * thread function, get/release pairs with Depth blocks in flight.
+ * @param  pArg : the pointer to the S_MPLB_THREAD.
+ * @return 0.
+ * @note   the blocks in flight are got before, and released after
+ *         the measurement.
+ */
+/*-----------------------------------------------------------------*/
+static int
+MPLB_run(void *pArg)
+{
+    S_MPLB_THREAD *pThread = (S_MPLB_THREAD *)pArg;
+    ktime_t        start;
+    u32            i;
+    u32            oldest;
+
+    for(i=0; i<g_mplbDepth; i++) {
+        if(CMN_getFixedMemPool(g_mplbMplId, &pThread->pInFlight[i], CMN_TIME_FEVR) != SUCCESS) {
+            pThread->pInFlight[i] = NULL;
+            pThread->error = -1;
+            goto EXIT;
+        }
+    }
+
+    start  = ktime_get();
+    oldest = 0;
+    for(i=0; i<g_mplbCount; i++) {
+        if(CMN_releaseFixedMemPool(g_mplbMplId, pThread->pInFlight[oldest]) != SUCCESS) {
+            pThread->error = -1;
+            break;
+        }
+        if(CMN_getFixedMemPool(g_mplbMplId, &pThread->pInFlight[oldest], CMN_TIME_FEVR) != SUCCESS) {
+            pThread->pInFlight[oldest] = NULL;
+            pThread->error = -1;
+            break;
+        }
+        // touch the block as the user of the pool does.
+        *(volatile u32 *)pThread->pInFlight[oldest] = i;
+        oldest = (oldest + 1) % g_mplbDepth;
+    }
+    pThread->ns = (u64)ktime_to_ns(ktime_sub(ktime_get(), start));
+
+EXIT:
+    for(i=0; i<g_mplbDepth; i++) {
+        if(pThread->pInFlight[i]) {
+            CMN_releaseFixedMemPool(g_mplbMplId, pThread->pInFlight[i]);
+        }
+    }
+    complete(&pThread->done);
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_initModule
+ *-----------------------------------------------------------------*/
+/**
+ * Initialize routine called when module inserted to kernel.
+ * @param   nothing.
+ * @return  0       (normally completion)
+ * @return  -EINVAL (the module parameter is invalid)
+ * @return  -ENOMEM (no memory)
+ * @note    the benchmark runs here, and the result goes to the kernel log.
+ */
+/*-----------------------------------------------------------------*/
+static int __init
+MPLB_initModule(void)
+{
+    S_MPLB_THREAD *pThread;
+    T_CMN_ERR      retval;
+    u32            blkCnt;
+    u32            started = 0;
+    u32            i;
+    u64            ns = 0;
+    int            error = 0;
+
+    if((g_mplbCount == 0) ||
+       (g_mplbSize == 0) ||
+       (g_mplbDepth == 0) || (g_mplbDepth > MPLB_DEPTH_MAX) ||
+       (g_mplbThreads == 0) || (g_mplbThreads > MPLB_THREADS_MAX)) {
+        return -EINVAL;
+    }
+
+    // one extra block per thread, a get never waits for the others.
+    blkCnt = (g_mplbDepth + 1) * g_mplbThreads;
+    if(blkCnt > 0xFFFF) {
+        return -EINVAL;
+    }
+
+    pThread = kzalloc(sizeof(S_MPLB_THREAD) * g_mplbThreads, GFP_KERNEL);
+    if(pThread == NULL) {
+        return -ENOMEM;
+    }
+
+    // any free ID, not to collide with the pools of CNL.
+    retval = CMN_acreateFixedMemPool(0, (u16)blkCnt, g_mplbSize);
+    if(retval <= 0) {
+        CMN_print("mplbench: CMN_acreateFixedMemPool failed[%d].\n", retval);
+        kfree(pThread);
+        return -ENOMEM;
+    }
+    g_mplbMplId = (u8)retval;
+
+    for(i=0; i<g_mplbThreads; i++) {
+        init_completion(&pThread[i].done);
+        pThread[i].pTsk = kthread_create(MPLB_run, &pThread[i], "mplbench/%u", i);
+        if(IS_ERR(pThread[i].pTsk)) {
+            error = -1;
+            break;
+        }
+        kthread_bind(pThread[i].pTsk, i % num_online_cpus());
+        started++;
+    }
+    for(i=0; i<started; i++) {
+        wake_up_process(pThread[i].pTsk);
+    }
+    for(i=0; i<started; i++) {
+        wait_for_completion(&pThread[i].done);
+        ns    += pThread[i].ns;
+        error |= pThread[i].error;
+    }
+
+    CMN_deleteFixedMemPool(g_mplbMplId);
+
+    CMN_print("mplbench: pool=tososcmn size=%u depth=%u threads=%u count=%u\n",
+              g_mplbSize, g_mplbDepth, g_mplbThreads, g_mplbCount);
+    if(error != 0) {
+        CMN_print("  failed\n");
+    } else {
+        CMN_print("  get+release : %llu ns/pair (per thread)\n",
+                  div_u64(div_u64(ns, g_mplbThreads), g_mplbCount));
+    }
+
+    kfree(pThread);
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_exitModule
+ *-----------------------------------------------------------------*/
+/**
+ * cleanup routine called when module removed from kernel.
+ * @param   nothing.
+ * @return  nothing.
+ * @note
+ */
+/*-----------------------------------------------------------------*/
+static void __exit
+MPLB_exitModule(void)
+{
+    return;
+}
+
+module_init(MPLB_initModule);
+module_exit(MPLB_exitModule);
+
+/* Module information */
+MODULE_LICENSE("GPL v2");
+MODULE_DESCRIPTION( DRIVER_DESC );
+MODULE_VERSION( DRIVER_VERSION );
@@ -0,0 +1,491 @@
+/*
+    Copyright 2011-2014 Toshiba Corporation.
+    All Rights Reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License only.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/**
+ *  @file     mplbench.c
+ *
+ *  @brief    microbenchmark of the fixed memory pool of oscmn.
+ *
+ *  @note     each thread keeps depth blocks in flight, and releases the
+ *            oldest one for each get, as the completion path does.
+ *
+ *            by default CMN_getFixedMemPool/CMN_releaseFixedMemPool of
+ *            the POSIX port are measured. -L measures a model of the
+ *            former pool instead, which chained a got block to the head
+ *            of the used queue and searched it on release under one lock.
+ *            so the cost of the former release grows with depth.
+ *
+ *            both are user space code. the kernel pool of tososcmn
+ *            (readyQ llist, per-CPU magazines, range check of release)
+ *            is not run here, see kmod/mplbench_km.c for it.
+ */
+/*=================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "cmn_type.h"
+#include "cmn_err.h"
+#include "oscmn.h"
+#include "cmn_cnf.h"
+
+
+/*-------------------------------------------------------------------
+ * Macro Definitions
+ *-----------------------------------------------------------------*/
+#define MPLB_DEF_COUNT                 1000000
+#define MPLB_DEF_SIZE                  2048
+#define MPLB_DEF_DEPTH                 8
+#define MPLB_DEF_THREADS               1
+
+#define MPLB_DEPTH_MAX                 1024
+#define MPLB_THREADS_MAX               64
+
+// pool ID for the benchmark, not used by CNL in this process.
+#define MPLB_MPL_ID                    CMN_MEM_POOL_MAX_NUM
+
+#define MPLB_NSEC_PER_SEC              1000000000ULL
+
+
+/*-------------------------------------------------------------------
+ * Structure Definitions
+ *-----------------------------------------------------------------*/
+/**
+ * @brief benchmark configuration.
+ */
+typedef struct tagS_MPLB_CONF {
+    u32         count;     // get/release pairs per thread.
+    u32         size;      // block size.
+    u32         depth;     // blocks in flight per thread.
+    u32         threads;
+    u8          listModel; // measure the model of the former pool.
+} S_MPLB_CONF;
+
+
+/**
+ * @brief block of the former pool model.
+ */
+typedef struct tagS_MPLB_BLK {
+    struct tagS_MPLB_BLK *pPrev;
+    struct tagS_MPLB_BLK *pNext;
+    void                 *pMem;
+} S_MPLB_BLK;
+
+
+/**
+ * @brief the former pool model, readyQ and usedQ under one lock.
+ */
+typedef struct tagS_MPLB_LIST {
+    pthread_mutex_t  lock;
+    pthread_cond_t   getWait;
+    S_MPLB_BLK       readyQ;
+    S_MPLB_BLK       usedQ;
+    S_MPLB_BLK      *pBlk;
+} S_MPLB_LIST;
+
+
+/**
+ * @brief one thread.
+ */
+typedef struct tagS_MPLB_THREAD {
+    pthread_t   thread;
+    void       *pInFlight[MPLB_DEPTH_MAX];
+    u64         ns;
+    int         error;
+} S_MPLB_THREAD;
+
+
+/*-------------------------------------------------------------------
+ * Global Definitions
+ *-----------------------------------------------------------------*/
+static S_MPLB_CONF g_conf = {
+    .count     = MPLB_DEF_COUNT,
+    .size      = MPLB_DEF_SIZE,
+    .depth     = MPLB_DEF_DEPTH,
+    .threads   = MPLB_DEF_THREADS,
+    .listModel = 0,
+};
+
+static S_MPLB_LIST g_list;
+
+
+/*-------------------------------------------------------------------
+ * Inline Functions
+ *-----------------------------------------------------------------*/
+static inline u64
+MPLB_nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u64)ts.tv_sec * MPLB_NSEC_PER_SEC) + ts.tv_nsec;
+}
+
+
+static inline void
+MPLB_unlink(S_MPLB_BLK *pBlk)
+{
+    pBlk->pPrev->pNext = pBlk->pNext;
+    pBlk->pNext->pPrev = pBlk->pPrev;
+}
+
+
+static inline void
+MPLB_addHead(S_MPLB_BLK *pHead,
+             S_MPLB_BLK *pBlk)
+{
+    pBlk->pNext         = pHead->pNext;
+    pBlk->pPrev         = pHead;
+    pHead->pNext->pPrev = pBlk;
+    pHead->pNext        = pBlk;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_createList
+ *-----------------------------------------------------------------*/
+/**
+ * create the model of the former pool.
+ * @param  cnt  : the number of blocks.
+ * @param  size : the size of block.
+ * @return 0 (normally completion), -1 (no memory)
+ * @note   nothing.
+ */
+/*-----------------------------------------------------------------*/
+static int
+MPLB_createList(u32 cnt,
+                u32 size)
+{
+    u32 i;
+
+    pthread_mutex_init(&g_list.lock, NULL);
+    pthread_cond_init(&g_list.getWait, NULL);
+    g_list.readyQ.pPrev = g_list.readyQ.pNext = &g_list.readyQ;
+    g_list.usedQ.pPrev  = g_list.usedQ.pNext  = &g_list.usedQ;
+
+    g_list.pBlk = calloc(cnt, sizeof(S_MPLB_BLK));
+    if(g_list.pBlk == NULL) {
+        return -1;
+    }
+    for(i=0; i<cnt; i++) {
+        g_list.pBlk[i].pMem = malloc(size);
+        if(g_list.pBlk[i].pMem == NULL) {
+            return -1;
+        }
+        MPLB_addHead(&g_list.readyQ, &g_list.pBlk[i]);
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_deleteList
+ *-----------------------------------------------------------------*/
+static void
+MPLB_deleteList(u32 cnt)
+{
+    u32 i;
+
+    if(g_list.pBlk) {
+        for(i=0; i<cnt; i++) {
+            free(g_list.pBlk[i].pMem);
+        }
+        free(g_list.pBlk);
+        g_list.pBlk = NULL;
+    }
+    pthread_cond_destroy(&g_list.getWait);
+    pthread_mutex_destroy(&g_list.lock);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_getList
+ *-----------------------------------------------------------------*/
+static void *
+MPLB_getList(void)
+{
+    S_MPLB_BLK *pBlk;
+
+    pthread_mutex_lock(&g_list.lock);
+    while(g_list.readyQ.pNext == &g_list.readyQ) {
+        pthread_cond_wait(&g_list.getWait, &g_list.lock);
+    }
+    pBlk = g_list.readyQ.pNext;
+    MPLB_unlink(pBlk);
+    MPLB_addHead(&g_list.usedQ, pBlk);
+    pthread_mutex_unlock(&g_list.lock);
+
+    return pBlk->pMem;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_releaseList
+ *-----------------------------------------------------------------*/
+static int
+MPLB_releaseList(void *pMem)
+{
+    S_MPLB_BLK *pBlk;
+
+    pthread_mutex_lock(&g_list.lock);
+    for(pBlk = g_list.usedQ.pNext; pBlk != &g_list.usedQ; pBlk = pBlk->pNext) {
+        if(pBlk->pMem == pMem) {
+            MPLB_unlink(pBlk);
+            MPLB_addHead(&g_list.readyQ, pBlk);
+            pthread_cond_signal(&g_list.getWait);
+            pthread_mutex_unlock(&g_list.lock);
+            return 0;
+        }
+    }
+    pthread_mutex_unlock(&g_list.lock);
+
+    return -1;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_get
+ *-----------------------------------------------------------------*/
+static int
+MPLB_get(void **ppMem)
+{
+    if(g_conf.listModel) {
+        *ppMem = MPLB_getList();
+        return 0;
+    }
+
+    return (CMN_getFixedMemPool(MPLB_MPL_ID, ppMem, CMN_TIME_FEVR) == SUCCESS) ? 0 : -1;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_release
+ *-----------------------------------------------------------------*/
+static int
+MPLB_release(void *pMem)
+{
+    if(g_conf.listModel) {
+        return MPLB_releaseList(pMem);
+    }
+
+    return (CMN_releaseFixedMemPool(MPLB_MPL_ID, pMem) == SUCCESS) ? 0 : -1;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_run
+ *-----------------------------------------------------------------*/
+/**
+ * thread function, get/release pairs with depth blocks in flight.
+ * @param  pArg : the pointer to the S_MPLB_THREAD.
+ * @return NULL.
+ * @note   the blocks in flight are got before, and released after
+ *         the measurement.
+ */
+/*-----------------------------------------------------------------*/
+static void *
+MPLB_run(void *pArg)
+{
+    S_MPLB_THREAD *pThread = (S_MPLB_THREAD *)pArg;
+    u64            start;
+    u32            i;
+    u32            oldest;
+
+    for(i=0; i<g_conf.depth; i++) {
+        if(MPLB_get(&pThread->pInFlight[i]) != 0) {
+            pThread->error = -1;
+            return NULL;
+        }
+    }
+
+    start  = MPLB_nowNs();
+    oldest = 0;
+    for(i=0; i<g_conf.count; i++) {
+        if(MPLB_release(pThread->pInFlight[oldest]) != 0) {
+            pThread->error = -1;
+            break;
+        }
+        if(MPLB_get(&pThread->pInFlight[oldest]) != 0) {
+            pThread->error = -1;
+            break;
+        }
+        // touch the block as the user of the pool does.
+        *(volatile u32 *)pThread->pInFlight[oldest] = i;
+        oldest = (oldest + 1) % g_conf.depth;
+    }
+    pThread->ns = MPLB_nowNs() - start;
+
+    for(i=0; i<g_conf.depth; i++) {
+        MPLB_release(pThread->pInFlight[i]);
+    }
+
+    return NULL;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_usage
+ *-----------------------------------------------------------------*/
+static void
+MPLB_usage(const char *pProg)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -n count      get/release pairs per thread (default %u)\n"
+            "  -s size       block size in byte (default %u)\n"
+            "  -q depth      blocks in flight per thread, 1-%u (default %u)\n"
+            "  -t threads    threads, 1-%u (default %u)\n"
+            "  -L            measure the model of the former pool\n",
+            pProg,
+            MPLB_DEF_COUNT, MPLB_DEF_SIZE,
+            MPLB_DEPTH_MAX, MPLB_DEF_DEPTH,
+            MPLB_THREADS_MAX, MPLB_DEF_THREADS);
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : MPLB_parseArgs
+ *-----------------------------------------------------------------*/
+static int
+MPLB_parseArgs(int    argc,
+               char **argv)
+{
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:s:q:t:Lh")) != -1) {
+        switch(opt) {
+        case 'n' :
+            g_conf.count = strtoul(optarg, NULL, 0);
+            break;
+        case 's' :
+            g_conf.size = strtoul(optarg, NULL, 0);
+            break;
+        case 'q' :
+            g_conf.depth = strtoul(optarg, NULL, 0);
+            break;
+        case 't' :
+            g_conf.threads = strtoul(optarg, NULL, 0);
+            break;
+        case 'L' :
+            g_conf.listModel = 1;
+            break;
+        default :
+            return -1;
+        }
+    }
+
+    if((g_conf.count == 0) ||
+       (g_conf.size == 0) ||
+       (g_conf.depth == 0) || (g_conf.depth > MPLB_DEPTH_MAX) ||
+       (g_conf.threads == 0) || (g_conf.threads > MPLB_THREADS_MAX)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*-------------------------------------------------------------------
+ * Function : main
+ *-----------------------------------------------------------------*/
+int
+main(int    argc,
+     char **argv)
+{
+    S_MPLB_THREAD *pThread;
+    u32            blkCnt;
+    u32            i;
+    u64            ns = 0;
+    int            retval = 0;
+
+    if(MPLB_parseArgs(argc, argv) != 0) {
+        MPLB_usage(argv[0]);
+        return 2;
+    }
+
+    // one extra block per thread, a get never waits for the others.
+    blkCnt = (g_conf.depth + 1) * g_conf.threads;
+    if(blkCnt > 0xFFFF) {
+        MPLB_usage(argv[0]);
+        return 2;
+    }
+
+    pThread = calloc(g_conf.threads, sizeof(S_MPLB_THREAD));
+    if(pThread == NULL) {
+        return 1;
+    }
+
+    if(g_conf.listModel) {
+        if(MPLB_createList(blkCnt, g_conf.size) != 0) {
+            fprintf(stderr, "no memory.\n");
+            MPLB_deleteList(blkCnt);
+            free(pThread);
+            return 1;
+        }
+    } else {
+        if(OSCMN_init() != 0) {
+            fprintf(stderr, "OSCMN_init failed.\n");
+            free(pThread);
+            return 1;
+        }
+        if(CMN_createFixedMemPool(MPLB_MPL_ID, 0, (u16)blkCnt, g_conf.size) != SUCCESS) {
+            fprintf(stderr, "CMN_createFixedMemPool failed.\n");
+            OSCMN_exit();
+            free(pThread);
+            return 1;
+        }
+    }
+
+    for(i=0; i<g_conf.threads; i++) {
+        pthread_create(&pThread[i].thread, NULL, MPLB_run, &pThread[i]);
+    }
+    for(i=0; i<g_conf.threads; i++) {
+        pthread_join(pThread[i].thread, NULL);
+        ns     += pThread[i].ns;
+        retval |= (pThread[i].error != 0);
+    }
+
+    if(g_conf.listModel) {
+        MPLB_deleteList(blkCnt);
+    } else {
+        CMN_deleteFixedMemPool(MPLB_MPL_ID);
+        OSCMN_exit();
+    }
+
+    printf("mplbench: pool=%s size=%u depth=%u threads=%u count=%u\n",
+           g_conf.listModel ? "former-list" : "oscmn",
+           g_conf.size, g_conf.depth, g_conf.threads, g_conf.count);
+    if(retval != 0) {
+        printf("  failed\n");
+    } else {
+        printf("  get+release : %.1f ns/pair (per thread)\n",
+               ns / (double)g_conf.threads / g_conf.count);
+    }
+
+    free(pThread);
+
+    return retval;
+}
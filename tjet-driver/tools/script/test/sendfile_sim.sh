@@ -0,0 +1,164 @@
+#!/bin/sh
+
+#
+# SENDFILE test on the simulated bus.
+#
+# the chips 0 and 1 of the simulated bus are linked back-to-back.
+# CnlFitCtrl0 sends a file by SENDFILE, and CnlFitCtrl1 compares the
+# received data with the same file. the file is put on two file systems.
+#
+# tmpfs   : tmpfs has no readpage, so SENDFILE reads the file into the
+#           bounce buffer.
+# ext4    : the file on a loop-mounted ext4 image is sent from the pages
+#           of page cache (zero-copy).
+#
+# usage : sh sendfile_sim.sh [object-path] [cnlbench-path]
+#
+
+if [ $# -ge 1 ] ; then
+obj_dir=$1
+else
+obj_dir=/system/lib/modules
+fi
+
+if [ $# -ge 2 ] ; then
+bench=$2
+else
+bench=`dirname $0`/../../bench/cnlbench
+fi
+
+module_list="tososcmn tosbuscmn toscnlfit tosiofit toscnl"
+module_sfx=".ko"
+device_name="CnlFitCtrl"
+device_dir="/dev"
+
+msg_size=65536
+msg_num=64
+msg_count=256
+
+log="/dev/null"
+
+
+#
+# check files
+#
+if ! [ -x $bench ]; then
+    echo "$bench is not found, make cnlbench in tools/bench."
+    exit 1
+fi
+
+for module_name in $module_list
+do
+    if ! [ -f $obj_dir/$module_name$module_sfx ]; then
+        echo "$obj_dir/$module_name$module_sfx is not found."
+        exit 1
+    fi
+done
+
+
+#
+# install module with the simulated bus
+#
+echo "### Install driver modules ..."
+
+for module_name in $module_list
+do
+    case "$module_name" in
+    "tosbuscmn"|"toscnlfit")
+        module_para="SimDevNum=2"
+        ;;
+    "toscnl")
+        module_para="BusSim=1"
+        ;;
+    *)
+        module_para=
+        ;;
+    esac
+
+    echo -n "+++ install $module_name $module_para ... "
+    /sbin/insmod "$obj_dir/$module_name$module_sfx" $module_para > $log
+    if [ $? = 0 ]; then
+        echo "OK."
+    else
+        echo "Failed."
+        exit 1
+    fi
+done
+
+
+#
+# make device node if udev did not.
+#
+major=`grep " $device_name\$" /proc/devices | cut -d ' ' -f 1`
+for minor in 0 1
+do
+    if ! [ -c $device_dir/$device_name$minor ]; then
+        mknod $device_dir/$device_name$minor c $major $minor
+    fi
+done
+
+
+#
+# run SENDFILE of the file in the directory
+#
+run_sendfile()
+{
+    echo "### SENDFILE $msg_count messages of $msg_size bytes on $1 ..."
+
+    dd if=/dev/urandom of=$2/data bs=$msg_size count=$msg_num 2> $log
+    sync
+
+    $bench -r resp -D $device_dir/${device_name}1 -s $msg_size -n $msg_count -F $2/data &
+    resp_pid=$!
+    sleep 1
+    $bench -r init -D $device_dir/${device_name}0 -s $msg_size -n $msg_count -F $2/data
+    init_result=$?
+    wait $resp_pid
+    resp_result=$?
+
+    if [ $init_result = 0 -a $resp_result = 0 ]; then
+        echo "### OK."
+    else
+        echo "### Failed[$init_result/$resp_result]."
+        result=1
+    fi
+}
+
+result=0
+tmp_dir=`mktemp -d`
+
+
+#
+# tmpfs (bounce buffer)
+#
+mount -t tmpfs -o size=16m tmpfs $tmp_dir
+run_sendfile tmpfs $tmp_dir
+umount $tmp_dir
+
+
+#
+# ext4 on loop device (page cache)
+#
+img=`mktemp`
+dd if=/dev/zero of=$img bs=1M count=32 2> $log
+if /sbin/mkfs.ext4 -q -F $img > $log 2>&1 && mount -t ext4 -o loop $img $tmp_dir; then
+    run_sendfile ext4 $tmp_dir
+    umount $tmp_dir
+else
+    echo "### ext4 on loop device is not available."
+    result=1
+fi
+rm -f $img
+
+
+#
+# cleanup
+#
+rmdir $tmp_dir
+
+for module_name in toscnl tosiofit toscnlfit tosbuscmn tososcmn
+do
+    /sbin/rmmod $module_name > $log
+done
+
+exit $result